@@ -0,0 +1,117 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#ifndef __TANGENT_MATH_FUNC__BENCH_CORPUS
+#define __TANGENT_MATH_FUNC__BENCH_CORPUS 65536
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include <TangentsMathFunc.hpp>
+
+/*
+ * One benchmark workload: helper functions followed by the function being measured, which is always the last one.
+ */
+struct BenchCase
+{
+  std::string name;
+  std::vector<std::string> identifiers;
+  std::vector<std::string> formulas;
+  int varCount;
+};
+
+/*
+ * Long sum of generated terms in x and y, e.g. "3*x^2 - 5*sin(y) + ...".
+ */
+static std::string benchLongExpression(int terms)
+{
+  static const char* const shapes[] = {"*x", "*y", "*x*y", "*x^2", "*sin(x)", "*cos(y)", "*(x*x + y*y)^0.5", "/(1 + x*x)"};
+  std::string formula = "1";
+  for(int i = 0 ; i < terms ; i++)
+  {
+    formula += (rand() % 2 ? " + " : " - ") + std::to_string(rand() % 97 + 1) + shapes[rand() % 8];
+  }
+  return formula;
+}
+
+/*
+ * The fixed benchmark corpus. Deterministic for a given seed.
+ */
+static std::vector<BenchCase> benchCorpus()
+{
+  std::vector<BenchCase> corpus;
+  srand(65536);
+  
+  // The polynomial from README.md.
+  BenchCase poly;
+  poly.name = "readme_polynomial";
+  poly.identifiers.push_back("f(x, y)");
+  poly.formulas.push_back("9*x^2 + 6*x*y + y^2 - 3*x - y - 1");
+  poly.varCount = 2;
+  corpus.push_back(poly);
+  
+  BenchCase trig;
+  trig.name = "trig_heavy";
+  trig.identifiers.push_back("f(x, y)");
+  trig.formulas.push_back("sin(x)*cos(y) + tan(x/4)*cos(x + y) - sin(2*x)^2 + atan(y)*sinh(x/8) + cosh(y/8)*tanh(x)");
+  trig.varCount = 2;
+  corpus.push_back(trig);
+  
+  // A chain of 32 user functions, each calling the previous one. The tail of the chain is too long to be inlined.
+  BenchCase deep;
+  deep.name = "deep_nesting";
+  deep.identifiers.push_back("d0(x, y)");
+  deep.formulas.push_back("x*y + 1");
+  for(int i = 1 ; i < 32 ; i++)
+  {
+    deep.identifiers.push_back("d" + std::to_string(i) + "(x, y)");
+    deep.formulas.push_back("d" + std::to_string(i - 1) + "(y, x*0.5 + 1)*0.75 + sin(x) - y");
+  }
+  deep.identifiers.push_back("f(x, y)");
+  deep.formulas.push_back("d31(x, y)");
+  deep.varCount = 2;
+  corpus.push_back(deep);
+  
+  BenchCase lengthy;
+  lengthy.name = "long_generated";
+  lengthy.identifiers.push_back("f(x, y)");
+  lengthy.formulas.push_back(benchLongExpression(200));
+  lengthy.varCount = 2;
+  corpus.push_back(lengthy);
+  
+  return corpus;
+}
+
+/*
+ * Define every function of a case in the default namespace, where the built-ins live.
+ *  Returns the functions in definition order.
+ */
+static std::vector<MathFunction*> benchLoad(const BenchCase& bc)
+{
+  std::vector<MathFunction*> funcs;
+  for(size_t i = 0 ; i < bc.identifiers.size() ; i++)
+  {
+    funcs.push_back(new MathFunction(bc.identifiers[i], bc.formulas[i]));
+  }
+  return funcs;
+}
+
+/*
+ * Destroy the functions of a case, callers first.
+ */
+static void benchUnload(std::vector<MathFunction*>& funcs)
+{
+  for(size_t i = funcs.size() ; i > 0 ; i--)
+  {
+    delete funcs[i - 1];
+  }
+  funcs.clear();
+}
+
+#endif
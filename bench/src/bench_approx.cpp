@@ -0,0 +1,184 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <string>
+
+#include <TangentsMathFunc.hpp>
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+/*
+ * A built-in measured over a range of arguments. Those of "logarithmic" cases are e^u for u uniform within the bounds,
+ *  with a random sign except for ln.
+ */
+struct ApproxCase
+{
+  const char* name;
+  const char* builtin;
+  double lower;
+  double upper;
+  bool logarithmic;
+  long double (*reference)(long double);
+};
+
+static const ApproxCase CASES[] = {
+  {"sin", "sin", -10, 10, false, sinl},
+  {"sin_wide", "sin", -1e5, 1e5, false, sinl},
+  {"cos", "cos", -10, 10, false, cosl},
+  {"cos_wide", "cos", -1e5, 1e5, false, cosl},
+  {"tan", "tan", -10, 10, false, tanl},
+  {"tan_wide", "tan", -1e5, 1e5, false, tanl},
+  {"exp", "exp", -700, 700, false, expl},
+  {"ln", "ln", -700, 700, true, logl}
+};
+
+static double secondsSince(Clock::time_point start)
+{
+  return chrono::duration<double>(Clock::now() - start).count();
+}
+
+/*
+ * Distance from the reference in units in the last place of the reference rounded to double.
+ */
+static double ulpError(double value, long double reference)
+{
+  double rounded = (double)reference;
+  if(value == rounded || (isnan(value) && isnan(rounded)))
+  {
+    return 0;
+  }
+  if(!isfinite(value) || !isfinite(rounded))
+  {
+    return INFINITY;
+  }
+  double ulp = nextafter(fabs(rounded), INFINITY) - fabs(rounded);
+  return (double)(fabsl((long double)value - reference) / ulp);
+}
+
+/*
+ * Best time of a few runs of invoke() over every argument, in nanoseconds per call.
+ */
+static double scalarNanos(const MathFunction& func, const double* xs, int rows, double* results)
+{
+  double best = INFINITY;
+  for(int run = 0 ; run < 5 ; run++)
+  {
+    Clock::time_point start = Clock::now();
+    for(int i = 0 ; i < rows ; i++)
+    {
+      results[i] = func.invoke({xs[i]});
+    }
+    double elapsed = secondsSince(start);
+    best = (elapsed < best ? elapsed : best);
+  }
+  return best * 1e9 / rows;
+}
+
+/*
+ * Best time of a few invokeBatch() calls over every argument, in nanoseconds per row.
+ */
+static double batchNanos(const MathFunction& func, const double* xs, int rows, double* results)
+{
+  double best = INFINITY;
+  for(int run = 0 ; run < 5 ; run++)
+  {
+    Clock::time_point start = Clock::now();
+    func.invokeBatch(&xs, rows, results);
+    double elapsed = secondsSince(start);
+    best = (elapsed < best ? elapsed : best);
+  }
+  return best * 1e9 / rows;
+}
+
+/*
+ * Usage: bench_approx [output.json] [rows]
+ *  Compares each built-in at PRECISION_EXACT and PRECISION_FAST: the maximum and mean errors in ULP against the long double
+ *  standard library, and the time per row of invoke() and invokeBatch().
+ */
+int main(int argc, char* argv[])
+{
+  FILE* out = (argc > 1 ? fopen(argv[1], "w") : stdout);
+  if(out == nullptr)
+  {
+    fprintf(stderr, "Cannot open %s\n", argv[1]);
+    return 1;
+  }
+  int rows = (argc > 2 ? atoi(argv[2]) : 1000000);
+  
+  // Both functions are compiled optimized right away, so that tiering does not interfere with the timings.
+  TierPolicy policy;
+  policy.enabled = false;
+  MathFunction::setTierPolicy(policy);
+  
+  mt19937_64 rng(65536);
+  double* xs = new double[rows];
+  double* exact = new double[rows];
+  double* fast = new double[rows];
+  bool first = true;
+  
+  fprintf(out, "{\n  \"benchmark\": \"approx\",\n  \"rows\": %d,\n  \"extended_reference\": %s,\n  \"cases\": [", rows, (sizeof(long double) > sizeof(double) ? "true" : "false"));
+  for(const ApproxCase& test : CASES)
+  {
+    uniform_real_distribution<double> uniform(test.lower, test.upper);
+    for(int i = 0 ; i < rows ; i++)
+    {
+      double u = uniform(rng);
+      xs[i] = (test.logarithmic ? exp(u) : u);
+      if(test.logarithmic && test.reference != logl && (rng() & 1))
+      {
+        xs[i] = -xs[i];
+      }
+    }
+    
+    string call = string(test.builtin) + "(x)";
+    MathFunction exactFunc(string("exact_") + test.name + "(x)", call);
+    MathFunction fastFunc(string("fast_") + test.name + "(x)", call);
+    fastFunc.setPrecision(PRECISION_FAST);
+    
+    double exactScalar = scalarNanos(exactFunc, xs, rows, exact);
+    double fastScalar = scalarNanos(fastFunc, xs, rows, fast);
+    double exactBatch = batchNanos(exactFunc, xs, rows, exact);
+    double fastBatch = batchNanos(fastFunc, xs, rows, fast);
+    
+    double exactMax = 0, exactSum = 0, fastMax = 0, fastSum = 0;
+    for(int i = 0 ; i < rows ; i++)
+    {
+      long double reference = test.reference(xs[i]);
+      double error = ulpError(exact[i], reference);
+      exactMax = fmax(exactMax, error);
+      exactSum += error;
+      error = ulpError(fast[i], reference);
+      fastMax = fmax(fastMax, error);
+      fastSum += error;
+    }
+    
+    fprintf(out, "%s\n    {\"name\": \"%s\", \"lower\": %g, \"upper\": %g,"
+      " \"exact\": {\"max_ulp\": %.3f, \"mean_ulp\": %.4f, \"scalar_ns\": %.2f, \"batch_ns\": %.2f},"
+      " \"fast\": {\"max_ulp\": %.3f, \"mean_ulp\": %.4f, \"scalar_ns\": %.2f, \"batch_ns\": %.2f}}",
+      first ? "" : ",", test.name, test.lower, test.upper,
+      exactMax, exactSum / rows, exactScalar, exactBatch, fastMax, fastSum / rows, fastScalar, fastBatch);
+    first = false;
+  }
+  fprintf(out, "\n  ]\n}\n");
+  
+  delete[] xs;
+  delete[] exact;
+  delete[] fast;
+  if(out != stdout)
+  {
+    fclose(out);
+  }
+  return 0;
+}
@@ -0,0 +1,237 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <TangentsMathFunc.hpp>
+
+#include "BenchCorpus.hpp"
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+/*
+ * Arena chunks allocated by the library, counted through the allocation hook of the arenas. Buffers taken from the
+ *  global operator new are not seen, see Arena::setAllocationHook().
+ */
+static atomic<size_t> ALLOCATIONS(0);
+
+static void* countAllocate(size_t size, void*)
+{
+  ALLOCATIONS++;
+  return malloc(size);
+}
+
+static void countRelease(void* ptr, size_t, void*)
+{
+  free(ptr);
+}
+
+/*
+ * A record of the array of structs read by invokeStrided().
+ */
+struct BenchRecord
+{
+  long long id;
+  double x;
+  double weight;
+  double y;
+};
+
+static double secondsSince(Clock::time_point start)
+{
+  return chrono::duration<double>(Clock::now() - start).count();
+}
+
+/*
+ * Keeps results observable so that the measured loops are not optimized away.
+ */
+static volatile double SINK = 0;
+
+/*
+ * Time a function over the given rows, with invoke() and with invokeBatch().
+ *
+ * Param(s):
+ *    scalarNs    -> Nanoseconds per call of invoke().
+ *    batchNs     -> Nanoseconds per row of invokeBatch().
+ */
+static void timeRows(const MathFunction& func, const vector<double>& xs, const vector<double>& ys, vector<double>& results, double& scalarNs, double& batchNs)
+{
+  int rows = (int)(xs.size());
+  Clock::time_point start = Clock::now();
+  for(int i = 0 ; i < rows ; i++)
+  {
+    results[i] = func.invoke({xs[i], ys[i]});
+  }
+  scalarNs = secondsSince(start) * 1e9 / rows;
+  SINK = results[rows / 2];
+  
+  const double* columns[] = {xs.data(), ys.data()};
+  start = Clock::now();
+  func.invokeBatch(columns, rows, results.data());
+  batchNs = secondsSince(start) * 1e9 / rows;
+  SINK = results[rows / 2];
+}
+
+/*
+ * Usage: bench_main [output.json] [scale]
+ *  Measures every corpus case: parse throughput, single-call latency percentiles, arena allocations per call,
+ *  and rows per second of a scalar invoke() loop, invokeBatch() and invokeStrided(). Then measures the cost of a pow()
+ *  call in instructions, the figure behind Program::POWER_COST. Scale multiplies the iteration counts.
+ */
+int main(int argc, char* argv[])
+{
+  FILE* out = (argc > 1 ? fopen(argv[1], "w") : stdout);
+  if(out == nullptr)
+  {
+    fprintf(stderr, "Cannot open %s\n", argv[1]);
+    return 1;
+  }
+  double scale = (argc > 2 ? atof(argv[2]) : 1.0);
+  Arena::setAllocationHook(countAllocate, countRelease, nullptr);
+  const int PARSES = max(1, (int)(2000 * scale));
+  const int LATENCY_CALLS = max(100, (int)(100000 * scale));
+  // A copy, as max() would bind a reference to the in-class constant, which has no definition.
+  int batchSize = Program::BATCH_SIZE;
+  const int ROWS = max(batchSize, (int)(1000000 * scale));
+  
+  vector<BenchCase> corpus = benchCorpus();
+  
+  // Shared inputs, in [0.5, 2.5) to stay inside the domain of every corpus function.
+  vector<double> xs(ROWS);
+  vector<double> ys(ROWS);
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    xs[i] = 0.5 + 2.0 * rand() / RAND_MAX;
+    ys[i] = 0.5 + 2.0 * rand() / RAND_MAX;
+  }
+  vector<double> results(ROWS);
+  vector<BenchRecord> records(ROWS);
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    records[i].x = xs[i];
+    records[i].y = ys[i];
+  }
+  
+  fprintf(out, "{\n  \"benchmark\": \"main\",\n  \"rows\": %d,\n  \"cases\": [", ROWS);
+  for(size_t c = 0 ; c < corpus.size() ; c++)
+  {
+    const BenchCase& bc = corpus[c];
+    vector<MathFunction*> funcs = benchLoad(bc);
+    MathFunction* target = funcs.back();
+    
+    // Parse throughput: redefine the measured function from scratch, helpers stay loaded.
+    size_t characters = bc.formulas.back().size() * PARSES;
+    Clock::time_point start = Clock::now();
+    for(int i = 0 ; i < PARSES ; i++)
+    {
+      delete target;
+      target = new MathFunction(bc.identifiers.back(), bc.formulas.back());
+    }
+    double parseSeconds = secondsSince(start);
+    funcs.back() = target;
+    
+    // Single-call latency, every call timed on its own.
+    vector<double> latencies(LATENCY_CALLS);
+    for(int i = 0 ; i < LATENCY_CALLS ; i++)
+    {
+      int row = i % ROWS;
+      Clock::time_point t0 = Clock::now();
+      double ret = target->invoke({xs[row], ys[row]});
+      latencies[i] = chrono::duration<double, nano>(Clock::now() - t0).count();
+      SINK = ret;
+    }
+    sort(latencies.begin(), latencies.end());
+    
+    // Hot by now. The throughput figures below are those of the optimized tier.
+    MathFunction::waitForTiering();
+    
+    // Arena allocations per call.
+    size_t allocations = ALLOCATIONS.load();
+    for(int i = 0 ; i < LATENCY_CALLS ; i++)
+    {
+      SINK = target->invoke({xs[i % ROWS], ys[i % ROWS]});
+    }
+    double allocationsPerCall = (double)(ALLOCATIONS.load() - allocations) / LATENCY_CALLS;
+    
+    // Rows per second, scalar.
+    start = Clock::now();
+    for(int i = 0 ; i < ROWS ; i++)
+    {
+      results[i] = target->invoke({xs[i], ys[i]});
+    }
+    double scalarSeconds = secondsSince(start);
+    SINK = results[ROWS / 2];
+    
+    // Rows per second, batched.
+    const double* columns[] = {xs.data(), ys.data()};
+    allocations = ALLOCATIONS.load();
+    start = Clock::now();
+    target->invokeBatch(columns, ROWS, results.data());
+    double batchSeconds = secondsSince(start);
+    double batchAllocations = (double)(ALLOCATIONS.load() - allocations);
+    SINK = results[ROWS / 2];
+    
+    // Rows per second, read in place from an array of records.
+    const double* bases[] = {&(records[0].x), &(records[0].y)};
+    ptrdiff_t strides[] = {sizeof(BenchRecord), sizeof(BenchRecord)};
+    start = Clock::now();
+    target->invokeStrided(bases, strides, ROWS, results.data());
+    double stridedSeconds = secondsSince(start);
+    SINK = results[ROWS / 2];
+    
+    fprintf(out, "%s\n    {\"name\": \"%s\", \"formula_chars\": %zu, \"instructions\": %d,"
+      " \"parses_per_sec\": %.1f, \"parse_chars_per_sec\": %.1f,"
+      " \"latency_p50_ns\": %.1f, \"latency_p99_ns\": %.1f, \"arena_allocations_per_call\": %.3f,"
+      " \"scalar_rows_per_sec\": %.1f, \"batch_rows_per_sec\": %.1f, \"strided_rows_per_sec\": %.1f, \"batch_arena_allocations\": %.0f, \"tier\": %d}",
+      c == 0 ? "" : ",", bc.name.c_str(), bc.formulas.back().size(), target->getMemoryUsage().instructions,
+      PARSES / parseSeconds, characters / parseSeconds,
+      latencies[LATENCY_CALLS / 2], latencies[(size_t)(LATENCY_CALLS * 0.99)], allocationsPerCall,
+      ROWS / scalarSeconds, ROWS / batchSeconds, ROWS / stridedSeconds, batchAllocations, target->getTierStats().tier);
+    
+    benchUnload(funcs);
+  }
+  fprintf(out, "\n  ],\n");
+  
+  // Cost of a power in instructions: a chain of multiplications gives the time of one instruction, and a power with
+  //  small integer exponents, as in a polynomial, is compared to a single multiplication. Compiled optimized right away,
+  //  with exponents read from a column so that the power is not rewritten.
+  TierPolicy policy;
+  policy.enabled = false;
+  MathFunction::setTierPolicy(policy);
+  vector<double> exponents(ROWS);
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    exponents[i] = 2 + rand() % 4;
+  }
+  MathFunction product("bench_product(x, y)", "x * y");
+  MathFunction chain("bench_chain(x, y)", "x * y * x * y * x * y * x * y");
+  MathFunction power("bench_power(x, y)", "x ^ y");
+  double productScalar, productBatch, chainScalar, chainBatch, powerScalar, powerBatch;
+  timeRows(product, xs, exponents, results, productScalar, productBatch);
+  timeRows(chain, xs, exponents, results, chainScalar, chainBatch);
+  timeRows(power, xs, exponents, results, powerScalar, powerBatch);
+  int extra = chain.getMemoryUsage().instructions - product.getMemoryUsage().instructions;
+  fprintf(out, "  \"power_cost\": {\"scalar_instructions\": %.1f, \"batch_instructions\": %.1f}\n}\n",
+    1 + (powerScalar - productScalar) * extra / (chainScalar - productScalar),
+    1 + (powerBatch - productBatch) * extra / (chainBatch - productBatch));
+  MathFunction::setTierPolicy(TierPolicy());
+  
+  if(out != stdout)
+  {
+    fclose(out);
+  }
+  return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <TangentsMathFunc.hpp>
+
+using namespace std;
+
+/*
+ * Resident set size of this process in bytes, or 0 if unavailable on this platform.
+ */
+static size_t residentBytes()
+{
+#ifdef _WIN32
+  return 0;
+#else
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if(statm == nullptr)
+  {
+    return 0;
+  }
+  long pages = 0;
+  long resident = 0;
+  if(fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+  {
+    resident = 0;
+  }
+  fclose(statm);
+  return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+/*
+ * Usage: bench_memory [function count] [output.json]
+ *  Loads generated formulas into one namespace and records RSS and accounted memory every 10k functions.
+ */
+int main(int argc, char* argv[])
+{
+  const int STEP = 10000;
+  int total = (argc > 1 ? atoi(argv[1]) : 100000);
+  FILE* out = (argc > 2 ? fopen(argv[2], "w") : stdout);
+  if(out == nullptr)
+  {
+    fprintf(stderr, "Cannot open %s\n", argv[2]);
+    return 1;
+  }
+  
+  srand(65536);
+  MathFunctionNamespace* ns = new MathFunctionNamespace();
+  MathFunction** funcs = new MathFunction*[total];
+  size_t baseline = residentBytes();
+  bool first = true;
+  
+  fprintf(out, "{\n  \"benchmark\": \"memory\",\n  \"baseline_rss_bytes\": %zu,\n  \"samples\": [", baseline);
+  for(int i = 0 ; i < total ; i++)
+  {
+    // Polynomials in two variables, every fourth one also calling an earlier function.
+    string formula = to_string(rand() % 97 + 1) + "*x^2 + " + to_string(rand() % 89 + 1) + "*x*y - " + to_string(rand() % 83 + 1) + "*y + " + to_string(rand() % 79);
+    if(i > 0 && i % 4 == 0)
+    {
+      formula += " + f" + to_string(rand() % i) + "(y, x)";
+    }
+    funcs[i] = new MathFunction(*ns, "f" + to_string(i) + "(x, y)", formula);
+    
+    if((i + 1) % STEP == 0 || i + 1 == total)
+    {
+      MemoryUsage usage = ns->getMemoryUsage();
+      size_t rss = residentBytes();
+      fprintf(out, "%s\n    {\"functions\": %d, \"rss_bytes\": %zu, \"rss_delta_bytes\": %zu, \"accounted_bytes\": %zu, \"postfix_bytes\": %zu, \"program_bytes\": %zu, \"table_bytes\": %zu, \"instructions\": %d}",
+        first ? "" : ",", i + 1, rss, rss - baseline, usage.getTotalBytes(), usage.postfixBytes, usage.programBytes, usage.tableBytes, usage.instructions);
+      first = false;
+    }
+  }
+  fprintf(out, "\n  ],\n  \"arena_reserved_bytes\": %zu\n}\n", Arena::getTotalReservedBytes());
+  
+  if(out != stdout)
+  {
+    fclose(out);
+  }
+  return 0;
+}
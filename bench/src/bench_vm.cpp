@@ -0,0 +1,117 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <TangentsMathFunc.hpp>
+
+#include "BenchCorpus.hpp"
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+static const Backend BACKENDS[] = {BACKEND_STACK, BACKEND_REGISTER};
+
+static const char* const BACKEND_NAMES[] = {"stack", "register"};
+
+static double secondsSince(Clock::time_point start)
+{
+  return chrono::duration<double>(Clock::now() - start).count();
+}
+
+/*
+ * Keeps results observable so that the measured loops are not optimized away.
+ */
+static volatile double SINK = 0;
+
+/*
+ * Usage: bench_vm [output.json] [rows]
+ *  Runs every corpus case on the stack and on the register backend: instructions, and the best time per row of a few runs
+ *  of a scalar invoke() loop and of invokeBatch(). Both backends must give the same results bit for bit.
+ */
+int main(int argc, char* argv[])
+{
+  FILE* out = (argc > 1 ? fopen(argv[1], "w") : stdout);
+  if(out == nullptr)
+  {
+    fprintf(stderr, "Cannot open %s\n", argv[1]);
+    return 1;
+  }
+  int rows = (argc > 2 ? atoi(argv[2]) : 1000000);
+  
+  // Every function is compiled optimized right away, so that tiering does not interfere with the timings.
+  TierPolicy policy;
+  policy.enabled = false;
+  MathFunction::setTierPolicy(policy);
+  
+  vector<BenchCase> corpus = benchCorpus();
+  
+  // Shared inputs, in [0.5, 2.5) to stay inside the domain of every corpus function.
+  vector<double> xs(rows);
+  vector<double> ys(rows);
+  for(int i = 0 ; i < rows ; i++)
+  {
+    xs[i] = 0.5 + 2.0 * rand() / RAND_MAX;
+    ys[i] = 0.5 + 2.0 * rand() / RAND_MAX;
+  }
+  const double* columns[] = {xs.data(), ys.data()};
+  vector<double> results[2] = {vector<double>(rows), vector<double>(rows)};
+  
+  fprintf(out, "{\n  \"benchmark\": \"vm\",\n  \"rows\": %d,\n  \"cases\": [", rows);
+  for(size_t c = 0 ; c < corpus.size() ; c++)
+  {
+    const BenchCase& bc = corpus[c];
+    fprintf(out, "%s\n    {\"name\": \"%s\"", c == 0 ? "" : ",", bc.name.c_str());
+    for(int b = 0 ; b < 2 ; b++)
+    {
+      MathFunction::setBackend(BACKENDS[b]);
+      vector<MathFunction*> funcs = benchLoad(bc);
+      MathFunction* target = funcs.back();
+      
+      double scalar = 1e300, batch = 1e300;
+      for(int run = 0 ; run < 3 ; run++)
+      {
+        Clock::time_point start = Clock::now();
+        for(int i = 0 ; i < rows ; i++)
+        {
+          results[b][i] = target->invoke({xs[i], ys[i]});
+        }
+        double elapsed = secondsSince(start);
+        scalar = (elapsed < scalar ? elapsed : scalar);
+        
+        start = Clock::now();
+        target->invokeBatch(columns, rows, results[b].data());
+        elapsed = secondsSince(start);
+        batch = (elapsed < batch ? elapsed : batch);
+      }
+      SINK = results[b][rows / 2];
+      
+      MemoryUsage usage = target->getMemoryUsage();
+      fprintf(out, ", \"%s\": {\"instructions\": %d, \"program_bytes\": %zu, \"scalar_ns\": %.2f, \"batch_ns\": %.2f}",
+        BACKEND_NAMES[b], (BACKENDS[b] == BACKEND_REGISTER ? usage.registerInstructions : usage.instructions), usage.programBytes,
+        scalar * 1e9 / rows, batch * 1e9 / rows);
+      benchUnload(funcs);
+    }
+    bool identical = (memcmp(results[0].data(), results[1].data(), rows * sizeof(double)) == 0);
+    fprintf(out, ", \"identical\": %s}", identical ? "true" : "false");
+  }
+  fprintf(out, "\n  ]\n}\n");
+  
+  MathFunction::setBackend(BACKEND_STACK);
+  if(out != stdout)
+  {
+    fclose(out);
+  }
+  return 0;
+}
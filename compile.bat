@@ -14,27 +14,96 @@ cd %~dp0src\util
 g++ -c %CPPFLAGS% -o %~dp0cache\LinkedNode.o LinkedNode.cpp
 g++ -c %CPPFLAGS% -o %~dp0cache\LinkedStack.o LinkedStack.cpp
 g++ -c %CPPFLAGS% -o %~dp0cache\HashTable.o HashTable.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\Arena.o Arena.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\PerfectHash.o PerfectHash.cpp
 
 cd %~dp0src\misc
 g++ -c %CPPFLAGS% -o %~dp0cache\StringWrap.o StringWrap.cpp
 g++ -c %CPPFLAGS% -o %~dp0cache\TFException.o TFException.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\FastFloat.o FastFloat.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\FastMath.o FastMath.cpp
 
 cd %~dp0src
 g++ -c %CPPFLAGS% -o %~dp0cache\Operators.o Operators.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\Profiler.o Profiler.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\Program.o Program.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\RegisterProgram.o RegisterProgram.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\TierCompiler.o TierCompiler.cpp
 g++ -c %CPPFLAGS% -o %~dp0cache\TangentsMathFunc.o TangentsMathFunc.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\CsvEvaluator.o CsvEvaluator.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\Integrator.o Integrator.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\RootFinder.o RootFinder.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\Tabulator.o Tabulator.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\AsyncEvaluator.o AsyncEvaluator.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\EvaluationPlan.o EvaluationPlan.cpp
+g++ -c %CPPFLAGS% -o %~dp0cache\Aggregator.o Aggregator.cpp
 
-:: Test target.
-set TARGET=test_main
-
+:: Test targets.
 mkdir %~dp0test\cache
 mkdir %~dp0test\bin
 
-cd %~dp0test\src
-g++ %CPPFLAGS% -c -o %~dp0test\cache\%TARGET%.o %TARGET%.cpp -I%~dp0src
+for %%T in (test_main test_horner test_redefine test_tiering test_csv test_batch test_bind test_integrator test_roots test_fastmath test_tabulator test_register test_async test_plan test_arrays test_namespace test_operators test_filter test_aggregator test_profiler test_arena test_dispatch) do (
+  g++ %CPPFLAGS% -c -o %~dp0test\cache\%%T.o %~dp0test\src\%%T.cpp -I%~dp0src
+  g++ -o %~dp0test\bin\%%T.exe %~dp0test\cache\%%T.o %~dp0cache\LinkedNode.o %~dp0cache\LinkedStack.o %~dp0cache\HashTable.o %~dp0cache\Arena.o %~dp0cache\PerfectHash.o %~dp0cache\StringWrap.o %~dp0cache\TFException.o %~dp0cache\FastFloat.o %~dp0cache\FastMath.o %~dp0cache\Operators.o %~dp0cache\Profiler.o %~dp0cache\Program.o %~dp0cache\RegisterProgram.o %~dp0cache\TierCompiler.o %~dp0cache\TangentsMathFunc.o %~dp0cache\CsvEvaluator.o %~dp0cache\Integrator.o %~dp0cache\RootFinder.o %~dp0cache\Tabulator.o %~dp0cache\AsyncEvaluator.o %~dp0cache\EvaluationPlan.o %~dp0cache\Aggregator.o %LDFLAGS%
+  strip -s %~dp0test\bin\%%T.exe
+)
+
+:: Profiled build, i.e. with TANGENT_MATH_FUNC_PROFILE: the library objects again, into a cache of their own,
+:: and the tests whose behaviour it changes, named with a "_profiled" suffix. Profiled builds inline no callee.
+mkdir %~dp0cache\profiled
+
+cd %~dp0src\util
+for %%S in (LinkedNode LinkedStack HashTable Arena PerfectHash) do g++ -c %CPPFLAGS% -DTANGENT_MATH_FUNC_PROFILE -o %~dp0cache\profiled\%%S.o %%S.cpp
+
+cd %~dp0src\misc
+for %%S in (StringWrap TFException FastFloat FastMath) do g++ -c %CPPFLAGS% -DTANGENT_MATH_FUNC_PROFILE -o %~dp0cache\profiled\%%S.o %%S.cpp
+
+cd %~dp0src
+for %%S in (Operators Profiler Program RegisterProgram TierCompiler TangentsMathFunc CsvEvaluator Integrator RootFinder Tabulator AsyncEvaluator EvaluationPlan Aggregator) do g++ -c %CPPFLAGS% -DTANGENT_MATH_FUNC_PROFILE -o %~dp0cache\profiled\%%S.o %%S.cpp
+
+for %%T in (test_profiler test_plan) do (
+  g++ %CPPFLAGS% -DTANGENT_MATH_FUNC_PROFILE -c -o %~dp0test\cache\%%T_profiled.o %~dp0test\src\%%T.cpp -I%~dp0src
+  g++ -o %~dp0test\bin\%%T_profiled.exe %~dp0test\cache\%%T_profiled.o %~dp0cache\profiled\LinkedNode.o %~dp0cache\profiled\LinkedStack.o %~dp0cache\profiled\HashTable.o %~dp0cache\profiled\Arena.o %~dp0cache\profiled\PerfectHash.o %~dp0cache\profiled\StringWrap.o %~dp0cache\profiled\TFException.o %~dp0cache\profiled\FastFloat.o %~dp0cache\profiled\FastMath.o %~dp0cache\profiled\Operators.o %~dp0cache\profiled\Profiler.o %~dp0cache\profiled\Program.o %~dp0cache\profiled\RegisterProgram.o %~dp0cache\profiled\TierCompiler.o %~dp0cache\profiled\TangentsMathFunc.o %~dp0cache\profiled\CsvEvaluator.o %~dp0cache\profiled\Integrator.o %~dp0cache\profiled\RootFinder.o %~dp0cache\profiled\Tabulator.o %~dp0cache\profiled\AsyncEvaluator.o %~dp0cache\profiled\EvaluationPlan.o %~dp0cache\profiled\Aggregator.o %LDFLAGS%
+  strip -s %~dp0test\bin\%%T_profiled.exe
+)
+
+:: Switch dispatch build, i.e. with TANGENT_MATH_FUNC_SWITCH_DISPATCH: the portable interpreters that compilers without
+:: computed goto get, built the same way as the profiled one, with a "_switch" suffix. Their results must match those of
+:: threaded dispatch bit for bit.
+mkdir %~dp0cache\switch
+
+cd %~dp0src\util
+for %%S in (LinkedNode LinkedStack HashTable Arena PerfectHash) do g++ -c %CPPFLAGS% -DTANGENT_MATH_FUNC_SWITCH_DISPATCH -o %~dp0cache\switch\%%S.o %%S.cpp
+
+cd %~dp0src\misc
+for %%S in (StringWrap TFException FastFloat FastMath) do g++ -c %CPPFLAGS% -DTANGENT_MATH_FUNC_SWITCH_DISPATCH -o %~dp0cache\switch\%%S.o %%S.cpp
+
+cd %~dp0src
+for %%S in (Operators Profiler Program RegisterProgram TierCompiler TangentsMathFunc CsvEvaluator Integrator RootFinder Tabulator AsyncEvaluator EvaluationPlan Aggregator) do g++ -c %CPPFLAGS% -DTANGENT_MATH_FUNC_SWITCH_DISPATCH -o %~dp0cache\switch\%%S.o %%S.cpp
+
+for %%T in (test_dispatch test_operators test_arrays) do (
+  g++ %CPPFLAGS% -DTANGENT_MATH_FUNC_SWITCH_DISPATCH -c -o %~dp0test\cache\%%T_switch.o %~dp0test\src\%%T.cpp -I%~dp0src
+  g++ -o %~dp0test\bin\%%T_switch.exe %~dp0test\cache\%%T_switch.o %~dp0cache\switch\LinkedNode.o %~dp0cache\switch\LinkedStack.o %~dp0cache\switch\HashTable.o %~dp0cache\switch\Arena.o %~dp0cache\switch\PerfectHash.o %~dp0cache\switch\StringWrap.o %~dp0cache\switch\TFException.o %~dp0cache\switch\FastFloat.o %~dp0cache\switch\FastMath.o %~dp0cache\switch\Operators.o %~dp0cache\switch\Profiler.o %~dp0cache\switch\Program.o %~dp0cache\switch\RegisterProgram.o %~dp0cache\switch\TierCompiler.o %~dp0cache\switch\TangentsMathFunc.o %~dp0cache\switch\CsvEvaluator.o %~dp0cache\switch\Integrator.o %~dp0cache\switch\RootFinder.o %~dp0cache\switch\Tabulator.o %~dp0cache\switch\AsyncEvaluator.o %~dp0cache\switch\EvaluationPlan.o %~dp0cache\switch\Aggregator.o %LDFLAGS%
+  strip -s %~dp0test\bin\%%T_switch.exe
+)
+
+:: Tools.
+mkdir %~dp0tools\cache
+mkdir %~dp0tools\bin
+
+for %%T in (csv_eval) do (
+  g++ %CPPFLAGS% -c -o %~dp0tools\cache\%%T.o %~dp0tools\src\%%T.cpp -I%~dp0src
+  g++ -o %~dp0tools\bin\%%T.exe %~dp0tools\cache\%%T.o %~dp0cache\LinkedNode.o %~dp0cache\LinkedStack.o %~dp0cache\HashTable.o %~dp0cache\Arena.o %~dp0cache\PerfectHash.o %~dp0cache\StringWrap.o %~dp0cache\TFException.o %~dp0cache\FastFloat.o %~dp0cache\FastMath.o %~dp0cache\Operators.o %~dp0cache\Profiler.o %~dp0cache\Program.o %~dp0cache\RegisterProgram.o %~dp0cache\TierCompiler.o %~dp0cache\TangentsMathFunc.o %~dp0cache\CsvEvaluator.o %~dp0cache\Integrator.o %~dp0cache\RootFinder.o %~dp0cache\Tabulator.o %~dp0cache\AsyncEvaluator.o %~dp0cache\EvaluationPlan.o %~dp0cache\Aggregator.o %LDFLAGS%
+)
+
+:: Benchmark targets.
+mkdir %~dp0bench\cache
+mkdir %~dp0bench\bin
 
-cd %~dp0
-g++ -o %~dp0test\bin\%TARGET%.exe %~dp0test\cache\%TARGET%.o %~dp0cache\LinkedNode.o %~dp0cache\LinkedStack.o %~dp0cache\HashTable.o %~dp0cache\StringWrap.o %~dp0cache\TFException.o %~dp0cache\Operators.o %~dp0cache\TangentsMathFunc.o %LDFLAGS%
-strip -s %~dp0test\bin\%TARGET%.exe
+for %%B in (bench_main bench_memory bench_approx bench_vm) do (
+  g++ %CPPFLAGS% -c -o %~dp0bench\cache\%%B.o %~dp0bench\src\%%B.cpp -I%~dp0src
+  g++ -o %~dp0bench\bin\%%B.exe %~dp0bench\cache\%%B.o %~dp0cache\LinkedNode.o %~dp0cache\LinkedStack.o %~dp0cache\HashTable.o %~dp0cache\Arena.o %~dp0cache\PerfectHash.o %~dp0cache\StringWrap.o %~dp0cache\TFException.o %~dp0cache\FastFloat.o %~dp0cache\FastMath.o %~dp0cache\Operators.o %~dp0cache\Profiler.o %~dp0cache\Program.o %~dp0cache\RegisterProgram.o %~dp0cache\TierCompiler.o %~dp0cache\TangentsMathFunc.o %~dp0cache\CsvEvaluator.o %~dp0cache\Integrator.o %~dp0cache\RootFinder.o %~dp0cache\Tabulator.o %~dp0cache\AsyncEvaluator.o %~dp0cache\EvaluationPlan.o %~dp0cache\Aggregator.o %LDFLAGS%
+)
 
 endlocal
 pause
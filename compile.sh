@@ -0,0 +1,88 @@
+#!/bin/sh
+# Linux counterpart of compile.bat: builds the library objects, the test targets, the profiled and switch dispatch ones, the tools and the benchmark targets.
+#  Compiler and flags may be overridden, e.g. CXX=clang++ CPPFLAGS="-O3 -march=native -std=c++14" ./compile.sh
+set -e
+
+ROOT=$(cd "$(dirname "$0")" && pwd)
+
+CXX=${CXX:-g++}
+CPPFLAGS=${CPPFLAGS:--O2 -std=c++14}
+LDFLAGS=${LDFLAGS:--lpthread}
+
+SOURCES="util/LinkedNode util/LinkedStack util/HashTable util/Arena util/PerfectHash misc/StringWrap misc/TFException misc/FastFloat misc/FastMath Operators Profiler Program RegisterProgram TierCompiler TangentsMathFunc CsvEvaluator Integrator RootFinder Tabulator AsyncEvaluator EvaluationPlan Aggregator"
+OBJECTS=""
+
+mkdir -p "$ROOT/cache"
+
+for SRC in $SOURCES
+do
+  OBJ="$ROOT/cache/$(basename $SRC).o"
+  $CXX -c $CPPFLAGS -o "$OBJ" "$ROOT/src/$SRC.cpp"
+  OBJECTS="$OBJECTS $OBJ"
+done
+
+# Test target.
+mkdir -p "$ROOT/test/cache" "$ROOT/test/bin"
+
+for TARGET in test_main test_horner test_redefine test_tiering test_csv test_batch test_bind test_integrator test_roots test_fastmath test_tabulator test_register test_async test_plan test_arrays test_namespace test_operators test_filter test_aggregator test_profiler test_arena test_dispatch
+do
+  $CXX $CPPFLAGS -c -o "$ROOT/test/cache/$TARGET.o" "$ROOT/test/src/$TARGET.cpp" -I"$ROOT/src"
+  $CXX -o "$ROOT/test/bin/$TARGET" "$ROOT/test/cache/$TARGET.o" $OBJECTS $LDFLAGS
+done
+
+# Profiled build, i.e. with TANGENT_MATH_FUNC_PROFILE: the library objects again, into a cache of their own,
+#  and the tests whose behaviour it changes, named with a "_profiled" suffix. Profiled builds inline no callee.
+PROFILED_OBJECTS=""
+
+mkdir -p "$ROOT/cache/profiled"
+
+for SRC in $SOURCES
+do
+  OBJ="$ROOT/cache/profiled/$(basename $SRC).o"
+  $CXX -c $CPPFLAGS -DTANGENT_MATH_FUNC_PROFILE -o "$OBJ" "$ROOT/src/$SRC.cpp"
+  PROFILED_OBJECTS="$PROFILED_OBJECTS $OBJ"
+done
+
+for TARGET in test_profiler test_plan
+do
+  $CXX $CPPFLAGS -DTANGENT_MATH_FUNC_PROFILE -c -o "$ROOT/test/cache/${TARGET}_profiled.o" "$ROOT/test/src/$TARGET.cpp" -I"$ROOT/src"
+  $CXX -o "$ROOT/test/bin/${TARGET}_profiled" "$ROOT/test/cache/${TARGET}_profiled.o" $PROFILED_OBJECTS $LDFLAGS
+done
+
+# Switch dispatch build, i.e. with TANGENT_MATH_FUNC_SWITCH_DISPATCH: the portable interpreters that compilers without
+#  computed goto get, built the same way as the profiled one, with a "_switch" suffix. Their results must match those of
+#  threaded dispatch bit for bit.
+SWITCH_OBJECTS=""
+
+mkdir -p "$ROOT/cache/switch"
+
+for SRC in $SOURCES
+do
+  OBJ="$ROOT/cache/switch/$(basename $SRC).o"
+  $CXX -c $CPPFLAGS -DTANGENT_MATH_FUNC_SWITCH_DISPATCH -o "$OBJ" "$ROOT/src/$SRC.cpp"
+  SWITCH_OBJECTS="$SWITCH_OBJECTS $OBJ"
+done
+
+for TARGET in test_dispatch test_operators test_arrays
+do
+  $CXX $CPPFLAGS -DTANGENT_MATH_FUNC_SWITCH_DISPATCH -c -o "$ROOT/test/cache/${TARGET}_switch.o" "$ROOT/test/src/$TARGET.cpp" -I"$ROOT/src"
+  $CXX -o "$ROOT/test/bin/${TARGET}_switch" "$ROOT/test/cache/${TARGET}_switch.o" $SWITCH_OBJECTS $LDFLAGS
+done
+
+# Tools.
+mkdir -p "$ROOT/tools/cache" "$ROOT/tools/bin"
+
+for TARGET in csv_eval
+do
+  $CXX $CPPFLAGS -c -o "$ROOT/tools/cache/$TARGET.o" "$ROOT/tools/src/$TARGET.cpp" -I"$ROOT/src"
+  $CXX -o "$ROOT/tools/bin/$TARGET" "$ROOT/tools/cache/$TARGET.o" $OBJECTS $LDFLAGS
+done
+
+# Benchmark targets.
+mkdir -p "$ROOT/bench/cache" "$ROOT/bench/bin"
+
+for TARGET in bench_main bench_memory bench_approx bench_vm
+do
+  $CXX $CPPFLAGS -c -o "$ROOT/bench/cache/$TARGET.o" "$ROOT/bench/src/$TARGET.cpp" -I"$ROOT/src"
+  $CXX -o "$ROOT/bench/bin/$TARGET" "$ROOT/bench/cache/$TARGET.o" $OBJECTS $LDFLAGS
+done
@@ -0,0 +1,261 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "misc/TFException.hpp"
+#include "Aggregator.hpp"
+
+struct AggregatePartial
+{
+    double sum = 0;
+    
+    /*
+     * Rounding error of "sum" under SUMMATION_COMPENSATED.
+     */
+    double compensation = 0;
+    
+    double min = 0;
+    double max = 0;
+    long long argmin = -1;
+    long long argmax = -1;
+    unsigned long long count = 0;
+    unsigned long long nanCount = 0;
+};
+
+/*
+ * Rows evaluated by one call of MathFunction::invokeBatch(), i.e. values buffered by a thread at once.
+ */
+static const int BLOCK_ROWS = 4096;
+
+static_assert(Aggregator::CHUNK_ROWS % BLOCK_ROWS == 0, "Chunks must be made of whole blocks.");
+
+/*
+ * Neumaier's variant of Kahan summation, which stays exact when the value outweighs the sum.
+ */
+static inline void addCompensated(double& sum, double& compensation, double value)
+{
+    double total = sum + value;
+    if(fabs(sum) >= fabs(value))
+    {
+        compensation += (sum - total) + value;
+    }
+    else
+    {
+        compensation += (value - total) + sum;
+    }
+    sum = total;
+}
+
+static double addPairwise(const double* values, size_t count)
+{
+    if(count <= 8)
+    {
+        double sum = 0;
+        for(size_t i = 0 ; i < count ; i++)
+        {
+            sum += values[i];
+        }
+        return sum;
+    }
+    size_t half = count / 2;
+    return addPairwise(values, half) + addPairwise(values + half, count - half);
+}
+
+Aggregator::Aggregator(Summation summation, int threads)
+{
+    if(summation < SUMMATION_PLAIN || summation > SUMMATION_PAIRWISE || threads < 0)
+    {
+        throw InvalidArgumentException("Unknown summation, or negative number of threads.");
+    }
+    this->summation = summation;
+    this->threads = (threads > 0 ? threads : max(1, (int)(thread::hardware_concurrency())));
+}
+
+void Aggregator::fold(const MathFunction& func, const double* const* columns, long long first, int rows, double* values, AggregatePartial& partial) const
+{
+    int varCount = func.getIdentifier().getVariablesCount();
+    vector<const double*> block(varCount);
+    double blockSums[CHUNK_ROWS / BLOCK_ROWS];
+    int blocks = 0;
+    for(int offset = 0 ; offset < rows ; offset += BLOCK_ROWS)
+    {
+        int count = min(BLOCK_ROWS, rows - offset);
+        long long base = first + offset;
+        for(int i = 0 ; i < varCount ; i++)
+        {
+            block[i] = columns[i] + base;
+        }
+        func.invokeBatch(block.data(), count, values);
+        
+        // NaN values are zeroed, so that the sums below need no test.
+        int nans = 0;
+        for(int j = 0 ; j < count ; j++)
+        {
+            double value = values[j];
+            if(value != value)
+            {
+                values[j] = 0;
+                nans++;
+                continue;
+            }
+            if(value < partial.min || partial.argmin < 0)
+            {
+                partial.min = value;
+                partial.argmin = base + j;
+            }
+            if(value > partial.max || partial.argmax < 0)
+            {
+                partial.max = value;
+                partial.argmax = base + j;
+            }
+        }
+        partial.count += count - nans;
+        partial.nanCount += nans;
+        
+        switch(this->summation)
+        {
+            case SUMMATION_PLAIN:
+                for(int j = 0 ; j < count ; j++)
+                {
+                    partial.sum += values[j];
+                }
+                break;
+            case SUMMATION_COMPENSATED:
+                for(int j = 0 ; j < count ; j++)
+                {
+                    addCompensated(partial.sum, partial.compensation, values[j]);
+                }
+                break;
+            case SUMMATION_PAIRWISE:
+                blockSums[blocks++] = addPairwise(values, count);
+                break;
+        }
+    }
+    if(this->summation == SUMMATION_PAIRWISE)
+    {
+        partial.sum = addPairwise(blockSums, blocks);
+    }
+}
+
+AggregateResult Aggregator::aggregate(const MathFunction& func, const double* const* columns, long long rows) const
+{
+    if(rows < 0)
+    {
+        throw InvalidArgumentException("The number of rows to aggregate may not be negative.");
+    }
+    long long chunks = (rows + CHUNK_ROWS - 1) / CHUNK_ROWS;
+    vector<AggregatePartial> partials(chunks);
+    
+    int workers = (int)(min((long long)(this->threads), chunks));
+    if(workers <= 1)
+    {
+        vector<double> values(BLOCK_ROWS);
+        for(long long c = 0 ; c < chunks ; c++)
+        {
+            this->fold(func, columns, c * CHUNK_ROWS, (int)(min((long long)(CHUNK_ROWS), rows - c * CHUNK_ROWS)), values.data(), partials[c]);
+        }
+    }
+    else
+    {
+        // Chunks are handed out one at a time, each one being folded into its own partial whichever thread takes it.
+        atomic<long long> next(0);
+        atomic<bool> failed(false);
+        vector<thread> pool;
+        vector<exception_ptr> errors(workers);
+        for(int w = 0 ; w < workers ; w++)
+        {
+            pool.emplace_back([&, w]() {
+                try
+                {
+                    vector<double> values(BLOCK_ROWS);
+                    while(!failed)
+                    {
+                        long long c = next++;
+                        if(c >= chunks)
+                        {
+                            break;
+                        }
+                        this->fold(func, columns, c * CHUNK_ROWS, (int)(min((long long)(CHUNK_ROWS), rows - c * CHUNK_ROWS)), values.data(), partials[c]);
+                    }
+                }
+                catch(...)
+                {
+                    errors[w] = current_exception();
+                    failed = true;
+                }
+            });
+        }
+        for(thread& worker : pool)
+        {
+            worker.join();
+        }
+        for(exception_ptr& error : errors)
+        {
+            if(error)
+            {
+                rethrow_exception(error);
+            }
+        }
+    }
+    
+    AggregateResult result;
+    double compensation = 0;
+    vector<double> sums(this->summation == SUMMATION_PAIRWISE ? chunks : 0);
+    for(long long c = 0 ; c < chunks ; c++)
+    {
+        const AggregatePartial& partial = partials[c];
+        result.count += partial.count;
+        result.nanCount += partial.nanCount;
+        if(partial.argmin >= 0 && (partial.min < result.min || result.argmin < 0))
+        {
+            result.min = partial.min;
+            result.argmin = partial.argmin;
+        }
+        if(partial.argmax >= 0 && (partial.max > result.max || result.argmax < 0))
+        {
+            result.max = partial.max;
+            result.argmax = partial.argmax;
+        }
+        switch(this->summation)
+        {
+            case SUMMATION_PLAIN:
+                result.sum += partial.sum;
+                break;
+            case SUMMATION_COMPENSATED:
+                addCompensated(result.sum, compensation, partial.sum);
+                compensation += partial.compensation;
+                break;
+            case SUMMATION_PAIRWISE:
+                sums[c] = partial.sum;
+                break;
+        }
+    }
+    if(this->summation == SUMMATION_PAIRWISE)
+    {
+        result.sum = addPairwise(sums.data(), sums.size());
+    }
+    
+    // An infinite sum leaves NaN behind in the compensation.
+    if(isfinite(result.sum))
+    {
+        result.sum += compensation;
+    }
+    result.mean = (result.count > 0 ? result.sum / result.count : nan(""));
+    if(result.count == 0)
+    {
+        result.min = nan("");
+        result.max = nan("");
+    }
+    return result;
+}
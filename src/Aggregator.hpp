@@ -0,0 +1,127 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include "TangentsMathFunc.hpp"
+
+#ifndef __TANGENT_MATH_FUNC__AGGREGATOR
+#define __TANGENT_MATH_FUNC__AGGREGATOR 65536
+
+using namespace std;
+
+enum Summation
+{
+    /*
+     * One addition per value. Fastest, with an error growing with the number of rows.
+     */
+    SUMMATION_PLAIN,
+    
+    /*
+     * Kahan-Babuska (Neumaier) summation, carrying the rounding error of every addition along.
+     *  The error does not grow with the number of rows.
+     */
+    SUMMATION_COMPENSATED,
+    
+    /*
+     * Values added by halves, recursively. The error grows with the logarithm of the number of rows.
+     */
+    SUMMATION_PAIRWISE
+};
+
+/*
+ * Aggregates of the values of a function over rows. NaN values are counted apart and take part in no other aggregate.
+ */
+struct AggregateResult
+{
+    double sum = 0;
+    
+    /*
+     * sum / count, NaN if there is no value.
+     */
+    double mean = 0;
+    
+    /*
+     * NaN if there is no value.
+     */
+    double min = 0;
+    
+    double max = 0;
+    
+    /*
+     * First row holding the minimum, -1 if there is no value.
+     */
+    long long argmin = -1;
+    
+    /*
+     * First row holding the maximum, -1 if there is no value.
+     */
+    long long argmax = -1;
+    
+    /*
+     * Values aggregated, i.e. rows whose value is not NaN.
+     */
+    unsigned long long count = 0;
+    
+    unsigned long long nanCount = 0;
+};
+
+/*
+ * Aggregates of a chunk of rows.
+ */
+struct AggregatePartial;
+
+/*
+ * Evaluates a function over many rows and folds its values into their sum, mean, minimum and maximum on the fly,
+ *  without writing them out. Every thread evaluates a block of rows at a time into a buffer of its own.
+ *
+ * Rows are cut into chunks of CHUNK_ROWS, whatever the number of threads. Each chunk is folded into a partial result,
+ *  and the partials are combined in the order of the chunks by the calling thread. Results are thus reproducible,
+ *  bit for bit, with any number of threads and any summation.
+ */
+class Aggregator
+{
+    private:
+        Summation summation;
+        
+        int threads;
+        
+        // Disabled
+        Aggregator(const Aggregator&);
+        void operator=(const Aggregator&);
+        
+        /*
+         * Fold the rows of a chunk.
+         *
+         * Param(s):
+         *    first     -> Index of the first row of the chunk.
+         *    values    -> Room for a block of values.
+         */
+        void fold(const MathFunction& func, const double* const* columns, long long first, int rows, double* values, AggregatePartial& partial) const;
+    
+    public:
+        /*
+         * Rows folded into one partial result.
+         */
+        static const int CHUNK_ROWS = 65536;
+        
+        /*
+         * Param(s):
+         *    threads    -> Threads evaluating the chunks, 0 for one per hardware thread.
+         */
+        Aggregator(Summation summation = SUMMATION_COMPENSATED, int threads = 0);
+        
+        /*
+         * Aggregate the values of a function over rows given as by MathFunction::invokeBatch(). e.g.
+         *  Aggregator aggregator(SUMMATION_PAIRWISE);
+         *  AggregateResult r = aggregator.aggregate(func, columns, rows);
+         *  printf("%f at row %lld\n", r.min, r.argmin);
+         *  An error thrown by the function is rethrown once every thread has stopped.
+         */
+        AggregateResult aggregate(const MathFunction& func, const double* const* columns, long long rows) const;
+};
+
+#endif
@@ -0,0 +1,416 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "misc/TFException.hpp"
+#include "AsyncEvaluator.hpp"
+
+/*
+ * A submitted batch, shared by its handles and, while it waits, the queue.
+ */
+struct AsyncJob
+{
+    const MathFunction* func;
+    
+    vector<const double*> columns;
+    
+    int rows;
+    
+    double* results;
+    
+    AsyncCallback callback;
+    
+    /*
+     * One of the AsyncStatus values. Leaves ASYNC_QUEUED under the lock of the queue only.
+     */
+    atomic<int> status;
+    
+    /*
+     * Set by cancel(), checked by the worker before each slice.
+     */
+    atomic<bool> stop;
+    
+    promise<void> settled;
+    
+    shared_future<void> future;
+    
+    /*
+     * The queue the job waits in. Expired once the evaluator is destroyed.
+     */
+    weak_ptr<AsyncQueue> queue;
+};
+
+/*
+ * State shared by an evaluator, its workers and the handles of its queued batches, so that cancelling a batch never
+ *  touches a destroyed evaluator.
+ */
+class AsyncQueue
+{
+    public:
+        mutex lock;
+        
+        /*
+         * Signalled when a job is queued, or the evaluator stops.
+         */
+        condition_variable available;
+        
+        /*
+         * Signalled when a job leaves the queue, or the evaluator stops.
+         */
+        condition_variable space;
+        
+        deque<shared_ptr<AsyncJob>> jobs;
+        
+        int capacity;
+        
+        bool stopping;
+        
+        AsyncQueue(int capacity);
+};
+
+AsyncQueue::AsyncQueue(int capacity) : capacity(capacity), stopping(false) {}
+
+/*
+ * Run the callback, then make the future ready.
+ */
+static void settle(AsyncJob* job, AsyncStatus status, exception_ptr error)
+{
+    job->status = status;
+    if(job->callback)
+    {
+        job->callback(status, error);
+    }
+    if(error)
+    {
+        job->settled.set_exception(error);
+    }
+    else
+    {
+        job->settled.set_value();
+    }
+}
+
+AsyncBatch::AsyncBatch() {}
+
+AsyncBatch::AsyncBatch(const shared_ptr<AsyncJob>& job) : job(job) {}
+
+bool AsyncBatch::isValid() const
+{
+    return (this->job != nullptr);
+}
+
+AsyncStatus AsyncBatch::getStatus() const
+{
+    if(!(this->job))
+    {
+        throw InvalidArgumentException("The batch handle is invalid.");
+    }
+    return (AsyncStatus)(this->job->status.load());
+}
+
+shared_future<void> AsyncBatch::getFuture() const
+{
+    if(!(this->job))
+    {
+        throw InvalidArgumentException("The batch handle is invalid.");
+    }
+    return this->job->future;
+}
+
+bool AsyncBatch::cancel()
+{
+    if(!(this->job))
+    {
+        throw InvalidArgumentException("The batch handle is invalid.");
+    }
+    this->job->stop = true;
+    
+    shared_ptr<AsyncQueue> queue = this->job->queue.lock();
+    if(!queue)
+    {
+        return false;
+    }
+    {
+        lock_guard<mutex> locked(queue->lock);
+        if(this->job->status != ASYNC_QUEUED)
+        {
+            return false;
+        }
+        queue->jobs.erase(find(queue->jobs.begin(), queue->jobs.end(), this->job));
+        this->job->status = ASYNC_CANCELLED;
+        queue->space.notify_one();
+    }
+    settle(this->job.get(), ASYNC_CANCELLED, make_exception_ptr(CancelledException()));
+    return true;
+}
+
+AsyncEvaluator::AsyncEvaluator(int threads, int capacity, int batchRows)
+{
+    if(threads < 0 || capacity < 1 || batchRows < 1)
+    {
+        throw InvalidArgumentException("The queue must hold a batch at least, and internal batches a row at least.");
+    }
+    this->queue = make_shared<AsyncQueue>(capacity);
+    this->batchRows = batchRows;
+    
+    int count = (threads > 0 ? threads : max(1, (int)(thread::hardware_concurrency())));
+    for(int i = 0 ; i < count ; i++)
+    {
+        this->workers.push_back(thread(&AsyncEvaluator::run, this));
+    }
+}
+
+AsyncEvaluator::~AsyncEvaluator()
+{
+    deque<shared_ptr<AsyncJob>> dropped;
+    {
+        lock_guard<mutex> locked(this->queue->lock);
+        this->queue->stopping = true;
+        dropped.swap(this->queue->jobs);
+        for(shared_ptr<AsyncJob>& job : dropped)
+        {
+            job->status = ASYNC_CANCELLED;
+        }
+        this->queue->available.notify_all();
+        this->queue->space.notify_all();
+    }
+    for(shared_ptr<AsyncJob>& job : dropped)
+    {
+        settle(job.get(), ASYNC_CANCELLED, make_exception_ptr(CancelledException()));
+    }
+    for(thread& worker : this->workers)
+    {
+        worker.join();
+    }
+}
+
+void AsyncEvaluator::run()
+{
+    // Reused by every coalesced group of this worker.
+    vector<double> inputs;
+    vector<double> outputs;
+    vector<shared_ptr<AsyncJob>> group;
+    
+    while(true)
+    {
+        group.clear();
+        {
+            unique_lock<mutex> locked(this->queue->lock);
+            while(this->queue->jobs.empty() && !(this->queue->stopping))
+            {
+                this->queue->available.wait(locked);
+            }
+            if(this->queue->jobs.empty())
+            {
+                return;
+            }
+            
+            deque<shared_ptr<AsyncJob>>& jobs = this->queue->jobs;
+            group.push_back(jobs.front());
+            jobs.pop_front();
+            
+            // Gather the small jobs of the same function waiting behind, as long as they fit into one internal batch.
+            int total = group[0]->rows;
+            if(total < this->batchRows)
+            {
+                for(deque<shared_ptr<AsyncJob>>::iterator it = jobs.begin() ; it != jobs.end() && total < this->batchRows ; )
+                {
+                    if((*it)->func == group[0]->func && total + (*it)->rows <= this->batchRows)
+                    {
+                        total += (*it)->rows;
+                        group.push_back(*it);
+                        it = jobs.erase(it);
+                    }
+                    else
+                    {
+                        it++;
+                    }
+                }
+            }
+            for(shared_ptr<AsyncJob>& job : group)
+            {
+                job->status = ASYNC_RUNNING;
+            }
+            
+            if(group.size() > 1)
+            {
+                this->queue->space.notify_all();
+            }
+            else
+            {
+                this->queue->space.notify_one();
+            }
+        }
+        
+        this->evaluate(group, inputs, outputs);
+    }
+}
+
+void AsyncEvaluator::evaluate(const vector<shared_ptr<AsyncJob>>& group, vector<double>& inputs, vector<double>& outputs) const
+{
+    const MathFunction* func = group[0]->func;
+    int varCount = func->getIdentifier().getVariablesCount();
+    
+    // Jobs cancelled between being popped and now are settled without being evaluated.
+    vector<AsyncJob*> live;
+    int total = 0;
+    for(const shared_ptr<AsyncJob>& job : group)
+    {
+        if(job->stop)
+        {
+            settle(job.get(), ASYNC_CANCELLED, make_exception_ptr(CancelledException()));
+            continue;
+        }
+        live.push_back(job.get());
+        total += job->rows;
+    }
+    
+    if(live.size() > 1)
+    {
+        inputs.resize((size_t)varCount * total);
+        outputs.resize(total);
+        vector<const double*> columns(varCount);
+        for(int i = 0 ; i < varCount ; i++)
+        {
+            columns[i] = inputs.data() + (size_t)i * total;
+        }
+        
+        int offset = 0;
+        for(AsyncJob* job : live)
+        {
+            for(int i = 0 ; i < varCount ; i++)
+            {
+                memcpy(inputs.data() + (size_t)i * total + offset, job->columns[i], job->rows * sizeof(double));
+            }
+            offset += job->rows;
+        }
+        
+        bool failed = false;
+        try
+        {
+            func->invokeBatch(columns.data(), total, outputs.data());
+        }
+        catch(...)
+        {
+            failed = true;
+        }
+        
+        // A failure of the coalesced batch is narrowed down by evaluating the jobs one by one below.
+        if(!failed)
+        {
+            offset = 0;
+            for(AsyncJob* job : live)
+            {
+                memcpy(job->results, outputs.data() + offset, job->rows * sizeof(double));
+                offset += job->rows;
+                settle(job, ASYNC_DONE, nullptr);
+            }
+            return;
+        }
+    }
+    
+    vector<const double*> columns(varCount);
+    for(AsyncJob* job : live)
+    {
+        try
+        {
+            bool cancelled = false;
+            for(int offset = 0 ; offset < job->rows ; offset += this->batchRows)
+            {
+                if(job->stop)
+                {
+                    cancelled = true;
+                    break;
+                }
+                for(int i = 0 ; i < varCount ; i++)
+                {
+                    columns[i] = job->columns[i] + offset;
+                }
+                func->invokeBatch(columns.data(), min(this->batchRows, job->rows - offset), job->results + offset);
+            }
+            
+            if(cancelled)
+            {
+                settle(job, ASYNC_CANCELLED, make_exception_ptr(CancelledException()));
+            }
+            else
+            {
+                settle(job, ASYNC_DONE, nullptr);
+            }
+        }
+        catch(...)
+        {
+            settle(job, ASYNC_FAILED, current_exception());
+        }
+    }
+}
+
+AsyncBatch AsyncEvaluator::enqueue(const MathFunction& func, const double* const* columns, int rows, double* results, const AsyncCallback& callback, bool block)
+{
+    int varCount = func.getIdentifier().getVariablesCount();
+    if(rows < 0 || (rows > 0 && results == nullptr) || (varCount > 0 && columns == nullptr))
+    {
+        throw InvalidArgumentException("A batch needs a column per variable and room for its results.");
+    }
+    
+    shared_ptr<AsyncJob> job = make_shared<AsyncJob>();
+    job->func = &func;
+    job->columns.assign(columns, columns + varCount);
+    job->rows = rows;
+    job->results = results;
+    job->callback = callback;
+    job->status = ASYNC_QUEUED;
+    job->stop = false;
+    job->future = job->settled.get_future().share();
+    job->queue = this->queue;
+    
+    {
+        unique_lock<mutex> locked(this->queue->lock);
+        while((int)(this->queue->jobs.size()) >= this->queue->capacity && !(this->queue->stopping))
+        {
+            if(!block)
+            {
+                return AsyncBatch();
+            }
+            this->queue->space.wait(locked);
+        }
+        if(!(this->queue->stopping))
+        {
+            this->queue->jobs.push_back(job);
+            this->queue->available.notify_one();
+            return AsyncBatch(job);
+        }
+        job->status = ASYNC_CANCELLED;
+    }
+    
+    // The evaluator is being destroyed.
+    settle(job.get(), ASYNC_CANCELLED, make_exception_ptr(CancelledException()));
+    return AsyncBatch(job);
+}
+
+AsyncBatch AsyncEvaluator::submit(const MathFunction& func, const double* const* columns, int rows, double* results, const AsyncCallback& callback)
+{
+    return this->enqueue(func, columns, rows, results, callback, true);
+}
+
+AsyncBatch AsyncEvaluator::trySubmit(const MathFunction& func, const double* const* columns, int rows, double* results, const AsyncCallback& callback)
+{
+    return this->enqueue(func, columns, rows, results, callback, false);
+}
+
+int AsyncEvaluator::getQueuedCount() const
+{
+    lock_guard<mutex> locked(this->queue->lock);
+    return (int)(this->queue->jobs.size());
+}
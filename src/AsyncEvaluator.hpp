@@ -0,0 +1,164 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "TangentsMathFunc.hpp"
+
+#ifndef __TANGENT_MATH_FUNC__ASYNC_EVALUATOR
+#define __TANGENT_MATH_FUNC__ASYNC_EVALUATOR 65536
+
+using namespace std;
+
+enum AsyncStatus
+{
+    ASYNC_QUEUED,
+    ASYNC_RUNNING,
+    ASYNC_DONE,
+    
+    /*
+     * The evaluation threw, e.g. DividedByZeroException. Some of the results may have been written.
+     */
+    ASYNC_FAILED,
+    
+    /*
+     * Cancelled before its last slice ran. The results of the slices run before are written.
+     */
+    ASYNC_CANCELLED
+};
+
+/*
+ * Called once a batch is settled, on the thread settling it: a worker, or the one cancelling it.
+ *  The error is nullptr for ASYNC_DONE. MUST NOT throw.
+ */
+typedef function<void(AsyncStatus status, exception_ptr error)> AsyncCallback;
+
+struct AsyncJob;
+
+class AsyncQueue;
+
+/*
+ * Handle of a batch submitted to an AsyncEvaluator. Copies refer to the same batch, and may outlive the evaluator.
+ */
+class AsyncBatch
+{
+    private:
+        shared_ptr<AsyncJob> job;
+        
+        AsyncBatch(const shared_ptr<AsyncJob>& job);
+    
+    public:
+        /*
+         * An invalid handle, also returned by AsyncEvaluator::trySubmit() when the queue is full.
+         */
+        AsyncBatch();
+        
+        bool isValid() const;
+        
+        AsyncStatus getStatus() const;
+        
+        /*
+         * Ready once the batch is settled, after its callback returned. get() throws the error of a failed batch,
+         *  or CancelledException.
+         */
+        shared_future<void> getFuture() const;
+        
+        /*
+         * Cancel the batch. A queued batch is dropped from the queue right away, freeing its place.
+         *  A running one stops before its next slice.
+         *
+         * Return:
+         *    True if the batch had not started, so none of its results were written.
+         */
+        bool cancel();
+    
+    friend class AsyncEvaluator;
+};
+
+/*
+ * Evaluates batches on a pool of threads, so that the submitting thread, e.g. an event loop or a coroutine
+ *  scheduler, never blocks on an evaluation. Completion is observed by a callback, a future, or by polling the status.
+ *
+ * The queue of waiting batches is bounded: submit() blocks while it is full, trySubmit() fails instead.
+ *  Batches smaller than "batchRows" queued for the same function are coalesced by a worker into one internal batch of
+ *  up to "batchRows" rows, their columns being copied side by side, which amortizes the per-call overhead of many small
+ *  requests. Larger batches are evaluated in place, "batchRows" rows at a time, and cancellation is checked in between.
+ *
+ * The function, the columns and the results MUST stay alive and unmodified until the batch is settled.
+ *  Batches are not ordered with each other, not even those of the same function.
+ */
+class AsyncEvaluator
+{
+    private:
+        shared_ptr<AsyncQueue> queue;
+        
+        vector<thread> workers;
+        
+        int batchRows;
+        
+        // Disabled
+        AsyncEvaluator(const AsyncEvaluator&);
+        void operator=(const AsyncEvaluator&);
+        
+        void run();
+        
+        /*
+         * Evaluate jobs of the same function. Several of them are evaluated as one batch, then settled one by one.
+         */
+        void evaluate(const vector<shared_ptr<AsyncJob>>& group, vector<double>& inputs, vector<double>& outputs) const;
+        
+        AsyncBatch enqueue(const MathFunction& func, const double* const* columns, int rows, double* results, const AsyncCallback& callback, bool block);
+    
+    public:
+        static const int DEFAULT_CAPACITY = 1024;
+        
+        static const int DEFAULT_BATCH_ROWS = 16384;
+        
+        /*
+         * Param(s):
+         *    threads      -> Worker threads, 0 for one per hardware thread.
+         *    capacity     -> Batches waiting at once, beyond which submitting blocks.
+         *    batchRows    -> Rows of the internal batches, i.e. the size up to which batches are coalesced, and the slice
+         *                    of a larger one evaluated between checks for cancellation.
+         */
+        AsyncEvaluator(int threads = 0, int capacity = DEFAULT_CAPACITY, int batchRows = DEFAULT_BATCH_ROWS);
+        
+        /*
+         * Cancel the queued batches, and wait for the running ones.
+         */
+        ~AsyncEvaluator();
+        
+        /*
+         * Queue a batch of func.invokeBatch(columns, rows, results), blocking while the queue is full. e.g.
+         *  const double* columns[] = {xs, ys};
+         *  AsyncBatch batch = evaluator.submit(func, columns, rows, results, [](AsyncStatus status, exception_ptr error) { ... });
+         *  batch.getFuture().get();
+         *  The array of columns is copied, unlike the columns themselves.
+         */
+        AsyncBatch submit(const MathFunction& func, const double* const* columns, int rows, double* results, const AsyncCallback& callback = nullptr);
+        
+        /*
+         * Same as submit(), but never blocks.
+         *
+         * Return:
+         *    An invalid handle if the queue is full.
+         */
+        AsyncBatch trySubmit(const MathFunction& func, const double* const* columns, int rows, double* results, const AsyncCallback& callback = nullptr);
+        
+        /*
+         * Batches waiting to be picked up by a worker.
+         */
+        int getQueuedCount() const;
+};
+
+#endif
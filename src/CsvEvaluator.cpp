@@ -0,0 +1,532 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <math.h>
+#include <string.h>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "misc/FastFloat.hpp"
+#include "misc/TFException.hpp"
+#include "CsvEvaluator.hpp"
+
+/*
+ * Bytes requested from the input at once.
+ */
+static const size_t READ_CHUNK = 1 << 16;
+
+/*
+ * Size of the output buffer of the writer.
+ */
+static const size_t WRITE_BUFFER = 1 << 16;
+
+/*
+ * Rows read, parsed, evaluated and written together. The buffers are reused, so they stop growing once warmed up.
+ */
+struct CsvBatch
+{
+    /*
+     * Complete lines as read, including the line breaks.
+     */
+    string text;
+    
+    /*
+     * Span of each non-empty line within the text, without the line break.
+     */
+    vector<size_t> lineStarts;
+    vector<size_t> lineEnds;
+    
+    /*
+     * Parsed values, one block of batchRows per parsed column.
+     */
+    vector<double> values;
+    
+    /*
+     * One block of batchRows per output.
+     */
+    vector<double> results;
+    
+    int rows;
+    
+    /*
+     * Marks the end of the input. Carries no rows.
+     */
+    bool last;
+    
+    /*
+     * Set by the evaluator if evaluating this batch or an earlier one threw. The writer drops its results.
+     *  Handed over through the queue along with the batch, as the writer may not look at the exception itself.
+     */
+    bool failed;
+};
+
+/*
+ * Blocking queue passing batches between the stages of the pipeline.
+ */
+class CsvBatchQueue
+{
+    private:
+        mutex lock;
+        
+        condition_variable available;
+        
+        deque<CsvBatch*> batches;
+    
+    public:
+        void push(CsvBatch* batch)
+        {
+            lock_guard<mutex> locked(this->lock);
+            this->batches.push_back(batch);
+            this->available.notify_one();
+        }
+        
+        CsvBatch* pop()
+        {
+            unique_lock<mutex> locked(this->lock);
+            while(this->batches.empty())
+            {
+                this->available.wait(locked);
+            }
+            CsvBatch* batch = this->batches.front();
+            this->batches.pop_front();
+            return batch;
+        }
+};
+
+/*
+ * End of the field starting at "begin". Quoted fields may contain the delimiter and doubled quotes.
+ */
+static const char* findFieldEnd(const char* begin, const char* end, char delimiter)
+{
+    if(begin < end && *begin == '"')
+    {
+        const char* cursor = begin + 1;
+        while(cursor < end)
+        {
+            if(*cursor == '"')
+            {
+                if(cursor + 1 < end && cursor[1] == '"')
+                {
+                    cursor += 2;
+                    continue;
+                }
+                break;
+            }
+            cursor++;
+        }
+        begin = cursor;
+    }
+    const char* found = (const char*)memchr(begin, delimiter, end - begin);
+    return (found == nullptr ? end : found);
+}
+
+/*
+ * Field without its spaces and enclosing quotes.
+ */
+static void trimField(const char*& begin, const char*& end)
+{
+    while(begin < end && *begin == ' ')
+    {
+        begin++;
+    }
+    while(end > begin && end[-1] == ' ')
+    {
+        end--;
+    }
+    if(end - begin >= 2 && *begin == '"' && end[-1] == '"')
+    {
+        begin++;
+        end--;
+    }
+}
+
+CsvEvaluator::CsvEvaluator(char _delimiter, int _batchRows, int _batchCount, int _precision)
+{
+    if(_batchRows < 1 || _batchCount < 1)
+    {
+        throw InvalidArgumentException("Batches MUST hold at least one row, and at least one batch is required.");
+    }
+    this->delimiter = _delimiter;
+    this->batchRows = _batchRows;
+    this->batchCount = _batchCount;
+    this->precision = (_precision < 1 ? 1 : (_precision > 17 ? 17 : _precision));
+    this->slotCount = 0;
+    this->rows = 0;
+}
+
+void CsvEvaluator::addOutput(const MathFunction& func, const string& column)
+{
+    Output output;
+    output.func = &func;
+    output.column = column;
+    this->outputs.push_back(output);
+}
+
+void CsvEvaluator::bind(const string& header)
+{
+    vector<string> names;
+    const char* cursor = header.data();
+    const char* end = cursor + header.size();
+    while(true)
+    {
+        const char* fieldEnd = findFieldEnd(cursor, end, this->delimiter);
+        const char* begin = cursor;
+        const char* stop = fieldEnd;
+        trimField(begin, stop);
+        names.push_back(string(begin, stop - begin));
+        if(fieldEnd == end)
+        {
+            break;
+        }
+        cursor = fieldEnd + 1;
+    }
+    
+    this->fieldSlots.assign(names.size(), -1);
+    this->slotCount = 0;
+    for(size_t i = 0 ; i < this->outputs.size() ; i++)
+    {
+        Output& output = this->outputs[i];
+        int varCount = output.func->getIdentifier().getVariablesCount();
+        output.slots.assign(varCount, -1);
+        for(int j = 0 ; j < varCount ; j++)
+        {
+            string name = output.func->getVariableName(j);
+            for(size_t k = 0 ; k < names.size() ; k++)
+            {
+                if(names[k] == name)
+                {
+                    if(this->fieldSlots[k] < 0)
+                    {
+                        this->fieldSlots[k] = this->slotCount++;
+                    }
+                    output.slots[j] = this->fieldSlots[k];
+                    break;
+                }
+            }
+            if(output.slots[j] < 0)
+            {
+                throw InvalidArgumentException(("No column is named \"" + name + "\", which is a variable of " + output.func->getIdentifier().getName() + ".").c_str());
+            }
+        }
+    }
+}
+
+bool CsvEvaluator::readLine(FILE* in, string& line)
+{
+    line.clear();
+    int c;
+    while((c = fgetc(in)) != EOF)
+    {
+        if(c == '\n')
+        {
+            break;
+        }
+        line.push_back((char)c);
+    }
+    if(!line.empty() && line[line.size() - 1] == '\r')
+    {
+        line.resize(line.size() - 1);
+    }
+    return c != EOF || !line.empty();
+}
+
+bool CsvEvaluator::read(FILE* in, CsvBatch* batch, string& carry) const
+{
+    string& text = batch->text;
+    text.assign(carry);
+    carry.clear();
+    
+    // Count line breaks until the batch is full, reading more as needed.
+    size_t scanned = 0;
+    int lines = 0;
+    while(true)
+    {
+        const char* found;
+        while(lines < this->batchRows && (found = (const char*)memchr(text.data() + scanned, '\n', text.size() - scanned)) != nullptr)
+        {
+            scanned = found - text.data() + 1;
+            lines++;
+        }
+        if(lines == this->batchRows || feof(in) || ferror(in))
+        {
+            break;
+        }
+        size_t length = text.size();
+        text.resize(length + READ_CHUNK);
+        text.resize(length + fread(&text[length], 1, READ_CHUNK, in));
+    }
+    
+    // The last line of a file may lack its line break.
+    if(lines < this->batchRows && scanned < text.size())
+    {
+        scanned = text.size();
+    }
+    carry.assign(text, scanned, string::npos);
+    text.resize(scanned);
+    return !text.empty();
+}
+
+void CsvEvaluator::parse(CsvBatch* batch) const
+{
+    batch->lineStarts.clear();
+    batch->lineEnds.clear();
+    batch->values.resize((size_t)this->slotCount * this->batchRows);
+    batch->results.resize(this->outputs.size() * this->batchRows);
+    
+    const char* text = batch->text.data();
+    size_t size = batch->text.size();
+    size_t start = 0;
+    int row = 0;
+    while(start < size)
+    {
+        const char* found = (const char*)memchr(text + start, '\n', size - start);
+        size_t next = (found == nullptr ? size : found - text + 1);
+        size_t end = (found == nullptr ? size : found - text);
+        if(end > start && text[end - 1] == '\r')
+        {
+            end--;
+        }
+        if(end > start)
+        {
+            batch->lineStarts.push_back(start);
+            batch->lineEnds.push_back(end);
+            
+            for(int i = 0 ; i < this->slotCount ; i++)
+            {
+                batch->values[(size_t)i * this->batchRows + row] = nan("");
+            }
+            const char* cursor = text + start;
+            const char* lineEnd = text + end;
+            for(size_t field = 0 ; field < this->fieldSlots.size() ; field++)
+            {
+                const char* fieldEnd = findFieldEnd(cursor, lineEnd, this->delimiter);
+                int slot = this->fieldSlots[field];
+                if(slot >= 0)
+                {
+                    const char* begin = cursor;
+                    const char* stop = fieldEnd;
+                    trimField(begin, stop);
+                    FastFloat::parse(begin, stop, batch->values[(size_t)slot * this->batchRows + row]);
+                }
+                if(fieldEnd == lineEnd)
+                {
+                    break;
+                }
+                cursor = fieldEnd + 1;
+            }
+            row++;
+        }
+        start = next;
+    }
+    batch->rows = row;
+}
+
+void CsvEvaluator::evaluate(CsvBatch* batch) const
+{
+    vector<const double*> columns;
+    vector<const double*> single;
+    for(size_t i = 0 ; i < this->outputs.size() ; i++)
+    {
+        const Output& output = this->outputs[i];
+        double* results = batch->results.data() + i * this->batchRows;
+        columns.resize(output.slots.size());
+        single.resize(output.slots.size());
+        for(size_t j = 0 ; j < output.slots.size() ; j++)
+        {
+            columns[j] = batch->values.data() + (size_t)output.slots[j] * this->batchRows;
+        }
+        try
+        {
+            output.func->invokeBatch(columns.data(), batch->rows, results);
+        }
+        catch(const exception& ex)
+        {
+            // One bad row fails the whole batch, so redo it row by row and only give up on the rows that fail.
+            for(int row = 0 ; row < batch->rows ; row++)
+            {
+                for(size_t j = 0 ; j < output.slots.size() ; j++)
+                {
+                    single[j] = columns[j] + row;
+                }
+                try
+                {
+                    output.func->invokeBatch(single.data(), 1, results + row);
+                }
+                catch(const exception& ex)
+                {
+                    results[row] = nan("");
+                }
+            }
+        }
+    }
+}
+
+void CsvEvaluator::write(CsvBatch* batch, FILE* out, char* buffer, size_t capacity) const
+{
+    // Room for a delimiter and the longest formatted double.
+    const size_t VALUE_ROOM = 40;
+    size_t used = 0;
+    const char* text = batch->text.data();
+    for(int row = 0 ; row < batch->rows ; row++)
+    {
+        size_t length = batch->lineEnds[row] - batch->lineStarts[row];
+        if(used + length > capacity)
+        {
+            fwrite(buffer, 1, used, out);
+            used = 0;
+        }
+        if(length > capacity)
+        {
+            fwrite(text + batch->lineStarts[row], 1, length, out);
+        }
+        else
+        {
+            memcpy(buffer + used, text + batch->lineStarts[row], length);
+            used += length;
+        }
+        
+        for(size_t i = 0 ; i < this->outputs.size() ; i++)
+        {
+            if(used + 1 + VALUE_ROOM > capacity)
+            {
+                fwrite(buffer, 1, used, out);
+                used = 0;
+            }
+            buffer[used++] = this->delimiter;
+            used += snprintf(buffer + used, VALUE_ROOM, "%.*g", this->precision, batch->results[i * this->batchRows + row]);
+        }
+        if(used + 1 > capacity)
+        {
+            fwrite(buffer, 1, used, out);
+            used = 0;
+        }
+        buffer[used++] = '\n';
+    }
+    fwrite(buffer, 1, used, out);
+}
+
+void CsvEvaluator::run(FILE* in, FILE* out)
+{
+    this->rows = 0;
+    string header;
+    if(!readLine(in, header))
+    {
+        return;
+    }
+    this->bind(header);
+    
+    fwrite(header.data(), 1, header.size(), out);
+    for(size_t i = 0 ; i < this->outputs.size() ; i++)
+    {
+        fprintf(out, "%c%s", this->delimiter, this->outputs[i].column.c_str());
+    }
+    fputc('\n', out);
+    
+    vector<CsvBatch> batches(this->batchCount);
+    CsvBatchQueue free;
+    CsvBatchQueue parsed;
+    CsvBatchQueue evaluated;
+    for(int i = 0 ; i < this->batchCount ; i++)
+    {
+        free.push(&(batches[i]));
+    }
+    
+    exception_ptr readError;
+    exception_ptr evaluateError;
+    
+    thread reader([&]() {
+        try
+        {
+            string carry;
+            while(true)
+            {
+                CsvBatch* batch = free.pop();
+                batch->last = !(this->read(in, batch, carry));
+                if(batch->last)
+                {
+                    parsed.push(batch);
+                    break;
+                }
+                this->parse(batch);
+                parsed.push(batch);
+            }
+        }
+        catch(...)
+        {
+            readError = current_exception();
+            CsvBatch* batch = free.pop();
+            batch->last = true;
+            parsed.push(batch);
+        }
+    });
+    
+    thread evaluator([&]() {
+        while(true)
+        {
+            CsvBatch* batch = parsed.pop();
+            // Once pushed, the batch belongs to the writer, which may recycle it before this thread looks at it again.
+            bool last = batch->last;
+            batch->failed = (evaluateError != nullptr);
+            if(!last && !(batch->failed))
+            {
+                try
+                {
+                    this->evaluate(batch);
+                }
+                catch(...)
+                {
+                    evaluateError = current_exception();
+                    batch->failed = true;
+                }
+            }
+            evaluated.push(batch);
+            if(last)
+            {
+                break;
+            }
+        }
+    });
+    
+    char* buffer = new char[WRITE_BUFFER];
+    while(true)
+    {
+        CsvBatch* batch = evaluated.pop();
+        if(batch->last)
+        {
+            break;
+        }
+        if(!(batch->failed))
+        {
+            this->write(batch, out, buffer, WRITE_BUFFER);
+            this->rows += batch->rows;
+        }
+        free.push(batch);
+    }
+    delete[] buffer;
+    
+    reader.join();
+    evaluator.join();
+    fflush(out);
+    
+    if(readError)
+    {
+        rethrow_exception(readError);
+    }
+    if(evaluateError)
+    {
+        rethrow_exception(evaluateError);
+    }
+}
+
+unsigned long long CsvEvaluator::getRowCount() const
+{
+    return this->rows;
+}
@@ -0,0 +1,121 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "TangentsMathFunc.hpp"
+
+#ifndef __TANGENT_MATH_FUNC__CSV_EVALUATOR
+#define __TANGENT_MATH_FUNC__CSV_EVALUATOR 65536
+
+using namespace std;
+
+struct CsvBatch;
+
+class CsvBatchQueue;
+
+/*
+ * Streams a CSV file through one or more MathFunctions, copying every input line and appending one column per function.
+ *  Variables are bound to the input columns of the same header name.
+ *
+ * Quoted fields may contain the delimiter, but not line breaks.
+ *
+ * Three threads form a pipeline: reading and parsing, evaluating in batches, and writing (the calling thread).
+ *  A fixed number of batches circulates between them, so memory use does not depend on the size of the input.
+ */
+class CsvEvaluator
+{
+    private:
+        struct Output
+        {
+            const MathFunction* func;
+            string column;
+            
+            /*
+             * Parsed column feeding each variable.
+             */
+            vector<int> slots;
+        };
+        
+        vector<Output> outputs;
+        
+        char delimiter;
+        
+        int batchRows;
+        
+        int batchCount;
+        
+        int precision;
+        
+        /*
+         * Parsed column of every input column, -1 if no variable is bound to it.
+         */
+        vector<int> fieldSlots;
+        
+        int slotCount;
+        
+        unsigned long long rows;
+        
+        // Disabled
+        CsvEvaluator(const CsvEvaluator&);
+        void operator=(const CsvEvaluator&);
+        
+        void bind(const string& header);
+        
+        /*
+         * Split the complete lines of a batch and parse the bound fields. Fields that are not numbers become NaN.
+         */
+        void parse(CsvBatch* batch) const;
+        
+        void evaluate(CsvBatch* batch) const;
+        
+        void write(CsvBatch* batch, FILE* out, char* buffer, size_t capacity) const;
+        
+        static bool readLine(FILE* in, string& line);
+        
+        /*
+         * Fill a batch with complete lines. The partial line at its end is moved into "carry".
+         *
+         * Return:
+         *    False once the input is exhausted and the batch is empty.
+         */
+        bool read(FILE* in, CsvBatch* batch, string& carry) const;
+    
+    public:
+        static const int DEFAULT_BATCH_ROWS = 4096;
+        
+        static const int DEFAULT_BATCH_COUNT = 4;
+        
+        /*
+         * Param(s):
+         *    batchRows     -> Rows evaluated at once.
+         *    batchCount    -> Batches in flight. Bounds the memory together with batchRows and the line length.
+         *    precision     -> Significant digits of the appended values, up to 17 which round-trips every double.
+         */
+        CsvEvaluator(char delimiter = ',', int batchRows = DEFAULT_BATCH_ROWS, int batchCount = DEFAULT_BATCH_COUNT, int precision = 17);
+        
+        /*
+         * Append a column holding the value of "func" for each row. The function MUST outlive the evaluator.
+         */
+        void addOutput(const MathFunction& func, const string& column);
+        
+        /*
+         * Process the whole input. Rows that fail to evaluate, e.g. divided by zero, get NaN.
+         *  Throws InvalidArgumentException if a variable has no column of the same name in the header.
+         */
+        void run(FILE* in, FILE* out);
+        
+        /*
+         * Rows processed by the last run().
+         */
+        unsigned long long getRowCount() const;
+};
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <mutex>
+#include <unordered_map>
+
+#include "misc/TFException.hpp"
+#include "EvaluationPlan.hpp"
+#include "Program.hpp"
+#include "RegisterProgram.hpp"
+#include "TierCompiler.hpp"
+
+EvaluationPlan::EvaluationPlan(const vector<const MathFunction*>& funcs)
+{
+    if(funcs.empty())
+    {
+        throw InvalidArgumentException("A plan needs a function at least.");
+    }
+    for(const MathFunction* func : funcs)
+    {
+        if(func->isBuiltIn())
+        {
+            throw InvalidArgumentException("Built-in functions cannot be planned.");
+        }
+    }
+    this->funcs = funcs;
+    
+    // Variables of the same name are the same input.
+    vector<vector<int>> params(funcs.size());
+    unordered_map<string, int> slots;
+    for(size_t f = 0 ; f < funcs.size() ; f++)
+    {
+        int varCount = funcs[f]->identifier->getVariablesCount();
+        for(int i = 0 ; i < varCount ; i++)
+        {
+            string name = funcs[f]->getVariableName(i);
+            unordered_map<string, int>::iterator found = slots.find(name);
+            if(found == slots.end())
+            {
+                found = slots.insert(make_pair(name, (int)(this->variables.size()))).first;
+                this->variables.push_back(name);
+            }
+            params[f].push_back(found->second);
+        }
+    }
+    
+    vector<Program*> progs(funcs.size());
+    vector<const int*> mapped(funcs.size());
+    {
+        // No formula may be redefined while being copied.
+        lock_guard<recursive_mutex> locked(TierCompiler::getLock());
+        unordered_map<const MathFunction*, MathFunction*> copies;
+        for(size_t f = 0 ; f < funcs.size() ; f++)
+        {
+            progs[f] = Program::emitFunction(*(this->snapshot(funcs[f], copies)), true);
+            mapped[f] = params[f].data();
+        }
+    }
+    this->fused = RegisterProgram::fuse(progs.data(), mapped.data(), (int)(funcs.size()), (int)(this->variables.size()));
+    for(Program* prog : progs)
+    {
+        Program::release(prog);
+    }
+    if(this->fused == nullptr)
+    {
+        this->releaseSnapshots();
+        throw InvalidArgumentException("A function of the plan does not reduce to a single value, or has an array whose variables are not all inputs of the plan in order.");
+    }
+}
+
+EvaluationPlan::~EvaluationPlan()
+{
+    RegisterProgram::release(this->fused);
+    this->releaseSnapshots();
+}
+
+MathFunction* EvaluationPlan::snapshot(const MathFunction* func, unordered_map<const MathFunction*, MathFunction*>& copies)
+{
+    unordered_map<const MathFunction*, MathFunction*>::iterator found = copies.find(func);
+    if(found != copies.end())
+    {
+        return found->second;
+    }
+    
+    // Out of the namespace, as a bound function is.
+    const MathFunctionIdentifier* ident = func->identifier;
+    MathFunction* copy = new MathFunction(func->NAME_SPACE, new MathFunctionIdentifier(ident->getName(), ident->getVariablesCount()), func->expression);
+    copy->arena = new Arena(func->expression.size() * MathFunction::ARENA_BYTES_PER_CHARACTER);
+    copy->precision = func->precision;
+    
+    Node<const OperationElement>* tail = func->postfixOperations;
+    Node<const OperationElement>* cache = tail;
+    while(cache != nullptr)
+    {
+        cache = cache->getNext();
+        const OperationElement* elem = cache->getValue();
+        if(elem->isOperator())
+        {
+            const Operator* op = dynamic_cast<const Operator*>(elem);
+            if(op->isFunction())
+            {
+                // Built-ins are never redefined.
+                MathFunction* callee = dynamic_cast<const OperatorInvokeFunc*>(op)->func;
+                copy->addToNode(new(*(copy->arena)) OperatorInvokeFunc(callee->isBuiltIn() ? callee : this->snapshot(callee, copies)));
+            }
+            else
+            {
+                // Plain operators are singletons.
+                copy->addToNode(op);
+            }
+        }
+        else if(dynamic_cast<const Operand*>(elem)->isNumeric())
+        {
+            copy->addToNode(new(*(copy->arena)) NumericOperand(dynamic_cast<const NumericOperand*>(elem)->getValue()));
+        }
+        else if(dynamic_cast<const ReducingOperand*>(elem) != nullptr)
+        {
+            const ReducingOperand* reduction = dynamic_cast<const ReducingOperand*>(elem);
+            copy->addToNode(new(*(copy->arena)) ReducingOperand(reduction->getOpCode(), reduction->getIndex(), reduction->getSecond(), reduction->getLength()));
+        }
+        else
+        {
+            copy->addToNode(new(*(copy->arena)) IndexingOperand(dynamic_cast<const IndexingOperand*>(elem)->getIndex()));
+        }
+        if(cache == tail)
+        {
+            break;
+        }
+    }
+    
+    // Already at the last tier, so that it is never promoted.
+    copy->tier = TIER_OPTIMIZED;
+    copy->program = Program::compile(*copy, true);
+    copies[func] = copy;
+    this->snapshots.push_back(copy);
+    return copy;
+}
+
+void EvaluationPlan::releaseSnapshots()
+{
+    // Each copy unlinks itself from its callees, which must still be there.
+    for(size_t i = this->snapshots.size() ; i > 0 ; i--)
+    {
+        delete this->snapshots[i - 1];
+    }
+    this->snapshots.clear();
+}
+
+int EvaluationPlan::getVariableCount() const
+{
+    return (int)(this->variables.size());
+}
+
+string EvaluationPlan::getVariableName(int index) const
+{
+    if(index < 0 || index >= (int)(this->variables.size()))
+    {
+        throw InvalidArgumentException("Variable index out of range.");
+    }
+    return this->variables[index];
+}
+
+int EvaluationPlan::getOutputCount() const
+{
+    return (int)(this->funcs.size());
+}
+
+void EvaluationPlan::run(const double* operands, double* results) const
+{
+    this->fused->run(operands, results);
+}
+
+void EvaluationPlan::runBatch(const double* const* columns, int rows, double* const* results) const
+{
+    this->fused->runBatch(columns, nullptr, rows, results);
+}
+
+int EvaluationPlan::getLength() const
+{
+    return this->fused->getLength();
+}
+
+size_t EvaluationPlan::getMemoryBytes() const
+{
+    size_t bytes = this->fused->getMemoryBytes();
+    for(const MathFunction* copy : this->snapshots)
+    {
+        MemoryUsage usage = copy->getMemoryUsage();
+        bytes += usage.functionBytes + usage.postfixBytes + usage.programBytes;
+    }
+    return bytes;
+}
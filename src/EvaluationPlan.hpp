@@ -0,0 +1,113 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TangentsMathFunc.hpp"
+
+#ifndef __TANGENT_MATH_FUNC__EVALUATION_PLAN
+#define __TANGENT_MATH_FUNC__EVALUATION_PLAN 65536
+
+using namespace std;
+
+class RegisterProgram;
+
+/*
+ * Evaluates several functions of the same inputs at once, e.g. the dozens of outputs computed for each input row.
+ *  The functions are compiled into a single program in register form, where every value computed by more than one of
+ *  them is computed once: common subexpressions, inlined callees, and calls of larger callees with the same arguments.
+ *  A batch is then a single pass over the inputs, filling every output column block by block.
+ *
+ * The variables of the plan are those of the functions, matched by name, in order of first appearance.
+ *  The plan is compiled from copies of the functions and of every user-defined function they reach, taken when it is
+ *  created, so it does not follow later redefinitions, whether a callee is inlined or called. The copies evaluate the
+ *  formulas, interpolants installed by a Tabulator being left out. The functions may be destroyed before the plan.
+ */
+class EvaluationPlan
+{
+    private:
+        vector<const MathFunction*> funcs;
+        
+        vector<string> variables;
+        
+        RegisterProgram* fused;
+        
+        /*
+         * Copies of the functions and of the user-defined functions they reach, callees first. Each one calls the copies
+         *  of its callees, and belongs to no dependency list, so none of them is ever recompiled.
+         */
+        vector<MathFunction*> snapshots;
+        
+        /*
+         * The copy of a user-defined function, made along with those of its callees unless made already.
+         */
+        MathFunction* snapshot(const MathFunction* func, unordered_map<const MathFunction*, MathFunction*>& copies);
+        
+        /*
+         * Destroy the copies, callers first.
+         */
+        void releaseSnapshots();
+        
+        // Disabled
+        EvaluationPlan(const EvaluationPlan&);
+        void operator=(const EvaluationPlan&);
+    
+    public:
+        /*
+         * e.g.
+         *  MathFunction r("r(x, y)", "(x^2 + y^2)^0.5");
+         *  MathFunction f("f(x, y)", "r(x, y) * 2");
+         *  MathFunction g("g(y, x, z)", "r(x, y) + z");
+         *  EvaluationPlan plan({&f, &g}); // variables x, y, z
+         *  Throws InvalidArgumentException for built-ins and for an empty list.
+         */
+        EvaluationPlan(const vector<const MathFunction*>& funcs);
+        
+        ~EvaluationPlan();
+        
+        int getVariableCount() const;
+        
+        string getVariableName(int index) const;
+        
+        int getOutputCount() const;
+        
+        /*
+         * Evaluate every function on one row.
+         *
+         * Param(s):
+         *    operands    -> One value per variable of the plan.
+         *    results     -> Receives one value per function, in the order of the list.
+         */
+        void run(const double* operands, double* results) const;
+        
+        /*
+         * Evaluate every function on many rows, e.g.
+         *  const double* columns[] = {xs, ys, zs};
+         *  double* results[] = {fs, gs};
+         *  plan.runBatch(columns, rows, results);
+         *
+         * Param(s):
+         *    columns    -> One array of "rows" values per variable of the plan.
+         *    results    -> One array of "rows" values per function, in the order of the list.
+         */
+        void runBatch(const double* const* columns, int rows, double* const* results) const;
+        
+        /*
+         * Instructions of the fused program.
+         */
+        int getLength() const;
+        
+        /*
+         * Bytes reserved for the fused program and for the copies of the functions.
+         */
+        size_t getMemoryBytes() const;
+};
+
+#endif
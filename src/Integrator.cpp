@@ -0,0 +1,423 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+#include "misc/TFException.hpp"
+#include "Integrator.hpp"
+
+struct IntegrationRegion
+{
+    double center[Integrator::MAX_DIMENSIONS];
+    double halfWidth[Integrator::MAX_DIMENSIONS];
+    double value;
+    double error;
+    
+    /*
+     * Dimension this region is halved along when split.
+     */
+    int splitDimension;
+    
+    bool operator<(const IntegrationRegion& other) const
+    {
+        return this->error < other.error;
+    }
+};
+
+/*
+ * Abscissae of the 15-point Kronrod rule on [-1, 1], the odd ones being those of the 7-point Gauss rule. Mirrored, 0 last.
+ */
+static const double KRONROD_NODES[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.000000000000000000000000000000000
+};
+
+static const double KRONROD_WEIGHTS[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+};
+
+static const double GAUSS_WEIGHTS[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+};
+
+/*
+ * Offsets of the Genz-Malik nodes on [-1, 1]^n, in units of the half widths.
+ */
+static const double GENZ_MALIK_LAMBDA2 = 0.35856858280031809199; // sqrt(9 / 70)
+static const double GENZ_MALIK_LAMBDA4 = 0.94868329805051379960; // sqrt(9 / 10)
+static const double GENZ_MALIK_LAMBDA5 = 0.68824720161168529772; // sqrt(9 / 19)
+
+/*
+ * Nodes of the rule applied to a region of "dims" dimensions.
+ */
+static int getNodeCount(int dims)
+{
+    if(dims == 1)
+    {
+        return 15;
+    }
+    // Center, 2 x 2n points on the axes, 2n(n - 1) points on the planes of two axes, and 2^n corners.
+    return 1 + 4 * dims + 2 * dims * (dims - 1) + (1 << dims);
+}
+
+/*
+ * Write the nodes of a region into the columns of the integrated variables, starting at row "base".
+ */
+static void placeNodes(const IntegrationRegion& region, int dims, double** columns, int base)
+{
+    if(dims == 1)
+    {
+        double c = region.center[0];
+        double h = region.halfWidth[0];
+        for(int i = 0 ; i < 7 ; i++)
+        {
+            columns[0][base + 2 * i] = c - h * KRONROD_NODES[i];
+            columns[0][base + 2 * i + 1] = c + h * KRONROD_NODES[i];
+        }
+        columns[0][base + 14] = c;
+        return;
+    }
+    
+    int row = base;
+    for(int d = 0 ; d < dims ; d++)
+    {
+        for(int k = 0 ; k < dims ; k++)
+        {
+            for(int j = 0 ; j < 4 ; j++)
+            {
+                columns[k][row + j] = region.center[k];
+            }
+        }
+        columns[d][row] = region.center[d] - region.halfWidth[d] * GENZ_MALIK_LAMBDA2;
+        columns[d][row + 1] = region.center[d] + region.halfWidth[d] * GENZ_MALIK_LAMBDA2;
+        columns[d][row + 2] = region.center[d] - region.halfWidth[d] * GENZ_MALIK_LAMBDA4;
+        columns[d][row + 3] = region.center[d] + region.halfWidth[d] * GENZ_MALIK_LAMBDA4;
+        row += 4;
+    }
+    for(int d = 0 ; d < dims ; d++)
+    {
+        for(int e = d + 1 ; e < dims ; e++)
+        {
+            for(int j = 0 ; j < 4 ; j++)
+            {
+                for(int k = 0 ; k < dims ; k++)
+                {
+                    columns[k][row] = region.center[k];
+                }
+                columns[d][row] = region.center[d] + ((j & 1) ? 1 : -1) * region.halfWidth[d] * GENZ_MALIK_LAMBDA4;
+                columns[e][row] = region.center[e] + ((j & 2) ? 1 : -1) * region.halfWidth[e] * GENZ_MALIK_LAMBDA4;
+                row++;
+            }
+        }
+    }
+    for(int j = 0 ; j < (1 << dims) ; j++)
+    {
+        for(int k = 0 ; k < dims ; k++)
+        {
+            columns[k][row] = region.center[k] + (((j >> k) & 1) ? 1 : -1) * region.halfWidth[k] * GENZ_MALIK_LAMBDA5;
+        }
+        row++;
+    }
+    for(int k = 0 ; k < dims ; k++)
+    {
+        columns[k][row] = region.center[k];
+    }
+}
+
+/*
+ * Combine the values at the nodes placed by placeNodes() into the estimates of a region.
+ */
+static void applyRule(IntegrationRegion& region, int dims, const double* values)
+{
+    if(dims == 1)
+    {
+        double center = values[14];
+        double kronrod = KRONROD_WEIGHTS[7] * center;
+        double gauss = GAUSS_WEIGHTS[3] * center;
+        for(int i = 0 ; i < 7 ; i++)
+        {
+            double pair = values[2 * i] + values[2 * i + 1];
+            kronrod += KRONROD_WEIGHTS[i] * pair;
+            if(i & 1)
+            {
+                gauss += GAUSS_WEIGHTS[i >> 1] * pair;
+            }
+        }
+        region.value = kronrod * region.halfWidth[0];
+        region.error = fabs((kronrod - gauss) * region.halfWidth[0]);
+        region.splitDimension = 0;
+        return;
+    }
+    
+    double n = dims;
+    int corners = 1 << dims;
+    int last = getNodeCount(dims) - 1;
+    double center = values[last];
+    double sum2 = 0;
+    double sum3 = 0;
+    double sum4 = 0;
+    double sum5 = 0;
+    double widest = 0;
+    double maxDifference = -1;
+    for(int d = 0 ; d < dims ; d++)
+    {
+        const double* axis = values + 4 * d;
+        double inner = axis[0] + axis[1];
+        double outer = axis[2] + axis[3];
+        sum2 += inner;
+        sum3 += outer;
+        
+        // Split along the axis with the largest fourth difference, the widest one among equals.
+        double difference = fabs((inner - 2 * center) - (outer - 2 * center) * (GENZ_MALIK_LAMBDA2 * GENZ_MALIK_LAMBDA2) / (GENZ_MALIK_LAMBDA4 * GENZ_MALIK_LAMBDA4));
+        if(difference > maxDifference || (difference == maxDifference && region.halfWidth[d] > widest))
+        {
+            maxDifference = difference;
+            widest = region.halfWidth[d];
+            region.splitDimension = d;
+        }
+    }
+    int row = 4 * dims;
+    for(int j = 0 ; j < 2 * dims * (dims - 1) ; j++)
+    {
+        sum4 += values[row++];
+    }
+    for(int j = 0 ; j < corners ; j++)
+    {
+        sum5 += values[row++];
+    }
+    
+    double volume = 1;
+    for(int d = 0 ; d < dims ; d++)
+    {
+        volume *= 2 * region.halfWidth[d];
+    }
+    double degree7 = (12824 - 9120 * n + 400 * n * n) / 19683 * center + 980.0 / 6561 * sum2
+            + (1820 - 400 * n) / 19683 * sum3 + 200.0 / 19683 * sum4 + 6859.0 / 19683 / corners * sum5;
+    double degree5 = (729 - 950 * n + 50 * n * n) / 729 * center + 245.0 / 486 * sum2 + (265 - 100 * n) / 1458 * sum3 + 25.0 / 729 * sum4;
+    region.value = degree7 * volume;
+    region.error = fabs((degree7 - degree5) * volume);
+}
+
+Integrator::Integrator(double absTolerance, double relTolerance, int maxRegions, int threads)
+{
+    if(!(absTolerance >= 0 && relTolerance >= 0) || maxRegions < 1 || threads < 0)
+    {
+        throw InvalidArgumentException("Tolerances must not be negative, and at least one region is needed.");
+    }
+    this->absTolerance = absTolerance;
+    this->relTolerance = relTolerance;
+    this->maxRegions = maxRegions;
+    this->threads = (threads > 0 ? threads : max(1, (int)(thread::hardware_concurrency())));
+}
+
+void Integrator::evaluate(const MathFunction& func, const int* slots, int dims, const double* point, vector<IntegrationRegion>& regions, IntegrationResult& result) const
+{
+    int varCount = func.getIdentifier().getVariablesCount();
+    int nodes = getNodeCount(dims);
+    int count = (int)(regions.size());
+    int rows = count * nodes;
+    
+    // Fixed variables are broadcast, so that a round is a single batch over all columns.
+    vector<double> buffer((size_t)(varCount + 1) * rows);
+    vector<const double*> columns(varCount);
+    double* integrated[MAX_DIMENSIONS];
+    for(int i = 0 ; i < varCount ; i++)
+    {
+        double* column = buffer.data() + (size_t)(i) * rows;
+        columns[i] = column;
+        fill(column, column + rows, (point != nullptr ? point[i] : 0));
+    }
+    for(int d = 0 ; d < dims ; d++)
+    {
+        integrated[d] = const_cast<double*>(columns[slots[d]]);
+    }
+    for(int i = 0 ; i < count ; i++)
+    {
+        placeNodes(regions[i], dims, integrated, i * nodes);
+    }
+    
+    double* values = buffer.data() + (size_t)(varCount) * rows;
+    int workers = min(this->threads, rows / MIN_ROWS_PER_THREAD);
+    if(workers <= 1)
+    {
+        func.invokeBatch(columns.data(), rows, values);
+    }
+    else
+    {
+        // Each worker takes whole regions.
+        vector<thread> pool;
+        vector<exception_ptr> errors(workers);
+        for(int w = 0 ; w < workers ; w++)
+        {
+            int first = (int)((long long)(count) * w / workers) * nodes;
+            int end = (int)((long long)(count) * (w + 1) / workers) * nodes;
+            pool.emplace_back([&, w, first, end]() {
+                try
+                {
+                    vector<const double*> offset(varCount);
+                    for(int i = 0 ; i < varCount ; i++)
+                    {
+                        offset[i] = columns[i] + first;
+                    }
+                    func.invokeBatch(offset.data(), end - first, values + first);
+                }
+                catch(...)
+                {
+                    errors[w] = current_exception();
+                }
+            });
+        }
+        for(thread& worker : pool)
+        {
+            worker.join();
+        }
+        for(exception_ptr& error : errors)
+        {
+            if(error)
+            {
+                rethrow_exception(error);
+            }
+        }
+    }
+    
+    for(int i = 0 ; i < count ; i++)
+    {
+        applyRule(regions[i], dims, values + (size_t)(i) * nodes);
+    }
+    result.evaluations += rows;
+}
+
+IntegrationResult Integrator::integrate(const MathFunction& func, const int* slots, int dims, const double* lower, const double* upper, const double* point) const
+{
+    if(point == nullptr && func.getIdentifier().getVariablesCount() > dims)
+    {
+        throw InvalidArgumentException("Values of the variables not integrated over are missing.");
+    }
+    
+    IntegrationResult result;
+    vector<IntegrationRegion> pending(1);
+    double sign = 1;
+    for(int d = 0 ; d < dims ; d++)
+    {
+        if(!(isfinite(lower[d]) && isfinite(upper[d])))
+        {
+            throw InvalidArgumentException("Integration bounds must be finite.");
+        }
+        // Reversed bounds flip the sign.
+        if(lower[d] > upper[d])
+        {
+            sign = -sign;
+        }
+        pending[0].center[d] = (lower[d] + upper[d]) / 2;
+        pending[0].halfWidth[d] = fabs(upper[d] - lower[d]) / 2;
+    }
+    
+    vector<IntegrationRegion> heap;
+    while(true)
+    {
+        this->evaluate(func, slots, dims, point, pending, result);
+        for(const IntegrationRegion& region : pending)
+        {
+            heap.push_back(region);
+            push_heap(heap.begin(), heap.end());
+        }
+        pending.clear();
+        
+        // Summed afresh every round, so that the totals do not drift.
+        result.value = 0;
+        result.error = 0;
+        for(const IntegrationRegion& region : heap)
+        {
+            result.value += region.value;
+            result.error += region.error;
+        }
+        result.regions = (int)(heap.size());
+        if(!(isfinite(result.value) && isfinite(result.error)))
+        {
+            break;
+        }
+        double tolerance = max(this->absTolerance, this->relTolerance * fabs(result.value));
+        if(result.error <= tolerance)
+        {
+            result.converged = true;
+            break;
+        }
+        if(result.regions >= this->maxRegions)
+        {
+            break;
+        }
+        
+        // Split the worst regions until the error they carry covers the excess, as if their halves were exact.
+        double removed = 0;
+        while(!heap.empty() && removed < result.error - tolerance && (int)(heap.size() + pending.size()) < this->maxRegions)
+        {
+            pop_heap(heap.begin(), heap.end());
+            IntegrationRegion region = heap.back();
+            heap.pop_back();
+            removed += region.error;
+            
+            int d = region.splitDimension;
+            region.halfWidth[d] /= 2;
+            region.center[d] -= region.halfWidth[d];
+            pending.push_back(region);
+            region.center[d] += 2 * region.halfWidth[d];
+            pending.push_back(region);
+        }
+    }
+    
+    result.value *= sign;
+    return result;
+}
+
+IntegrationResult Integrator::integrate(const MathFunction& func, const string& variable, double lower, double upper, const double* point) const
+{
+    return this->integrate(func, {variable}, &lower, &upper, point);
+}
+
+IntegrationResult Integrator::integrate(const MathFunction& func, initializer_list<string> variables, const double* lower, const double* upper, const double* point) const
+{
+    int dims = (int)(variables.size());
+    if(dims < 1 || dims > MAX_DIMENSIONS)
+    {
+        throw InvalidArgumentException(("Integration over 1 to " + to_string(MAX_DIMENSIONS) + " variables is supported.").c_str());
+    }
+    
+    int varCount = func.getIdentifier().getVariablesCount();
+    int slots[MAX_DIMENSIONS];
+    int d = 0;
+    for(const string& variable : variables)
+    {
+        int slot = 0;
+        while(slot < varCount && func.getVariableName(slot) != variable)
+        {
+            slot++;
+        }
+        for(int e = 0 ; e < d ; e++)
+        {
+            if(slots[e] == slot)
+            {
+                slot = varCount;
+            }
+        }
+        if(slot == varCount)
+        {
+            throw InvalidArgumentException(("Unknown or repeated variable: " + variable).c_str());
+        }
+        slots[d++] = slot;
+    }
+    return this->integrate(func, slots, dims, lower, upper, point);
+}
@@ -0,0 +1,126 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "TangentsMathFunc.hpp"
+
+#ifndef __TANGENT_MATH_FUNC__INTEGRATOR
+#define __TANGENT_MATH_FUNC__INTEGRATOR 65536
+
+using namespace std;
+
+/*
+ * Outcome of an integration.
+ */
+struct IntegrationResult
+{
+    double value = 0;
+    
+    /*
+     * Estimated absolute error, the sum of the estimates of all regions.
+     */
+    double error = 0;
+    
+    /*
+     * Rows evaluated.
+     */
+    unsigned long long evaluations = 0;
+    
+    /*
+     * Regions the domain ended up split into.
+     */
+    int regions = 0;
+    
+    /*
+     * False if the region limit was hit, or the function is not finite somewhere, before the tolerance was met.
+     */
+    bool converged = false;
+};
+
+/*
+ * A box being integrated over, with the estimates of the rule applied to it.
+ */
+struct IntegrationRegion;
+
+/*
+ * Adaptive integration of a MathFunction over one to four of its variables, the others held fixed.
+ *  One variable is integrated by the 7-point Gauss and 15-point Kronrod pair, two to four by the degree 7 Genz-Malik rule
+ *  with its embedded degree 5 rule. The error of a region is the difference between the two.
+ *
+ * The regions with the largest errors are split in halves until the total error meets the tolerance.
+ *  All nodes of the regions split in a round are evaluated by a few large invokeBatch() calls, spread over threads.
+ */
+class Integrator
+{
+    private:
+        double absTolerance;
+        
+        double relTolerance;
+        
+        int maxRegions;
+        
+        int threads;
+        
+        // Disabled
+        Integrator(const Integrator&);
+        void operator=(const Integrator&);
+        
+        /*
+         * Apply the rule to every region at once, filling in their values, errors and split dimensions.
+         *
+         * Param(s):
+         *    slots    -> Variable of the function for each integrated dimension.
+         *    point    -> Values of all variables, those integrated over being ignored.
+         */
+        void evaluate(const MathFunction& func, const int* slots, int dims, const double* point, vector<IntegrationRegion>& regions, IntegrationResult& result) const;
+        
+        IntegrationResult integrate(const MathFunction& func, const int* slots, int dims, const double* lower, const double* upper, const double* point) const;
+    
+    public:
+        static const int MAX_DIMENSIONS = 4;
+        
+        /*
+         * Nodes evaluated by one thread at least. Smaller rounds run on the calling thread alone.
+         */
+        static const int MIN_ROWS_PER_THREAD = 4096;
+        
+        /*
+         * Integration stops once the error estimate is within max(absTolerance, relTolerance * |value|).
+         *
+         * Param(s):
+         *    maxRegions    -> Limit of the number of regions, bounding both the time and the memory.
+         *    threads       -> Threads evaluating the nodes, 0 for one per hardware thread.
+         */
+        Integrator(double absTolerance = 1e-10, double relTolerance = 1e-10, int maxRegions = 65536, int threads = 0);
+        
+        /*
+         * Integrate over a single variable, e.g. the integral of f(x, y) over x in [0, 1] at y = 2:
+         *  double point[] = {0, 2};
+         *  IntegrationResult r = integrator.integrate(f, "x", 0, 1, point);
+         *
+         * Param(s):
+         *    point    -> Values of all variables in the order of the identifier. The integrated one is ignored.
+         *                May be nullptr if the function has no other variable.
+         */
+        IntegrationResult integrate(const MathFunction& func, const string& variable, double lower, double upper, const double* point = nullptr) const;
+        
+        /*
+         * Integrate over a box of up to MAX_DIMENSIONS variables, e.g. f(x, y, z) over x, y in [0, 1] x [-1, 1] at z = 3:
+         *  double lower[] = {0, -1}, upper[] = {1, 1}, point[] = {0, 0, 3};
+         *  IntegrationResult r = integrator.integrate(f, {"x", "y"}, lower, upper, point);
+         *
+         * Param(s):
+         *    lower, upper    -> Finite bounds, one per variable in the order of "variables".
+         */
+        IntegrationResult integrate(const MathFunction& func, initializer_list<string> variables, const double* lower, const double* upper, const double* point = nullptr) const;
+};
+
+#endif
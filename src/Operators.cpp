@@ -22,6 +22,16 @@ const OperatorBinary& Operator::OPERATOR_MULTIPLICATION = *(new OperatorMultipli
 const OperatorBinary& Operator::OPERATOR_DIVISION = *(new OperatorDivision());
 const OperatorBinary& Operator::OPERATOR_MODDING = *(new OperatorModding());
 const OperatorBinary& Operator::OPERATOR_POWER = *(new OperatorPower());
+const OperatorBinary& Operator::OPERATOR_LESS = *(new OperatorLogical(OPCODE_LESS));
+const OperatorBinary& Operator::OPERATOR_LESS_EQUAL = *(new OperatorLogical(OPCODE_LESS_EQUAL));
+const OperatorBinary& Operator::OPERATOR_GREATER = *(new OperatorLogical(OPCODE_GREATER));
+const OperatorBinary& Operator::OPERATOR_GREATER_EQUAL = *(new OperatorLogical(OPCODE_GREATER_EQUAL));
+const OperatorBinary& Operator::OPERATOR_EQUAL = *(new OperatorLogical(OPCODE_EQUAL));
+const OperatorBinary& Operator::OPERATOR_NOT_EQUAL = *(new OperatorLogical(OPCODE_NOT_EQUAL));
+const OperatorBinary& Operator::OPERATOR_AND = *(new OperatorLogical(OPCODE_AND));
+const OperatorBinary& Operator::OPERATOR_OR = *(new OperatorLogical(OPCODE_OR));
+const OperatorUnary& Operator::OPERATOR_NOT = *(new OperatorNot());
+const OperatorSelect& Operator::OPERATOR_SELECT = *(new OperatorSelect());
 const OperatorLeftBracket& Operator::OPERATOR_LEFT_BRACKET = *(new OperatorLeftBracket());
 
 bool Operand::isOperator() const
@@ -44,6 +54,69 @@ bool IndexingOperand::isNumeric() const
     return false;
 }
 
+ReducingOperand::ReducingOperand(int _opcode, int _index, int _second, int _length)
+{
+    this->opcode = _opcode;
+    this->index = _index;
+    this->second = _second;
+    this->length = _length;
+}
+
+int ReducingOperand::getOpCode() const
+{
+    return this->opcode;
+}
+
+int ReducingOperand::getIndex() const
+{
+    return this->index;
+}
+
+int ReducingOperand::getSecond() const
+{
+    return this->second;
+}
+
+int ReducingOperand::getLength() const
+{
+    return this->length;
+}
+
+bool ReducingOperand::isNumeric() const
+{
+    return false;
+}
+
+int ReducingOperand::getOpCode(const string& name)
+{
+    if(name == "sum")
+    {
+        return OPCODE_SUM;
+    }
+    if(name == "prod")
+    {
+        return OPCODE_PRODUCT;
+    }
+    if(name == "dot")
+    {
+        return OPCODE_DOT;
+    }
+    if(name == "min")
+    {
+        return OPCODE_MINIMUM;
+    }
+    if(name == "max")
+    {
+        return OPCODE_MAXIMUM;
+    }
+    return OPCODE_NONE;
+}
+
+int ReducingOperand::getArrayCount(int opcode)
+{
+    return (opcode == OPCODE_DOT ? 2 : 1);
+}
+
 bool NumericOperand::isNumeric() const
 {
     return true;
@@ -91,7 +164,12 @@ double OperatorNegative::operate(const double& input) const
 
 int OperatorNegative::getLevel() const
 {
-    return 3;
+    return 7;
+}
+
+int OperatorNegative::getOpCode() const
+{
+    return OPCODE_NEGATIVE;
 }
 
 double OperatorAddition::operate(const double& lhs, const double& rhs) const
@@ -101,7 +179,12 @@ double OperatorAddition::operate(const double& lhs, const double& rhs) const
 
 int OperatorAddition::getLevel() const
 {
-    return 1;
+    return 5;
+}
+
+int OperatorAddition::getOpCode() const
+{
+    return OPCODE_ADDITION;
 }
 
 double OperatorNegation::operate(const double& lhs, const double& rhs) const
@@ -111,7 +194,12 @@ double OperatorNegation::operate(const double& lhs, const double& rhs) const
 
 int OperatorNegation::getLevel() const
 {
-    return 1;
+    return 5;
+}
+
+int OperatorNegation::getOpCode() const
+{
+    return OPCODE_NEGATION;
 }
 
 double OperatorMultiplication::operate(const double& lhs, const double& rhs) const
@@ -121,7 +209,12 @@ double OperatorMultiplication::operate(const double& lhs, const double& rhs) con
 
 int OperatorMultiplication::getLevel() const
 {
-    return 2;
+    return 6;
+}
+
+int OperatorMultiplication::getOpCode() const
+{
+    return OPCODE_MULTIPLICATION;
 }
 
 double OperatorDivision::operate(const double& lhs, const double& rhs) const
@@ -135,7 +228,12 @@ double OperatorDivision::operate(const double& lhs, const double& rhs) const
 
 int OperatorDivision::getLevel() const
 {
-    return 2;
+    return 6;
+}
+
+int OperatorDivision::getOpCode() const
+{
+    return OPCODE_DIVISION;
 }
 
 double OperatorModding::operate(const double& lhs, const double& rhs) const
@@ -149,7 +247,12 @@ double OperatorModding::operate(const double& lhs, const double& rhs) const
 
 int OperatorModding::getLevel() const
 {
-    return 2;
+    return 6;
+}
+
+int OperatorModding::getOpCode() const
+{
+    return OPCODE_MODDING;
 }
 
 double OperatorPower::operate(const double& lhs, const double& rhs) const
@@ -159,7 +262,96 @@ double OperatorPower::operate(const double& lhs, const double& rhs) const
         
 int OperatorPower::getLevel() const
 {
-    return 4;
+    return 8;
+}
+
+int OperatorPower::getOpCode() const
+{
+    return OPCODE_POWER;
+}
+
+OperatorLogical::OperatorLogical(int _opcode)
+{
+    this->opcode = _opcode;
+}
+
+double OperatorLogical::operate(const double& lhs, const double& rhs) const
+{
+    switch(this->opcode)
+    {
+        case OPCODE_LESS:
+            return (lhs < rhs ? 1 : 0);
+        case OPCODE_LESS_EQUAL:
+            return (lhs <= rhs ? 1 : 0);
+        case OPCODE_GREATER:
+            return (lhs > rhs ? 1 : 0);
+        case OPCODE_GREATER_EQUAL:
+            return (lhs >= rhs ? 1 : 0);
+        case OPCODE_EQUAL:
+            return (lhs == rhs ? 1 : 0);
+        case OPCODE_NOT_EQUAL:
+            return (lhs != rhs ? 1 : 0);
+        case OPCODE_AND:
+            return (lhs != 0 && rhs != 0 ? 1 : 0);
+        default:
+            return (lhs != 0 || rhs != 0 ? 1 : 0);
+    }
+}
+
+int OperatorLogical::getLevel() const
+{
+    switch(this->opcode)
+    {
+        case OPCODE_OR:
+            return 1;
+        case OPCODE_AND:
+            return 2;
+        case OPCODE_EQUAL:
+        case OPCODE_NOT_EQUAL:
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+int OperatorLogical::getOpCode() const
+{
+    return this->opcode;
+}
+
+double OperatorNot::operate(const double& input) const
+{
+    return (input == 0 ? 1 : 0);
+}
+
+int OperatorNot::getLevel() const
+{
+    return 7;
+}
+
+int OperatorNot::getOpCode() const
+{
+    return OPCODE_NOT;
+}
+
+bool OperatorSelect::isUnary() const
+{
+    return false;
+}
+
+int OperatorSelect::getLevel() const
+{
+    return -1;
+}
+
+int OperatorSelect::getOpCode() const
+{
+    return OPCODE_SELECT;
+}
+
+bool OperatorSelect::isSelection(const string& name, int varCount)
+{
+    return (varCount == 3 && (name == "if" || name == "select"));
 }
 
 bool OperatorLeftBracket::isUnary() const
@@ -183,6 +375,11 @@ int OperatorLeftBracket::getLevel() const
     return 0;
 }
 
+int OperatorLeftBracket::getOpCode() const
+{
+    return OPCODE_NONE;
+}
+
 OperatorInvokeFunc::OperatorInvokeFunc(MathFunction* _f) : func(_f), varCount(_f->getIdentifier().getVariablesCount()){}
 
 bool OperatorInvokeFunc::isFunction() const
@@ -199,3 +396,8 @@ int OperatorInvokeFunc::getLevel() const
 {
     return -1;
 }
+
+int OperatorInvokeFunc::getOpCode() const
+{
+    return OPCODE_INVOKE;
+}
@@ -6,9 +6,59 @@
  *  https://github.com/tan2pow16/TangentsMathFunc
  */
 
+#include <string>
+
 #ifndef __TANGENT_MATH_FUNC__OPERATION_ELEM
 #define __TANGENT_MATH_FUNC__OPERATION_ELEM 65536
 
+using namespace std;
+
+/*
+ * Opcodes of the flattened instruction stream a MathFunction is compiled into. See Program.hpp.
+ */
+enum OpCode
+{
+    OPCODE_NONE = -1,
+    OPCODE_CONSTANT,
+    OPCODE_VARIABLE,
+    OPCODE_STORE,
+    OPCODE_NEGATIVE,
+    OPCODE_ADDITION,
+    OPCODE_NEGATION,
+    OPCODE_MULTIPLICATION,
+    OPCODE_DIVISION,
+    OPCODE_MODDING,
+    OPCODE_POWER,
+    OPCODE_INVOKE,
+    
+    // a * b + c, emitted by the polynomial rewrite only.
+    OPCODE_MULTIPLY_ADD,
+    
+    // Reductions over whole array parameters, see ReducingOperand. They read the frame directly and push their value.
+    OPCODE_SUM,
+    OPCODE_PRODUCT,
+    OPCODE_DOT,
+    OPCODE_MINIMUM,
+    OPCODE_MAXIMUM,
+    
+    // Comparisons and logical operators, giving 1 or 0. Any nonzero value, NaN included, is true.
+    OPCODE_LESS,
+    OPCODE_LESS_EQUAL,
+    OPCODE_GREATER,
+    OPCODE_GREATER_EQUAL,
+    OPCODE_EQUAL,
+    OPCODE_NOT_EQUAL,
+    OPCODE_AND,
+    OPCODE_OR,
+    OPCODE_NOT,
+    
+    // c ? a : b of "if(c, a, b)", both a and b being computed, so that it never branches.
+    OPCODE_SELECT,
+    
+    // Number of opcodes, not an opcode itself.
+    OPCODE_COUNT
+};
+
 /*
  * An interface class allowing us to put both Operators and Operands into a same linked structure.
  */
@@ -39,6 +89,42 @@ class IndexingOperand : public Operand
         bool isNumeric() const;
 };
 
+/*
+ * A reduction over array parameters, e.g. "sum(w)" or "dot(w, x)", which reads "length" variables from "index" on,
+ *  and from "second" on as well for OPCODE_DOT. Being computed from the variables alone, it is an operand of the postfix expression.
+ */
+class ReducingOperand : public Operand
+{
+    private:
+        int opcode;
+        int index;
+        int second;
+        int length;
+    
+    public:
+        ReducingOperand(int _opcode, int _index, int _second, int _length);
+        
+        int getOpCode() const;
+        
+        int getIndex() const;
+        
+        int getSecond() const;
+        
+        int getLength() const;
+        
+        bool isNumeric() const;
+        
+        /*
+         * Opcode of the reduction named so, OPCODE_NONE if there is none.
+         */
+        static int getOpCode(const string& name);
+        
+        /*
+         * Arrays taken by a reduction.
+         */
+        static int getArrayCount(int opcode);
+};
+
 /*
  * Operand to be put into the MathFunction::postfix expression.
  */
@@ -68,6 +154,7 @@ class NumericOperand : public Operand
 class OperatorUnary;
 class OperatorBinary;
 class OperatorLeftBracket;
+class OperatorSelect;
 
 class Operator : public OperationElement
 {
@@ -87,6 +174,16 @@ class Operator : public OperationElement
         static const OperatorBinary& OPERATOR_DIVISION;
         static const OperatorBinary& OPERATOR_MODDING;
         static const OperatorBinary& OPERATOR_POWER;
+        static const OperatorBinary& OPERATOR_LESS;
+        static const OperatorBinary& OPERATOR_LESS_EQUAL;
+        static const OperatorBinary& OPERATOR_GREATER;
+        static const OperatorBinary& OPERATOR_GREATER_EQUAL;
+        static const OperatorBinary& OPERATOR_EQUAL;
+        static const OperatorBinary& OPERATOR_NOT_EQUAL;
+        static const OperatorBinary& OPERATOR_AND;
+        static const OperatorBinary& OPERATOR_OR;
+        static const OperatorUnary& OPERATOR_NOT;
+        static const OperatorSelect& OPERATOR_SELECT;
         static const OperatorLeftBracket& OPERATOR_LEFT_BRACKET;
         
         virtual bool isBracket() const;
@@ -98,6 +195,11 @@ class Operator : public OperationElement
         virtual bool isFunction() const;
         
         virtual int getLevel() const = 0;
+        
+        /*
+         * The instruction this operator compiles into.
+         */
+        virtual int getOpCode() const = 0;
 };
 
 /*
@@ -153,6 +255,8 @@ class OperatorNegative : public OperatorUnary
         double operate(const double& input) const;
         
         int getLevel() const;
+        
+        int getOpCode() const;
     
     friend class Operator;
 };
@@ -172,6 +276,8 @@ class OperatorAddition : public OperatorBinary
         double operate(const double& lhs, const double& rhs) const;
         
         int getLevel() const;
+        
+        int getOpCode() const;
     
     friend class Operator;
 };
@@ -191,6 +297,8 @@ class OperatorNegation : public OperatorBinary
         double operate(const double& lhs, const double& rhs) const;
         
         int getLevel() const;
+        
+        int getOpCode() const;
     
     friend class Operator;
 };
@@ -210,6 +318,8 @@ class OperatorMultiplication : public OperatorBinary
         double operate(const double& lhs, const double& rhs) const;
         
         int getLevel() const;
+        
+        int getOpCode() const;
     
     friend class Operator;
 };
@@ -229,6 +339,8 @@ class OperatorDivision : public OperatorBinary
         double operate(const double& lhs, const double& rhs) const;
         
         int getLevel() const;
+        
+        int getOpCode() const;
     
     friend class Operator;
 };
@@ -248,6 +360,8 @@ class OperatorModding : public OperatorBinary
         double operate(const double& lhs, const double& rhs) const;
         
         int getLevel() const;
+        
+        int getOpCode() const;
     
     friend class Operator;
 };
@@ -267,6 +381,79 @@ class OperatorPower : public OperatorBinary
         double operate(const double& lhs, const double& rhs) const;
         
         int getLevel() const;
+        
+        int getOpCode() const;
+    
+    friend class Operator;
+};
+
+/*
+ * Corresponding to "<", "<=", ">", ">=", "==", "!=", "&&" and "||", from the highest precedence to the lowest,
+ *  "&&" and "||" evaluating both operands.
+ */
+
+class OperatorLogical : public OperatorBinary
+{
+    private:
+        int opcode;
+        
+        OperatorLogical(int _opcode);
+        OperatorLogical(const OperatorLogical&);
+        void operator=(const OperatorLogical&);
+        
+    public:
+        double operate(const double& lhs, const double& rhs) const;
+        
+        int getLevel() const;
+        
+        int getOpCode() const;
+    
+    friend class Operator;
+};
+
+/*
+ * Corresponding to "!" in "!a"
+ */
+
+class OperatorNot : public OperatorUnary
+{
+    private:
+        OperatorNot(){}
+        OperatorNot(const OperatorNot&);
+        void operator=(const OperatorNot&);
+        
+    public:
+        double operate(const double& input) const;
+        
+        int getLevel() const;
+        
+        int getOpCode() const;
+    
+    friend class Operator;
+};
+
+/*
+ * Corresponding to "if(c, a, b)", or "select(c, a, b)". Put into the postfix expression behind its arguments, like a call.
+ */
+
+class OperatorSelect : public Operator
+{
+    private:
+        OperatorSelect(){}
+        OperatorSelect(const OperatorSelect&);
+        void operator=(const OperatorSelect&);
+    
+    public:
+        bool isUnary() const;
+        
+        int getLevel() const;
+        
+        int getOpCode() const;
+        
+        /*
+         * Whether a call of this name and argument count is a selection.
+         */
+        static bool isSelection(const string& name, int varCount);
     
     friend class Operator;
 };
@@ -286,6 +473,8 @@ class OperatorLeftBracket : public OperatorBinary
         double operate(const double& lhs, const double& rhs) const;
         
         int getLevel() const;
+        
+        int getOpCode() const;
     
     friend class Operator;
 };
@@ -295,7 +484,7 @@ class MathFunction;
 class OperatorInvokeFunc : public Operator
 {
     public:
-        const MathFunction* func;
+        MathFunction* func;
         int varCount;
         
         OperatorInvokeFunc(MathFunction* _f);
@@ -305,6 +494,8 @@ class OperatorInvokeFunc : public Operator
         bool isUnary() const;
         
         int getLevel() const;
+        
+        int getOpCode() const;
 };
 
 #endif
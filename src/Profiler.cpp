@@ -0,0 +1,366 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Profiler.hpp"
+#include "TangentsMathFunc.hpp"
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+/*
+ * Calls of one function along one call path.
+ */
+struct ProfileNode
+{
+    const MathFunction* func;
+    
+    /*
+     * Copied when the node is created, since the function may be destroyed before the report.
+     */
+    string name;
+    
+    ProfileNode* parent;
+    
+    ProfileNode* child;
+    
+    ProfileNode* sibling;
+    
+    unsigned long long calls;
+    
+    unsigned long long nanos;
+};
+
+/*
+ * Everything recorded by one thread.
+ */
+class ProfileCollector
+{
+    public:
+        /*
+         * Root of the call tree, not a function.
+         */
+        ProfileNode root;
+        
+        ProfileNode* current;
+        
+        unsigned long long counts[OPCODE_COUNT];
+        
+        unsigned long long samples[OPCODE_COUNT];
+        
+        unsigned long long sampledRows[OPCODE_COUNT];
+        
+        unsigned long long sampledNanos[OPCODE_COUNT];
+        
+        /*
+         * Instructions left until the next timed one.
+         */
+        unsigned int countdown;
+        
+        /*
+         * State of the xorshift generator drawing the distances between timed instructions. Never 0.
+         */
+        uint32_t seed;
+        
+        ProfileCollector* next;
+        
+        ProfileCollector(uint32_t _seed) : root{nullptr, "", nullptr, nullptr, nullptr, 0, 0}, current(&root), seed(_seed | 1), next(nullptr)
+        {
+            this->countdown = this->draw();
+            this->clear();
+        }
+        
+        /*
+         * Distance to the next timed instruction, from 1 to 2 * SAMPLE_INTERVAL - 1, SAMPLE_INTERVAL on average.
+         */
+        unsigned int draw()
+        {
+            this->seed ^= this->seed << 13;
+            this->seed ^= this->seed >> 17;
+            this->seed ^= this->seed << 5;
+            return 1 + this->seed % (2 * Profiler::SAMPLE_INTERVAL - 1);
+        }
+        
+        void clear()
+        {
+            freeChildren(&(this->root));
+            this->current = &(this->root);
+            memset(this->counts, 0, sizeof(this->counts));
+            memset(this->samples, 0, sizeof(this->samples));
+            memset(this->sampledRows, 0, sizeof(this->sampledRows));
+            memset(this->sampledNanos, 0, sizeof(this->sampledNanos));
+        }
+        
+        static void freeChildren(ProfileNode* node)
+        {
+            ProfileNode* child = node->child;
+            while(child != nullptr)
+            {
+                ProfileNode* sibling = child->sibling;
+                freeChildren(child);
+                delete child;
+                child = sibling;
+            }
+            node->child = nullptr;
+        }
+        
+        /*
+         * Child of the current node for the function, created on first call.
+         */
+        ProfileNode* enter(const MathFunction* func)
+        {
+            ProfileNode* node = this->current->child;
+            while(node != nullptr && node->func != func)
+            {
+                node = node->sibling;
+            }
+            if(node == nullptr)
+            {
+                const MathFunctionIdentifier& ident = func->getIdentifier();
+                node = new ProfileNode{func, ident.getName() + "/" + to_string(ident.getVariablesCount()), this->current, nullptr, this->current->child, 0, 0};
+                this->current->child = node;
+            }
+            this->current = node;
+            return node;
+        }
+};
+
+static const char* const OPCODE_NAMES[OPCODE_COUNT] = {"constant", "variable", "store", "negative", "addition", "negation", "multiplication", "division", "modding", "power", "invoke", "multiply-add", "sum", "product", "dot", "minimum", "maximum", "less", "less-equal", "greater", "greater-equal", "equal", "not-equal", "and", "or", "not", "select"};
+
+static thread_local ProfileCollector* COLLECTOR = nullptr;
+
+atomic<bool> Profiler::ENABLED(false);
+
+atomic<ProfileCollector*> Profiler::COLLECTORS(nullptr);
+
+bool Profiler::isAvailable()
+{
+#ifdef TANGENT_MATH_FUNC_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    ENABLED.store(enabled);
+}
+
+void Profiler::reset()
+{
+    for(ProfileCollector* collector = COLLECTORS.load() ; collector != nullptr ; collector = collector->next)
+    {
+        collector->clear();
+    }
+}
+
+ProfileCollector* Profiler::getCollector()
+{
+    if(COLLECTOR == nullptr)
+    {
+        // Collectors are never freed, so that the records of finished threads stay in the reports.
+        //  Each thread samples at its own distances.
+        static atomic<uint32_t> threads(0);
+        ProfileCollector* collector = new ProfileCollector(2654435769u * (threads.fetch_add(1) + 1));
+        collector->next = COLLECTORS.load();
+        while(!COLLECTORS.compare_exchange_weak(collector->next, collector));
+        COLLECTOR = collector;
+    }
+    return COLLECTOR;
+}
+
+/*
+ * Nanoseconds a timed sample adds by reading the clock twice, measured once.
+ */
+static double clockOverhead()
+{
+    static double overhead = -1;
+    if(overhead < 0)
+    {
+        const int ROUNDS = 1000;
+        Clock::time_point start = Clock::now();
+        for(int i = 0 ; i < ROUNDS ; i++)
+        {
+            Clock::now();
+        }
+        overhead = chrono::duration<double, nano>(Clock::now() - start).count() / ROUNDS;
+    }
+    return overhead;
+}
+
+/*
+ * Time spent in a node but not in its children.
+ */
+static unsigned long long selfNanos(const ProfileNode* node)
+{
+    unsigned long long nanos = node->nanos;
+    for(const ProfileNode* child = node->child ; child != nullptr ; child = child->sibling)
+    {
+        nanos -= (child->nanos < nanos ? child->nanos : nanos);
+    }
+    return nanos;
+}
+
+struct ProfileTotals
+{
+    string name;
+    unsigned long long calls;
+    unsigned long long nanos;
+    unsigned long long self;
+};
+
+static void accumulate(const ProfileNode* node, map<const MathFunction*, ProfileTotals>& totals)
+{
+    for(const ProfileNode* child = node->child ; child != nullptr ; child = child->sibling)
+    {
+        ProfileTotals& entry = totals[child->func];
+        entry.name = child->name;
+        entry.calls += child->calls;
+        // A function never calls itself, thus summing inclusive time over its paths counts nothing twice.
+        entry.nanos += child->nanos;
+        entry.self += selfNanos(child);
+        accumulate(child, totals);
+    }
+}
+
+unsigned long long Profiler::getExecutedCount(int opcode)
+{
+    unsigned long long count = 0;
+    for(ProfileCollector* collector = COLLECTORS.load() ; collector != nullptr ; collector = collector->next)
+    {
+        count += collector->counts[opcode];
+    }
+    return count;
+}
+
+unsigned long long Profiler::getSampledCount(int opcode)
+{
+    unsigned long long count = 0;
+    for(ProfileCollector* collector = COLLECTORS.load() ; collector != nullptr ; collector = collector->next)
+    {
+        count += collector->samples[opcode];
+    }
+    return count;
+}
+
+void Profiler::printFlatReport(FILE* out)
+{
+    unsigned long long counts[OPCODE_COUNT] = {0};
+    unsigned long long samples[OPCODE_COUNT] = {0};
+    unsigned long long rows[OPCODE_COUNT] = {0};
+    unsigned long long nanos[OPCODE_COUNT] = {0};
+    map<const MathFunction*, ProfileTotals> totals;
+    for(ProfileCollector* collector = COLLECTORS.load() ; collector != nullptr ; collector = collector->next)
+    {
+        for(int i = 0 ; i < OPCODE_COUNT ; i++)
+        {
+            counts[i] += collector->counts[i];
+            samples[i] += collector->samples[i];
+            rows[i] += collector->sampledRows[i];
+            nanos[i] += collector->sampledNanos[i];
+        }
+        accumulate(&(collector->root), totals);
+    }
+    
+    fprintf(out, "%-16s %16s %14s %10s\n", "opcode", "executed", "est. ms", "ns/op");
+    for(int i = 0 ; i < OPCODE_COUNT ; i++)
+    {
+        if(counts[i] == 0)
+        {
+            continue;
+        }
+        // Time of unsampled instructions is extrapolated from the sampled ones, less the cost of reading the clock.
+        double perOp = (rows[i] > 0 ? (nanos[i] - clockOverhead() * samples[i]) / rows[i] : 0.0);
+        perOp = (perOp > 0 ? perOp : 0.0);
+        fprintf(out, "%-16s %16llu %14.3f %10.1f\n", OPCODE_NAMES[i], counts[i], perOp * counts[i] / 1e6, perOp);
+    }
+    
+    vector<ProfileTotals> sorted;
+    for(map<const MathFunction*, ProfileTotals>::const_iterator it = totals.begin() ; it != totals.end() ; it++)
+    {
+        sorted.push_back(it->second);
+    }
+    sort(sorted.begin(), sorted.end(), [](const ProfileTotals& a, const ProfileTotals& b) { return a.self > b.self; });
+    
+    fprintf(out, "\n%-24s %12s %14s %14s\n", "function", "calls", "total ms", "self ms");
+    for(size_t i = 0 ; i < sorted.size() ; i++)
+    {
+        fprintf(out, "%-24s %12llu %14.3f %14.3f\n", sorted[i].name.c_str(), sorted[i].calls, sorted[i].nanos / 1e6, sorted[i].self / 1e6);
+    }
+}
+
+static void printNode(FILE* out, const ProfileNode* node, int depth)
+{
+    for(const ProfileNode* child = node->child ; child != nullptr ; child = child->sibling)
+    {
+        fprintf(out, "%*s%-*s %12llu %14.3f %14.3f\n", depth * 2, "", 40 - depth * 2 > 0 ? 40 - depth * 2 : 1, child->name.c_str(), child->calls, child->nanos / 1e6, selfNanos(child) / 1e6);
+        printNode(out, child, depth + 1);
+    }
+}
+
+void Profiler::printCallTreeReport(FILE* out)
+{
+    fprintf(out, "%-40s %12s %14s %14s\n", "call path", "calls", "total ms", "self ms");
+    for(ProfileCollector* collector = COLLECTORS.load() ; collector != nullptr ; collector = collector->next)
+    {
+        printNode(out, &(collector->root), 0);
+    }
+}
+
+ProfileCall::ProfileCall(const MathFunction* func) : collector(nullptr), node(nullptr)
+{
+    if(Profiler::isEnabled())
+    {
+        this->collector = Profiler::getCollector();
+        this->node = this->collector->enter(func);
+        this->start = Clock::now();
+    }
+}
+
+ProfileCall::~ProfileCall()
+{
+    if(this->collector != nullptr)
+    {
+        this->node->nanos += chrono::duration_cast<chrono::nanoseconds>(Clock::now() - this->start).count();
+        this->node->calls++;
+        this->collector->current = this->node->parent;
+    }
+}
+
+ProfileInstruction::ProfileInstruction(int _opcode, int _rows) : collector(nullptr), opcode(_opcode), rows(_rows)
+{
+    if(Profiler::isEnabled())
+    {
+        ProfileCollector* _collector = Profiler::getCollector();
+        _collector->counts[_opcode] += _rows;
+        if(--(_collector->countdown) == 0)
+        {
+            _collector->countdown = _collector->draw();
+            this->collector = _collector;
+            this->start = Clock::now();
+        }
+    }
+}
+
+ProfileInstruction::~ProfileInstruction()
+{
+    if(this->collector != nullptr)
+    {
+        this->collector->sampledNanos[this->opcode] += chrono::duration_cast<chrono::nanoseconds>(Clock::now() - this->start).count();
+        this->collector->samples[this->opcode]++;
+        this->collector->sampledRows[this->opcode] += this->rows;
+    }
+}
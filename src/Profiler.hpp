@@ -0,0 +1,147 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+
+#include "Operators.hpp"
+
+#ifndef __TANGENT_MATH_FUNC__PROFILER
+#define __TANGENT_MATH_FUNC__PROFILER 65536
+
+class MathFunction;
+
+class ProfileCollector;
+
+struct ProfileNode;
+
+/*
+ * Evaluation profiler. Counts executed instructions per opcode with sampled timings, and calls per MathFunction
+ *  arranged as a call tree with inclusive and self time.
+ *
+ * The hooks are only compiled in when TANGENT_MATH_FUNC_PROFILE is defined, otherwise evaluation carries no profiling code at all.
+ *  Even then, nothing is recorded until Profiler::setEnabled(true) is called.
+ *  Since inlined callees leave no calls behind, profiled builds do not inline, so that every user-defined function appears in the call tree.
+ *
+ * Each thread records into its own collector. Reports and reset() MUST NOT run concurrently with evaluation.
+ */
+class Profiler
+{
+    private:
+        static std::atomic<bool> ENABLED;
+        
+        /*
+         * All collectors ever created, including those of finished threads.
+         */
+        static std::atomic<ProfileCollector*> COLLECTORS;
+        
+        Profiler();
+    
+    public:
+        /*
+         * One instruction out of this many is timed, on average. The distance to the next timed instruction is drawn
+         *  at random from 1 to twice this less 1, so that sampling does not follow a formula whose instructions repeat
+         *  with a period dividing it, which would time the same few opcodes only.
+         */
+        static const unsigned int SAMPLE_INTERVAL = 64;
+        
+        /*
+         * True if the library was built with TANGENT_MATH_FUNC_PROFILE.
+         */
+        static bool isAvailable();
+        
+        static void setEnabled(bool enabled);
+        
+        static bool isEnabled()
+        {
+            return ENABLED.load(std::memory_order_relaxed);
+        }
+        
+        /*
+         * Drop everything recorded so far.
+         */
+        static void reset();
+        
+        /*
+         * Instructions of an opcode executed so far by every thread, each row of a batch counting as one.
+         */
+        static unsigned long long getExecutedCount(int opcode);
+        
+        /*
+         * Instructions of an opcode timed so far by every thread, a batch instruction counting as one.
+         */
+        static unsigned long long getSampledCount(int opcode);
+        
+        /*
+         * Per-opcode counts and estimated time, followed by per-function calls, inclusive and self time, slowest first.
+         */
+        static void printFlatReport(FILE* out);
+        
+        /*
+         * Calls and time of every distinct call path, indented by depth.
+         */
+        static void printCallTreeReport(FILE* out);
+        
+        /*
+         * Collector of the calling thread, created on first use.
+         */
+        static ProfileCollector* getCollector();
+};
+
+/*
+ * Times one call of a MathFunction and places it in the call tree. Used through PROFILE_CALL().
+ */
+class ProfileCall
+{
+    private:
+        ProfileCollector* collector;
+        
+        ProfileNode* node;
+        
+        std::chrono::steady_clock::time_point start;
+    
+    public:
+        ProfileCall(const MathFunction* func);
+        
+        ~ProfileCall();
+};
+
+/*
+ * Counts one executed instruction and times a sample of them. Used through PROFILE_INSTRUCTION().
+ */
+class ProfileInstruction
+{
+    private:
+        ProfileCollector* collector;
+        
+        int opcode;
+        
+        int rows;
+        
+        std::chrono::steady_clock::time_point start;
+    
+    public:
+        /*
+         * Param(s):
+         *    rows    -> Number of rows the instruction is applied to, 1 unless evaluating a batch.
+         */
+        ProfileInstruction(int opcode, int rows);
+        
+        ~ProfileInstruction();
+};
+
+#ifdef TANGENT_MATH_FUNC_PROFILE
+#define PROFILE_CALL(func) ProfileCall __profileCall(func)
+#define PROFILE_INSTRUCTION(opcode, rows) ProfileInstruction __profileInstruction(opcode, rows)
+#else
+#define PROFILE_CALL(func)
+#define PROFILE_INSTRUCTION(opcode, rows)
+#endif
+
+#endif
@@ -0,0 +1,1988 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <math.h>
+#include <string.h>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "misc/TFException.hpp"
+#include "Operators.hpp"
+#include "Profiler.hpp"
+#include "Program.hpp"
+#include "RegisterProgram.hpp"
+#include "TangentsMathFunc.hpp"
+
+/*
+ * Fused where the target has a fast fma(), otherwise rounded twice like the operations it replaces. FP_FAST_FMA is only
+ *  defined when the instruction set has one, e.g. with -mfma or -march=native on x86-64, so a plain -O2 build never fuses.
+ *  Defining TANGENT_MATH_FUNC_FMA fuses on every target, through a software fma() where there is no instruction for it.
+ */
+#if defined(FP_FAST_FMA) || defined(TANGENT_MATH_FUNC_FMA)
+#define MULTIPLY_ADD(a, b, c) fma(a, b, c)
+#else
+#define MULTIPLY_ADD(a, b, c) ((a) * (b) + (c))
+#endif
+
+/*
+ * Handlers of execute(). Under threaded dispatch, each one jumps to the next, and the last instruction out of the code.
+ */
+#ifdef TANGENT_MATH_FUNC_THREADED_DISPATCH
+#define HANDLE(op) HANDLE_##op:
+#define NEXT() if(++ins == end) goto finished; goto *(ins->handler)
+
+static const void* const* HANDLERS = nullptr;
+#else
+#define HANDLE(op) case OPCODE_##op:
+#define NEXT() break
+#endif
+
+double GridAxis::at(int i) const
+{
+    return (this->count == 1 ? this->start : this->start + (this->stop - this->start) * i / (this->count - 1));
+}
+
+Program::Program()
+{
+    this->arena = nullptr;
+    this->code = nullptr;
+    this->length = 0;
+    this->varCount = 0;
+    this->frameSize = 0;
+    this->stackSize = 0;
+    this->valid = true;
+    this->depth = 0;
+    this->optimize = true;
+    this->registers = nullptr;
+}
+
+Program::~Program()
+{
+}
+
+void Program::release(Program* prog)
+{
+    if(prog == nullptr)
+    {
+        return;
+    }
+    RegisterProgram::release(prog->registers);
+    Arena* arena = prog->arena;
+    prog->~Program();
+    delete arena;
+}
+
+bool Program::isInlinable(const MathFunction* callee)
+{
+#ifdef TANGENT_MATH_FUNC_PROFILE
+    // Keep every call visible to the profiler.
+    return false;
+#endif
+    const Program* prog = callee->program;
+    if(prog == nullptr || !(prog->valid) || prog->length > MAX_INLINE_LENGTH)
+    {
+        return false;
+    }
+    
+    // Reductions read their arrays from consecutive frame slots, which inlined arguments are not guaranteed to be.
+    for(int i = 0 ; i < prog->length ; i++)
+    {
+        if(isReduction(prog->code[i].opcode))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Program::isReduction(int opcode)
+{
+    return (opcode >= OPCODE_SUM && opcode <= OPCODE_MAXIMUM);
+}
+
+int Program::getArity(int opcode)
+{
+    switch(opcode)
+    {
+        case OPCODE_NEGATIVE:
+        case OPCODE_NOT:
+            return 1;
+        case OPCODE_MULTIPLY_ADD:
+        case OPCODE_SELECT:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
+double Program::reduce(int opcode, const double* lhs, const double* rhs, int length)
+{
+    double acc = (opcode == OPCODE_DOT ? lhs[0] * rhs[0] : lhs[0]);
+    for(int k = 1 ; k < length ; k++)
+    {
+        double v = lhs[k];
+        switch(opcode)
+        {
+            case OPCODE_SUM:
+                acc += v;
+                break;
+            case OPCODE_PRODUCT:
+                acc *= v;
+                break;
+            case OPCODE_DOT:
+                acc += v * rhs[k];
+                break;
+            // NaN wins either way, like it does in arithmetic.
+            case OPCODE_MINIMUM:
+                acc = (v < acc || v != v ? v : acc);
+                break;
+            case OPCODE_MAXIMUM:
+                acc = (v > acc || v != v ? v : acc);
+                break;
+        }
+    }
+    return acc;
+}
+
+void Program::reduce(int opcode, const double* const* lhs, const double* const* rhs, int length, int count, double* dst)
+{
+    const double* a = lhs[0];
+    if(opcode == OPCODE_DOT)
+    {
+        const double* b = rhs[0];
+        for(int i = 0 ; i < count ; i++)
+        {
+            dst[i] = a[i] * b[i];
+        }
+    }
+    else
+    {
+        memcpy(dst, a, count * sizeof(double));
+    }
+    for(int k = 1 ; k < length ; k++)
+    {
+        a = lhs[k];
+        switch(opcode)
+        {
+            case OPCODE_SUM:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] += a[i];
+                }
+                break;
+            case OPCODE_PRODUCT:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] *= a[i];
+                }
+                break;
+            case OPCODE_DOT:
+            {
+                const double* b = rhs[k];
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] += a[i] * b[i];
+                }
+                break;
+            }
+            case OPCODE_MINIMUM:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = (a[i] < dst[i] || a[i] != a[i] ? a[i] : dst[i]);
+                }
+                break;
+            case OPCODE_MAXIMUM:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = (a[i] > dst[i] || a[i] != a[i] ? a[i] : dst[i]);
+                }
+                break;
+        }
+    }
+}
+
+void Program::compare(int opcode, const double* lhs, const double* rhs, int count, double* dst)
+{
+    switch(opcode)
+    {
+        case OPCODE_LESS:
+            for(int i = 0 ; i < count ; i++)
+            {
+                dst[i] = (lhs[i] < rhs[i] ? 1.0 : 0.0);
+            }
+            break;
+        case OPCODE_LESS_EQUAL:
+            for(int i = 0 ; i < count ; i++)
+            {
+                dst[i] = (lhs[i] <= rhs[i] ? 1.0 : 0.0);
+            }
+            break;
+        case OPCODE_GREATER:
+            for(int i = 0 ; i < count ; i++)
+            {
+                dst[i] = (lhs[i] > rhs[i] ? 1.0 : 0.0);
+            }
+            break;
+        case OPCODE_GREATER_EQUAL:
+            for(int i = 0 ; i < count ; i++)
+            {
+                dst[i] = (lhs[i] >= rhs[i] ? 1.0 : 0.0);
+            }
+            break;
+        case OPCODE_EQUAL:
+            for(int i = 0 ; i < count ; i++)
+            {
+                dst[i] = (lhs[i] == rhs[i] ? 1.0 : 0.0);
+            }
+            break;
+        case OPCODE_NOT_EQUAL:
+            for(int i = 0 ; i < count ; i++)
+            {
+                dst[i] = (lhs[i] != rhs[i] ? 1.0 : 0.0);
+            }
+            break;
+        case OPCODE_AND:
+            for(int i = 0 ; i < count ; i++)
+            {
+                dst[i] = ((lhs[i] != 0) & (rhs[i] != 0) ? 1.0 : 0.0);
+            }
+            break;
+        case OPCODE_OR:
+            for(int i = 0 ; i < count ; i++)
+            {
+                dst[i] = ((lhs[i] != 0) | (rhs[i] != 0) ? 1.0 : 0.0);
+            }
+            break;
+    }
+}
+
+double Program::evaluate(int opcode, double lhs, double rhs)
+{
+    switch(opcode)
+    {
+        case OPCODE_NEGATIVE:
+            return -rhs;
+        case OPCODE_ADDITION:
+            return lhs + rhs;
+        case OPCODE_NEGATION:
+            return lhs - rhs;
+        case OPCODE_MULTIPLICATION:
+            return lhs * rhs;
+        case OPCODE_DIVISION:
+            if(rhs == 0)
+            {
+                throw DividedByZeroException();
+            }
+            return lhs / rhs;
+        case OPCODE_MODDING:
+            if(rhs == 0)
+            {
+                throw DividedByZeroException();
+            }
+            return fmod(lhs, rhs);
+        case OPCODE_POWER:
+            return pow(lhs, rhs);
+        case OPCODE_LESS:
+            return (lhs < rhs ? 1 : 0);
+        case OPCODE_LESS_EQUAL:
+            return (lhs <= rhs ? 1 : 0);
+        case OPCODE_GREATER:
+            return (lhs > rhs ? 1 : 0);
+        case OPCODE_GREATER_EQUAL:
+            return (lhs >= rhs ? 1 : 0);
+        case OPCODE_EQUAL:
+            return (lhs == rhs ? 1 : 0);
+        case OPCODE_NOT_EQUAL:
+            return (lhs != rhs ? 1 : 0);
+        case OPCODE_AND:
+            return (lhs != 0 && rhs != 0 ? 1 : 0);
+        case OPCODE_OR:
+            return (lhs != 0 || rhs != 0 ? 1 : 0);
+        case OPCODE_NOT:
+            return (rhs == 0 ? 1 : 0);
+        default:
+            return nan("");
+    }
+}
+
+void Program::emit(int opcode, int index, double value, const MathFunction* func)
+{
+    Instruction& ins = this->code[this->length++];
+    ins.opcode = opcode;
+    ins.index = index;
+    ins.value = value;
+    ins.func = func;
+    ins.length = 0;
+    ins.second = 0;
+    ins.handler = getHandler(opcode);
+}
+
+void Program::emitPush(int opcode, int index, double value)
+{
+    this->emit(opcode, index, value, nullptr);
+    if(++(this->depth) > this->stackSize)
+    {
+        this->stackSize = this->depth;
+    }
+}
+
+void Program::emitStore(int index)
+{
+    if(this->depth < 1)
+    {
+        this->valid = false;
+        return;
+    }
+    this->emit(OPCODE_STORE, index, 0, nullptr);
+    this->depth--;
+}
+
+void Program::emitOperation(int opcode)
+{
+    int argc = getArity(opcode);
+    if(this->depth < argc)
+    {
+        this->valid = false;
+        return;
+    }
+    
+    // The last pushed constants are exactly the top of the operand stack, so they can be folded right away.
+    Instruction* last = this->code + this->length - 1;
+    if(!(this->optimize))
+    {
+        // Baseline tier, nothing to fold.
+    }
+    else if(argc == 1 && last->opcode == OPCODE_CONSTANT)
+    {
+        last->value = evaluate(opcode, 0, last->value);
+        return;
+    }
+    else if(argc == 2 && this->length >= 2 && last->opcode == OPCODE_CONSTANT && last[-1].opcode == OPCODE_CONSTANT)
+    {
+        try
+        {
+            last[-1].value = evaluate(opcode, last[-1].value, last->value);
+            this->length--;
+            this->depth--;
+            return;
+        }
+        catch(const DividedByZeroException& ex)
+        {
+            // Keep the operation so the exception is thrown upon invocation instead.
+        }
+    }
+    else if(argc == 3 && this->length >= 3 && last->opcode == OPCODE_CONSTANT && last[-1].opcode == OPCODE_CONSTANT && last[-2].opcode == OPCODE_CONSTANT)
+    {
+        last[-2].value = (opcode == OPCODE_SELECT ? (last[-2].value != 0 ? last[-1].value : last->value) : MULTIPLY_ADD(last[-2].value, last[-1].value, last->value));
+        this->length -= 2;
+        this->depth -= 2;
+        return;
+    }
+    
+    this->emit(opcode, 0, 0, nullptr);
+    this->depth -= argc - 1;
+}
+
+void Program::emitInvoke(const MathFunction* callee, int argc)
+{
+    if(this->depth < argc)
+    {
+        this->valid = false;
+        return;
+    }
+    
+    int constants = 0;
+    while(this->optimize && constants < argc && this->code[this->length - 1 - constants].opcode == OPCODE_CONSTANT)
+    {
+        constants++;
+    }
+    
+    // Every function is pure, thus a call with constant arguments only is a constant as well.
+    if(constants == argc)
+    {
+        double* args = new double[argc + 1];
+        for(int i = 0 ; i < argc ; i++)
+        {
+            args[i] = this->code[this->length - argc + i].value;
+        }
+        try
+        {
+            double value = callee->invoke(args);
+            this->length -= argc;
+            this->depth -= argc;
+            this->emitPush(OPCODE_CONSTANT, 0, value);
+            delete[] args;
+            return;
+        }
+        catch(const exception& ex)
+        {
+            delete[] args;
+        }
+    }
+    
+    this->emit(OPCODE_INVOKE, argc, 0, callee);
+    this->depth -= argc - 1;
+    if(this->depth > this->stackSize)
+    {
+        this->stackSize = this->depth;
+    }
+}
+
+void Program::emitReduction(int opcode, int index, int second, int length)
+{
+    this->emitPush(opcode, index, 0);
+    Instruction& ins = this->code[this->length - 1];
+    ins.length = length;
+    ins.second = second;
+}
+
+void Program::emitInline(const Program* callee, int argc)
+{
+    if(this->depth < argc)
+    {
+        this->valid = false;
+        return;
+    }
+    
+    int base = this->varCount;
+    double* bound = new double[argc + 1];
+    bool* isBound = new bool[argc + 1];
+    
+    // Arguments are stored from the top of the stack down. Trailing constants are dropped and substituted instead.
+    bool trailing = true;
+    for(int i = argc - 1 ; i >= 0 ; i--)
+    {
+        if(trailing && this->code[this->length - 1].opcode == OPCODE_CONSTANT)
+        {
+            isBound[i] = true;
+            bound[i] = this->code[this->length - 1].value;
+            this->length--;
+            this->depth--;
+        }
+        else
+        {
+            trailing = false;
+            isBound[i] = false;
+            this->emitStore(base + i);
+        }
+    }
+    
+    for(int i = 0 ; i < callee->length ; i++)
+    {
+        const Instruction& ins = callee->code[i];
+        switch(ins.opcode)
+        {
+            case OPCODE_CONSTANT:
+                this->emitPush(OPCODE_CONSTANT, 0, ins.value);
+                break;
+            case OPCODE_VARIABLE:
+                if(ins.index < argc && isBound[ins.index])
+                {
+                    this->emitPush(OPCODE_CONSTANT, 0, bound[ins.index]);
+                }
+                else
+                {
+                    this->emitPush(OPCODE_VARIABLE, base + ins.index, 0);
+                }
+                break;
+            case OPCODE_STORE:
+                this->emitStore(base + ins.index);
+                break;
+            case OPCODE_INVOKE:
+                this->emitInvoke(ins.func, ins.index);
+                break;
+            default:
+                this->emitOperation(ins.opcode);
+                break;
+        }
+    }
+    
+    if(base + callee->frameSize > this->frameSize)
+    {
+        this->frameSize = base + callee->frameSize;
+    }
+    
+    delete[] bound;
+    delete[] isBound;
+}
+
+Program* Program::allocate(int capacity)
+{
+    Arena* arena = new Arena(sizeof(Program) + capacity * sizeof(Instruction));
+    Program* prog = new(*arena) Program();
+    prog->arena = arena;
+    prog->code = (Instruction*)(arena->allocate(capacity * sizeof(Instruction)));
+    return prog;
+}
+
+void Program::emitCopy(const Instruction& ins)
+{
+    switch(ins.opcode)
+    {
+        case OPCODE_CONSTANT:
+        case OPCODE_VARIABLE:
+            this->emitPush(ins.opcode, ins.index, ins.value);
+            break;
+        case OPCODE_STORE:
+            this->emitStore(ins.index);
+            break;
+        case OPCODE_INVOKE:
+            this->emitInvoke(ins.func, ins.index);
+            break;
+        case OPCODE_SUM:
+        case OPCODE_PRODUCT:
+        case OPCODE_DOT:
+        case OPCODE_MINIMUM:
+        case OPCODE_MAXIMUM:
+            this->emitReduction(ins.opcode, ins.index, ins.second, ins.length);
+            break;
+        default:
+            this->emitOperation(ins.opcode);
+            break;
+    }
+}
+
+void Program::split(int inner, Program*& outer, Program*& body, int*& patches, int& hoisted) const
+{
+    // First pass: simulate the operand stack, tracking which values vary with the inner variable.
+    bool* varying = new bool[this->length + 1];
+    int* hoist = new int[this->length + 1];
+    int* stackIns = new int[this->stackSize + 1];
+    bool* stackVarying = new bool[this->stackSize + 1];
+    bool* slotVarying = new bool[this->frameSize + 1];
+    for(int i = 0 ; i < this->frameSize ; i++)
+    {
+        slotVarying[i] = (i == inner);
+    }
+    int top = -1;
+    hoisted = 0;
+    for(int i = 0 ; i < this->length ; i++)
+    {
+        const Instruction& ins = this->code[i];
+        hoist[i] = -1;
+        int argc = 0;
+        switch(ins.opcode)
+        {
+            case OPCODE_CONSTANT:
+                varying[i] = false;
+                break;
+            case OPCODE_VARIABLE:
+                varying[i] = slotVarying[ins.index];
+                break;
+            case OPCODE_SUM:
+            case OPCODE_PRODUCT:
+            case OPCODE_DOT:
+            case OPCODE_MINIMUM:
+            case OPCODE_MAXIMUM:
+                varying[i] = false;
+                for(int k = 0 ; k < ins.length ; k++)
+                {
+                    varying[i] = varying[i] || slotVarying[ins.index + k] || (ins.opcode == OPCODE_DOT && slotVarying[ins.second + k]);
+                }
+                break;
+            case OPCODE_STORE:
+                varying[i] = stackVarying[top--];
+                slotVarying[ins.index] = varying[i];
+                continue;
+            case OPCODE_NEGATIVE:
+            case OPCODE_NOT:
+                argc = 1;
+                break;
+            case OPCODE_INVOKE:
+                argc = ins.index;
+                break;
+            case OPCODE_MULTIPLY_ADD:
+            case OPCODE_SELECT:
+                argc = 3;
+                break;
+            default:
+                argc = 2;
+                break;
+        }
+        if(argc > 0)
+        {
+            varying[i] = false;
+            for(int j = top - argc + 1 ; j <= top ; j++)
+            {
+                varying[i] = varying[i] || stackVarying[j];
+            }
+            // Invariant operands of a varying instruction are computed once per outer index, then read as constants.
+            for(int j = top - argc + 1 ; varying[i] && j <= top ; j++)
+            {
+                if(!stackVarying[j])
+                {
+                    hoist[stackIns[j]] = (this->code[stackIns[j]].opcode == OPCODE_CONSTANT ? HOIST_CONSTANT : hoisted++);
+                }
+            }
+            top -= argc;
+        }
+        top++;
+        stackIns[top] = i;
+        stackVarying[top] = varying[i];
+    }
+    if(!stackVarying[0])
+    {
+        hoist[stackIns[0]] = (this->code[stackIns[0]].opcode == OPCODE_CONSTANT ? HOIST_CONSTANT : hoisted++);
+    }
+    
+    // Second pass: invariant instructions go to the outer program, which stores every hoisted value behind the frame.
+    outer = allocate(this->length + hoisted);
+    outer->varCount = this->varCount;
+    outer->frameSize = this->frameSize + hoisted;
+    outer->optimize = false;
+    body = allocate(this->length);
+    body->varCount = this->varCount;
+    body->frameSize = this->frameSize;
+    body->optimize = false;
+    patches = new int[hoisted + 1];
+    for(int i = 0 ; i < this->length ; i++)
+    {
+        const Instruction& ins = this->code[i];
+        if(varying[i])
+        {
+            body->emitCopy(ins);
+        }
+        else if(hoist[i] == HOIST_CONSTANT)
+        {
+            // Plain constants are moved as they are.
+            body->emitCopy(ins);
+        }
+        else
+        {
+            outer->emitCopy(ins);
+            if(hoist[i] >= 0)
+            {
+                outer->emitStore(this->frameSize + hoist[i]);
+                patches[hoist[i]] = body->length;
+                body->emitPush(OPCODE_CONSTANT, 0, 0);
+            }
+        }
+    }
+    
+    delete[] varying;
+    delete[] hoist;
+    delete[] stackIns;
+    delete[] stackVarying;
+    delete[] slotVarying;
+}
+
+/*
+ * A polynomial in frame slots: a sum of terms, each a coefficient times positive integer powers of slots.
+ *  Built from a polynomial subexpression of a program, then emitted back in multivariate Horner form.
+ *
+ * Products are distributed only over a single term, and powers are expanded only for a single term, so that no
+ *  cancellation is introduced: other products and powers of sums store each sum into a fresh frame slot instead.
+ *  Like terms are combined, but terms are never dropped, so that NaN and infinite values still propagate.
+ */
+class Polynomial
+{
+    private:
+        /*
+         * Exponent of each slot of a term.
+         */
+        typedef map<int, int> Powers;
+        
+        /*
+         * Coefficient of each term.
+         */
+        map<Powers, double> terms;
+        
+    public:
+        /*
+         * Sums stored into fresh slots, in the order they have to be computed.
+         */
+        struct Context
+        {
+            int nextSlot;
+            vector<pair<int, Polynomial> > stored;
+            
+            /*
+             * Set once an exponent exceeds MAX_POLYNOMIAL_DEGREE, which aborts the rewrite.
+             */
+            bool overflow;
+        };
+        
+        static Polynomial constant(double value)
+        {
+            Polynomial poly;
+            poly.terms[Powers()] = value;
+            return poly;
+        }
+        
+        static Polynomial variable(int slot)
+        {
+            Polynomial poly;
+            Powers powers;
+            powers[slot] = 1;
+            poly.terms[powers] = 1;
+            return poly;
+        }
+        
+        void add(const Polynomial& other, double sign)
+        {
+            for(const pair<const Powers, double>& term : other.terms)
+            {
+                this->terms[term.first] += sign * term.second;
+            }
+        }
+        
+        void negate()
+        {
+            for(pair<const Powers, double>& term : this->terms)
+            {
+                term.second = -term.second;
+            }
+        }
+        
+        /*
+         * Replace a sum by a fresh slot holding it.
+         */
+        void store(Context& ctx)
+        {
+            if(this->terms.size() > 1)
+            {
+                int slot = ctx.nextSlot++;
+                ctx.stored.push_back(make_pair(slot, *this));
+                *this = variable(slot);
+            }
+        }
+        
+        static Polynomial multiply(Polynomial lhs, Polynomial rhs, Context& ctx)
+        {
+            if(lhs.terms.size() > 1 && rhs.terms.size() > 1)
+            {
+                lhs.store(ctx);
+                rhs.store(ctx);
+            }
+            Polynomial product;
+            for(const pair<const Powers, double>& a : lhs.terms)
+            {
+                for(const pair<const Powers, double>& b : rhs.terms)
+                {
+                    Powers powers = a.first;
+                    for(const pair<const int, int>& power : b.first)
+                    {
+                        if((powers[power.first] += power.second) > Program::MAX_POLYNOMIAL_DEGREE)
+                        {
+                            ctx.overflow = true;
+                        }
+                    }
+                    product.terms[powers] += a.second * b.second;
+                }
+            }
+            return product;
+        }
+        
+        static Polynomial power(Polynomial base, int exponent, Context& ctx)
+        {
+            if(exponent > 1)
+            {
+                base.store(ctx);
+            }
+            Polynomial result = constant(1);
+            for(int i = 0 ; i < exponent ; i++)
+            {
+                result = multiply(result, base, ctx);
+            }
+            return result;
+        }
+        
+        /*
+         * Convert the polynomial subexpression ending at instruction "i".
+         *
+         * Param(s):
+         *    operands    -> Instructions computing the operands of each instruction, three per instruction.
+         */
+        static Polynomial build(const Program* prog, const int* operands, int i, Context& ctx)
+        {
+            const Instruction& ins = prog->code[i];
+            const int* args = operands + 3 * i;
+            Polynomial poly;
+            switch(ins.opcode)
+            {
+                case OPCODE_CONSTANT:
+                    return constant(ins.value);
+                case OPCODE_VARIABLE:
+                    return variable(ins.index);
+                case OPCODE_NEGATIVE:
+                    poly = build(prog, operands, args[0], ctx);
+                    poly.negate();
+                    return poly;
+                case OPCODE_ADDITION:
+                case OPCODE_NEGATION:
+                    poly = build(prog, operands, args[0], ctx);
+                    poly.add(build(prog, operands, args[1], ctx), (ins.opcode == OPCODE_ADDITION ? 1 : -1));
+                    return poly;
+                case OPCODE_MULTIPLICATION:
+                    return multiply(build(prog, operands, args[0], ctx), build(prog, operands, args[1], ctx), ctx);
+                case OPCODE_POWER:
+                    return power(build(prog, operands, args[0], ctx), (int)(prog->code[args[1]].value), ctx);
+                case OPCODE_MULTIPLY_ADD:
+                    poly = multiply(build(prog, operands, args[0], ctx), build(prog, operands, args[1], ctx), ctx);
+                    poly.add(build(prog, operands, args[2], ctx), 1);
+                    return poly;
+                default:
+                    return poly;
+            }
+        }
+        
+        /*
+         * Upper bound of the instructions emit() produces, stored sums included.
+         */
+        int getCodeBound(const Context& ctx) const
+        {
+            int bound = 4;
+            for(const pair<int, Polynomial>& stored : ctx.stored)
+            {
+                bound += stored.second.getCodeBound() + 1;
+            }
+            return bound + this->getCodeBound();
+        }
+        
+        int getCodeBound() const
+        {
+            int bound = 4;
+            for(const pair<const Powers, double>& term : this->terms)
+            {
+                bound += 4;
+                for(const pair<const int, int>& power : term.first)
+                {
+                    bound += 4 * power.second;
+                }
+            }
+            return bound;
+        }
+        
+        /*
+         * Emit the Horner form of a list of terms. Takes the slot occurring in most terms, the highest exponent among equals,
+         *  groups the terms by its exponent, and recurses into the coefficient of each exponent:
+         *  sum(x^k * q_k) = (...(q_n * x + q_(n-1)) * x + ...) * x + q_0
+         */
+        static void emit(Program* out, const vector<pair<Powers, double> >& terms)
+        {
+            map<int, pair<int, int> > occurrences;
+            for(const pair<Powers, double>& term : terms)
+            {
+                for(const pair<const int, int>& power : term.first)
+                {
+                    pair<int, int>& occurrence = occurrences[power.first];
+                    occurrence.first++;
+                    occurrence.second = max(occurrence.second, power.second);
+                }
+            }
+            if(occurrences.empty())
+            {
+                double sum = 0;
+                for(const pair<Powers, double>& term : terms)
+                {
+                    sum += term.second;
+                }
+                out->emitPush(OPCODE_CONSTANT, 0, sum);
+                return;
+            }
+            
+            int slot = occurrences.begin()->first;
+            pair<int, int> best = occurrences.begin()->second;
+            for(const pair<const int, pair<int, int> >& occurrence : occurrences)
+            {
+                if(occurrence.second > best)
+                {
+                    slot = occurrence.first;
+                    best = occurrence.second;
+                }
+            }
+            
+            map<int, vector<pair<Powers, double> >, greater<int> > groups;
+            for(const pair<Powers, double>& term : terms)
+            {
+                Powers powers = term.first;
+                Powers::iterator found = powers.find(slot);
+                int exponent = 0;
+                if(found != powers.end())
+                {
+                    exponent = found->second;
+                    powers.erase(found);
+                }
+                groups[exponent].push_back(make_pair(powers, term.second));
+            }
+            
+            // Index of the accumulator while it is still the leading coefficient alone, as a constant.
+            int leading = -1;
+            int previous = -1;
+            for(const pair<const int, vector<pair<Powers, double> > >& group : groups)
+            {
+                if(previous < 0)
+                {
+                    int mark = out->length;
+                    emit(out, group.second);
+                    if(out->length == mark + 1 && out->code[mark].opcode == OPCODE_CONSTANT)
+                    {
+                        leading = mark;
+                    }
+                    previous = group.first;
+                    continue;
+                }
+                for(int i = group.first + 1 ; i < previous ; i++)
+                {
+                    out->emitPush(OPCODE_VARIABLE, slot, 0);
+                    out->emitOperation(OPCODE_MULTIPLICATION);
+                    leading = -1;
+                }
+                
+                // A leading coefficient of 1 or -1 needs no multiplication.
+                if(leading >= 0 && (out->code[leading].value == 1 || out->code[leading].value == -1))
+                {
+                    bool negative = (out->code[leading].value == -1);
+                    out->length--;
+                    out->depth--;
+                    if(negative)
+                    {
+                        emit(out, group.second);
+                        out->emitPush(OPCODE_VARIABLE, slot, 0);
+                        out->emitOperation(OPCODE_NEGATION);
+                    }
+                    else
+                    {
+                        out->emitPush(OPCODE_VARIABLE, slot, 0);
+                        emit(out, group.second);
+                        out->emitOperation(OPCODE_ADDITION);
+                    }
+                }
+                else
+                {
+                    out->emitPush(OPCODE_VARIABLE, slot, 0);
+                    emit(out, group.second);
+                    out->emitOperation(OPCODE_MULTIPLY_ADD);
+                }
+                leading = -1;
+                previous = group.first;
+            }
+            for(int i = 0 ; i < previous ; i++)
+            {
+                out->emitPush(OPCODE_VARIABLE, slot, 0);
+                out->emitOperation(OPCODE_MULTIPLICATION);
+            }
+        }
+        
+        /*
+         * Emit the stored sums first, then the polynomial itself.
+         */
+        void emit(Program* out, const Context& ctx) const
+        {
+            for(const pair<int, Polynomial>& stored : ctx.stored)
+            {
+                emit(out, vector<pair<Powers, double> >(stored.second.terms.begin(), stored.second.terms.end()));
+                out->emitStore(stored.first);
+            }
+            emit(out, vector<pair<Powers, double> >(this->terms.begin(), this->terms.end()));
+        }
+};
+
+Program* Program::factorPolynomials() const
+{
+    // Rebuild the expression tree: the operands of each instruction, where the code computing it starts, and whether it is a polynomial.
+    int* start = new int[this->length + 1];
+    int* parent = new int[this->length + 1];
+    int* operands = new int[3 * this->length + 3];
+    bool* polynomial = new bool[this->length + 1];
+    int* stackIns = new int[this->stackSize + 1];
+    int top = -1;
+    for(int i = 0 ; i < this->length ; i++)
+    {
+        const Instruction& ins = this->code[i];
+        start[i] = i;
+        parent[i] = -1;
+        polynomial[i] = false;
+        int argc = 0;
+        switch(ins.opcode)
+        {
+            case OPCODE_CONSTANT:
+            case OPCODE_VARIABLE:
+                polynomial[i] = true;
+                break;
+            case OPCODE_SUM:
+            case OPCODE_PRODUCT:
+            case OPCODE_DOT:
+            case OPCODE_MINIMUM:
+            case OPCODE_MAXIMUM:
+                break;
+            case OPCODE_STORE:
+                top--;
+                continue;
+            case OPCODE_NEGATIVE:
+            case OPCODE_NOT:
+                argc = 1;
+                break;
+            case OPCODE_INVOKE:
+                argc = ins.index;
+                break;
+            case OPCODE_MULTIPLY_ADD:
+            case OPCODE_SELECT:
+                argc = 3;
+                break;
+            default:
+                argc = 2;
+                break;
+        }
+        
+        // Operands of a polynomial are polynomials computed right after each other, with no store in between.
+        bool contiguous = true;
+        bool operandsPolynomial = true;
+        int end = i - 1;
+        for(int j = argc - 1 ; j >= 0 ; j--)
+        {
+            int operand = stackIns[top - argc + 1 + j];
+            if(j < 3)
+            {
+                operands[3 * i + j] = operand;
+            }
+            parent[operand] = i;
+            operandsPolynomial = operandsPolynomial && polynomial[operand];
+            contiguous = contiguous && (operand == end);
+            end = start[operand] - 1;
+        }
+        if(argc > 0)
+        {
+            start[i] = start[stackIns[top - argc + 1]];
+        }
+        switch(ins.opcode)
+        {
+            case OPCODE_NEGATIVE:
+            case OPCODE_ADDITION:
+            case OPCODE_NEGATION:
+            case OPCODE_MULTIPLICATION:
+            case OPCODE_MULTIPLY_ADD:
+                polynomial[i] = operandsPolynomial && contiguous;
+                break;
+            case OPCODE_POWER:
+            {
+                const Instruction& exponent = this->code[operands[3 * i + 1]];
+                polynomial[i] = operandsPolynomial && contiguous && exponent.opcode == OPCODE_CONSTANT
+                        && exponent.value >= 0 && exponent.value <= MAX_POLYNOMIAL_DEGREE && exponent.value == floor(exponent.value);
+                break;
+            }
+        }
+        top -= argc;
+        stackIns[++top] = i;
+    }
+    
+    // Rewrite the largest polynomials, each into a program of its own first.
+    Program** rewritten = new Program*[this->length + 1];
+    int* ends = new int[this->length + 1];
+    int frameSize = this->frameSize;
+    int count = 0;
+    int total = this->length;
+    for(int i = 0 ; i < this->length ; i++)
+    {
+        rewritten[i] = nullptr;
+        if(!polynomial[i] || (parent[i] >= 0 && polynomial[parent[i]]) || start[i] == i)
+        {
+            continue;
+        }
+        
+        Polynomial::Context ctx;
+        ctx.nextSlot = frameSize;
+        ctx.overflow = false;
+        Polynomial poly = Polynomial::build(this, operands, i, ctx);
+        if(ctx.overflow)
+        {
+            continue;
+        }
+        
+        int cost = i - start[i] + 1;
+        for(int j = start[i] ; j <= i ; j++)
+        {
+            cost += (this->code[j].opcode == OPCODE_POWER ? POWER_COST - 1 : 0);
+        }
+        Program* factored = allocate(poly.getCodeBound(ctx));
+        poly.emit(factored, ctx);
+        if(factored->length < cost)
+        {
+            rewritten[start[i]] = factored;
+            ends[start[i]] = i;
+            frameSize = ctx.nextSlot;
+            total += factored->length;
+            count++;
+        }
+        else
+        {
+            release(factored);
+        }
+    }
+    
+    Program* prog = nullptr;
+    if(count > 0)
+    {
+        prog = allocate(total);
+        prog->varCount = this->varCount;
+        prog->frameSize = frameSize;
+        for(int i = 0 ; i < this->length ; i++)
+        {
+            Program* factored = rewritten[i];
+            if(factored == nullptr)
+            {
+                prog->emitCopy(this->code[i]);
+                continue;
+            }
+            for(int j = 0 ; j < factored->length ; j++)
+            {
+                prog->emitCopy(factored->code[j]);
+            }
+            // The factored code replaces the whole polynomial.
+            i = ends[i];
+            release(factored);
+        }
+        if(prog->depth != 1)
+        {
+            prog->valid = false;
+        }
+    }
+    
+    delete[] start;
+    delete[] parent;
+    delete[] operands;
+    delete[] polynomial;
+    delete[] stackIns;
+    delete[] rewritten;
+    delete[] ends;
+    return prog;
+}
+
+Program* Program::compile(const MathFunction& func, bool optimize)
+{
+    Program* prog = emitFunction(func, optimize);
+    if(MathFunction::BACKEND == BACKEND_REGISTER)
+    {
+        prog->registers = RegisterProgram::translate(prog);
+    }
+    return prog;
+}
+
+Program* Program::emitFunction(const MathFunction& func, bool optimize)
+{
+    if(func.tabulation != nullptr)
+    {
+        // A call of the interpolant, inlined by the callers like any other short program.
+        int varCount = func.identifier->getVariablesCount();
+        Program* prog = allocate(varCount + 1);
+        prog->varCount = varCount;
+        prog->frameSize = varCount;
+        prog->optimize = optimize;
+        for(int i = 0 ; i < varCount ; i++)
+        {
+            prog->emitPush(OPCODE_VARIABLE, i, 0);
+        }
+        prog->emitInvoke(func.tabulation, varCount);
+        return prog;
+    }
+    
+    Node<const OperationElement>* tail = func.postfixOperations;
+    
+    // First pass: the length before folding is an upper bound of the final length.
+    int bound = 0;
+    Node<const OperationElement>* cache = (tail == nullptr ? nullptr : tail->getNext());
+    while(cache != nullptr)
+    {
+        const OperationElement* elem = cache->getValue();
+        if(elem->isOperator() && dynamic_cast<const Operator*>(elem)->isFunction())
+        {
+            const OperatorInvokeFunc* oif = dynamic_cast<const OperatorInvokeFunc*>(elem);
+            bound += (optimize && isInlinable(oif->func)) ? oif->varCount + oif->func->program.load()->length : 1;
+        }
+        else
+        {
+            bound++;
+        }
+        cache = cache->getNext();
+        if(cache == tail->getNext())
+        {
+            break;
+        }
+    }
+    
+    Program* prog = allocate(bound);
+    prog->varCount = func.identifier->getVariablesCount();
+    prog->frameSize = prog->varCount;
+    prog->optimize = optimize;
+    
+    if(tail == nullptr)
+    {
+        prog->valid = false;
+        return prog;
+    }
+    
+    do
+    {
+        const OperationElement* elem = cache->getValue();
+        if(elem->isOperator())
+        {
+            const Operator* op = dynamic_cast<const Operator*>(elem);
+            if(op->isFunction())
+            {
+                const OperatorInvokeFunc* oif = dynamic_cast<const OperatorInvokeFunc*>(op);
+                if(optimize && isInlinable(oif->func))
+                {
+                    prog->emitInline(oif->func->program, oif->varCount);
+                }
+                else if(func.precision == PRECISION_FAST)
+                {
+                    prog->emitInvoke(&(oif->func->approximate()), oif->varCount);
+                }
+                else
+                {
+                    prog->emitInvoke(oif->func, oif->varCount);
+                }
+            }
+            else
+            {
+                prog->emitOperation(op->getOpCode());
+            }
+        }
+        else
+        {
+            const Operand* operand = dynamic_cast<const Operand*>(elem);
+            const ReducingOperand* reduction = dynamic_cast<const ReducingOperand*>(operand);
+            if(operand->isNumeric())
+            {
+                prog->emitPush(OPCODE_CONSTANT, 0, dynamic_cast<const NumericOperand*>(operand)->getValue());
+            }
+            else if(reduction != nullptr)
+            {
+                prog->emitReduction(reduction->getOpCode(), reduction->getIndex(), reduction->getSecond(), reduction->getLength());
+            }
+            else
+            {
+                prog->emitPush(OPCODE_VARIABLE, dynamic_cast<const IndexingOperand*>(operand)->getIndex(), 0);
+            }
+        }
+        cache = cache->getNext();
+    }
+    while(prog->valid && cache != tail->getNext());
+    
+    if(prog->depth != 1)
+    {
+        prog->valid = false;
+    }
+    else if(optimize)
+    {
+        Program* factored = prog->factorPolynomials();
+        if(factored != nullptr)
+        {
+            release(prog);
+            prog = factored;
+        }
+    }
+    return prog;
+}
+
+double Program::execute(const double* operands, double* memory) const
+{
+#ifdef TANGENT_MATH_FUNC_THREADED_DISPATCH
+    static const void* const LABELS[OPCODE_COUNT] = {
+        &&HANDLE_CONSTANT, &&HANDLE_VARIABLE, &&HANDLE_STORE, &&HANDLE_NEGATIVE, &&HANDLE_ADDITION, &&HANDLE_NEGATION,
+        &&HANDLE_MULTIPLICATION, &&HANDLE_DIVISION, &&HANDLE_MODDING, &&HANDLE_POWER, &&HANDLE_INVOKE, &&HANDLE_MULTIPLY_ADD,
+        &&HANDLE_SUM, &&HANDLE_PRODUCT, &&HANDLE_DOT, &&HANDLE_MINIMUM, &&HANDLE_MAXIMUM, &&HANDLE_LESS, &&HANDLE_LESS_EQUAL,
+        &&HANDLE_GREATER, &&HANDLE_GREATER_EQUAL, &&HANDLE_EQUAL, &&HANDLE_NOT_EQUAL, &&HANDLE_AND, &&HANDLE_OR, &&HANDLE_NOT, &&HANDLE_SELECT
+    };
+    if(memory == nullptr)
+    {
+        HANDLERS = LABELS;
+        return 0;
+    }
+#endif
+    
+    double* frame = memory;
+    double* stack = memory + this->frameSize - 1;
+    // A function with every variable bound has none, and may be called without operands.
+    if(this->varCount > 0)
+    {
+        memcpy(frame, operands, this->varCount * sizeof(double));
+    }
+    
+    const Instruction* ins = this->code;
+    const Instruction* end = this->code + this->length;
+#ifdef TANGENT_MATH_FUNC_THREADED_DISPATCH
+    if(ins == end)
+    {
+        return *stack;
+    }
+    goto *(ins->handler);
+#else
+    for( ; ins != end ; ins++)
+    {
+        PROFILE_INSTRUCTION(ins->opcode, 1);
+        switch(ins->opcode)
+        {
+#endif
+            HANDLE(CONSTANT)
+                *(++stack) = ins->value;
+                NEXT();
+            HANDLE(VARIABLE)
+                *(++stack) = frame[ins->index];
+                NEXT();
+            HANDLE(STORE)
+                frame[ins->index] = *(stack--);
+                NEXT();
+            HANDLE(NEGATIVE)
+                *stack = -(*stack);
+                NEXT();
+            HANDLE(ADDITION)
+                stack--;
+                stack[0] = stack[0] + stack[1];
+                NEXT();
+            HANDLE(NEGATION)
+                stack--;
+                stack[0] = stack[0] - stack[1];
+                NEXT();
+            HANDLE(MULTIPLICATION)
+                stack--;
+                stack[0] = stack[0] * stack[1];
+                NEXT();
+            HANDLE(DIVISION)
+                stack--;
+                if(stack[1] == 0)
+                {
+                    throw DividedByZeroException();
+                }
+                stack[0] = stack[0] / stack[1];
+                NEXT();
+            HANDLE(MODDING)
+                stack--;
+                if(stack[1] == 0)
+                {
+                    throw DividedByZeroException();
+                }
+                stack[0] = fmod(stack[0], stack[1]);
+                NEXT();
+            HANDLE(POWER)
+                stack--;
+                stack[0] = pow(stack[0], stack[1]);
+                NEXT();
+            HANDLE(INVOKE)
+            {
+                PROFILE_CALL(ins->func);
+                stack -= ins->index - 1;
+                stack[0] = ins->func->invoke(stack);
+                NEXT();
+            }
+            HANDLE(MULTIPLY_ADD)
+                stack -= 2;
+                stack[0] = MULTIPLY_ADD(stack[0], stack[1], stack[2]);
+                NEXT();
+            HANDLE(SUM)
+            HANDLE(PRODUCT)
+            HANDLE(DOT)
+            HANDLE(MINIMUM)
+            HANDLE(MAXIMUM)
+                *(++stack) = reduce(ins->opcode, frame + ins->index, frame + ins->second, ins->length);
+                NEXT();
+            // Comparisons and selections are written as conditional moves, so that they compile without branches.
+            HANDLE(LESS)
+                stack--;
+                stack[0] = (stack[0] < stack[1] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(LESS_EQUAL)
+                stack--;
+                stack[0] = (stack[0] <= stack[1] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(GREATER)
+                stack--;
+                stack[0] = (stack[0] > stack[1] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(GREATER_EQUAL)
+                stack--;
+                stack[0] = (stack[0] >= stack[1] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(EQUAL)
+                stack--;
+                stack[0] = (stack[0] == stack[1] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(NOT_EQUAL)
+                stack--;
+                stack[0] = (stack[0] != stack[1] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(AND)
+                stack--;
+                stack[0] = ((stack[0] != 0) & (stack[1] != 0) ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(OR)
+                stack--;
+                stack[0] = ((stack[0] != 0) | (stack[1] != 0) ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(NOT)
+                *stack = (*stack == 0 ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(SELECT)
+                stack -= 2;
+                stack[0] = (stack[0] != 0 ? stack[1] : stack[2]);
+                NEXT();
+#ifdef TANGENT_MATH_FUNC_THREADED_DISPATCH
+    finished:
+#else
+        }
+    }
+#endif
+    return *stack;
+}
+
+const void* Program::getHandler(int opcode)
+{
+#ifdef TANGENT_MATH_FUNC_THREADED_DISPATCH
+    // Labels are local to execute(), so it is run once to hand out their addresses.
+    static bool resolved = (Program().execute(nullptr, nullptr), true);
+    return (resolved && opcode >= 0 && opcode < OPCODE_COUNT ? HANDLERS[opcode] : nullptr);
+#else
+    return nullptr;
+#endif
+}
+
+double Program::executeGuarded(const double* operands) const
+{
+    vector<double> values(this->frameSize + this->stackSize);
+    vector<char> divided(this->frameSize + this->stackSize, 0);
+    double* frame = values.data();
+    char* zero = divided.data();
+    if(this->varCount > 0)
+    {
+        memcpy(frame, operands, this->varCount * sizeof(double));
+    }
+    
+    // Values are computed as in execute(), evaluate() applying the operations the same way.
+    int top = this->frameSize - 1;
+    for(const Instruction* ins = this->code ; ins != this->code + this->length ; ins++)
+    {
+        switch(ins->opcode)
+        {
+            case OPCODE_CONSTANT:
+                frame[++top] = ins->value;
+                zero[top] = 0;
+                break;
+            case OPCODE_VARIABLE:
+                frame[++top] = frame[ins->index];
+                zero[top] = zero[ins->index];
+                break;
+            case OPCODE_STORE:
+                frame[ins->index] = frame[top];
+                zero[ins->index] = zero[top--];
+                break;
+            case OPCODE_INVOKE:
+            {
+                top -= ins->index - 1;
+                char any = 0;
+                for(int i = 0 ; i < ins->index ; i++)
+                {
+                    any |= zero[top + i];
+                }
+                try
+                {
+                    frame[top] = (any ? nan("") : ins->func->invoke(frame + top));
+                }
+                catch(const DividedByZeroException& ex)
+                {
+                    any = 1;
+                }
+                zero[top] = any;
+                break;
+            }
+            case OPCODE_MULTIPLY_ADD:
+                top -= 2;
+                frame[top] = MULTIPLY_ADD(frame[top], frame[top + 1], frame[top + 2]);
+                zero[top] |= zero[top + 1] | zero[top + 2];
+                break;
+            case OPCODE_SELECT:
+            {
+                top -= 2;
+                int picked = (frame[top] != 0 ? top + 1 : top + 2);
+                frame[top] = frame[picked];
+                zero[top] |= zero[picked];
+                break;
+            }
+            case OPCODE_SUM:
+            case OPCODE_PRODUCT:
+            case OPCODE_DOT:
+            case OPCODE_MINIMUM:
+            case OPCODE_MAXIMUM:
+                frame[++top] = reduce(ins->opcode, frame + ins->index, frame + ins->second, ins->length);
+                zero[top] = 0;
+                for(int i = 0 ; i < ins->length ; i++)
+                {
+                    zero[top] |= zero[ins->index + i] | (ins->opcode == OPCODE_DOT ? zero[ins->second + i] : 0);
+                }
+                break;
+            default:
+            {
+                int argc = getArity(ins->opcode);
+                top -= argc - 1;
+                double lhs = (argc == 2 ? frame[top] : 0);
+                double rhs = frame[top + argc - 1];
+                zero[top] |= zero[top + argc - 1];
+                if((ins->opcode == OPCODE_DIVISION || ins->opcode == OPCODE_MODDING) && rhs == 0)
+                {
+                    frame[top] = nan("");
+                    zero[top] = 1;
+                }
+                else
+                {
+                    frame[top] = evaluate(ins->opcode, lhs, rhs);
+                }
+                break;
+            }
+        }
+    }
+    
+    if(zero[top])
+    {
+        throw DividedByZeroException();
+    }
+    return frame[top];
+}
+
+void Program::gather(const double* const* columns, const ptrdiff_t* strides, int varCount, int row, double* operands)
+{
+    for(int i = 0 ; i < varCount ; i++)
+    {
+        operands[i] = (strides == nullptr ? columns[i][row] : *(const double*)((const char*)(columns[i]) + row * strides[i]));
+    }
+}
+
+double Program::run(const double* operands) const
+{
+    if(!(this->valid))
+    {
+        return nan("");
+    }
+    if(this->registers != nullptr)
+    {
+        return this->registers->run(operands);
+    }
+    
+    double buffer[LOCAL_BUFFER_SIZE];
+    double* memory = buffer;
+    if(this->frameSize + this->stackSize > LOCAL_BUFFER_SIZE)
+    {
+        memory = new double[this->frameSize + this->stackSize];
+    }
+    
+    double ret;
+    bool divided = false;
+    try
+    {
+        ret = this->execute(operands, memory);
+    }
+    catch(const DividedByZeroException& ex)
+    {
+        // Both branches of a selection are computed, so the division may be in a branch not taken.
+        divided = true;
+    }
+    catch(...)
+    {
+        if(memory != buffer)
+        {
+            delete[] memory;
+        }
+        throw;
+    }
+    
+    if(memory != buffer)
+    {
+        delete[] memory;
+    }
+    return (divided ? this->executeGuarded(operands) : ret);
+}
+
+void Program::executeBatch(const double* const* columns, const ptrdiff_t* strides, int offset, int count, double* memory, const double** views, double* results) const
+{
+    for(int i = 0 ; i < this->varCount ; i++)
+    {
+        if(strides == nullptr || strides[i] == sizeof(double))
+        {
+            views[i] = columns[i] + offset;
+        }
+        else
+        {
+            // Gathered into the parameter's own slot, which nothing else writes to.
+            const char* src = (const char*)(columns[i]) + offset * strides[i];
+            ptrdiff_t stride = strides[i];
+            double* dst = memory + i * BATCH_SIZE;
+            for(int j = 0 ; j < count ; j++)
+            {
+                dst[j] = *(const double*)(src + j * stride);
+            }
+            views[i] = dst;
+        }
+    }
+    for(int i = this->varCount ; i < this->frameSize ; i++)
+    {
+        views[i] = memory + i * BATCH_SIZE;
+    }
+    
+    int top = this->frameSize - 1;
+    const Instruction* ins = this->code;
+    const Instruction* end = this->code + this->length;
+    for( ; ins != end ; ins++)
+    {
+        double* dst = nullptr;
+        const double* lhs = nullptr;
+        const double* rhs = nullptr;
+        bool zero = false;
+        PROFILE_INSTRUCTION(ins->opcode, count);
+        switch(ins->opcode)
+        {
+            case OPCODE_CONSTANT:
+                dst = memory + (++top) * BATCH_SIZE;
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = ins->value;
+                }
+                views[top] = dst;
+                break;
+            case OPCODE_VARIABLE:
+                top++;
+                if(ins->index < this->varCount)
+                {
+                    // Input columns never change, so parameters are pushed without copying.
+                    views[top] = views[ins->index];
+                }
+                else
+                {
+                    dst = memory + top * BATCH_SIZE;
+                    memcpy(dst, views[ins->index], count * sizeof(double));
+                    views[top] = dst;
+                }
+                break;
+            case OPCODE_STORE:
+                memcpy(memory + ins->index * BATCH_SIZE, views[top--], count * sizeof(double));
+                break;
+            case OPCODE_NEGATIVE:
+                dst = memory + top * BATCH_SIZE;
+                lhs = views[top];
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = -lhs[i];
+                }
+                views[top] = dst;
+                break;
+            case OPCODE_NOT:
+                dst = memory + top * BATCH_SIZE;
+                lhs = views[top];
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = (lhs[i] == 0 ? 1.0 : 0.0);
+                }
+                views[top] = dst;
+                break;
+            case OPCODE_INVOKE:
+            {
+                PROFILE_CALL(ins->func);
+                top -= ins->index - 1;
+                dst = memory + top * BATCH_SIZE;
+                ins->func->invokeColumns(views + top, count, dst);
+                views[top] = dst;
+                break;
+            }
+            case OPCODE_MULTIPLY_ADD:
+            {
+                top -= 2;
+                dst = memory + top * BATCH_SIZE;
+                const double* a = views[top];
+                const double* b = views[top + 1];
+                const double* c = views[top + 2];
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = MULTIPLY_ADD(a[i], b[i], c[i]);
+                }
+                views[top] = dst;
+                break;
+            }
+            case OPCODE_SELECT:
+            {
+                top -= 2;
+                dst = memory + top * BATCH_SIZE;
+                const double* c = views[top];
+                const double* a = views[top + 1];
+                const double* b = views[top + 2];
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = (c[i] != 0 ? a[i] : b[i]);
+                }
+                views[top] = dst;
+                break;
+            }
+            case OPCODE_SUM:
+            case OPCODE_PRODUCT:
+            case OPCODE_DOT:
+            case OPCODE_MINIMUM:
+            case OPCODE_MAXIMUM:
+                dst = memory + (++top) * BATCH_SIZE;
+                reduce(ins->opcode, views + ins->index, views + ins->second, ins->length, count, dst);
+                views[top] = dst;
+                break;
+            default:
+                top--;
+                dst = memory + top * BATCH_SIZE;
+                lhs = views[top];
+                rhs = views[top + 1];
+                switch(ins->opcode)
+                {
+                    case OPCODE_ADDITION:
+                        for(int i = 0 ; i < count ; i++)
+                        {
+                            dst[i] = lhs[i] + rhs[i];
+                        }
+                        break;
+                    case OPCODE_NEGATION:
+                        for(int i = 0 ; i < count ; i++)
+                        {
+                            dst[i] = lhs[i] - rhs[i];
+                        }
+                        break;
+                    case OPCODE_MULTIPLICATION:
+                        for(int i = 0 ; i < count ; i++)
+                        {
+                            dst[i] = lhs[i] * rhs[i];
+                        }
+                        break;
+                    case OPCODE_DIVISION:
+                        for(int i = 0 ; i < count ; i++)
+                        {
+                            zero |= (rhs[i] == 0);
+                            dst[i] = lhs[i] / rhs[i];
+                        }
+                        break;
+                    case OPCODE_MODDING:
+                        for(int i = 0 ; i < count ; i++)
+                        {
+                            zero |= (rhs[i] == 0);
+                            dst[i] = fmod(lhs[i], rhs[i]);
+                        }
+                        break;
+                    case OPCODE_POWER:
+                        for(int i = 0 ; i < count ; i++)
+                        {
+                            dst[i] = pow(lhs[i], rhs[i]);
+                        }
+                        break;
+                    default:
+                        compare(ins->opcode, lhs, rhs, count, dst);
+                        break;
+                }
+                if(zero)
+                {
+                    throw DividedByZeroException();
+                }
+                views[top] = dst;
+                break;
+        }
+    }
+    memcpy(results, views[top], count * sizeof(double));
+}
+
+void Program::runBatch(const double* const* columns, int rows, double* results) const
+{
+    this->runBatch(columns, nullptr, rows, results);
+}
+
+void Program::runBatch(const double* const* columns, const ptrdiff_t* strides, int rows, double* results) const
+{
+    if(!(this->valid))
+    {
+        for(int i = 0 ; i < rows ; i++)
+        {
+            results[i] = nan("");
+        }
+        return;
+    }
+    if(this->registers != nullptr)
+    {
+        this->registers->runBatch(columns, strides, rows, results);
+        return;
+    }
+    
+    // Frame and stack slots are laid out as in run(), but every slot holds a block of rows.
+    int slots = this->frameSize + this->stackSize;
+    double* memory = new double[slots * BATCH_SIZE];
+    const double** views = new const double*[slots];
+    try
+    {
+        for(int offset = 0 ; offset < rows ; offset += BATCH_SIZE)
+        {
+            int count = (rows - offset < BATCH_SIZE ? rows - offset : BATCH_SIZE);
+            try
+            {
+                this->executeBatch(columns, strides, offset, count, memory, views, results + offset);
+            }
+            catch(const DividedByZeroException& ex)
+            {
+                this->runRows(columns, strides, offset, count, results + offset);
+            }
+        }
+    }
+    catch(...)
+    {
+        delete[] memory;
+        delete[] views;
+        throw;
+    }
+    delete[] memory;
+    delete[] views;
+}
+
+void Program::runRows(const double* const* columns, const ptrdiff_t* strides, int offset, int count, double* results) const
+{
+    vector<double> operands(this->varCount + 1);
+    for(int i = 0 ; i < count ; i++)
+    {
+        gather(columns, strides, this->varCount, offset + i, operands.data());
+        results[i] = this->run(operands.data());
+    }
+}
+
+void Program::runGrid(const GridAxis* axes, double* results) const
+{
+    int inner = this->varCount - 1;
+    int columnSize = axes[inner].count;
+    long long outerCount = 1;
+    for(int i = 0 ; i < inner ; i++)
+    {
+        outerCount *= axes[i].count;
+    }
+    
+    if(!(this->valid))
+    {
+        for(long long i = 0 ; i < outerCount * columnSize ; i++)
+        {
+            results[i] = nan("");
+        }
+        return;
+    }
+    
+    Program* outer;
+    Program* body;
+    int* patches;
+    int hoisted;
+    this->split(inner, outer, body, patches, hoisted);
+    
+    double* column = new double[columnSize];
+    for(int i = 0 ; i < columnSize ; i++)
+    {
+        column[i] = axes[inner].at(i);
+    }
+    double* operands = new double[this->varCount];
+    
+    // The body reads the inner variable alone, except for reductions, which read every slot of their arrays.
+    //  Outer variables are then broadcast into their slots from the operands, with a stride of 0.
+    bool broadcast = false;
+    for(int i = 0 ; i < body->length ; i++)
+    {
+        broadcast = broadcast || isReduction(body->code[i].opcode);
+    }
+    const double** columns = new const double*[this->varCount];
+    ptrdiff_t* strides = new ptrdiff_t[this->varCount];
+    for(int i = 0 ; i < this->varCount ; i++)
+    {
+        columns[i] = (broadcast && i != inner ? operands + i : column);
+        strides[i] = (broadcast && i != inner ? 0 : sizeof(double));
+    }
+    int* index = new int[this->varCount];
+    for(int i = 0 ; i < this->varCount ; i++)
+    {
+        operands[i] = 0;
+        index[i] = 0;
+    }
+    double* scalars = new double[outer->frameSize + outer->stackSize];
+    int slots = body->frameSize + body->stackSize;
+    double* memory = new double[slots * BATCH_SIZE];
+    const double** views = new const double*[slots];
+    
+    try
+    {
+        for(long long t = 0 ; t < outerCount ; t++)
+        {
+            for(int i = 0 ; i < inner ; i++)
+            {
+                operands[i] = axes[i].at(index[i]);
+            }
+            double* row = results + t * columnSize;
+            try
+            {
+                outer->execute(operands, scalars);
+                for(int i = 0 ; i < hoisted ; i++)
+                {
+                    body->code[patches[i]].value = scalars[this->frameSize + i];
+                }
+                for(int offset = 0 ; offset < columnSize ; offset += BATCH_SIZE)
+                {
+                    body->executeBatch(columns, strides, offset, (columnSize - offset < BATCH_SIZE ? columnSize - offset : BATCH_SIZE), memory, views, row + offset);
+                }
+            }
+            catch(const DividedByZeroException& ex)
+            {
+                // The division may be in a branch not taken, see runRows().
+                for(int i = 0 ; i < columnSize ; i++)
+                {
+                    operands[inner] = column[i];
+                    row[i] = this->run(operands);
+                }
+                operands[inner] = 0;
+            }
+            
+            // Next outer index, the last outer axis moving fastest.
+            for(int i = inner - 1 ; i >= 0 && ++(index[i]) == axes[i].count ; i--)
+            {
+                index[i] = 0;
+            }
+        }
+    }
+    catch(...)
+    {
+        Program::release(outer);
+        Program::release(body);
+        delete[] patches;
+        delete[] column;
+        delete[] columns;
+        delete[] strides;
+        delete[] operands;
+        delete[] index;
+        delete[] scalars;
+        delete[] memory;
+        delete[] views;
+        throw;
+    }
+    Program::release(outer);
+    Program::release(body);
+    delete[] patches;
+    delete[] column;
+    delete[] columns;
+    delete[] strides;
+    delete[] operands;
+    delete[] index;
+    delete[] scalars;
+    delete[] memory;
+    delete[] views;
+}
+
+int Program::getLength() const
+{
+    return this->length;
+}
+
+const Instruction* Program::getCode() const
+{
+    return this->code;
+}
+
+const RegisterProgram* Program::getRegisterProgram() const
+{
+    return this->registers;
+}
+
+size_t Program::getMemoryBytes() const
+{
+    return this->arena->getReservedBytes() + (this->registers != nullptr ? this->registers->getMemoryBytes() : 0);
+}
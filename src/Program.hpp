@@ -0,0 +1,369 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stddef.h>
+
+#include "util/Arena.hpp"
+#include "Operators.hpp"
+
+#ifndef __TANGENT_MATH_FUNC__PROGRAM
+#define __TANGENT_MATH_FUNC__PROGRAM 65536
+
+class MathFunction;
+
+class Polynomial;
+
+class RegisterProgram;
+
+/*
+ * Under threaded dispatch, the interpreters jump from each instruction straight to the handler of the next one,
+ *  whose address was stored in the instruction when it was emitted, instead of going back to a switch over the opcode.
+ *  Each handler ends with a jump of its own, so the branch predictor learns which opcodes tend to follow which.
+ *  Needs computed goto, i.e. GCC or Clang. Defining TANGENT_MATH_FUNC_SWITCH_DISPATCH keeps the portable switch,
+ *  which profiled builds use as well.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(TANGENT_MATH_FUNC_SWITCH_DISPATCH) && !defined(TANGENT_MATH_FUNC_PROFILE)
+#define TANGENT_MATH_FUNC_THREADED_DISPATCH
+#endif
+
+/*
+ * A single step of a compiled Program.
+ */
+struct Instruction
+{
+    /*
+     * One of the OpCode values.
+     */
+    int opcode;
+    
+    /*
+     * Frame slot for OPCODE_VARIABLE and OPCODE_STORE, argument count for OPCODE_INVOKE,
+     *  first slot of the (first) array of a reduction.
+     */
+    int index;
+    
+    /*
+     * Slots of each array of a reduction.
+     */
+    int length;
+    
+    /*
+     * First slot of the second array of OPCODE_DOT.
+     */
+    int second;
+    
+    /*
+     * Pushed value of OPCODE_CONSTANT.
+     */
+    double value;
+    
+    /*
+     * Callee of OPCODE_INVOKE.
+     */
+    const MathFunction* func;
+    
+    /*
+     * Address of the handler of the opcode in Program::execute() under threaded dispatch, nullptr otherwise.
+     */
+    const void* handler;
+};
+
+/*
+ * One axis of a Cartesian grid: "count" evenly spaced values from "start" to "stop", both included.
+ */
+struct GridAxis
+{
+    double start;
+    double stop;
+    int count;
+    
+    /*
+     * The i-th value of the axis.
+     */
+    double at(int i) const;
+};
+
+/*
+ * The flattened form of a MathFunction's postfix expression.
+ *  Calls to small user-defined functions are inlined into the caller's frame, and constant sub-expressions are folded,
+ *  so running a program touches neither the linked postfix list nor the heap.
+ *  A program and its code share one exactly sized arena, thus they are contiguous in memory.
+ */
+class Program
+{
+    private:
+        /*
+         * Arena holding this object and its code.
+         */
+        Arena* arena;
+        
+        /*
+         * Contiguous instruction stream.
+         */
+        Instruction* code;
+        
+        /*
+         * Number of instructions in use.
+         */
+        int length;
+        
+        /*
+         * Number of arguments copied into the frame before running.
+         */
+        int varCount;
+        
+        /*
+         * Frame slots, including the parameters of inlined callees.
+         */
+        int frameSize;
+        
+        /*
+         * Maximum depth of the operand stack.
+         */
+        int stackSize;
+        
+        /*
+         * False if the expression does not reduce to exactly one value. Such a program always yields NaN.
+         */
+        bool valid;
+        
+        /*
+         * Operand stack depth while compiling.
+         */
+        int depth;
+        
+        /*
+         * Whether callees are inlined and constants folded while compiling.
+         */
+        bool optimize;
+        
+        /*
+         * Register form run in place of the code under BACKEND_REGISTER, nullptr otherwise. Owned by this program.
+         */
+        RegisterProgram* registers;
+        
+        Program();
+        
+        /*
+         * Use Program::release() instead.
+         */
+        ~Program();
+        
+        // Disabled
+        Program(const Program&);
+        void operator=(const Program&);
+        
+        /*
+         * An empty program with room for "capacity" instructions, in an arena of its own.
+         */
+        static Program* allocate(int capacity);
+        
+        static bool isInlinable(const MathFunction* callee);
+        
+        static bool isReduction(int opcode);
+        
+        /*
+         * Operands popped by an operation, i.e. an opcode neither pushing, storing, calling nor reducing.
+         */
+        static int getArity(int opcode);
+        
+        /*
+         * Reduce one row, the arrays being contiguous. Shared by the interpreters, so that they round alike.
+         */
+        static double reduce(int opcode, const double* lhs, const double* rhs, int length);
+        
+        /*
+         * Reduce a block of rows, each variable of the arrays being a column of the block.
+         *  Every step runs over the whole block, in the same order as reduce(), so that the loops vectorize.
+         */
+        static void reduce(int opcode, const double* const* lhs, const double* const* rhs, int length, int count, double* dst);
+        
+        /*
+         * Apply a binary comparison or logical opcode to a block of rows. Shared by the interpreters, the loops being
+         *  written without branches so that they vectorize.
+         */
+        static void compare(int opcode, const double* lhs, const double* rhs, int count, double* dst);
+        
+        /*
+         * Apply an arithmetic, comparison or logical opcode the same way execute() does. Used for constant folding, and by executeGuarded().
+         */
+        static double evaluate(int opcode, double lhs, double rhs);
+        
+        void emit(int opcode, int index, double value, const MathFunction* func);
+        
+        void emitPush(int opcode, int index, double value);
+        
+        void emitStore(int index);
+        
+        void emitOperation(int opcode);
+        
+        void emitInvoke(const MathFunction* callee, int argc);
+        
+        void emitReduction(int opcode, int index, int second, int length);
+        
+        /*
+         * Append an instruction of another program as it is.
+         */
+        void emitCopy(const Instruction& ins);
+        
+        /*
+         * Copy the code of a callee into this program, relocating its frame behind the parameters of this one.
+         *  Arguments that are compile-time constants are substituted into the callee's code instead of being stored.
+         */
+        void emitInline(const Program* callee, int argc);
+        
+        /*
+         * Param(s):
+         *    memory    -> The frame and the stack. If nullptr, execute() only hands out the addresses of its handlers.
+         */
+        double execute(const double* operands, double* memory) const;
+        
+        /*
+         * Run the code again once execute() has thrown DividedByZeroException, each value carrying whether it depends on
+         *  a division by zero. A selection carries the flags of its condition and of the operand it picks only,
+         *  so that a division by zero in the branch not taken is dropped.
+         *
+         * Return:
+         *    The value of execute(). Throws DividedByZeroException if it depends on a division by zero.
+         */
+        double executeGuarded(const double* operands) const;
+        
+        /*
+         * Handler of an opcode in execute() under threaded dispatch, nullptr otherwise.
+         */
+        static const void* getHandler(int opcode);
+        
+        /*
+         * Copy the values of row "row" of the columns, "strides[i]" bytes apart, or contiguous if "strides" is nullptr.
+         */
+        static void gather(const double* const* columns, const ptrdiff_t* strides, int varCount, int row, double* operands);
+        
+        /*
+         * Run one block of at most BATCH_SIZE rows. Every frame and stack slot is a block of values,
+         *  and views point at the block a slot currently holds, which is an input column for the parameters.
+         *  Strided parameters are gathered into their slots first.
+         */
+        void executeBatch(const double* const* columns, const ptrdiff_t* strides, int offset, int count, double* memory, const double** views, double* results) const;
+        
+        /*
+         * Evaluate the rows of a block one by one with run(), in place of an executeBatch() having thrown DividedByZeroException.
+         *  Both branches of a selection are computed over a whole block, so the division may be in a branch not taken.
+         */
+        void runRows(const double* const* columns, const ptrdiff_t* strides, int offset, int count, double* results) const;
+        
+        /*
+         * Split the code into the part invariant in the variable "inner" and the part varying with it.
+         *  The outer program stores the invariant operands of varying instructions into "hoisted" slots behind the frame,
+         *  and the body reads each of them as a constant to be patched at "patches[i]" before running.
+         */
+        void split(int inner, Program*& outer, Program*& body, int*& patches, int& hoisted) const;
+        
+        /*
+         * Mark of split() for a constant operand of a varying instruction, which needs no hoisting.
+         */
+        static const int HOIST_CONSTANT = -2;
+        
+        /*
+         * Rewrite every polynomial subexpression, i.e. made of constants, variables, +, -, * and small integer powers,
+         *  into multivariate Horner form with multiply-adds, wherever that is cheaper.
+         *
+         * Return:
+         *    A new program, or nullptr if nothing was rewritten.
+         */
+        Program* factorPolynomials() const;
+        
+        /*
+         * The stack code of compile().
+         */
+        static Program* emitFunction(const MathFunction& func, bool optimize);
+    
+    public:
+        /*
+         * Callees longer than this are invoked instead of being inlined.
+         */
+        static const int MAX_INLINE_LENGTH = 256;
+        
+        /*
+         * Programs whose frame and stack fit into this many doubles run without allocating.
+         */
+        static const int LOCAL_BUFFER_SIZE = 128;
+        
+        /*
+         * Rows evaluated at once by runBatch(). Each slot of a block is small enough to stay in the L1 cache.
+         */
+        static const int BATCH_SIZE = 256;
+        
+        /*
+         * Integer powers up to this exponent are turned into multiplications by the polynomial rewrite.
+         */
+        static const int MAX_POLYNOMIAL_DEGREE = 16;
+        
+        /*
+         * Cost of a pow() call, in instructions. A polynomial is rewritten only if it gets cheaper.
+         *  bench_main measures it as "power_cost": about 20 instructions per call of invoke(), and more than twice that
+         *  per row of invokeBatch(), where the other instructions are cheaper. The lower figure is taken.
+         */
+        static const int POWER_COST = 20;
+        
+        /*
+         * Compile the postfix expression of a user-defined function.
+         *  Callees are taken in their current compiled form, so they MUST be compiled before their callers.
+         *
+         * Param(s):
+         *    optimize    -> False for the baseline tier, a plain translation of the postfix expression.
+         *                   Either way, the program gets its register form under BACKEND_REGISTER.
+         */
+        static Program* compile(const MathFunction& func, bool optimize);
+        
+        /*
+         * Destroy a compiled program along with its arena. Accepts nullptr.
+         */
+        static void release(Program* prog);
+        
+        double run(const double* operands) const;
+        
+        /*
+         * Evaluate many rows at once, one instruction over a whole block of rows at a time.
+         *
+         * Param(s):
+         *    columns    -> One array of "rows" values per variable.
+         *    results    -> Receives "rows" values.
+         */
+        void runBatch(const double* const* columns, int rows, double* results) const;
+        
+        /*
+         * Same as above, with the values of each variable "strides[i]" bytes apart. Contiguous columns are read in place.
+         */
+        void runBatch(const double* const* columns, const ptrdiff_t* strides, int rows, double* results) const;
+        
+        /*
+         * The register form, nullptr unless compiled under BACKEND_REGISTER.
+         */
+        const RegisterProgram* getRegisterProgram() const;
+        
+        /*
+         * Evaluate over a Cartesian grid, one axis per variable, into a dense row-major array with the last axis moving fastest.
+         *  Subexpressions not depending on the last variable are computed once per outer index only.
+         */
+        void runGrid(const GridAxis* axes, double* results) const;
+        
+        int getLength() const;
+        
+        const Instruction* getCode() const;
+        
+        /*
+         * Bytes reserved for this program and its code, the register form included.
+         */
+        size_t getMemoryBytes() const;
+    
+    friend class EvaluationPlan;
+    friend class Polynomial;
+    friend class RegisterProgram;
+};
+
+#endif
@@ -0,0 +1,891 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <vector>
+
+#include "misc/TFException.hpp"
+#include "Operators.hpp"
+#include "Profiler.hpp"
+#include "RegisterProgram.hpp"
+#include "TangentsMathFunc.hpp"
+
+using namespace std;
+
+/*
+ * Same as in Program.cpp, so that both backends round alike.
+ */
+#if defined(FP_FAST_FMA) || defined(TANGENT_MATH_FUNC_FMA)
+#define MULTIPLY_ADD(a, b, c) fma(a, b, c)
+#else
+#define MULTIPLY_ADD(a, b, c) ((a) * (b) + (c))
+#endif
+
+/*
+ * Handlers of execute(), as in Program.cpp.
+ */
+#ifdef TANGENT_MATH_FUNC_THREADED_DISPATCH
+#define HANDLE(op) HANDLE_##op:
+#define NEXT() if(++ins == end) goto finished; op = ins->operands; goto *(ins->handler)
+
+static const void* const* HANDLERS = nullptr;
+#else
+#define HANDLE(op) case OPCODE_##op:
+#define NEXT() break
+#endif
+
+/*
+ * Bytes of an arena block, rounded up to the alignment of the arena.
+ */
+static size_t aligned(size_t size)
+{
+    return (size + Arena::ALIGNMENT - 1) & ~(Arena::ALIGNMENT - 1);
+}
+
+/*
+ * Binary operations giving the same bits with their operands swapped, which are then numbered in a canonical order.
+ */
+static bool isCommutative(int opcode)
+{
+    switch(opcode)
+    {
+        case OPCODE_ADDITION:
+        case OPCODE_MULTIPLICATION:
+        case OPCODE_EQUAL:
+        case OPCODE_NOT_EQUAL:
+        case OPCODE_AND:
+        case OPCODE_OR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+RegisterProgram::RegisterProgram()
+{
+    this->arena = nullptr;
+    this->code = nullptr;
+    this->length = 0;
+    this->varCount = 0;
+    this->constants = nullptr;
+    this->constantCount = 0;
+    this->registerCount = 0;
+    this->arguments = nullptr;
+    this->maxArguments = 0;
+    this->results = nullptr;
+    this->resultCount = 0;
+}
+
+RegisterProgram::~RegisterProgram()
+{
+}
+
+void RegisterProgram::release(RegisterProgram* prog)
+{
+    if(prog == nullptr)
+    {
+        return;
+    }
+    Arena* arena = prog->arena;
+    prog->~RegisterProgram();
+    delete arena;
+}
+
+RegisterProgram* RegisterProgram::translate(const Program* prog)
+{
+    return fuse(&prog, nullptr, 1, prog->varCount);
+}
+
+RegisterProgram* RegisterProgram::fuse(const Program* const* progs, const int* const* params, int programCount, int varCount)
+{
+    // Values are numbered as virtual registers: the parameters, then the constants and the results of instructions
+    //  in order of appearance. Each one is written once, so frame slots are mere names for them.
+    int values = varCount;
+    vector<int> constantIndex(varCount, -1);
+    vector<double> constantValues;
+    map<uint64_t, int> constantIds;
+    vector<RegisterInstruction> code;
+    vector<int> arguments;
+    int maxArguments = 0;
+    vector<int> outputs;
+    
+    // Value numbering: an instruction reading the same values as an earlier one, e.g. in the inlined code of a callee
+    //  called twice with the same arguments, or in another program of the fusion, gives the value of that one.
+    //  Every operation is a pure function of its operands, so this holds for calls of non-inlined callees as well.
+    map<vector<intptr_t>, int> numbered;
+    vector<intptr_t> key;
+    
+    for(int p = 0 ; p < programCount ; p++)
+    {
+        const Program* prog = progs[p];
+        if(!(prog->valid))
+        {
+            return nullptr;
+        }
+        vector<int> slots(prog->frameSize, -1);
+        for(int i = 0 ; i < prog->varCount ; i++)
+        {
+            slots[i] = (params == nullptr ? i : params[p][i]);
+        }
+        vector<int> stack;
+        
+        for(int i = 0 ; i < prog->length ; i++)
+        {
+            const Instruction& ins = prog->code[i];
+            RegisterInstruction reg;
+            reg.opcode = ins.opcode;
+            reg.operands[0] = reg.operands[1] = reg.operands[2] = 0;
+            reg.func = nullptr;
+            reg.handler = getHandler(ins.opcode);
+            key.assign(1, ins.opcode);
+            switch(ins.opcode)
+            {
+                case OPCODE_CONSTANT:
+                {
+                    // Keyed by the bits, so that 0 and -0 stay apart.
+                    uint64_t bits;
+                    memcpy(&bits, &(ins.value), sizeof(bits));
+                    map<uint64_t, int>::iterator found = constantIds.find(bits);
+                    if(found == constantIds.end())
+                    {
+                        found = constantIds.insert(make_pair(bits, values++)).first;
+                        constantIndex.push_back((int)(constantValues.size()));
+                        constantValues.push_back(ins.value);
+                    }
+                    stack.push_back(found->second);
+                    continue;
+                }
+                case OPCODE_VARIABLE:
+                    if(slots[ins.index] < 0)
+                    {
+                        return nullptr;
+                    }
+                    stack.push_back(slots[ins.index]);
+                    continue;
+                case OPCODE_STORE:
+                    slots[ins.index] = stack.back();
+                    stack.pop_back();
+                    continue;
+                case OPCODE_NEGATIVE:
+                case OPCODE_NOT:
+                    reg.operands[0] = stack.back();
+                    stack.pop_back();
+                    key.push_back(reg.operands[0]);
+                    break;
+                case OPCODE_INVOKE:
+                    reg.func = ins.func;
+                    key.push_back((intptr_t)(ins.func));
+                    key.insert(key.end(), stack.end() - ins.index, stack.end());
+                    break;
+                case OPCODE_MULTIPLY_ADD:
+                    for(int j = 2 ; j >= 0 ; j--)
+                    {
+                        reg.operands[j] = stack.back();
+                        stack.pop_back();
+                    }
+                    // Both products round alike, so the factors are ordered.
+                    if(reg.operands[0] > reg.operands[1])
+                    {
+                        swap(reg.operands[0], reg.operands[1]);
+                    }
+                    key.insert(key.end(), reg.operands, reg.operands + 3);
+                    break;
+                case OPCODE_SELECT:
+                    for(int j = 2 ; j >= 0 ; j--)
+                    {
+                        reg.operands[j] = stack.back();
+                        stack.pop_back();
+                    }
+                    key.insert(key.end(), reg.operands, reg.operands + 3);
+                    break;
+                case OPCODE_SUM:
+                case OPCODE_PRODUCT:
+                case OPCODE_DOT:
+                case OPCODE_MINIMUM:
+                case OPCODE_MAXIMUM:
+                    // Arrays are read from consecutive parameter registers, which parameters shuffled by a plan may not be.
+                    for(int k = 0 ; k < ins.length ; k++)
+                    {
+                        if(slots[ins.index + k] != slots[ins.index] + k || (ins.opcode == OPCODE_DOT && slots[ins.second + k] != slots[ins.second] + k))
+                        {
+                            return nullptr;
+                        }
+                    }
+                    reg.operands[0] = slots[ins.index];
+                    reg.operands[1] = (ins.opcode == OPCODE_DOT ? slots[ins.second] : 0);
+                    reg.operands[2] = ins.length;
+                    key.insert(key.end(), reg.operands, reg.operands + 3);
+                    break;
+                default:
+                    reg.operands[1] = stack.back();
+                    stack.pop_back();
+                    reg.operands[0] = stack.back();
+                    stack.pop_back();
+                    if(isCommutative(ins.opcode) && reg.operands[0] > reg.operands[1])
+                    {
+                        swap(reg.operands[0], reg.operands[1]);
+                    }
+                    key.insert(key.end(), reg.operands, reg.operands + 2);
+                    break;
+            }
+            
+            map<vector<intptr_t>, int>::iterator found = numbered.find(key);
+            if(found != numbered.end())
+            {
+                if(ins.opcode == OPCODE_INVOKE)
+                {
+                    stack.resize(stack.size() - ins.index);
+                }
+                stack.push_back(found->second);
+                continue;
+            }
+            if(ins.opcode == OPCODE_INVOKE)
+            {
+                reg.operands[0] = (int)(arguments.size());
+                reg.operands[1] = ins.index;
+                arguments.insert(arguments.end(), stack.end() - ins.index, stack.end());
+                stack.resize(stack.size() - ins.index);
+                maxArguments = (ins.index > maxArguments ? ins.index : maxArguments);
+            }
+            reg.target = values++;
+            numbered.insert(make_pair(key, reg.target));
+            constantIndex.push_back(-1);
+            stack.push_back(reg.target);
+            code.push_back(reg);
+        }
+        outputs.push_back(stack.back());
+    }
+    
+    // Live ranges end at the last instruction reading a value. The results live until the end.
+    int length = (int)(code.size());
+    vector<int> lastUse(values, -1);
+    vector<int> first(length), count(length);
+    for(int i = 0 ; i < length ; i++)
+    {
+        RegisterInstruction& reg = code[i];
+        int* read = reg.operands;
+        int reads = Program::getArity(reg.opcode);
+        // Reductions read parameters only, which are never freed.
+        if(Program::isReduction(reg.opcode))
+        {
+            reads = 0;
+        }
+        if(reg.opcode == OPCODE_INVOKE)
+        {
+            read = arguments.data() + reg.operands[0];
+            reads = reg.operands[1];
+        }
+        first[i] = (int)(read - (reg.opcode == OPCODE_INVOKE ? arguments.data() : reg.operands));
+        count[i] = reads;
+        for(int j = 0 ; j < reads ; j++)
+        {
+            lastUse[read[j]] = i;
+        }
+    }
+    for(int v : outputs)
+    {
+        lastUse[v] = length;
+    }
+    
+    // Linear scan over the temporaries. Operands dying at an instruction are freed before its target is taken,
+    //  so that the target may reuse one of them. Every operation reads all of its operands before writing.
+    int base = varCount + (int)(constantValues.size());
+    vector<int> physical(values);
+    vector<int> free;
+    int temporaries = 0;
+    for(int v = 0 ; v < values ; v++)
+    {
+        physical[v] = (v < varCount ? v : (constantIndex[v] >= 0 ? varCount + constantIndex[v] : -1));
+    }
+    for(int i = 0 ; i < length ; i++)
+    {
+        RegisterInstruction& reg = code[i];
+        int* read = (reg.opcode == OPCODE_INVOKE ? arguments.data() : reg.operands) + first[i];
+        for(int j = 0 ; j < count[i] ; j++)
+        {
+            int v = read[j];
+            if(physical[v] >= base && lastUse[v] == i)
+            {
+                free.push_back(physical[v]);
+                // Freed once, even if read twice.
+                lastUse[v] = -1;
+            }
+        }
+        int target = reg.target;
+        if(free.empty())
+        {
+            physical[target] = base + temporaries++;
+        }
+        else
+        {
+            physical[target] = free.back();
+            free.pop_back();
+        }
+        // Never read: the register is free again right away.
+        if(lastUse[target] < 0)
+        {
+            free.push_back(physical[target]);
+        }
+    }
+    
+    size_t capacity = aligned(sizeof(RegisterProgram)) + aligned(length * sizeof(RegisterInstruction))
+        + aligned(constantValues.size() * sizeof(double)) + aligned(arguments.size() * sizeof(int)) + aligned(programCount * sizeof(int));
+    Arena* arena = new Arena(capacity);
+    RegisterProgram* regs = new(*arena) RegisterProgram();
+    regs->arena = arena;
+    regs->length = length;
+    regs->varCount = varCount;
+    regs->constantCount = (int)(constantValues.size());
+    regs->registerCount = base + temporaries;
+    regs->maxArguments = maxArguments;
+    regs->resultCount = programCount;
+    regs->code = (RegisterInstruction*)(arena->allocate(length * sizeof(RegisterInstruction)));
+    regs->constants = (double*)(arena->allocate(constantValues.size() * sizeof(double)));
+    regs->arguments = (int*)(arena->allocate(arguments.size() * sizeof(int)));
+    regs->results = (int*)(arena->allocate(programCount * sizeof(int)));
+    for(size_t i = 0 ; i < constantValues.size() ; i++)
+    {
+        regs->constants[i] = constantValues[i];
+    }
+    for(size_t i = 0 ; i < arguments.size() ; i++)
+    {
+        regs->arguments[i] = physical[arguments[i]];
+    }
+    for(int i = 0 ; i < programCount ; i++)
+    {
+        regs->results[i] = physical[outputs[i]];
+    }
+    for(int i = 0 ; i < length ; i++)
+    {
+        RegisterInstruction reg = code[i];
+        reg.target = physical[reg.target];
+        if(reg.opcode != OPCODE_INVOKE)
+        {
+            for(int j = 0 ; j < count[i] ; j++)
+            {
+                reg.operands[j] = physical[reg.operands[j]];
+            }
+        }
+        regs->code[i] = reg;
+    }
+    return regs;
+}
+
+double RegisterProgram::execute(double* registers) const
+{
+#ifdef TANGENT_MATH_FUNC_THREADED_DISPATCH
+    // Loads and stores never appear in register code.
+    static const void* const LABELS[OPCODE_COUNT] = {
+        &&HANDLE_NONE, &&HANDLE_NONE, &&HANDLE_NONE, &&HANDLE_NEGATIVE, &&HANDLE_ADDITION, &&HANDLE_NEGATION,
+        &&HANDLE_MULTIPLICATION, &&HANDLE_DIVISION, &&HANDLE_MODDING, &&HANDLE_POWER, &&HANDLE_INVOKE, &&HANDLE_MULTIPLY_ADD,
+        &&HANDLE_SUM, &&HANDLE_PRODUCT, &&HANDLE_DOT, &&HANDLE_MINIMUM, &&HANDLE_MAXIMUM, &&HANDLE_LESS, &&HANDLE_LESS_EQUAL,
+        &&HANDLE_GREATER, &&HANDLE_GREATER_EQUAL, &&HANDLE_EQUAL, &&HANDLE_NOT_EQUAL, &&HANDLE_AND, &&HANDLE_OR, &&HANDLE_NOT, &&HANDLE_SELECT
+    };
+    if(registers == nullptr)
+    {
+        HANDLERS = LABELS;
+        return 0;
+    }
+#endif
+    
+    double* scratch = registers + this->registerCount;
+    const RegisterInstruction* ins = this->code;
+    const RegisterInstruction* end = this->code + this->length;
+    const int* op;
+#ifdef TANGENT_MATH_FUNC_THREADED_DISPATCH
+    if(ins == end)
+    {
+        return registers[this->results[0]];
+    }
+    op = ins->operands;
+    goto *(ins->handler);
+#else
+    for( ; ins != end ; ins++)
+    {
+        PROFILE_INSTRUCTION(ins->opcode, 1);
+        op = ins->operands;
+        switch(ins->opcode)
+        {
+#endif
+            HANDLE(NEGATIVE)
+                registers[ins->target] = -registers[op[0]];
+                NEXT();
+            HANDLE(ADDITION)
+                registers[ins->target] = registers[op[0]] + registers[op[1]];
+                NEXT();
+            HANDLE(NEGATION)
+                registers[ins->target] = registers[op[0]] - registers[op[1]];
+                NEXT();
+            HANDLE(MULTIPLICATION)
+                registers[ins->target] = registers[op[0]] * registers[op[1]];
+                NEXT();
+            HANDLE(DIVISION)
+                if(registers[op[1]] == 0)
+                {
+                    throw DividedByZeroException();
+                }
+                registers[ins->target] = registers[op[0]] / registers[op[1]];
+                NEXT();
+            HANDLE(MODDING)
+                if(registers[op[1]] == 0)
+                {
+                    throw DividedByZeroException();
+                }
+                registers[ins->target] = fmod(registers[op[0]], registers[op[1]]);
+                NEXT();
+            HANDLE(POWER)
+                registers[ins->target] = pow(registers[op[0]], registers[op[1]]);
+                NEXT();
+            HANDLE(INVOKE)
+            {
+                PROFILE_CALL(ins->func);
+                const int* args = this->arguments + op[0];
+                for(int i = 0 ; i < op[1] ; i++)
+                {
+                    scratch[i] = registers[args[i]];
+                }
+                registers[ins->target] = ins->func->invoke(scratch);
+                NEXT();
+            }
+            HANDLE(MULTIPLY_ADD)
+                registers[ins->target] = MULTIPLY_ADD(registers[op[0]], registers[op[1]], registers[op[2]]);
+                NEXT();
+            HANDLE(SUM)
+            HANDLE(PRODUCT)
+            HANDLE(DOT)
+            HANDLE(MINIMUM)
+            HANDLE(MAXIMUM)
+                registers[ins->target] = Program::reduce(ins->opcode, registers + op[0], registers + op[1], op[2]);
+                NEXT();
+            HANDLE(LESS)
+                registers[ins->target] = (registers[op[0]] < registers[op[1]] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(LESS_EQUAL)
+                registers[ins->target] = (registers[op[0]] <= registers[op[1]] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(GREATER)
+                registers[ins->target] = (registers[op[0]] > registers[op[1]] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(GREATER_EQUAL)
+                registers[ins->target] = (registers[op[0]] >= registers[op[1]] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(EQUAL)
+                registers[ins->target] = (registers[op[0]] == registers[op[1]] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(NOT_EQUAL)
+                registers[ins->target] = (registers[op[0]] != registers[op[1]] ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(AND)
+                registers[ins->target] = ((registers[op[0]] != 0) & (registers[op[1]] != 0) ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(OR)
+                registers[ins->target] = ((registers[op[0]] != 0) | (registers[op[1]] != 0) ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(NOT)
+                registers[ins->target] = (registers[op[0]] == 0 ? 1.0 : 0.0);
+                NEXT();
+            HANDLE(SELECT)
+                registers[ins->target] = (registers[op[0]] != 0 ? registers[op[1]] : registers[op[2]]);
+                NEXT();
+#ifdef TANGENT_MATH_FUNC_THREADED_DISPATCH
+            HANDLE(NONE)
+                NEXT();
+    finished:
+#else
+        }
+    }
+#endif
+    return registers[this->results[0]];
+}
+
+const void* RegisterProgram::getHandler(int opcode)
+{
+#ifdef TANGENT_MATH_FUNC_THREADED_DISPATCH
+    // Labels are local to execute(), so it is run once to hand out their addresses.
+    static bool resolved = (RegisterProgram().execute(nullptr), true);
+    return (resolved && opcode >= 0 && opcode < OPCODE_COUNT ? HANDLERS[opcode] : nullptr);
+#else
+    return nullptr;
+#endif
+}
+
+void RegisterProgram::executeGuarded(const double* operands, double* results) const
+{
+    vector<double> values(this->registerCount + this->maxArguments);
+    vector<char> divided(this->registerCount, 0);
+    double* registers = values.data();
+    char* zero = divided.data();
+    double* scratch = registers + this->registerCount;
+    if(this->varCount > 0)
+    {
+        memcpy(registers, operands, this->varCount * sizeof(double));
+    }
+    memcpy(registers + this->varCount, this->constants, this->constantCount * sizeof(double));
+    
+    // Values are computed as in execute(), Program::evaluate() applying the operations the same way.
+    for(const RegisterInstruction* ins = this->code ; ins != this->code + this->length ; ins++)
+    {
+        const int* op = ins->operands;
+        double value;
+        char any = 0;
+        switch(ins->opcode)
+        {
+            case OPCODE_INVOKE:
+            {
+                const int* args = this->arguments + op[0];
+                for(int i = 0 ; i < op[1] ; i++)
+                {
+                    scratch[i] = registers[args[i]];
+                    any |= zero[args[i]];
+                }
+                try
+                {
+                    value = (any ? nan("") : ins->func->invoke(scratch));
+                }
+                catch(const DividedByZeroException& ex)
+                {
+                    value = nan("");
+                    any = 1;
+                }
+                break;
+            }
+            case OPCODE_MULTIPLY_ADD:
+                value = MULTIPLY_ADD(registers[op[0]], registers[op[1]], registers[op[2]]);
+                any = zero[op[0]] | zero[op[1]] | zero[op[2]];
+                break;
+            case OPCODE_SELECT:
+            {
+                int picked = (registers[op[0]] != 0 ? op[1] : op[2]);
+                value = registers[picked];
+                any = zero[op[0]] | zero[picked];
+                break;
+            }
+            case OPCODE_SUM:
+            case OPCODE_PRODUCT:
+            case OPCODE_DOT:
+            case OPCODE_MINIMUM:
+            case OPCODE_MAXIMUM:
+                value = Program::reduce(ins->opcode, registers + op[0], registers + op[1], op[2]);
+                for(int i = 0 ; i < op[2] ; i++)
+                {
+                    any |= zero[op[0] + i] | (ins->opcode == OPCODE_DOT ? zero[op[1] + i] : 0);
+                }
+                break;
+            case OPCODE_NEGATIVE:
+            case OPCODE_NOT:
+                value = Program::evaluate(ins->opcode, 0, registers[op[0]]);
+                any = zero[op[0]];
+                break;
+            default:
+                any = zero[op[0]] | zero[op[1]];
+                if((ins->opcode == OPCODE_DIVISION || ins->opcode == OPCODE_MODDING) && registers[op[1]] == 0)
+                {
+                    value = nan("");
+                    any = 1;
+                }
+                else
+                {
+                    value = Program::evaluate(ins->opcode, registers[op[0]], registers[op[1]]);
+                }
+                break;
+        }
+        registers[ins->target] = value;
+        zero[ins->target] = any;
+    }
+    
+    for(int i = 0 ; i < this->resultCount ; i++)
+    {
+        if(zero[this->results[i]])
+        {
+            throw DividedByZeroException();
+        }
+        results[i] = registers[this->results[i]];
+    }
+}
+
+double RegisterProgram::run(const double* operands) const
+{
+    double ret;
+    this->run(operands, &ret);
+    return ret;
+}
+
+void RegisterProgram::run(const double* operands, double* results) const
+{
+    double buffer[Program::LOCAL_BUFFER_SIZE];
+    double* registers = buffer;
+    if(this->registerCount + this->maxArguments > Program::LOCAL_BUFFER_SIZE)
+    {
+        registers = new double[this->registerCount + this->maxArguments];
+    }
+    if(this->varCount > 0)
+    {
+        memcpy(registers, operands, this->varCount * sizeof(double));
+    }
+    memcpy(registers + this->varCount, this->constants, this->constantCount * sizeof(double));
+    
+    bool divided = false;
+    try
+    {
+        this->execute(registers);
+    }
+    catch(const DividedByZeroException& ex)
+    {
+        // Both branches of a selection are computed, so the division may be in a branch not taken.
+        divided = true;
+    }
+    catch(...)
+    {
+        if(registers != buffer)
+        {
+            delete[] registers;
+        }
+        throw;
+    }
+    for(int i = 0 ; i < this->resultCount && !divided ; i++)
+    {
+        results[i] = registers[this->results[i]];
+    }
+    
+    if(registers != buffer)
+    {
+        delete[] registers;
+    }
+    if(divided)
+    {
+        this->executeGuarded(operands, results);
+    }
+}
+
+void RegisterProgram::executeBatch(const double* const* columns, const ptrdiff_t* strides, int offset, int count, double* memory, const double** views, double* const* results) const
+{
+    const int BATCH_SIZE = Program::BATCH_SIZE;
+    for(int i = 0 ; i < this->varCount ; i++)
+    {
+        if(strides == nullptr || strides[i] == sizeof(double))
+        {
+            views[i] = columns[i] + offset;
+        }
+        else
+        {
+            // Gathered into the parameter's own register, which no instruction writes to.
+            const char* src = (const char*)(columns[i]) + offset * strides[i];
+            ptrdiff_t stride = strides[i];
+            double* dst = memory + i * BATCH_SIZE;
+            for(int j = 0 ; j < count ; j++)
+            {
+                dst[j] = *(const double*)(src + j * stride);
+            }
+            views[i] = dst;
+        }
+    }
+    
+    const double** scratch = views + this->registerCount;
+    const RegisterInstruction* ins = this->code;
+    const RegisterInstruction* end = this->code + this->length;
+    for( ; ins != end ; ins++)
+    {
+        PROFILE_INSTRUCTION(ins->opcode, count);
+        double* dst = memory + ins->target * BATCH_SIZE;
+        const double* lhs = nullptr;
+        const double* rhs = nullptr;
+        if(ins->opcode != OPCODE_INVOKE && !Program::isReduction(ins->opcode))
+        {
+            // Unused operands are register 0.
+            lhs = views[ins->operands[0]];
+            rhs = views[ins->operands[1]];
+        }
+        bool zero = false;
+        switch(ins->opcode)
+        {
+            case OPCODE_NEGATIVE:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = -lhs[i];
+                }
+                break;
+            case OPCODE_NOT:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = (lhs[i] == 0 ? 1.0 : 0.0);
+                }
+                break;
+            case OPCODE_ADDITION:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = lhs[i] + rhs[i];
+                }
+                break;
+            case OPCODE_NEGATION:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = lhs[i] - rhs[i];
+                }
+                break;
+            case OPCODE_MULTIPLICATION:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = lhs[i] * rhs[i];
+                }
+                break;
+            case OPCODE_DIVISION:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    zero |= (rhs[i] == 0);
+                    dst[i] = lhs[i] / rhs[i];
+                }
+                break;
+            case OPCODE_MODDING:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    zero |= (rhs[i] == 0);
+                    dst[i] = fmod(lhs[i], rhs[i]);
+                }
+                break;
+            case OPCODE_POWER:
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = pow(lhs[i], rhs[i]);
+                }
+                break;
+            case OPCODE_INVOKE:
+            {
+                PROFILE_CALL(ins->func);
+                const int* args = this->arguments + ins->operands[0];
+                for(int i = 0 ; i < ins->operands[1] ; i++)
+                {
+                    scratch[i] = views[args[i]];
+                }
+                ins->func->invokeColumns(scratch, count, dst);
+                break;
+            }
+            case OPCODE_MULTIPLY_ADD:
+            {
+                const double* addend = views[ins->operands[2]];
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = MULTIPLY_ADD(lhs[i], rhs[i], addend[i]);
+                }
+                break;
+            }
+            case OPCODE_SELECT:
+            {
+                const double* otherwise = views[ins->operands[2]];
+                for(int i = 0 ; i < count ; i++)
+                {
+                    dst[i] = (lhs[i] != 0 ? rhs[i] : otherwise[i]);
+                }
+                break;
+            }
+            case OPCODE_SUM:
+            case OPCODE_PRODUCT:
+            case OPCODE_DOT:
+            case OPCODE_MINIMUM:
+            case OPCODE_MAXIMUM:
+                Program::reduce(ins->opcode, views + ins->operands[0], views + ins->operands[1], ins->operands[2], count, dst);
+                break;
+            default:
+                Program::compare(ins->opcode, lhs, rhs, count, dst);
+                break;
+        }
+        if(zero)
+        {
+            throw DividedByZeroException();
+        }
+    }
+    for(int i = 0 ; i < this->resultCount ; i++)
+    {
+        memcpy(results[i] + offset, views[this->results[i]], count * sizeof(double));
+    }
+}
+
+void RegisterProgram::runBatch(const double* const* columns, const ptrdiff_t* strides, int rows, double* results) const
+{
+    this->runBatch(columns, strides, rows, &results);
+}
+
+void RegisterProgram::runBatch(const double* const* columns, const ptrdiff_t* strides, int rows, double* const* results) const
+{
+    // One block per register, with the arguments of calls as views only. Constants are filled once for all blocks.
+    const int BATCH_SIZE = Program::BATCH_SIZE;
+    double* memory = new double[this->registerCount * BATCH_SIZE];
+    const double** views = new const double*[this->registerCount + this->maxArguments];
+    for(int i = this->varCount ; i < this->registerCount ; i++)
+    {
+        views[i] = memory + i * BATCH_SIZE;
+    }
+    for(int i = 0 ; i < this->constantCount ; i++)
+    {
+        double* block = memory + (this->varCount + i) * BATCH_SIZE;
+        for(int j = 0 ; j < BATCH_SIZE ; j++)
+        {
+            block[j] = this->constants[i];
+        }
+    }
+    try
+    {
+        for(int offset = 0 ; offset < rows ; offset += BATCH_SIZE)
+        {
+            int count = (rows - offset < BATCH_SIZE ? rows - offset : BATCH_SIZE);
+            try
+            {
+                this->executeBatch(columns, strides, offset, count, memory, views, results);
+            }
+            catch(const DividedByZeroException& ex)
+            {
+                this->runRows(columns, strides, offset, count, results);
+            }
+        }
+    }
+    catch(...)
+    {
+        delete[] memory;
+        delete[] views;
+        throw;
+    }
+    delete[] memory;
+    delete[] views;
+}
+
+void RegisterProgram::runRows(const double* const* columns, const ptrdiff_t* strides, int offset, int count, double* const* results) const
+{
+    vector<double> operands(this->varCount + 1);
+    vector<double> values(this->resultCount);
+    for(int i = 0 ; i < count ; i++)
+    {
+        Program::gather(columns, strides, this->varCount, offset + i, operands.data());
+        this->run(operands.data(), values.data());
+        for(int j = 0 ; j < this->resultCount ; j++)
+        {
+            results[j][offset + i] = values[j];
+        }
+    }
+}
+
+int RegisterProgram::getLength() const
+{
+    return this->length;
+}
+
+int RegisterProgram::getRegisterCount() const
+{
+    return this->registerCount;
+}
+
+const RegisterInstruction* RegisterProgram::getCode() const
+{
+    return this->code;
+}
+
+size_t RegisterProgram::getMemoryBytes() const
+{
+    return this->arena->getReservedBytes();
+}
@@ -0,0 +1,198 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stddef.h>
+
+#include "util/Arena.hpp"
+#include "Program.hpp"
+
+#ifndef __TANGENT_MATH_FUNC__REGISTER_PROGRAM
+#define __TANGENT_MATH_FUNC__REGISTER_PROGRAM 65536
+
+/*
+ * A three-address step of a RegisterProgram: "target" = opcode(operands).
+ */
+struct RegisterInstruction
+{
+    /*
+     * One of the OpCode values, neither OPCODE_CONSTANT, OPCODE_VARIABLE nor OPCODE_STORE.
+     */
+    int opcode;
+    
+    int target;
+    
+    /*
+     * Registers read, "rhs" first for OPCODE_NEGATIVE, all three for OPCODE_MULTIPLY_ADD.
+     *  For OPCODE_INVOKE, the first entry of the call in the argument table, and the argument count.
+     *  For reductions, the first register of each array, and the length of the arrays.
+     */
+    int operands[3];
+    
+    /*
+     * Callee of OPCODE_INVOKE.
+     */
+    const MathFunction* func;
+    
+    /*
+     * Address of the handler of the opcode in RegisterProgram::execute() under threaded dispatch, nullptr otherwise.
+     */
+    const void* handler;
+};
+
+/*
+ * The register form of a Program, run in its place under BACKEND_REGISTER.
+ *  Every intermediate value gets a register of its own instead of a stack slot, so loads of variables and constants,
+ *  and stores of the arguments of inlined callees, vanish: variables are read from their parameter registers,
+ *  constants from registers filled once per run, and the arguments of inlined callees are renamed.
+ *
+ * Registers are laid out as the parameters, the constants, and the temporaries. Temporaries are reused by linear scan,
+ *  a register being freed after the last instruction reading it, so that the working set stays as small as the widest
+ *  point of the expression. The arguments of a call are copied behind the temporaries.
+ */
+class RegisterProgram
+{
+    private:
+        /*
+         * Arena holding this object, its code, its constants and its argument table.
+         */
+        Arena* arena;
+        
+        RegisterInstruction* code;
+        
+        int length;
+        
+        int varCount;
+        
+        /*
+         * Values of the registers behind the parameters.
+         */
+        double* constants;
+        
+        int constantCount;
+        
+        /*
+         * Registers of every kind, arguments of calls excluded.
+         */
+        int registerCount;
+        
+        /*
+         * Argument registers of every call, one after another.
+         */
+        int* arguments;
+        
+        /*
+         * Largest argument count of a call, i.e. slots reserved behind the registers.
+         */
+        int maxArguments;
+        
+        /*
+         * Registers holding the value of each fused program, see fuse().
+         */
+        int* results;
+        
+        int resultCount;
+        
+        RegisterProgram();
+        
+        /*
+         * Use RegisterProgram::release() instead.
+         */
+        ~RegisterProgram();
+        
+        // Disabled
+        RegisterProgram(const RegisterProgram&);
+        void operator=(const RegisterProgram&);
+        
+        /*
+         * Param(s):
+         *    registers    -> The register file, loaded. If nullptr, execute() only hands out the addresses of its handlers.
+         */
+        double execute(double* registers) const;
+        
+        /*
+         * Same as Program::executeGuarded(), every fused program included.
+         */
+        void executeGuarded(const double* operands, double* results) const;
+        
+        /*
+         * Handler of an opcode in execute() under threaded dispatch, nullptr otherwise.
+         */
+        static const void* getHandler(int opcode);
+        
+        /*
+         * Run one block of at most Program::BATCH_SIZE rows. Every register is a block of values, and views point at the block
+         *  a register holds, which is an input column for the parameters. Views of the other registers are set by runBatch().
+         */
+        void executeBatch(const double* const* columns, const ptrdiff_t* strides, int offset, int count, double* memory, const double** views, double* const* results) const;
+        
+        /*
+         * Same as Program::runRows(), every fused program included.
+         */
+        void runRows(const double* const* columns, const ptrdiff_t* strides, int offset, int count, double* const* results) const;
+        
+        /*
+         * Translate valid programs into a single one computing all of their values. Instructions computing a value
+         *  already computed, by the same program or another one, are dropped, so that common subexpressions, and calls of
+         *  the same callee with the same arguments, are evaluated once.
+         *
+         * Param(s):
+         *    params      -> For each program, the parameter of the fused program passed as each of its variables.
+         *                   If nullptr, every program takes the parameters in order.
+         *    varCount    -> Parameters of the fused program.
+         *
+         * Return:
+         *    nullptr if a program is invalid.
+         */
+        static RegisterProgram* fuse(const Program* const* progs, const int* const* params, int programCount, int varCount);
+    
+    public:
+        /*
+         * Translate a valid program.
+         *
+         * Return:
+         *    nullptr if the program is invalid.
+         */
+        static RegisterProgram* translate(const Program* prog);
+        
+        /*
+         * Destroy a program along with its arena. Accepts nullptr.
+         */
+        static void release(RegisterProgram* prog);
+        
+        /*
+         * Same as Program::run().
+         */
+        double run(const double* operands) const;
+        
+        /*
+         * Evaluate every fused program, see EvaluationPlan::run().
+         */
+        void run(const double* operands, double* results) const;
+        
+        /*
+         * Same as Program::runBatch().
+         */
+        void runBatch(const double* const* columns, const ptrdiff_t* strides, int rows, double* results) const;
+        
+        /*
+         * Evaluate every fused program, each one into its own array of results.
+         */
+        void runBatch(const double* const* columns, const ptrdiff_t* strides, int rows, double* const* results) const;
+        
+        int getLength() const;
+        
+        int getRegisterCount() const;
+        
+        const RegisterInstruction* getCode() const;
+        
+        size_t getMemoryBytes() const;
+    
+    friend class EvaluationPlan;
+};
+
+#endif
@@ -0,0 +1,486 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <float.h>
+#include <math.h>
+#include <algorithm>
+
+#include "misc/TFException.hpp"
+#include "RootFinder.hpp"
+
+/*
+ * Evaluates a function for a subset of the rows of a block, at one value of the solved variable per row.
+ *  The parameters of those rows are gathered into contiguous columns first, so the evaluation is a single batch.
+ */
+class RootEvaluator
+{
+    private:
+        const double* const* columns;
+        
+        int slot;
+        
+        int varCount;
+        
+        /*
+         * First row of the current block.
+         */
+        int first;
+        
+        vector<double> gathered;
+        
+        vector<const double*> views;
+    
+    public:
+        RootEvaluator(const double* const* _columns, int _slot, int _varCount, int capacity) : columns(_columns), slot(_slot), varCount(_varCount), first(0)
+        {
+            this->gathered.resize((size_t)(_varCount) * capacity);
+            this->views.resize(_varCount);
+            for(int v = 0 ; v < _varCount ; v++)
+            {
+                this->views[v] = this->gathered.data() + (size_t)(v) * capacity;
+            }
+        }
+        
+        void setBlock(int _first)
+        {
+            this->first = _first;
+        }
+        
+        /*
+         * Gather the parameters of "count" rows of the block, with "x" as the solved variable.
+         */
+        void gather(const int* rows, const double* x, int count)
+        {
+            for(int v = 0 ; v < this->varCount ; v++)
+            {
+                double* column = const_cast<double*>(this->views[v]);
+                if(v == this->slot)
+                {
+                    copy(x, x + count, column);
+                    continue;
+                }
+                const double* source = this->columns[v] + this->first;
+                for(int i = 0 ; i < count ; i++)
+                {
+                    column[i] = source[rows[i]];
+                }
+            }
+        }
+        
+        /*
+         * Evaluate at the gathered rows. Rows which fail to evaluate get NaN.
+         */
+        void run(const MathFunction& func, int count, double* results)
+        {
+            try
+            {
+                func.invokeBatch(this->views.data(), count, results);
+            }
+            catch(const exception& ex)
+            {
+                // One bad row fails the whole batch, so redo it row by row and only give up on the rows that fail.
+                vector<const double*> single(this->varCount);
+                for(int i = 0 ; i < count ; i++)
+                {
+                    for(int v = 0 ; v < this->varCount ; v++)
+                    {
+                        single[v] = this->views[v] + i;
+                    }
+                    try
+                    {
+                        func.invokeBatch(single.data(), 1, results + i);
+                    }
+                    catch(const exception& ex)
+                    {
+                        results[i] = nan("");
+                    }
+                }
+            }
+        }
+};
+
+/*
+ * Brent's method as in zeroin: "b" is the best estimate, "a" the previous one, and the root lies between "b" and "c".
+ */
+struct BrentState
+{
+    double a, b, c;
+    double fa, fb, fc;
+    
+    /*
+     * Last step and the one before it.
+     */
+    double d, e;
+};
+
+/*
+ * Newton's method safeguarded by bisection, the function being negative at "xl" and positive at "xh".
+ */
+struct NewtonState
+{
+    double xl, xh;
+    double x, f, df;
+    
+    /*
+     * Last step and the one before it.
+     */
+    double dx, dxold;
+};
+
+RootFinder::RootFinder(double tolerance, int maxIterations)
+{
+    if(!(tolerance > 0) || maxIterations < 1)
+    {
+        throw InvalidArgumentException("The tolerance and the iteration limit must be positive.");
+    }
+    this->tolerance = tolerance;
+    this->maxIterations = maxIterations;
+}
+
+int RootFinder::solveBrent(const MathFunction& func, int slot, const double* const* columns, const double* lower, const double* upper, int rows, double* roots, int* iterations, int* status) const
+{
+    RootEvaluator evaluator(columns, slot, func.getIdentifier().getVariablesCount(), 2 * BLOCK_ROWS);
+    vector<BrentState> states(BLOCK_ROWS);
+    vector<int> active(2 * BLOCK_ROWS);
+    vector<double> x(2 * BLOCK_ROWS);
+    vector<double> fx(2 * BLOCK_ROWS);
+    int converged = 0;
+    
+    for(int first = 0 ; first < rows ; first += BLOCK_ROWS)
+    {
+        int count = (rows - first < BLOCK_ROWS ? rows - first : BLOCK_ROWS);
+        evaluator.setBlock(first);
+        
+        // Both ends of every bracket in one batch.
+        for(int i = 0 ; i < count ; i++)
+        {
+            active[i] = i;
+            active[count + i] = i;
+            x[i] = lower[first + i];
+            x[count + i] = upper[first + i];
+        }
+        evaluator.gather(active.data(), x.data(), 2 * count);
+        evaluator.run(func, 2 * count, fx.data());
+        
+        int n = 0;
+        for(int i = 0 ; i < count ; i++)
+        {
+            BrentState& s = states[i];
+            s.a = lower[first + i];
+            s.b = upper[first + i];
+            s.fa = fx[i];
+            s.fb = fx[count + i];
+            iterations[first + i] = 0;
+            roots[first + i] = nan("");
+            if(!(isfinite(s.fa) && isfinite(s.fb)))
+            {
+                status[first + i] = ROOT_NOT_FINITE;
+            }
+            else if((s.fa > 0 && s.fb > 0) || (s.fa < 0 && s.fb < 0))
+            {
+                status[first + i] = ROOT_NOT_BRACKETED;
+            }
+            else
+            {
+                s.c = s.b;
+                s.fc = s.fb;
+                active[n++] = i;
+            }
+        }
+        
+        for(int iter = 1 ; n > 0 ; iter++)
+        {
+            // Step every running row, keeping those which have not converged yet.
+            int m = 0;
+            for(int j = 0 ; j < n ; j++)
+            {
+                int i = active[j];
+                int r = first + i;
+                BrentState& s = states[i];
+                if(!isfinite(s.fb))
+                {
+                    status[r] = ROOT_NOT_FINITE;
+                    iterations[r] = iter - 1;
+                    continue;
+                }
+                if((s.fb > 0 && s.fc > 0) || (s.fb < 0 && s.fc < 0))
+                {
+                    s.c = s.a;
+                    s.fc = s.fa;
+                    s.d = s.b - s.a;
+                    s.e = s.d;
+                }
+                if(fabs(s.fc) < fabs(s.fb))
+                {
+                    s.a = s.b;
+                    s.b = s.c;
+                    s.c = s.a;
+                    s.fa = s.fb;
+                    s.fb = s.fc;
+                    s.fc = s.fa;
+                }
+                
+                double tol = 2 * DBL_EPSILON * fabs(s.b) + 0.5 * this->tolerance;
+                double xm = 0.5 * (s.c - s.b);
+                roots[r] = s.b;
+                iterations[r] = iter - 1;
+                if(fabs(xm) <= tol || s.fb == 0)
+                {
+                    status[r] = ROOT_CONVERGED;
+                    converged++;
+                    continue;
+                }
+                if(iter > this->maxIterations)
+                {
+                    status[r] = ROOT_MAX_ITERATIONS;
+                    continue;
+                }
+                
+                if(fabs(s.e) >= tol && fabs(s.fa) > fabs(s.fb))
+                {
+                    // Inverse quadratic interpolation, or the secant method if only two points are distinct.
+                    double p, q;
+                    double t = s.fb / s.fa;
+                    if(s.a == s.c)
+                    {
+                        p = 2 * xm * t;
+                        q = 1 - t;
+                    }
+                    else
+                    {
+                        double u = s.fa / s.fc;
+                        double v = s.fb / s.fc;
+                        p = t * (2 * xm * u * (u - v) - (s.b - s.a) * (v - 1));
+                        q = (u - 1) * (v - 1) * (t - 1);
+                    }
+                    if(p > 0)
+                    {
+                        q = -q;
+                    }
+                    p = fabs(p);
+                    
+                    // Accept the interpolation only if it falls within the bracket and shrinks fast enough, otherwise bisect.
+                    if(2 * p < min(3 * xm * q - fabs(tol * q), fabs(s.e * q)))
+                    {
+                        s.e = s.d;
+                        s.d = p / q;
+                    }
+                    else
+                    {
+                        s.d = xm;
+                        s.e = s.d;
+                    }
+                }
+                else
+                {
+                    s.d = xm;
+                    s.e = s.d;
+                }
+                s.a = s.b;
+                s.fa = s.fb;
+                s.b += (fabs(s.d) > tol ? s.d : copysign(tol, xm));
+                
+                active[m] = i;
+                x[m] = s.b;
+                m++;
+            }
+            
+            n = m;
+            if(n > 0)
+            {
+                evaluator.gather(active.data(), x.data(), n);
+                evaluator.run(func, n, fx.data());
+                for(int j = 0 ; j < n ; j++)
+                {
+                    states[active[j]].fb = fx[j];
+                }
+            }
+        }
+    }
+    return converged;
+}
+
+int RootFinder::solveNewton(const MathFunction& func, const MathFunction& derivative, int slot, const double* const* columns, const double* lower, const double* upper, int rows, double* roots, int* iterations, int* status) const
+{
+    RootEvaluator evaluator(columns, slot, func.getIdentifier().getVariablesCount(), 2 * BLOCK_ROWS);
+    vector<NewtonState> states(BLOCK_ROWS);
+    vector<int> active(2 * BLOCK_ROWS);
+    vector<double> x(2 * BLOCK_ROWS);
+    vector<double> fx(2 * BLOCK_ROWS);
+    vector<double> dfx(BLOCK_ROWS);
+    int converged = 0;
+    
+    for(int first = 0 ; first < rows ; first += BLOCK_ROWS)
+    {
+        int count = (rows - first < BLOCK_ROWS ? rows - first : BLOCK_ROWS);
+        evaluator.setBlock(first);
+        
+        for(int i = 0 ; i < count ; i++)
+        {
+            active[i] = i;
+            active[count + i] = i;
+            x[i] = lower[first + i];
+            x[count + i] = upper[first + i];
+        }
+        evaluator.gather(active.data(), x.data(), 2 * count);
+        evaluator.run(func, 2 * count, fx.data());
+        
+        // Rows bracketed start from the midpoint.
+        int n = 0;
+        for(int i = 0 ; i < count ; i++)
+        {
+            int r = first + i;
+            double lo = lower[r];
+            double hi = upper[r];
+            double flo = fx[i];
+            double fhi = fx[count + i];
+            iterations[r] = 0;
+            roots[r] = nan("");
+            if(!(isfinite(flo) && isfinite(fhi)))
+            {
+                status[r] = ROOT_NOT_FINITE;
+            }
+            else if((flo > 0 && fhi > 0) || (flo < 0 && fhi < 0))
+            {
+                status[r] = ROOT_NOT_BRACKETED;
+            }
+            else if(flo == 0 || fhi == 0)
+            {
+                roots[r] = (flo == 0 ? lo : hi);
+                status[r] = ROOT_CONVERGED;
+                converged++;
+            }
+            else
+            {
+                NewtonState& s = states[i];
+                s.xl = (flo < 0 ? lo : hi);
+                s.xh = (flo < 0 ? hi : lo);
+                s.x = 0.5 * (lo + hi);
+                s.dxold = fabs(hi - lo);
+                s.dx = s.dxold;
+                active[n] = i;
+                x[n] = s.x;
+                n++;
+            }
+        }
+        
+        for(int iter = 1 ; n > 0 ; iter++)
+        {
+            evaluator.gather(active.data(), x.data(), n);
+            evaluator.run(func, n, fx.data());
+            evaluator.run(derivative, n, dfx.data());
+            
+            int m = 0;
+            for(int j = 0 ; j < n ; j++)
+            {
+                int i = active[j];
+                int r = first + i;
+                NewtonState& s = states[i];
+                s.f = fx[j];
+                s.df = dfx[j];
+                roots[r] = s.x;
+                iterations[r] = iter;
+                if(!isfinite(s.f))
+                {
+                    status[r] = ROOT_NOT_FINITE;
+                    continue;
+                }
+                if(s.f == 0)
+                {
+                    status[r] = ROOT_CONVERGED;
+                    converged++;
+                    continue;
+                }
+                if(s.f < 0)
+                {
+                    s.xl = s.x;
+                }
+                else
+                {
+                    s.xh = s.x;
+                }
+                
+                // Bisect whenever the Newton step would leave the bracket, or would not halve the step before last.
+                bool bisect = !isfinite(s.df) || ((s.x - s.xh) * s.df - s.f) * ((s.x - s.xl) * s.df - s.f) > 0 || fabs(2 * s.f) > fabs(s.dxold * s.df);
+                s.dxold = s.dx;
+                if(bisect)
+                {
+                    s.dx = 0.5 * (s.xh - s.xl);
+                    s.x = s.xl + s.dx;
+                }
+                else
+                {
+                    s.dx = s.f / s.df;
+                    s.x -= s.dx;
+                }
+                if(fabs(s.dx) < this->tolerance)
+                {
+                    roots[r] = s.x;
+                    status[r] = ROOT_CONVERGED;
+                    converged++;
+                    continue;
+                }
+                if(iter >= this->maxIterations)
+                {
+                    status[r] = ROOT_MAX_ITERATIONS;
+                    continue;
+                }
+                
+                active[m] = i;
+                x[m] = s.x;
+                m++;
+            }
+            n = m;
+        }
+    }
+    return converged;
+}
+
+int RootFinder::solve(const MathFunction& func, const MathFunction* derivative, const string& variable, const double* const* columns, const double* lower, const double* upper, int rows, double* roots, int* iterations, int* status) const
+{
+    int varCount = func.getIdentifier().getVariablesCount();
+    if(derivative != nullptr && derivative->getIdentifier().getVariablesCount() != varCount)
+    {
+        throw InvalidArgumentException("The derivative must take the same variables as the function.");
+    }
+    
+    int slot = 0;
+    while(slot < varCount && func.getVariableName(slot) != variable)
+    {
+        slot++;
+    }
+    if(slot == varCount)
+    {
+        throw InvalidArgumentException(("Unknown variable: " + variable).c_str());
+    }
+    
+    // Counts and statuses are always tracked, into scratch space if not wanted.
+    vector<int> scratch;
+    if(iterations == nullptr || status == nullptr)
+    {
+        scratch.resize(2 * (size_t)(rows));
+        iterations = (iterations != nullptr ? iterations : scratch.data());
+        status = (status != nullptr ? status : scratch.data() + rows);
+    }
+    
+    if(derivative == nullptr)
+    {
+        return this->solveBrent(func, slot, columns, lower, upper, rows, roots, iterations, status);
+    }
+    return this->solveNewton(func, *derivative, slot, columns, lower, upper, rows, roots, iterations, status);
+}
+
+int RootFinder::solve(const MathFunction& func, const string& variable, const double* const* columns, const double* lower, const double* upper, int rows, double* roots, int* iterations, int* status) const
+{
+    return this->solve(func, nullptr, variable, columns, lower, upper, rows, roots, iterations, status);
+}
+
+int RootFinder::solve(const MathFunction& func, const MathFunction& derivative, const string& variable, const double* const* columns, const double* lower, const double* upper, int rows, double* roots, int* iterations, int* status) const
+{
+    return this->solve(func, &derivative, variable, columns, lower, upper, rows, roots, iterations, status);
+}
@@ -0,0 +1,102 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <string>
+#include <vector>
+
+#include "TangentsMathFunc.hpp"
+
+#ifndef __TANGENT_MATH_FUNC__ROOT_FINDER
+#define __TANGENT_MATH_FUNC__ROOT_FINDER 65536
+
+using namespace std;
+
+/*
+ * Outcome of solving one row.
+ */
+enum RootStatus
+{
+    ROOT_CONVERGED,
+    
+    /*
+     * The function has the same sign at both ends of the bracket.
+     */
+    ROOT_NOT_BRACKETED,
+    
+    /*
+     * The iteration limit was reached. The best estimate so far is reported.
+     */
+    ROOT_MAX_ITERATIONS,
+    
+    /*
+     * The function is NaN or infinite somewhere on the way, or failed to evaluate, e.g. divided by zero.
+     */
+    ROOT_NOT_FINITE
+};
+
+/*
+ * Solves f(x; params) = 0 for x on many rows at once, each row having its own parameters and bracket.
+ *  All rows iterate in lockstep: every iteration gathers the rows still running, evaluates them by one invokeBatch() call,
+ *  and drops those that have converged. Rows are processed in blocks of BLOCK_ROWS, so memory use does not depend on their number.
+ *
+ * Without a derivative, each row runs Brent's method. With one, each row runs Newton's method safeguarded by bisection,
+ *  which keeps the iterate within the bracket.
+ */
+class RootFinder
+{
+    private:
+        double tolerance;
+        
+        int maxIterations;
+        
+        // Disabled
+        RootFinder(const RootFinder&);
+        void operator=(const RootFinder&);
+        
+        int solve(const MathFunction& func, const MathFunction* derivative, const string& variable, const double* const* columns, const double* lower, const double* upper, int rows, double* roots, int* iterations, int* status) const;
+        
+        int solveBrent(const MathFunction& func, int slot, const double* const* columns, const double* lower, const double* upper, int rows, double* roots, int* iterations, int* status) const;
+        
+        int solveNewton(const MathFunction& func, const MathFunction& derivative, int slot, const double* const* columns, const double* lower, const double* upper, int rows, double* roots, int* iterations, int* status) const;
+    
+    public:
+        static const int BLOCK_ROWS = 4096;
+        
+        /*
+         * Param(s):
+         *    tolerance        -> Absolute tolerance of the roots. Rows also stop once the function is exactly 0.
+         *    maxIterations    -> Evaluations per row after those at the ends of the bracket.
+         */
+        RootFinder(double tolerance = 1e-12, int maxIterations = 100);
+        
+        /*
+         * Solve every row by Brent's method, e.g. x^2 = c for a column of c:
+         *  MathFunction f("f(x, c)", "x^2 - c");
+         *  const double* columns[] = {nullptr, cs};
+         *  finder.solve(f, "x", columns, lowers, uppers, rows, roots, iterations, status);
+         *
+         * Param(s):
+         *    columns         -> One array of "rows" values per variable. The solved variable's array is ignored and may be nullptr.
+         *    lower, upper    -> Bracket of each row. The function must change sign across it.
+         *    roots           -> Receives "rows" roots, NaN for rows not bracketed or not finite.
+         *    iterations      -> Receives the number of iterations of each row. May be nullptr.
+         *    status          -> Receives a RootStatus per row. May be nullptr.
+         *
+         * Return:
+         *    Number of rows converged.
+         */
+        int solve(const MathFunction& func, const string& variable, const double* const* columns, const double* lower, const double* upper, int rows, double* roots, int* iterations = nullptr, int* status = nullptr) const;
+        
+        /*
+         * Same as above by safeguarded Newton's method. "derivative" is the partial derivative of "func" in the solved variable,
+         *  taking the same variables in the same order.
+         */
+        int solve(const MathFunction& func, const MathFunction& derivative, const string& variable, const double* const* columns, const double* lower, const double* upper, int rows, double* roots, int* iterations = nullptr, int* status = nullptr) const;
+};
+
+#endif
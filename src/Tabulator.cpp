@@ -0,0 +1,391 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <math.h>
+#include <algorithm>
+
+#include "misc/TFException.hpp"
+#include "Tabulator.hpp"
+
+static const double PI = 3.14159265358979323846;
+
+/*
+ * Sum of c[k] T_k(t) for k < n, with c[0] already halved.
+ */
+static inline double clenshaw(const double* c, int n, double t)
+{
+    double b1 = 0, b2 = 0;
+    double t2 = t + t;
+    for(int k = n - 1 ; k > 0 ; k--)
+    {
+        double b0 = c[k] + t2 * b1 - b2;
+        b2 = b1;
+        b1 = b0;
+    }
+    return c[0] + t * b1 - b2;
+}
+
+/*
+ * Interpolant of a piece at local coordinates in [-1, 1]. Two variables take one recurrence along the second variable
+ *  per coefficient of the first one.
+ */
+static inline double evaluatePiece(const double* c, int n, int dims, const double* t)
+{
+    if(dims == 1)
+    {
+        return clenshaw(c, n, t[0]);
+    }
+    double inner[Tabulator::MAX_DEGREE + 1];
+    for(int i = 0 ; i < n ; i++)
+    {
+        inner[i] = clenshaw(c + i * n, n, t[1]);
+    }
+    return clenshaw(inner, n, t[0]);
+}
+
+/*
+ * The interpolant installed into a tabulated function. Not in any namespace, and evaluated like a built-in.
+ */
+class MathFunctionTable : public MathFunction
+{
+    private:
+        int dims;
+        
+        /*
+         * Coefficients per piece and variable, i.e. the degree plus one.
+         */
+        int order;
+        
+        int pieces[2];
+        
+        double lower[2];
+        
+        double upper[2];
+        
+        /*
+         * Pieces per unit along each variable.
+         */
+        double scale[2];
+        
+        vector<double> coefficients;
+        
+        /*
+         * The formula, compiled when tabulated, for arguments outside of the box.
+         */
+        Program* exact;
+        
+        double evaluate(const double* operands) const;
+    
+    protected:
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
+    
+    public:
+        /*
+         * Takes over the coefficients. "func" MUST NOT be tabulated already.
+         */
+        MathFunctionTable(MathFunctionNamespace& ns, const MathFunction& func, int _dims, int _order, const int* _pieces, const double* _lower, const double* _upper, vector<double>& _coefficients);
+        
+        ~MathFunctionTable();
+};
+
+MathFunctionTable::MathFunctionTable(MathFunctionNamespace& ns, const MathFunction& func, int _dims, int _order, const int* _pieces, const double* _lower, const double* _upper, vector<double>& _coefficients) :
+    MathFunction(ns, new MathFunctionIdentifier(func.getIdentifier().getName(), _dims), "")
+{
+    this->dims = _dims;
+    this->order = _order;
+    for(int d = 0 ; d < 2 ; d++)
+    {
+        this->pieces[d] = _pieces[d];
+        this->lower[d] = _lower[d];
+        this->upper[d] = _upper[d];
+        this->scale[d] = _pieces[d] / (_upper[d] - _lower[d]);
+    }
+    this->coefficients.swap(_coefficients);
+    this->exact = Program::compile(func, true);
+}
+
+MathFunctionTable::~MathFunctionTable()
+{
+    Program::release(this->exact);
+}
+
+double MathFunctionTable::evaluate(const double* operands) const
+{
+    int offset = 0;
+    double t[2];
+    for(int d = 0 ; d < this->dims ; d++)
+    {
+        // Also false for NaN.
+        if(!(operands[d] >= this->lower[d] && operands[d] <= this->upper[d]))
+        {
+            return this->exact->run(operands);
+        }
+        double u = (operands[d] - this->lower[d]) * this->scale[d];
+        int piece = min((int)u, this->pieces[d] - 1);
+        t[d] = 2 * (u - piece) - 1;
+        offset = offset * this->pieces[d] + piece;
+    }
+    int stride = (this->dims == 1 ? this->order : this->order * this->order);
+    return evaluatePiece(this->coefficients.data() + (size_t)(offset) * stride, this->order, this->dims, t);
+}
+
+double MathFunctionTable::invoke(const double* operands) const
+{
+    return this->evaluate(operands);
+}
+
+void MathFunctionTable::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    double row[2];
+    for(int i = 0 ; i < rows ; i++)
+    {
+        for(int d = 0 ; d < this->dims ; d++)
+        {
+            row[d] = columns[d][i];
+        }
+        results[i] = this->evaluate(row);
+    }
+}
+
+Tabulator::Tabulator(double absTolerance, double relTolerance, int degree, int maxPieces)
+{
+    if(!(absTolerance >= 0 && relTolerance >= 0) || degree < 1 || degree > MAX_DEGREE || maxPieces < 1)
+    {
+        throw InvalidArgumentException("Tolerances must not be negative, the degree must be within [1, MAX_DEGREE], and at least one piece is needed.");
+    }
+    this->absTolerance = absTolerance;
+    this->relTolerance = relTolerance;
+    this->degree = degree;
+    this->maxPieces = maxPieces;
+}
+
+bool Tabulator::fit(const MathFunction& func, int dims, const double* lower, const double* upper, vector<double>& coefficients, bool* failing, TabulationResult& result) const
+{
+    int n = this->degree + 1;
+    const int* pieces = result.pieces;
+    int count = pieces[0] * pieces[1];
+    
+    // Chebyshev nodes, the extrema of T_n as test points, and T_j at each node.
+    vector<double> nodes(n), tests(n + 1), chebyshev(n * n);
+    for(int k = 0 ; k < n ; k++)
+    {
+        nodes[k] = cos(PI * (k + 0.5) / n);
+        for(int j = 0 ; j < n ; j++)
+        {
+            chebyshev[j * n + k] = cos(PI * j * (k + 0.5) / n);
+        }
+    }
+    for(int k = 0 ; k <= n ; k++)
+    {
+        tests[k] = cos(PI * k / n);
+    }
+    
+    // Local coordinates of the test points of a piece. With two variables, those on a node line of one variable
+    //  measure the error along the other one alone, which is the kind 0 or 1 of the point. The rest are of kind 2.
+    vector<double> testLocal[2];
+    vector<int> kinds;
+    if(dims == 1)
+    {
+        testLocal[0] = tests;
+        kinds.assign(n + 1, 0);
+    }
+    else
+    {
+        for(int kind = 0 ; kind < 3 ; kind++)
+        {
+            const vector<double>& first = (kind == 1 ? nodes : tests);
+            const vector<double>& second = (kind == 0 ? nodes : tests);
+            for(double a : first)
+            {
+                for(double b : second)
+                {
+                    testLocal[0].push_back(a);
+                    testLocal[1].push_back(b);
+                    kinds.push_back(kind);
+                }
+            }
+        }
+    }
+    
+    int nodeRows = (dims == 1 ? n : n * n);
+    int testRows = (int)(kinds.size());
+    size_t rows = (size_t)(count) * (nodeRows + testRows);
+    vector<double> buffer((dims + 1) * rows);
+    const double* columns[2];
+    double width[2];
+    for(int d = 0 ; d < dims ; d++)
+    {
+        columns[d] = buffer.data() + d * rows;
+        width[d] = (upper[d] - lower[d]) / pieces[d];
+    }
+    
+    // Rows of the nodes of every piece, then of the test points of every piece.
+    for(int p = 0 ; p < count ; p++)
+    {
+        int index[2] = {(dims == 1 ? p : p / pieces[1]), p % pieces[1]};
+        double* x[2];
+        for(int d = 0 ; d < dims ; d++)
+        {
+            x[d] = const_cast<double*>(columns[d]);
+        }
+        for(int r = 0 ; r < nodeRows ; r++)
+        {
+            int local[2] = {(dims == 1 ? r : r / n), r % n};
+            for(int d = 0 ; d < dims ; d++)
+            {
+                x[d][(size_t)(p) * nodeRows + r] = lower[d] + (index[d] + (nodes[local[d]] + 1) / 2) * width[d];
+            }
+        }
+        for(int r = 0 ; r < testRows ; r++)
+        {
+            for(int d = 0 ; d < dims ; d++)
+            {
+                x[d][(size_t)(count) * nodeRows + (size_t)(p) * testRows + r] = lower[d] + (index[d] + (testLocal[d][r] + 1) / 2) * width[d];
+            }
+        }
+    }
+    double* values = buffer.data() + dims * rows;
+    func.invokeBatch(columns, (int)(rows), values);
+    result.evaluations += rows;
+    for(size_t r = 0 ; r < rows ; r++)
+    {
+        if(!isfinite(values[r]))
+        {
+            return false;
+        }
+    }
+    
+    // c_j = 2 / n * sum of f(node_k) T_j(node_k) over k, halved for j = 0. Applied along each variable in turn.
+    int stride = (dims == 1 ? n : n * n);
+    coefficients.assign((size_t)(count) * stride, 0);
+    vector<double> partial(stride);
+    for(int p = 0 ; p < count ; p++)
+    {
+        const double* f = values + (size_t)(p) * nodeRows;
+        double* c = coefficients.data() + (size_t)(p) * stride;
+        int inner = (dims == 1 ? 1 : n);
+        // Along the last variable, for each node of the first one.
+        for(int a = 0 ; a < inner ; a++)
+        {
+            for(int j = 0 ; j < n ; j++)
+            {
+                double sum = 0;
+                for(int k = 0 ; k < n ; k++)
+                {
+                    sum += f[a * n + k] * chebyshev[j * n + k];
+                }
+                partial[a * n + j] = sum * (j == 0 ? 1.0 : 2.0) / n;
+            }
+        }
+        if(dims == 1)
+        {
+            copy(partial.begin(), partial.end(), c);
+            continue;
+        }
+        for(int i = 0 ; i < n ; i++)
+        {
+            for(int j = 0 ; j < n ; j++)
+            {
+                double sum = 0;
+                for(int a = 0 ; a < n ; a++)
+                {
+                    sum += partial[a * n + j] * chebyshev[i * n + a];
+                }
+                c[i * n + j] = sum * (i == 0 ? 1.0 : 2.0) / n;
+            }
+        }
+    }
+    
+    bool failed[3] = {false, false, false};
+    result.maxError = 0;
+    for(int p = 0 ; p < count ; p++)
+    {
+        const double* f = values + (size_t)(count) * nodeRows + (size_t)(p) * testRows;
+        const double* c = coefficients.data() + (size_t)(p) * stride;
+        for(int r = 0 ; r < testRows ; r++)
+        {
+            double t[2] = {testLocal[0][r], (dims == 1 ? 0 : testLocal[1][r])};
+            double error = fabs(evaluatePiece(c, n, dims, t) - f[r]);
+            result.maxError = max(result.maxError, error);
+            if(error > max(this->absTolerance, this->relTolerance * fabs(f[r])))
+            {
+                failed[kinds[r]] = true;
+            }
+        }
+    }
+    
+    // Points off both node lines only fail along with one variable, in general. Otherwise both are refined.
+    failing[0] = failed[0] || (failed[2] && !failed[1]);
+    failing[1] = failed[1] || (failed[2] && !failed[0]);
+    return true;
+}
+
+TabulationResult Tabulator::tabulate(MathFunction& func, int dims, const double* lower, const double* upper) const
+{
+    if(func.isBuiltIn())
+    {
+        throw InvalidArgumentException("Built-in functions cannot be tabulated.");
+    }
+    if(func.getIdentifier().getVariablesCount() != dims)
+    {
+        throw InvalidArgumentException("The bounds do not match the variables of the function.");
+    }
+    for(int d = 0 ; d < dims ; d++)
+    {
+        if(!(isfinite(lower[d]) && isfinite(upper[d]) && lower[d] < upper[d]))
+        {
+            throw InvalidArgumentException("Tabulation bounds must be finite and increasing.");
+        }
+    }
+    
+    // Sampled from the formula, not from a previous interpolant.
+    func.untabulate();
+    
+    TabulationResult result;
+    vector<double> coefficients;
+    bool failing[2];
+    while(true)
+    {
+        if(!(this->fit(func, dims, lower, upper, coefficients, failing, result)))
+        {
+            return result;
+        }
+        if(!(failing[0] || failing[1]))
+        {
+            break;
+        }
+        int next[2] = {result.pieces[0], result.pieces[1]};
+        for(int d = 0 ; d < dims ; d++)
+        {
+            next[d] *= (failing[d] ? 2 : 1);
+        }
+        if((long long)(next[0]) * next[1] > this->maxPieces)
+        {
+            return result;
+        }
+        result.pieces[0] = next[0];
+        result.pieces[1] = next[1];
+    }
+    
+    result.converged = true;
+    double box[2][2] = {{lower[0], (dims == 1 ? 0 : lower[1])}, {upper[0], (dims == 1 ? 1 : upper[1])}};
+    func.setTabulation(new MathFunctionTable(func.NAME_SPACE, func, dims, this->degree + 1, result.pieces, box[0], box[1], coefficients));
+    return result;
+}
+
+TabulationResult Tabulator::tabulate(MathFunction& func, double lower, double upper) const
+{
+    return this->tabulate(func, 1, &lower, &upper);
+}
+
+TabulationResult Tabulator::tabulate(MathFunction& func, const double* lower, const double* upper) const
+{
+    return this->tabulate(func, 2, lower, upper);
+}
@@ -0,0 +1,118 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <vector>
+
+#include "TangentsMathFunc.hpp"
+
+#ifndef __TANGENT_MATH_FUNC__TABULATOR
+#define __TANGENT_MATH_FUNC__TABULATOR 65536
+
+using namespace std;
+
+/*
+ * Outcome of a tabulation.
+ */
+struct TabulationResult
+{
+    /*
+     * Pieces along each variable, 1 for the second one of a single-variable function.
+     */
+    int pieces[2] = {1, 1};
+    
+    /*
+     * Largest absolute difference between the interpolant and the function at the test points of the last round.
+     */
+    double maxError = 0;
+    
+    /*
+     * Rows evaluated, test points included.
+     */
+    unsigned long long evaluations = 0;
+    
+    /*
+     * False if the piece limit was hit, or the function is not finite somewhere, before the tolerance was met.
+     *  The function is left evaluating its formula then.
+     */
+    bool converged = false;
+};
+
+/*
+ * Replaces a smooth function of one or two variables, over a box, by a piecewise Chebyshev interpolant.
+ *  The box is cut into a uniform grid of pieces, and the function is interpolated at the Chebyshev nodes of each piece,
+ *  by a tensor product of polynomials for two variables. Evaluating it takes locating the piece, a few arithmetic
+ *  operations, and a Clenshaw recurrence, whatever the cost of the formula.
+ *
+ * The pieces along a variable are doubled until the interpolant meets the tolerance at test points between the nodes,
+ *  i.e. the extrema of the Chebyshev polynomial of the degree, the ends of the pieces included. With two variables,
+ *  only the variables whose interpolation fails are refined.
+ *
+ * Once the tolerance is met, the interpolant is installed into the function itself, so every formula calling it by name,
+ *  existing ones included, evaluates the interpolant instead. Arguments outside of the box are evaluated by the formula.
+ *  Redefining the function or any of its callees, or calling untabulate(), goes back to the formula.
+ *  Installing recompiles the function and its dependents, thus MUST NOT overlap their evaluation by other threads,
+ *  as MathFunction::redefine().
+ */
+class Tabulator
+{
+    private:
+        double absTolerance;
+        
+        double relTolerance;
+        
+        int degree;
+        
+        int maxPieces;
+        
+        // Disabled
+        Tabulator(const Tabulator&);
+        void operator=(const Tabulator&);
+        
+        /*
+         * Interpolate at the nodes of every piece and check the test points.
+         *
+         * Param(s):
+         *    coefficients    -> Receives the Chebyshev coefficients, piece after piece in row-major order.
+         *    failing         -> Receives whether the interpolation along each variable misses the tolerance somewhere.
+         *
+         * Return:
+         *    False if the function is not finite at some node or test point.
+         */
+        bool fit(const MathFunction& func, int dims, const double* lower, const double* upper, vector<double>& coefficients, bool* failing, TabulationResult& result) const;
+        
+        TabulationResult tabulate(MathFunction& func, int dims, const double* lower, const double* upper) const;
+    
+    public:
+        static const int MAX_DEGREE = 32;
+        
+        /*
+         * The interpolant must be within max(absTolerance, relTolerance * |f|) of the function at every test point.
+         *
+         * Param(s):
+         *    degree       -> Degree of the polynomial of each piece along each variable.
+         *                    Higher ones need fewer pieces, but take longer to evaluate.
+         *    maxPieces    -> Limit of the number of pieces, bounding the memory of the interpolant.
+         */
+        Tabulator(double absTolerance = 1e-10, double relTolerance = 1e-10, int degree = 12, int maxPieces = 4096);
+        
+        /*
+         * Tabulate a function of one variable over [lower, upper], e.g.
+         *  MathFunction f("f(x)", "exp(-x^2) * sin(3 * x) / (1 + x^2)");
+         *  TabulationResult r = tabulator.tabulate(f, -4, 4);
+         */
+        TabulationResult tabulate(MathFunction& func, double lower, double upper) const;
+        
+        /*
+         * Tabulate a function of two variables over [lower[0], upper[0]] x [lower[1], upper[1]], e.g.
+         *  double lower[] = {0, -1}, upper[] = {1, 1};
+         *  TabulationResult r = tabulator.tabulate(g, lower, upper);
+         */
+        TabulationResult tabulate(MathFunction& func, const double* lower, const double* upper) const;
+};
+
+#endif
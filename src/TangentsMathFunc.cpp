@@ -6,22 +6,64 @@
  *  https://github.com/tan2pow16/TangentsMathFunc
  */
 
+#include <algorithm>
 #include <initializer_list>
+#include <limits.h>
 #include <math.h>
 #include <string>
 #include <string.h>
+#include <vector>
 
 #include "util/LinkedStack.hpp"
+#include "misc/FastMath.hpp"
 #include "misc/TFException.hpp"
 #include "Operators.hpp"
+#include "RegisterProgram.hpp"
 #include "TangentsMathFunc.hpp"
 
-MathFunctionNamespace& MathFunction::DEFAULT_NAMESPACE = *(new MathFunctionNamespace());
+/*
+ * Look up the compile-time registry of the built-ins, constructing the function found upon its first use.
+ */
+static MathFunction* findBuiltIn(const MathFunctionIdentifier* ident);
+
+unsigned int MathFunction::VISIT_EPOCH = 0;
+
+TierPolicy MathFunction::TIER_POLICY;
+
+Backend MathFunction::BACKEND = BACKEND_STACK;
+
+atomic<unsigned long long> MathFunction::PROMOTIONS(0);
+
+/*
+ * Fast form of a single-argument built-in, called in its place by functions at PRECISION_FAST. Not in any namespace.
+ */
+class MathFunctionApproximation : public MathFunction
+{
+    private:
+        double (*scalar)(double);
+        
+        void (*batch)(const double*, int, double*);
+    
+    protected:
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
+    
+    public:
+        MathFunctionApproximation(MathFunctionNamespace& ns, const string& name, double (*_scalar)(double), void (*_batch)(const double*, int, double*));
+};
 
 class MathFunctionSine : public MathFunction
 {
+    private:
+        MathFunctionApproximation approximation;
+    
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
+        
+        const MathFunction& approximate() const;
     
     public:
         MathFunctionSine(MathFunctionNamespace& ns);
@@ -29,8 +71,15 @@ class MathFunctionSine : public MathFunction
 
 class MathFunctionCosine : public MathFunction
 {
+    private:
+        MathFunctionApproximation approximation;
+    
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
+        
+        const MathFunction& approximate() const;
     
     public:
         MathFunctionCosine(MathFunctionNamespace& ns);
@@ -38,8 +87,15 @@ class MathFunctionCosine : public MathFunction
 
 class MathFunctionTangent : public MathFunction
 {
+    private:
+        MathFunctionApproximation approximation;
+    
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
+        
+        const MathFunction& approximate() const;
     
     public:
         MathFunctionTangent(MathFunctionNamespace& ns);
@@ -48,7 +104,9 @@ class MathFunctionTangent : public MathFunction
 class MathFunctionHyperbolicSine : public MathFunction
 {
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
     
     public:
         MathFunctionHyperbolicSine(MathFunctionNamespace& ns);
@@ -57,7 +115,9 @@ class MathFunctionHyperbolicSine : public MathFunction
 class MathFunctionHyperbolicCosine : public MathFunction
 {
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
     
     public:
         MathFunctionHyperbolicCosine(MathFunctionNamespace& ns);
@@ -66,7 +126,9 @@ class MathFunctionHyperbolicCosine : public MathFunction
 class MathFunctionHyperbolicTangent : public MathFunction
 {
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
     
     public:
         MathFunctionHyperbolicTangent(MathFunctionNamespace& ns);
@@ -75,7 +137,9 @@ class MathFunctionHyperbolicTangent : public MathFunction
 class MathFunctionArcSine : public MathFunction
 {
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
     
     public:
         MathFunctionArcSine(MathFunctionNamespace& ns);
@@ -84,7 +148,9 @@ class MathFunctionArcSine : public MathFunction
 class MathFunctionArcCosine : public MathFunction
 {
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
     
     public:
         MathFunctionArcCosine(MathFunctionNamespace& ns);
@@ -93,7 +159,9 @@ class MathFunctionArcCosine : public MathFunction
 class MathFunctionArcTangent : public MathFunction
 {
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
     
     public:
         MathFunctionArcTangent(MathFunctionNamespace& ns);
@@ -102,7 +170,9 @@ class MathFunctionArcTangent : public MathFunction
 class MathFunctionArcTangent2 : public MathFunction
 {
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
     
     public:
         MathFunctionArcTangent2(MathFunctionNamespace& ns);
@@ -110,8 +180,15 @@ class MathFunctionArcTangent2 : public MathFunction
 
 class MathFunctionExponential : public MathFunction
 {
+    private:
+        MathFunctionApproximation approximation;
+    
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
+        
+        const MathFunction& approximate() const;
     
     public:
         MathFunctionExponential(MathFunctionNamespace& ns);
@@ -119,8 +196,15 @@ class MathFunctionExponential : public MathFunction
 
 class MathFunctionNaturalLog : public MathFunction
 {
+    private:
+        MathFunctionApproximation approximation;
+    
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
+        
+        const MathFunction& approximate() const;
     
     public:
         MathFunctionNaturalLog(MathFunctionNamespace& ns);
@@ -129,7 +213,9 @@ class MathFunctionNaturalLog : public MathFunction
 class MathFunctionLog10 : public MathFunction
 {
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
     
     public:
         MathFunctionLog10(MathFunctionNamespace& ns);
@@ -138,7 +224,9 @@ class MathFunctionLog10 : public MathFunction
 class MathFunctionLog : public MathFunction
 {
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
     
     public:
         MathFunctionLog(MathFunctionNamespace& ns);
@@ -147,7 +235,9 @@ class MathFunctionLog : public MathFunction
 class MathFunctionCeiling : public MathFunction
 {
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
     
     public:
         MathFunctionCeiling(MathFunctionNamespace& ns);
@@ -156,7 +246,9 @@ class MathFunctionCeiling : public MathFunction
 class MathFunctionFloor : public MathFunction
 {
     protected:
-        double invoke(double* operands) const;
+        double invoke(const double* operands) const;
+        
+        void invokeColumns(const double* const* columns, int rows, double* results) const;
     
     public:
         MathFunctionFloor(MathFunctionNamespace& ns);
@@ -215,20 +307,123 @@ int MathFunctionIdentifier::hash(int capacity) const
     return init;
 }
 
-MathFunctionNamespace::MathFunctionNamespace()
+size_t MemoryUsage::getTotalBytes() const
+{
+    return this->functionBytes + this->postfixBytes + this->programBytes + this->dependentsBytes + this->tableBytes;
+}
+
+void MemoryUsage::add(const MemoryUsage& usage)
+{
+    this->functionBytes += usage.functionBytes;
+    this->functions += usage.functions;
+    this->postfixBytes += usage.postfixBytes;
+    this->postfixNodes += usage.postfixNodes;
+    this->programBytes += usage.programBytes;
+    this->instructions += usage.instructions;
+    this->registerInstructions += usage.registerInstructions;
+    this->dependentsBytes += usage.dependentsBytes;
+    this->dependents += usage.dependents;
+    this->shadows += usage.shadows;
+    this->tableBytes += usage.tableBytes;
+    this->buckets += usage.buckets;
+    this->chainNodes += usage.chainNodes;
+}
+
+MathFunctionNamespace::MathFunctionNamespace() : capacity(MAX_FUNCTIONS_CAPACITY), parent(nullptr) {}
+
+MathFunctionNamespace::MathFunctionNamespace(const MathFunctionNamespace* parent, int capacity) : capacity(capacity), parent(parent)
 {
-    this->functions = new HashTable<const MathFunctionIdentifier, MathFunction>(MAX_FUNCTIONS_CAPACITY);
+    if(capacity < 1)
+    {
+        throw InvalidArgumentException("A namespace needs a bucket at least.");
+    }
 }
 
 MathFunctionNamespace::~MathFunctionNamespace()
 {
+    // Shadows still left are destroyed along. Their links to one another are dropped first,
+    //  so that destroying one of them never reaches another one already destroyed.
+    lock_guard<recursive_mutex> locked(TierCompiler::getLock());
+    vector<MathFunction*> funcs;
+    if(this->functions != nullptr)
+    {
+        this->functions->forEach(collectFunction, &funcs);
+    }
+    for(int i = 0 ; this->frozen != nullptr && i < this->frozen->getSlotCount() ; i++)
+    {
+        if(this->frozenFunctions[i] != nullptr)
+        {
+            funcs.push_back(this->frozenFunctions[i]);
+        }
+    }
+    vector<MathFunction*> shadows;
+    for(MathFunction* func : funcs)
+    {
+        if(func->isShadow)
+        {
+            shadows.push_back(func);
+        }
+    }
+    for(MathFunction* shadow : shadows)
+    {
+        while(shadow->dependents != nullptr)
+        {
+            Node<MathFunction>* next = shadow->dependents->getNext();
+            delete shadow->dependents;
+            shadow->dependents = next;
+        }
+    }
+    vector<MathFunction*> unused;
+    for(MathFunction* shadow : shadows)
+    {
+        shadow->unlinkDependencies(unused);
+        shadow->postfixOperations = nullptr;
+    }
+    for(MathFunction* shadow : shadows)
+    {
+        delete shadow;
+    }
+    // Shadows of the parents which served the ones of this namespace only.
+    for(MathFunction* shadow : shadows)
+    {
+        unused.erase(std::remove(unused.begin(), unused.end(), shadow), unused.end());
+    }
+    MathFunction::releaseShadows(unused);
+    
     delete this->functions;
+    delete this->frozen;
+    delete[] this->frozenFunctions;
+}
+
+const MathFunctionNamespace& MathFunctionNamespace::getBuiltIns()
+{
+    // Never destroyed, as the built-ins and the functions destroyed at exit may still reference it.
+    static MathFunctionNamespace* builtIns = []()
+    {
+        MathFunctionNamespace* ns = new MathFunctionNamespace(nullptr, 1);
+        ns->builtIns = true;
+        return ns;
+    }();
+    return *builtIns;
+}
+
+const MathFunctionNamespace* MathFunctionNamespace::getParent() const
+{
+    return this->parent;
 }
 
 void MathFunctionNamespace::replace(const MathFunctionIdentifier* ident, MathFunction* _replace)
 {
     static bool dummy;
-    if(this->functions->remove(ident))
+    if(this->frozen != nullptr)
+    {
+        MathFunction** slot = this->getFrozenSlot(ident);
+        if(slot != nullptr)
+        {
+            *slot = _replace;
+        }
+    }
+    else if(this->functions != nullptr && this->functions->remove(ident))
     {
         this->functions->put(ident, _replace, dummy);
     }
@@ -236,6 +431,14 @@ void MathFunctionNamespace::replace(const MathFunctionIdentifier* ident, MathFun
 
 bool MathFunctionNamespace::add(const MathFunctionIdentifier* ident, MathFunction* func)
 {
+    if(this->isFrozen())
+    {
+        return false;
+    }
+    if(this->functions == nullptr)
+    {
+        this->functions = new HashTable<const MathFunctionIdentifier, MathFunction>(this->capacity);
+    }
     if(this->functions->get(ident) == nullptr)
     {
         static bool dummy;
@@ -248,17 +451,152 @@ bool MathFunctionNamespace::add(const MathFunctionIdentifier* ident, MathFunctio
 bool MathFunctionNamespace::del(const MathFunctionIdentifier* ident)
 {
     static MathFunction* cache = nullptr;
-    if((cache = this->functions->get(ident)) != nullptr)
+    if((cache = this->get(ident)) != nullptr)
     {
-        if(!(cache->isReferencedByOthers))
+        if(cache->dependents == nullptr)
         {
-            this->functions->remove(ident);
+            this->remove(ident);
             return true;
         }
     }
     return false;
 }
 
+void MathFunctionNamespace::remove(const MathFunctionIdentifier* ident)
+{
+    if(this->frozen != nullptr)
+    {
+        MathFunction** slot = this->getFrozenSlot(ident);
+        if(slot != nullptr)
+        {
+            *slot = nullptr;
+        }
+    }
+    else if(this->functions != nullptr)
+    {
+        this->functions->remove(ident);
+    }
+}
+
+MathFunction** MathFunctionNamespace::getFrozenSlot(const MathFunctionIdentifier* ident) const
+{
+    const string& name = ident->getName();
+    MathFunction** slot = this->frozenFunctions + this->frozen->find(name.data(), name.size(), ident->getVariablesCount());
+    return (*slot != nullptr && *((*slot)->identifier) == *ident ? slot : nullptr);
+}
+
+MathFunction* MathFunctionNamespace::get(const MathFunctionIdentifier* ident) const
+{
+    if(this->builtIns)
+    {
+        return findBuiltIn(ident);
+    }
+    if(this->frozen != nullptr)
+    {
+        MathFunction** slot = this->getFrozenSlot(ident);
+        return (slot == nullptr ? nullptr : *slot);
+    }
+    return (this->functions == nullptr ? nullptr : this->functions->get(ident));
+}
+
+MathFunction* MathFunctionNamespace::find(const MathFunctionIdentifier* ident) const
+{
+    for(const MathFunctionNamespace* layer = this ; layer != nullptr ; layer = layer->parent)
+    {
+        MathFunction* func = layer->get(ident);
+        if(func != nullptr)
+        {
+            return func;
+        }
+    }
+    return nullptr;
+}
+
+void MathFunctionNamespace::accumulateMemoryUsage(const MathFunctionIdentifier* ident, MathFunction* func, void* usage)
+{
+    ((MemoryUsage*)usage)->add(func->getMemoryUsage());
+}
+
+void MathFunctionNamespace::collectFunction(const MathFunctionIdentifier* ident, MathFunction* func, void* funcs)
+{
+    ((vector<MathFunction*>*)funcs)->push_back(func);
+}
+
+void MathFunctionNamespace::freeze()
+{
+    // Declarations and lookups of other threads run under the same lock.
+    lock_guard<recursive_mutex> locked(TierCompiler::getLock());
+    if(this->isFrozen())
+    {
+        return;
+    }
+    
+    vector<MathFunction*> funcs;
+    if(this->functions != nullptr)
+    {
+        this->functions->forEach(collectFunction, &funcs);
+    }
+    vector<const char*> keys;
+    vector<size_t> lengths;
+    vector<uint32_t> salts;
+    for(MathFunction* func : funcs)
+    {
+        keys.push_back(func->identifier->getName().data());
+        lengths.push_back(func->identifier->getName().size());
+        salts.push_back(func->identifier->getVariablesCount());
+    }
+    
+    this->frozen = new PerfectHash(keys.data(), lengths.data(), salts.data(), (int)(funcs.size()));
+    this->frozenFunctions = new MathFunction*[this->frozen->getSlotCount()]();
+    for(size_t i = 0 ; i < funcs.size() ; i++)
+    {
+        this->frozenFunctions[this->frozen->find(keys[i], lengths[i], salts[i])] = funcs[i];
+    }
+    delete this->functions;
+    this->functions = nullptr;
+}
+
+bool MathFunctionNamespace::isFrozen() const
+{
+    return (this->builtIns || this->frozen != nullptr);
+}
+
+void MathFunctionNamespace::setPrecision(Precision _precision)
+{
+    this->precision = _precision;
+}
+
+Precision MathFunctionNamespace::getPrecision() const
+{
+    return this->precision;
+}
+
+MemoryUsage MathFunctionNamespace::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.tableBytes = sizeof(MathFunctionNamespace);
+    if(this->functions != nullptr)
+    {
+        this->functions->forEach(accumulateMemoryUsage, &usage);
+        usage.tableBytes += this->functions->getMemoryBytes();
+        usage.buckets = this->functions->getCapacity();
+        usage.chainNodes = this->functions->getSize();
+    }
+    else if(this->frozen != nullptr)
+    {
+        for(int i = 0 ; i < this->frozen->getSlotCount() ; i++)
+        {
+            if(this->frozenFunctions[i] != nullptr)
+            {
+                usage.add(this->frozenFunctions[i]->getMemoryUsage());
+            }
+        }
+        usage.tableBytes += this->frozen->getMemoryBytes() + this->frozen->getSlotCount() * sizeof(MathFunction*);
+        usage.buckets = this->frozen->getSlotCount();
+    }
+    return usage;
+}
+
 bool MathFunction::isAlphabetOrNumber(char c)
 {
     return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
@@ -268,12 +606,12 @@ void MathFunction::addToNode(const OperationElement* elem)
 {
     if(this->postfixOperations == nullptr)
     {
-        this->postfixOperations = new Node<const OperationElement>(elem, false);
+        this->postfixOperations = new(*(this->arena)) Node<const OperationElement>(elem, false);
         this->postfixOperations->setNext(this->postfixOperations);
     }
     else
     {
-        Node<const OperationElement>* _node = new Node<const OperationElement>(elem, false);
+        Node<const OperationElement>* _node = new(*(this->arena)) Node<const OperationElement>(elem, false);
         _node->setNext(this->postfixOperations->getNext());
         this->postfixOperations->setNext(_node);
         this->postfixOperations = this->postfixOperations->getNext();
@@ -283,6 +621,7 @@ void MathFunction::addToNode(const OperationElement* elem)
 MathFunction::MathFunction(MathFunctionNamespace& _name_space, MathFunctionIdentifier* _identifier, bool _replace) : NAME_SPACE(_name_space)
 {
     this->identifier = _identifier;
+    this->isShadow = _replace;
     if(_replace)
     {
         this->NAME_SPACE.replace(this->identifier, this);
@@ -293,6 +632,12 @@ MathFunction::MathFunction(MathFunctionNamespace& _name_space, MathFunctionIdent
     }
 }
 
+MathFunction::MathFunction(MathFunctionNamespace& _name_space, MathFunctionIdentifier* _identifier, const string& _expression) : NAME_SPACE(_name_space)
+{
+    this->identifier = _identifier;
+    this->expression = _expression;
+}
+
 bool MathFunction::isStringSpacedValid(string& _str, int brackets_pair_limit, bool isIdent)
 {
     int _len = _str.size();
@@ -306,7 +651,7 @@ bool MathFunction::isStringSpacedValid(string& _str, int brackets_pair_limit, bo
         {
             if((i > 0 && isAlphabetOrNumber(_str[i - 1])) && (i < (_len - 1) && isAlphabetOrNumber(_str[i + 1])))
             {
-                delete copy;
+                delete[] copy;
                 return false;
             }
         }
@@ -324,21 +669,21 @@ bool MathFunction::isStringSpacedValid(string& _str, int brackets_pair_limit, bo
                     brackets_pair_limit--;
                     if(brackets_pair_limit < 0)
                     {
-                        delete copy;
+                        delete[] copy;
                         return false;
                     }
                 }
                 if(brackets < 0)
                 {
-                    delete copy;
+                    delete[] copy;
                     return false;
                 }
             }
             else if(isIdent)
             {
-                if(strchr("+-*/%^", _str[i]) != nullptr)
+                if(strchr("+-*/%^<>=!&|", _str[i]) != nullptr)
                 {
-                    delete copy;
+                    delete[] copy;
                     return false;
                 }
             }
@@ -346,212 +691,414 @@ bool MathFunction::isStringSpacedValid(string& _str, int brackets_pair_limit, bo
         }
     }
     _str = copy;
+    delete[] copy;
     return (brackets_pair_limit <= 0);
 }
 
-MathFunction::MathFunction(const string& _identifier, const string& formula) : MathFunction::MathFunction(DEFAULT_NAMESPACE, _identifier, formula) {}
+MathFunctionNamespace& MathFunction::getDefaultNamespace()
+{
+    // Never destroyed, as the functions destroyed at exit may still reference it.
+    static MathFunctionNamespace* ns = new MathFunctionNamespace(&MathFunctionNamespace::getBuiltIns(), MathFunctionNamespace::MAX_FUNCTIONS_CAPACITY);
+    return *ns;
+}
+
+MathFunction::MathFunction(const string& _identifier, const string& formula) : MathFunction::MathFunction(getDefaultNamespace(), _identifier, formula) {}
 
 MathFunction::MathFunction(MathFunctionNamespace& _name_space, const string& _identifier, const string& formula) : NAME_SPACE(_name_space)
 {
+    lock_guard<recursive_mutex> locked(TierCompiler::getLock());
+    this->resetTier();
+    
     string __ident = _identifier;
     string __formu = formula;
     
-    if(isStringSpacedValid(__ident, 1, true) && isStringSpacedValid(__formu, -1, false))
+    if(!(isStringSpacedValid(__ident, 1, true) && isStringSpacedValid(__formu, -1, false)))
     {
-        this->expression = __ident + '=' + __formu;
-        string __name = __ident.substr(0, __ident.find_first_of('('));
-        int _cache0 = __ident.find_first_of('(') + 1;
-        string __vars = __ident.substr(_cache0, __ident.find_first_of(')') - _cache0);
-        int varCount = 0;
-        HashTable<String, int> varTable(MAX_VARIABLE_COUNT);
-        int strIndexStart = 0;
-        int strIndexEnd = -1;
-        static bool error = false;
-        while((strIndexEnd = __vars.find_first_of(',', strIndexStart)) != string::npos)
+        throw InvalidFormulaException("Either the spacing is invalid or the brackets are not paired.");
+    }
+    
+    this->expression = __ident + '=' + __formu;
+    string __name;
+    HashTable<String, MathFunctionParameter> varTable(count(__ident.begin(), __ident.end(), ',') + 1);
+    int varCount = parseIdentifier(__ident, __name, varTable);
+    if(OperatorSelect::isSelection(__name, (int)(count(__ident.begin(), __ident.end(), ',')) + 1))
+    {
+        throw InvalidArgumentException("\"if\" and \"select\" of 3 arguments are selections, which cannot be declared.");
+    }
+    
+    this->identifier = new MathFunctionIdentifier(__name, varCount);
+    this->precision = this->NAME_SPACE.precision;
+    MathFunction* previous = this->NAME_SPACE.get(this->identifier);
+    if(previous != nullptr && !(previous->isShadow))
+    {
+        delete this->identifier;
+        throw InvalidArgumentException("Conflicting function name!");
+    }
+    if(previous == nullptr && this->NAME_SPACE.isFrozen())
+    {
+        delete this->identifier;
+        throw InvalidArgumentException("Functions cannot be declared into a frozen namespace.");
+    }
+    
+    // Redefinition of a destroyed function: take over the dependents of its shadow, so that they pick up the new formula.
+    if(previous != nullptr)
+    {
+        this->dependents = previous->dependents;
+        previous->dependents = nullptr;
+    }
+    
+    this->arena = new Arena(__formu.size() * ARENA_BYTES_PER_CHARACTER);
+    try
+    {
+        this->parseFormula(__formu, varTable);
+    }
+    catch(...)
+    {
+        if(previous != nullptr)
         {
-            varTable.put(new String(__vars.substr(strIndexStart, strIndexEnd - strIndexStart)), new int(varCount++), error);
-            if(error)
-            {
-                throw InvalidFormulaException("Conflicting variable names!");
-            }
-            strIndexStart = strIndexEnd + 1;
+            previous->dependents = this->dependents;
         }
-        varTable.put(new String(__vars.substr(strIndexStart, __vars.size() - strIndexStart)), new int(varCount++), error);
-        if(error)
+        delete this->arena;
+        delete this->identifier;
+        throw;
+    }
+    
+    if(previous != nullptr)
+    {
+        this->NAME_SPACE.replace(this->identifier, this);
+        for(Node<MathFunction>* cache = this->dependents ; cache != nullptr ; cache = cache->getNext())
         {
-            throw InvalidFormulaException("Conflicting variable names!");
+            cache->getValue()->retarget(previous, this);
         }
-        
-        this->identifier = new MathFunctionIdentifier(__name, varCount);
-        if(!(this->NAME_SPACE.add(this->identifier, this)))
+        delete previous;
+    }
+    else
+    {
+        this->NAME_SPACE.add(this->identifier, this);
+    }
+    
+    this->linkDependencies();
+    this->compile();
+    this->recompileDependents();
+}
+
+int MathFunction::parseIdentifier(const string& _ident, string& name, HashTable<String, MathFunctionParameter>& varTable)
+{
+    name = _ident.substr(0, _ident.find_first_of('('));
+    int _cache0 = _ident.find_first_of('(') + 1;
+    string __vars = _ident.substr(_cache0, _ident.find_first_of(')') - _cache0);
+    int varCount = 0;
+    int strIndexStart = 0;
+    int strIndexEnd = -1;
+    while((strIndexEnd = __vars.find_first_of(',', strIndexStart)) != string::npos)
+    {
+        addParameter(__vars.substr(strIndexStart, strIndexEnd - strIndexStart), varTable, varCount);
+        strIndexStart = strIndexEnd + 1;
+    }
+    addParameter(__vars.substr(strIndexStart, __vars.size() - strIndexStart), varTable, varCount);
+    return varCount;
+}
+
+void MathFunction::addParameter(const string& _param, HashTable<String, MathFunctionParameter>& varTable, int& varCount)
+{
+    static bool error = false;
+    size_t bracket = _param.find_first_of('[');
+    int length = 0;
+    if(bracket != string::npos && ((length = parseSubscript(_param, bracket)) <= 0 || length > INT_MAX - varCount))
+    {
+        throw InvalidFormulaException(("Invalid array length: " + _param).c_str());
+    }
+    varTable.put(new String(_param.substr(0, bracket)), new MathFunctionParameter{varCount, length}, error, true);
+    if(error)
+    {
+        throw InvalidFormulaException("Conflicting variable names!");
+    }
+    varCount += (length > 0 ? length : 1);
+}
+
+int MathFunction::parseSubscript(const string& _str, size_t bracket)
+{
+    size_t end = _str.size() - 1;
+    if(end <= bracket + 1 || end - bracket - 1 > 9 || _str[end] != ']')
+    {
+        return -1;
+    }
+    int value = 0;
+    for(size_t i = bracket + 1 ; i < end ; i++)
+    {
+        if(_str[i] < '0' || _str[i] > '9')
         {
-            throw InvalidArgumentException("Conflicting function name!");
+            return -1;
         }
-        
-        bool previouslyOperator = true;
-        
-        LinkedStack<const Operator> operators;
-        
-        strIndexStart = 0;
-        strIndexEnd = -1;
-        while(strIndexStart < __formu.size() && ((strIndexEnd = __formu.find_first_of("+-*/%^(),", strIndexStart)) != string::npos) || (strIndexEnd = __formu.size()) > strIndexStart)
+        value = value * 10 + (_str[i] - '0');
+    }
+    return value;
+}
+
+int MathFunction::addVariable(const string& _operandStr_, HashTable<String, MathFunctionParameter>& varTable, bool wholeArgument)
+{
+    size_t bracket = _operandStr_.find_first_of('[');
+    String _str_(_operandStr_.substr(0, bracket));
+    MathFunctionParameter* param = varTable.get(&_str_);
+    if(param == nullptr)
+    {
+        throw InvalidFormulaException(("Undefined variable: " + _operandStr_).c_str());
+    }
+    
+    // "w[3]" is an element of the array "w".
+    if(bracket != string::npos)
+    {
+        int element = parseSubscript(_operandStr_, bracket);
+        if(param->length == 0 || element < 0 || element >= param->length)
         {
-            if(strIndexEnd == __formu.size() || __formu[strIndexEnd] != '(')
-            {
-                if(strIndexEnd > strIndexStart)
-                {
-                    bool numericOperand = false;
-                    string _operandStr_ = __formu.substr(strIndexStart, strIndexEnd - strIndexStart);
-                    try
-                    {
-                        static size_t _offset_;
-                        double val = stod(_operandStr_, &_offset_);
-                        if(_offset_ == _operandStr_.size())
-                        {
-                            numericOperand = true;
-                            this->addToNode(new NumericOperand(val));
-                        }
-                    }
-                    catch(invalid_argument& ia){}
-                
-                    if(!numericOperand)
-                    {
-                        String _str_(_operandStr_);
-                        int* index = varTable.get(&_str_);
-                        if(index == nullptr)
-                        {
-                            throw InvalidFormulaException(("Undefined variable: " + _operandStr_).c_str());
-                        }
-                        this->addToNode(new IndexingOperand(*index));
-                    }
-                    previouslyOperator = false;
-                }
-                
-                if(strIndexEnd == __formu.size())
-                {
-                    break;
-                }
-            }
-            else if(strIndexEnd > strIndexStart)
-            {
-                string __f_name = __formu.substr(strIndexStart, strIndexEnd - strIndexStart);
-                int _vCountInner = this->parseInnerFunctionInput(__formu, strIndexEnd, varTable);
-                MathFunctionIdentifier mfi(__f_name, _vCountInner);
-                MathFunction* _func = this->NAME_SPACE.functions->get(&mfi);
-                if(_func == nullptr)
+            throw InvalidFormulaException(("Invalid array element: " + _operandStr_).c_str());
+        }
+        this->addToNode(new(*(this->arena)) IndexingOperand(param->index + element));
+        return 1;
+    }
+    if(param->length == 0)
+    {
+        this->addToNode(new(*(this->arena)) IndexingOperand(param->index));
+        return 1;
+    }
+    
+    // A whole array passed to a function stands for all of its elements, in order.
+    if(!wholeArgument)
+    {
+        throw InvalidFormulaException(("An array must be indexed, reduced or passed as a whole argument: " + _operandStr_).c_str());
+    }
+    for(int i = 0 ; i < param->length ; i++)
+    {
+        this->addToNode(new(*(this->arena)) IndexingOperand(param->index + i));
+    }
+    return param->length;
+}
+
+bool MathFunction::parseReduction(const string& _expressions, int& endIndex, const string& name, HashTable<String, MathFunctionParameter>& varTable)
+{
+    int opcode = ReducingOperand::getOpCode(name);
+    size_t end = _expressions.find_first_of("()", endIndex + 1);
+    if(opcode == OPCODE_NONE || end == string::npos || _expressions[end] != ')')
+    {
+        return false;
+    }
+    
+    // Only whole arrays of the same length are reduced, anything else is an ordinary call.
+    MathFunctionParameter* arrays[2] = {nullptr, nullptr};
+    int arrayCount = 0;
+    size_t start = endIndex + 1;
+    while(start <= end)
+    {
+        size_t next = _expressions.find_first_of(",)", start);
+        String _str_(_expressions.substr(start, next - start));
+        MathFunctionParameter* param = varTable.get(&_str_);
+        if(param == nullptr || param->length == 0 || arrayCount == 2 || (arrayCount > 0 && param->length != arrays[0]->length))
+        {
+            return false;
+        }
+        arrays[arrayCount++] = param;
+        start = next + 1;
+    }
+    if(arrayCount != ReducingOperand::getArrayCount(opcode))
+    {
+        return false;
+    }
+    
+    this->addToNode(new(*(this->arena)) ReducingOperand(opcode, arrays[0]->index, (arrayCount > 1 ? arrays[1]->index : 0), arrays[0]->length));
+    endIndex = end + 1;
+    return true;
+}
+
+void MathFunction::parseFormula(string& _formula, HashTable<String, MathFunctionParameter>& varTable)
+{
+    bool previouslyOperator = true;
+    
+    LinkedStack<const Operator> operators;
+    
+    int strIndexStart = 0;
+    int strIndexEnd = -1;
+    while(strIndexStart < _formula.size() && ((strIndexEnd = _formula.find_first_of("+-*/%^(),<>=!&|", strIndexStart)) != string::npos) || (strIndexEnd = _formula.size()) > strIndexStart)
+    {
+        if(strIndexEnd == _formula.size() || _formula[strIndexEnd] != '(')
+        {
+            if(strIndexEnd > strIndexStart)
+            {
+                bool numericOperand = false;
+                string _operandStr_ = _formula.substr(strIndexStart, strIndexEnd - strIndexStart);
+                try
+                {
+                    static size_t _offset_;
+                    double val = stod(_operandStr_, &_offset_);
+                    if(_offset_ == _operandStr_.size())
+                    {
+                        numericOperand = true;
+                        this->addToNode(new(*(this->arena)) NumericOperand(val));
+                    }
+                }
+                catch(invalid_argument& ia){}
+            
+                if(!numericOperand)
                 {
-                    throw InvalidFormulaException(("Undefined function: " + __f_name + " which should accept " + to_string(_vCountInner) + " arguments.").c_str());
+                    this->addVariable(_operandStr_, varTable, false);
                 }
-                _func->isReferencedByOthers = true;
-                this->addToNode(new OperatorInvokeFunc(_func));
-                strIndexStart = strIndexEnd;
                 previouslyOperator = false;
-                continue;
             }
             
-            if(__formu[strIndexEnd] != '(' && __formu[strIndexEnd] != '-' && previouslyOperator)
+            if(strIndexEnd == _formula.size())
             {
-                throw InvalidFormulaException("Invalid operator sequence!");
+                break;
             }
-            
-            const Operator* op = nullptr;
-            static const Operator* op2 = nullptr;
-            
-            switch(__formu[strIndexEnd])
+        }
+        else if(strIndexEnd > strIndexStart)
+        {
+            string __f_name = _formula.substr(strIndexStart, strIndexEnd - strIndexStart);
+            if(!(this->parseReduction(_formula, strIndexEnd, __f_name, varTable)))
             {
-                case '-':
-                    if(previouslyOperator)
-                    {
-                        op = &(Operator::OPERATOR_NEGATIVE);
-                        if((op2 = operators.peek()) != nullptr && op2->isUnary())
-                        {
-                            throw InvalidFormulaException("Invalid conjunction of multiple unary operator \'-\'.");
-                        }
-                    }
-                    else
-                    {
-                        op = &(Operator::OPERATOR_NEGATION);
-                    }
-                    break;
-                case '+':
-                    op = &(Operator::OPERATOR_ADDITION);
-                    break;
-                case '*':
-                    op = &(Operator::OPERATOR_MULTIPLICATION);
-                    break;
-                case '/':
-                    op = &(Operator::OPERATOR_DIVISION);
-                    break;
-                case '%':
-                    op = &(Operator::OPERATOR_MODDING);
-                    break;
-                case '^':
-                    op = &(Operator::OPERATOR_POWER);
-                    break;
-                case '(':
-                    op = &(Operator::OPERATOR_LEFT_BRACKET);
-                    break;
-                case ')':
+                int _vCountInner = this->parseInnerFunctionInput(_formula, strIndexEnd, varTable);
+                this->addCall(__f_name, _vCountInner);
+            }
+            strIndexStart = strIndexEnd;
+            previouslyOperator = false;
+            continue;
+        }
+        
+        if(_formula[strIndexEnd] != '(' && _formula[strIndexEnd] != '-' && _formula[strIndexEnd] != '!' && previouslyOperator)
+        {
+            throw InvalidFormulaException("Invalid operator sequence!");
+        }
+        
+        const Operator* op = nullptr;
+        static const Operator* op2 = nullptr;
+        
+        switch(_formula[strIndexEnd])
+        {
+            case '-':
+                if(previouslyOperator)
                 {
-                    while((op2 = operators.peek()) != nullptr && !(op2->isBracket()))
+                    op = &(Operator::OPERATOR_NEGATIVE);
+                    if((op2 = operators.peek()) != nullptr && op2->isUnary())
                     {
-                        this->addToNode(operators.pop());
+                        throw InvalidFormulaException("Invalid conjunction of multiple unary operator \'-\'.");
                     }
-                    operators.pop();
-                    previouslyOperator = false;
-                    strIndexStart = strIndexEnd + 1;
-                    continue;
                 }
-                case ',':
-                    throw InvalidFormulaException("Invalid seperation character \',\' outside of a function input.");
-                default:
-                    break;
-            }
-            
-            if(op != nullptr)
+                else
+                {
+                    op = &(Operator::OPERATOR_NEGATION);
+                }
+                break;
+            case '+':
+                op = &(Operator::OPERATOR_ADDITION);
+                break;
+            case '*':
+                op = &(Operator::OPERATOR_MULTIPLICATION);
+                break;
+            case '/':
+                op = &(Operator::OPERATOR_DIVISION);
+                break;
+            case '%':
+                op = &(Operator::OPERATOR_MODDING);
+                break;
+            case '^':
+                op = &(Operator::OPERATOR_POWER);
+                break;
+            case '(':
+                op = &(Operator::OPERATOR_LEFT_BRACKET);
+                break;
+            case ')':
             {
-                if(!(op->isBracket()))
+                while((op2 = operators.peek()) != nullptr && !(op2->isBracket()))
                 {
-                    while((op2 = operators.peek()) != nullptr && op2->getLevel() >= op->getLevel())
-                    {
-                        this->addToNode(operators.pop());
-                    }
+                    this->addToNode(operators.pop());
                 }
-                operators.push(op);
+                operators.pop();
+                previouslyOperator = false;
+                strIndexStart = strIndexEnd + 1;
+                continue;
             }
-            
-            previouslyOperator = true;
-            
-            strIndexStart = strIndexEnd + 1;
+            case ',':
+                throw InvalidFormulaException("Invalid seperation character \',\' outside of a function input.");
+            default:
+                op = parseLogicalOperator(_formula, strIndexEnd, previouslyOperator);
+                if(op->isUnary() && (op2 = operators.peek()) != nullptr && op2->isUnary())
+                {
+                    throw InvalidFormulaException("Invalid conjunction of multiple unary operators.");
+                }
+                break;
         }
         
-        while(operators.peek() != nullptr)
+        if(op != nullptr)
         {
-            this->addToNode(operators.pop());
+            if(!(op->isBracket()))
+            {
+                while((op2 = operators.peek()) != nullptr && op2->getLevel() >= op->getLevel())
+                {
+                    this->addToNode(operators.pop());
+                }
+            }
+            operators.push(op);
         }
+        
+        previouslyOperator = true;
+        
+        strIndexStart = strIndexEnd + 1;
     }
-    else
+    
+    while(operators.peek() != nullptr)
     {
-        throw InvalidFormulaException("Either the spacing is invalid or the brackets are not paired.");
+        this->addToNode(operators.pop());
     }
 }
 
 MathFunction::~MathFunction()
 {
-    if(this->isReferencedByOthers)
+    lock_guard<recursive_mutex> locked(TierCompiler::getLock());
+    if(this->tier == TIER_QUEUED)
     {
-        MathFunction* replace = new MathFunction(this->NAME_SPACE, this->identifier);
+        TierCompiler::cancel(this);
+        this->tier = TIER_BASELINE;
+    }
+    
+    if(this->dependents != nullptr)
+    {
+        // Still referenced: hand the compiled code over to a shadow which keeps serving the dependents.
+        MathFunction* replace = new MathFunction(this->NAME_SPACE, this->identifier, true);
         replace->expression = this->expression;
-        replace->isReferencedByOthers = true;
         replace->postfixOperations = this->postfixOperations;
+        replace->program = this->program.load();
+        replace->retired = this->retired;
+        replace->tier = this->tier.load();
+        replace->precision = this->precision;
+        replace->tabulation = this->tabulation;
+        replace->arena = this->arena;
+        replace->dependents = this->dependents;
+        // Linked first, so that no callee which is a shadow is left without dependents in between.
+        replace->linkDependencies();
+        vector<MathFunction*> unused;
+        this->unlinkDependencies(unused);
+        for(Node<MathFunction>* cache = replace->dependents ; cache != nullptr ; cache = cache->getNext())
+        {
+            cache->getValue()->retarget(this, replace);
+        }
+        replace->recompileDependents();
     }
     else
     {
+        vector<MathFunction*> unused;
+        this->unlinkDependencies(unused);
+        releaseShadows(unused);
+        if(this->NAME_SPACE.get(this->identifier) == this)
+        {
+            this->NAME_SPACE.remove(this->identifier);
+        }
+        Program::release(this->program);
+        Program::release(this->retired);
+        delete this->tabulation;
+        delete this->arena;
         delete this->identifier;
     }
 }
 
-int MathFunction::parseInnerFunctionInput(string& _expressions, int& endIndex, HashTable<String, int>& varTable)
+int MathFunction::parseInnerFunctionInput(string& _expressions, int& endIndex, HashTable<String, MathFunctionParameter>& varTable)
 {
     endIndex++;
     int _varCountInner = 0;
@@ -568,7 +1115,7 @@ int MathFunction::parseInnerFunctionInput(string& _expressions, int& endIndex, H
         bool previouslyOperator = true;
         LinkedStack<const Operator> operators;
         int innerBrackets = 0;
-        while((strIndexEnd = _expressions.find_first_of("+-*/%^(),", strIndexStart)) != string::npos && strIndexEnd <= argumentExpectedEndIndex)
+        while((strIndexEnd = _expressions.find_first_of("+-*/%^(),<>=!&|", strIndexStart)) != string::npos && strIndexEnd <= argumentExpectedEndIndex)
         {
             if(_expressions[strIndexEnd] != '(')
             {
@@ -583,20 +1130,15 @@ int MathFunction::parseInnerFunctionInput(string& _expressions, int& endIndex, H
                         if(_offset_ == _operandStr_.size())
                         {
                             numericOperand = true;
-                            this->addToNode(new NumericOperand(val));
+                            this->addToNode(new(*(this->arena)) NumericOperand(val));
                         }
                     }
                     catch(invalid_argument& ia){}
                 
                     if(!numericOperand)
                     {
-                        String _str_(_operandStr_);
-                        int* index = varTable.get(&_str_);
-                        if(index == nullptr)
-                        {
-                            throw InvalidFormulaException(("Undefined variable: " + _operandStr_).c_str());
-                        }
-                        this->addToNode(new IndexingOperand(*index));
+                        bool wholeArgument = (strIndexStart == argumentStartIndex && innerBrackets == 0 && (_expressions[strIndexEnd] == ',' || _expressions[strIndexEnd] == ')'));
+                        _varCountInner += this->addVariable(_operandStr_, varTable, wholeArgument) - 1;
                     }
                     previouslyOperator = false;
                 }
@@ -609,22 +1151,18 @@ int MathFunction::parseInnerFunctionInput(string& _expressions, int& endIndex, H
             else if(strIndexEnd > strIndexStart)
             {
                 string __f_name = _expressions.substr(strIndexStart, strIndexEnd - strIndexStart);
-                int _vCountInner = this->parseInnerFunctionInput(_expressions, strIndexEnd, varTable);
-                MathFunctionIdentifier mfi(__f_name, _vCountInner);
-                MathFunction* _func = this->NAME_SPACE.functions->get(&mfi);
-                if(_func == nullptr)
+                if(!(this->parseReduction(_expressions, strIndexEnd, __f_name, varTable)))
                 {
-                    throw InvalidFormulaException(("Undefined function: " + __f_name + " which should accept " + to_string(_vCountInner) + " arguments.").c_str());
+                    int _vCountInner = this->parseInnerFunctionInput(_expressions, strIndexEnd, varTable);
+                    this->addCall(__f_name, _vCountInner);
                 }
-                _func->isReferencedByOthers = true;
-                this->addToNode(new OperatorInvokeFunc(_func));
                 strIndexStart = strIndexEnd;
                 argumentExpectedEndIndex = _expressions.find_first_of(",)", strIndexStart);
                 previouslyOperator = false;
                 continue;
             }
             
-            if(_expressions[strIndexEnd] != '(' && _expressions[strIndexEnd] != '-' && previouslyOperator)
+            if(_expressions[strIndexEnd] != '(' && _expressions[strIndexEnd] != '-' && _expressions[strIndexEnd] != '!' && previouslyOperator)
             {
                 throw InvalidFormulaException("Invalid operator sequence!");
             }
@@ -701,6 +1239,11 @@ int MathFunction::parseInnerFunctionInput(string& _expressions, int& endIndex, H
                     strIndexStart = strIndexEnd + 1;
                     continue;
                 default:
+                    op = parseLogicalOperator(_expressions, strIndexEnd, previouslyOperator);
+                    if(op->isUnary() && (op2 = operators.peek()) != nullptr && op2->isUnary())
+                    {
+                        throw InvalidFormulaException("Invalid conjunction of multiple unary operators.");
+                    }
                     break;
             }
             
@@ -726,240 +1269,1409 @@ int MathFunction::parseInnerFunctionInput(string& _expressions, int& endIndex, H
     return _varCountInner;
 }
 
-double MathFunction::invoke(double* operands) const
+const Operator* MathFunction::parseLogicalOperator(const string& _formula, int& index, bool previouslyOperator)
 {
-    Node<const OperationElement>* __node = nullptr;
-    Node<const OperationElement>* __cache = nullptr;
-    
-    __node = this->postfixOperations->getNext();
-    __cache = __node;
-    
-    if(this->postfixOperations == nullptr)
+    char c = _formula[index];
+    bool equals = (index + 1 < (int)(_formula.size()) && _formula[index + 1] == '=');
+    if(c == '!' && !equals)
     {
-        return nan("");
+        if(!previouslyOperator)
+        {
+            throw InvalidFormulaException("Invalid operator sequence!");
+        }
+        return &(Operator::OPERATOR_NOT);
     }
-    
-    if(__node == nullptr)
+    if(previouslyOperator)
     {
-        return nan("");
+        throw InvalidFormulaException("Invalid operator sequence!");
     }
-    LinkedStack<const NumericOperand> stackedOperands;
-    do
+    
+    const Operator* op = nullptr;
+    switch(c)
     {
-        if(__cache->getValue()->isOperator())
-        {
-            const Operator* op = dynamic_cast<const Operator*>(__cache->getValue());
-            if(op->isFunction())
-            {
-                const OperatorInvokeFunc* oif = dynamic_cast<const OperatorInvokeFunc*>(op);
-                const MathFunction* _func = oif->func;
-                double* _operands = new double[oif->varCount];
-                for(int i = oif->varCount - 1 ; i >= 0 ; i--)
-                {
-                    _operands[i] = stackedOperands.peek()->getValue();
-                    stackedOperands.pop();
-                }
-                NumericOperand* _fVal = new NumericOperand(_func->invoke(_operands));
-                stackedOperands.push(_fVal);
-                delete _operands;
-            }
-            else if(op->isUnary())
-            {
-                const OperatorUnary* ou = dynamic_cast<const OperatorUnary*>(op);
-                NumericOperand* _opVal = new NumericOperand(ou->operate(stackedOperands.peek()->getValue()));
-                stackedOperands.pop();
-                stackedOperands.push(_opVal);
-            }
-            else
-            {
-                const OperatorBinary* ob = dynamic_cast<const OperatorBinary*>(op);
-                if(stackedOperands.isEmpty())
-                {
-                    return nan("");
-                }
-                double rhs = stackedOperands.peek()->getValue();
-                stackedOperands.pop();
-                if(stackedOperands.isEmpty())
-                {
-                    return nan("");
-                }
-                double lhs = stackedOperands.peek()->getValue();
-                
-                stackedOperands.pop();
-                stackedOperands.push(new NumericOperand(ob->operate(lhs, rhs)));
-            }
-        }
-        else
-        {
-            const Operand* operand = dynamic_cast<const Operand*>(__cache->getValue());
-            if(operand->isNumeric())
+        case '<':
+            op = (equals ? &(Operator::OPERATOR_LESS_EQUAL) : &(Operator::OPERATOR_LESS));
+            break;
+        case '>':
+            op = (equals ? &(Operator::OPERATOR_GREATER_EQUAL) : &(Operator::OPERATOR_GREATER));
+            break;
+        case '=':
+            op = (equals ? &(Operator::OPERATOR_EQUAL) : nullptr);
+            break;
+        case '!':
+            op = &(Operator::OPERATOR_NOT_EQUAL);
+            break;
+        case '&':
+        case '|':
+            if(index + 1 < (int)(_formula.size()) && _formula[index + 1] == c)
             {
-                stackedOperands.push(dynamic_cast<const NumericOperand*>(operand));
+                op = (c == '&' ? &(Operator::OPERATOR_AND) : &(Operator::OPERATOR_OR));
+                index++;
             }
-            else
-            {
-                const IndexingOperand* ioperand = dynamic_cast<const IndexingOperand*>(operand);
-                stackedOperands.push(new NumericOperand(operands[ioperand->getIndex()]));
-            }
-        }
-        __cache = __cache->getNext();
+            break;
     }
-    while(__cache != __node);
-    
-    if(stackedOperands.isEmpty())
+    if(op == nullptr)
     {
-        return nan("");
+        throw InvalidFormulaException("Invalid operator: '=', '&' and '|' are only used in \"==\", \"&&\" and \"||\".");
+    }
+    if(equals)
+    {
+        index++;
     }
-    return stackedOperands.peek()->getValue();
+    return op;
 }
 
-double MathFunction::invoke(initializer_list<double> var_list) const
+MathFunction* MathFunction::resolve(const string& name, int varCount)
 {
-    int _size = var_list.size();
-    if(_size != this->identifier->getVariablesCount())
+    MathFunctionIdentifier mfi(name, varCount);
+    MathFunction* _func = this->NAME_SPACE.find(&mfi);
+    if(_func == nullptr)
     {
-        throw InvalidArgumentException(("The function accepts " + to_string(this->identifier->getVariablesCount()) + " arguments, but received " + to_string(_size) + ".").c_str());
+        throw InvalidFormulaException(("Undefined function: " + name + " which should accept " + to_string(varCount) + " arguments.").c_str());
     }
-    double* operands = new double[_size];
-    int i = 0;
-    for(double d : var_list)
+    if(_func == this || this->isTransitiveDependent(_func))
     {
-        operands[i] = d;
-        i++;
+        throw InvalidFormulaException(("Circular reference: " + name + " depends on the function being defined.").c_str());
     }
-    return this->invoke(operands);
+    return _func;
 }
 
-const MathFunctionIdentifier& MathFunction::getIdentifier() const
+void MathFunction::addCall(const string& name, int varCount)
 {
-    return *(this->identifier);
+    if(OperatorSelect::isSelection(name, varCount))
+    {
+        this->addToNode(&(Operator::OPERATOR_SELECT));
+    }
+    else
+    {
+        this->addToNode(new(*(this->arena)) OperatorInvokeFunc(this->resolve(name, varCount)));
+    }
 }
 
-MathFunctionSine::MathFunctionSine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("sin", 1), false) {}
-
-double MathFunctionSine::invoke(double* operands) const
+bool MathFunction::isBuiltIn() const
 {
-    return sin(operands[0]);
+    return this->expression.empty();
 }
 
-MathFunctionCosine::MathFunctionCosine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("cos", 1), false) {}
-
-double MathFunctionCosine::invoke(double* operands) const
+void MathFunction::linkDependencies()
 {
-    return cos(operands[0]);
+    Node<const OperationElement>* tail = this->postfixOperations;
+    if(tail == nullptr)
+    {
+        return;
+    }
+    Node<const OperationElement>* cache = tail;
+    do
+    {
+        cache = cache->getNext();
+        const OperationElement* elem = cache->getValue();
+        if(elem->isOperator() && dynamic_cast<const Operator*>(elem)->isFunction())
+        {
+            MathFunction* callee = dynamic_cast<const OperatorInvokeFunc*>(elem)->func;
+            // Built-ins are never redefined, so they do not need to know who references them.
+            if(!(callee->isBuiltIn()))
+            {
+                callee->addDependent(this);
+            }
+        }
+    }
+    while(cache != tail);
 }
 
-MathFunctionTangent::MathFunctionTangent(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("tan", 1), false) {}
-
-double MathFunctionTangent::invoke(double* operands) const
+void MathFunction::unlinkDependencies(vector<MathFunction*>& unused)
 {
-    return tan(operands[0]);
+    Node<const OperationElement>* tail = this->postfixOperations;
+    if(tail == nullptr)
+    {
+        return;
+    }
+    Node<const OperationElement>* cache = tail;
+    do
+    {
+        cache = cache->getNext();
+        const OperationElement* elem = cache->getValue();
+        if(elem->isOperator() && dynamic_cast<const Operator*>(elem)->isFunction())
+        {
+            MathFunction* callee = dynamic_cast<const OperatorInvokeFunc*>(elem)->func;
+            callee->removeDependent(this);
+            if(callee->isShadow && callee->dependents == nullptr && find(unused.begin(), unused.end(), callee) == unused.end())
+            {
+                unused.push_back(callee);
+            }
+        }
+    }
+    while(cache != tail);
 }
 
-MathFunctionHyperbolicSine::MathFunctionHyperbolicSine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("sinh", 1), false) {}
-
-double MathFunctionHyperbolicSine::invoke(double* operands) const
+void MathFunction::releaseShadows(const vector<MathFunction*>& unused)
 {
-    return sinh(operands[0]);
+    for(MathFunction* shadow : unused)
+    {
+        // Unless called again since, e.g. by the new formula of a redefinition.
+        if(shadow->dependents == nullptr)
+        {
+            delete shadow;
+        }
+    }
 }
 
-MathFunctionHyperbolicCosine::MathFunctionHyperbolicCosine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("cosh", 1), false) {}
-
-double MathFunctionHyperbolicCosine::invoke(double* operands) const
+void MathFunction::addDependent(MathFunction* func)
 {
-    return cosh(operands[0]);
+    for(Node<MathFunction>* cache = this->dependents ; cache != nullptr ; cache = cache->getNext())
+    {
+        if(cache->getValue() == func)
+        {
+            return;
+        }
+    }
+    this->dependents = new Node<MathFunction>(func, this->dependents, false);
 }
 
-MathFunctionHyperbolicTangent::MathFunctionHyperbolicTangent(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("tanh", 1), false) {}
-
-double MathFunctionHyperbolicTangent::invoke(double* operands) const
+void MathFunction::removeDependent(MathFunction* func)
 {
-    return tanh(operands[0]);
+    Node<MathFunction>* prev = nullptr;
+    for(Node<MathFunction>* cache = this->dependents ; cache != nullptr ; cache = cache->getNext())
+    {
+        if(cache->getValue() == func)
+        {
+            if(prev == nullptr)
+            {
+                this->dependents = cache->getNext();
+            }
+            else
+            {
+                prev->setNext(cache->getNext());
+            }
+            delete cache;
+            return;
+        }
+        prev = cache;
+    }
 }
 
-MathFunctionArcSine::MathFunctionArcSine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("asin", 1), false) {}
-
-double MathFunctionArcSine::invoke(double* operands) const
+bool MathFunction::isTransitiveDependent(const MathFunction* func)
 {
-    return asin(operands[0]);
+    if(this->dependents == nullptr)
+    {
+        return false;
+    }
+    
+    LinkedStack<MathFunction> pending;
+    unsigned int epoch = ++VISIT_EPOCH;
+    this->visitEpoch = epoch;
+    pending.push(this);
+    while(!pending.isEmpty())
+    {
+        MathFunction* cache = pending.pop();
+        for(Node<MathFunction>* node = cache->dependents ; node != nullptr ; node = node->getNext())
+        {
+            MathFunction* dep = node->getValue();
+            if(dep == func)
+            {
+                return true;
+            }
+            if(dep->visitEpoch != epoch)
+            {
+                dep->visitEpoch = epoch;
+                pending.push(dep);
+            }
+        }
+    }
+    return false;
 }
 
-MathFunctionArcCosine::MathFunctionArcCosine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("acos", 1), false) {}
-
-double MathFunctionArcCosine::invoke(double* operands) const
+void MathFunction::collectDependents(unsigned int epoch, LinkedStack<MathFunction>& order)
 {
-    return acos(operands[0]);
-}
+    if(this->visitEpoch == epoch)
+    {
+        return;
+    }
+    this->visitEpoch = epoch;
+    for(Node<MathFunction>* cache = this->dependents ; cache != nullptr ; cache = cache->getNext())
+    {
+        cache->getValue()->collectDependents(epoch, order);
+    }
+    order.push(this);
+}
+
+void MathFunction::retarget(const MathFunction* from, MathFunction* to)
+{
+    Node<const OperationElement>* tail = this->postfixOperations;
+    if(tail == nullptr)
+    {
+        return;
+    }
+    Node<const OperationElement>* cache = tail;
+    do
+    {
+        cache = cache->getNext();
+        const OperationElement* elem = cache->getValue();
+        if(elem->isOperator() && dynamic_cast<const Operator*>(elem)->isFunction())
+        {
+            OperatorInvokeFunc* oif = const_cast<OperatorInvokeFunc*>(dynamic_cast<const OperatorInvokeFunc*>(elem));
+            if(oif->func == from)
+            {
+                oif->func = to;
+            }
+        }
+    }
+    while(cache != tail);
+}
+
+void MathFunction::compile()
+{
+    Program* old = this->program;
+    this->program = Program::compile(*this, this->tier == TIER_OPTIMIZED);
+    Program::release(old);
+    Program::release(this->retired);
+    this->retired = nullptr;
+}
+
+void MathFunction::countInvocation(unsigned long long _rows) const
+{
+    unsigned long long calls = this->invocations.fetch_add(1, memory_order_relaxed) + 1;
+    unsigned long long total = this->rows.fetch_add(_rows, memory_order_relaxed) + _rows;
+    if(calls >= TIER_POLICY.invocationThreshold || total >= TIER_POLICY.rowThreshold)
+    {
+        // Only the thread winning the transition queues the function.
+        int expected = TIER_BASELINE;
+        MathFunction* self = const_cast<MathFunction*>(this);
+        if(self->tier.compare_exchange_strong(expected, TIER_QUEUED))
+        {
+            TierCompiler::request(self);
+        }
+    }
+}
+
+void MathFunction::promote()
+{
+    if(this->tier != TIER_QUEUED)
+    {
+        return;
+    }
+    
+    // Callees of a hot function are hot as well. Promoting them first lets this function inline their optimized code.
+    Node<const OperationElement>* tail = this->postfixOperations;
+    Node<const OperationElement>* cache = tail;
+    while(cache != nullptr)
+    {
+        cache = cache->getNext();
+        const OperationElement* elem = cache->getValue();
+        if(elem->isOperator() && dynamic_cast<const Operator*>(elem)->isFunction())
+        {
+            MathFunction* callee = dynamic_cast<const OperatorInvokeFunc*>(elem)->func;
+            if(!(callee->isBuiltIn()) && callee->tier != TIER_OPTIMIZED)
+            {
+                TierCompiler::cancel(callee);
+                callee->tier = TIER_QUEUED;
+                callee->promote();
+            }
+        }
+        if(cache == tail)
+        {
+            break;
+        }
+    }
+    
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Program* optimized = Program::compile(*this, true);
+    this->compileNanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    
+    Program::release(this->retired);
+    this->retired = this->program;
+    this->tier = TIER_OPTIMIZED;
+    this->program.store(optimized, memory_order_release);
+    PROMOTIONS++;
+}
+
+void MathFunction::resetTier()
+{
+    if(this->tier == TIER_QUEUED)
+    {
+        TierCompiler::cancel(this);
+    }
+    this->tier = (TIER_POLICY.enabled ? TIER_BASELINE : TIER_OPTIMIZED);
+    this->invocations = 0;
+    this->rows = 0;
+    this->compileNanos = 0;
+}
+
+void MathFunction::recompileDependents()
+{
+    // Post-order pushes every function after all of its dependents, so popping yields callees before callers.
+    LinkedStack<MathFunction> order;
+    unsigned int epoch = ++VISIT_EPOCH;
+    this->visitEpoch = epoch;
+    for(Node<MathFunction>* cache = this->dependents ; cache != nullptr ; cache = cache->getNext())
+    {
+        cache->getValue()->collectDependents(epoch, order);
+    }
+    
+    // Interpolants were sampled from the callees as they were. They are dropped once no recompiled caller refers to them.
+    LinkedStack<MathFunction> stale;
+    while(!order.isEmpty())
+    {
+        MathFunction* func = order.pop();
+        if(func->tabulation != nullptr)
+        {
+            stale.push(func->tabulation);
+            func->tabulation = nullptr;
+        }
+        func->compile();
+    }
+    while(!stale.isEmpty())
+    {
+        delete stale.pop();
+    }
+}
+
+void MathFunction::setTabulation(MathFunction* table)
+{
+    lock_guard<recursive_mutex> locked(TierCompiler::getLock());
+    MathFunction* old = this->tabulation;
+    this->tabulation = table;
+    this->compile();
+    this->recompileDependents();
+    delete old;
+}
+
+void MathFunction::redefine(const string& formula)
+{
+    lock_guard<recursive_mutex> locked(TierCompiler::getLock());
+    if(this->isBuiltIn())
+    {
+        throw InvalidArgumentException("Built-in functions cannot be redefined.");
+    }
+    
+    string __formu = formula;
+    if(!isStringSpacedValid(__formu, -1, false))
+    {
+        throw InvalidFormulaException("Either the spacing is invalid or the brackets are not paired.");
+    }
+    
+    string __ident = this->expression.substr(0, this->expression.find_first_of('='));
+    string __name;
+    HashTable<String, MathFunctionParameter> varTable(count(__ident.begin(), __ident.end(), ',') + 1);
+    parseIdentifier(__ident, __name, varTable);
+    
+    Node<const OperationElement>* old = this->postfixOperations;
+    Arena* oldArena = this->arena;
+    this->postfixOperations = nullptr;
+    this->arena = new Arena(__formu.size() * ARENA_BYTES_PER_CHARACTER);
+    try
+    {
+        this->parseFormula(__formu, varTable);
+    }
+    catch(...)
+    {
+        delete this->arena;
+        this->arena = oldArena;
+        this->postfixOperations = old;
+        throw;
+    }
+    
+    Node<const OperationElement>* fresh = this->postfixOperations;
+    this->postfixOperations = old;
+    vector<MathFunction*> unused;
+    this->unlinkDependencies(unused);
+    this->postfixOperations = fresh;
+    delete oldArena;
+    
+    this->expression = __ident + '=' + __formu;
+    this->linkDependencies();
+    releaseShadows(unused);
+    this->resetTier();
+    this->setTabulation(nullptr);
+}
+
+MathFunction* MathFunction::bind(initializer_list<pair<string, double>> values) const
+{
+    lock_guard<recursive_mutex> locked(TierCompiler::getLock());
+    if(this->isBuiltIn())
+    {
+        throw InvalidArgumentException("Built-in functions cannot be bound.");
+    }
+    if(this->expression.find_first_of('[') < this->expression.find_first_of('='))
+    {
+        throw InvalidArgumentException("Functions of arrays cannot be bound.");
+    }
+    
+    int varCount = this->identifier->getVariablesCount();
+    bool* isBound = new bool[varCount + 1];
+    double* bound = new double[varCount + 1];
+    int* remap = new int[varCount + 1];
+    memset(isBound, 0, (varCount + 1) * sizeof(bool));
+    
+    for(const pair<string, double>& value : values)
+    {
+        int index = 0;
+        while(index < varCount && this->getVariableName(index) != value.first)
+        {
+            index++;
+        }
+        if(index == varCount || isBound[index])
+        {
+            delete[] isBound;
+            delete[] bound;
+            delete[] remap;
+            throw InvalidArgumentException(("Unknown or repeatedly bound variable: " + value.first).c_str());
+        }
+        isBound[index] = true;
+        bound[index] = value.second;
+    }
+    
+    // The remaining variables keep their order.
+    string __ident = this->identifier->getName() + '(';
+    int remaining = 0;
+    for(int i = 0 ; i < varCount ; i++)
+    {
+        if(!isBound[i])
+        {
+            __ident += (remaining > 0 ? "," : "") + this->getVariableName(i);
+            remap[i] = remaining++;
+        }
+    }
+    __ident += ')';
+    
+    string __formu = this->expression.substr(this->expression.find_first_of('=') + 1);
+    MathFunction* func = new MathFunction(this->NAME_SPACE, new MathFunctionIdentifier(this->identifier->getName(), remaining), __ident + '=' + __formu);
+    func->arena = new Arena(__formu.size() * ARENA_BYTES_PER_CHARACTER);
+    func->precision = this->precision;
+    
+    // Bound variables become constants, which the optimized compilation folds along with everything depending on them only.
+    Node<const OperationElement>* tail = this->postfixOperations;
+    Node<const OperationElement>* cache = tail;
+    while(cache != nullptr)
+    {
+        cache = cache->getNext();
+        const OperationElement* elem = cache->getValue();
+        if(elem->isOperator())
+        {
+            const Operator* op = dynamic_cast<const Operator*>(elem);
+            if(op->isFunction())
+            {
+                func->addToNode(new(*(func->arena)) OperatorInvokeFunc(dynamic_cast<const OperatorInvokeFunc*>(op)->func));
+            }
+            else
+            {
+                // Plain operators are singletons.
+                func->addToNode(op);
+            }
+        }
+        else if(dynamic_cast<const Operand*>(elem)->isNumeric())
+        {
+            func->addToNode(new(*(func->arena)) NumericOperand(dynamic_cast<const NumericOperand*>(elem)->getValue()));
+        }
+        else
+        {
+            int index = dynamic_cast<const IndexingOperand*>(elem)->getIndex();
+            if(isBound[index])
+            {
+                func->addToNode(new(*(func->arena)) NumericOperand(bound[index]));
+            }
+            else
+            {
+                func->addToNode(new(*(func->arena)) IndexingOperand(remap[index]));
+            }
+        }
+        if(cache == tail)
+        {
+            break;
+        }
+    }
+    
+    delete[] isBound;
+    delete[] bound;
+    delete[] remap;
+    
+    func->linkDependencies();
+    func->tier = TIER_QUEUED;
+    func->promote();
+    return func;
+}
+
+double MathFunction::invoke(const double* operands) const
+{
+    Program* prog = this->program.load(memory_order_acquire);
+    if(prog == nullptr)
+    {
+        return nan("");
+    }
+    if(this->tier.load(memory_order_relaxed) == TIER_BASELINE)
+    {
+        this->countInvocation(1);
+    }
+    return prog->run(operands);
+}
+
+void MathFunction::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    Program* prog = this->program.load(memory_order_acquire);
+    if(prog != nullptr)
+    {
+        if(this->tier.load(memory_order_relaxed) == TIER_BASELINE)
+        {
+            this->countInvocation(rows);
+        }
+        prog->runBatch(columns, rows, results);
+        return;
+    }
+    
+    // Built-ins without a batch form of their own are gathered one row at a time.
+    int varCount = this->identifier->getVariablesCount();
+    double* row = new double[varCount + 1];
+    for(int i = 0 ; i < rows ; i++)
+    {
+        for(int j = 0 ; j < varCount ; j++)
+        {
+            row[j] = columns[j][i];
+        }
+        results[i] = this->invoke(row);
+    }
+    delete[] row;
+}
+
+void MathFunction::invokeBatch(const double* const* columns, int rows, double* results) const
+{
+    PROFILE_CALL(this);
+    this->invokeColumns(columns, rows, results);
+}
+
+void MathFunction::invokeStrided(const double* const* bases, const ptrdiff_t* strides, int rows, double* results) const
+{
+    PROFILE_CALL(this);
+    Program* prog = this->program.load(memory_order_acquire);
+    if(prog != nullptr)
+    {
+        if(this->tier.load(memory_order_relaxed) == TIER_BASELINE)
+        {
+            this->countInvocation(rows);
+        }
+        prog->runBatch(bases, strides, rows, results);
+        return;
+    }
+    
+    // Built-ins only take columns, thus the rows are gathered block by block.
+    int varCount = this->identifier->getVariablesCount();
+    double* buffer = new double[varCount * Program::BATCH_SIZE + 1];
+    vector<const double*> columns(varCount);
+    for(int i = 0 ; i < varCount ; i++)
+    {
+        columns[i] = buffer + i * Program::BATCH_SIZE;
+    }
+    for(int offset = 0 ; offset < rows ; offset += Program::BATCH_SIZE)
+    {
+        int count = (rows - offset < Program::BATCH_SIZE ? rows - offset : Program::BATCH_SIZE);
+        for(int i = 0 ; i < varCount ; i++)
+        {
+            const char* src = (const char*)(bases[i]) + offset * strides[i];
+            for(int j = 0 ; j < count ; j++)
+            {
+                buffer[i * Program::BATCH_SIZE + j] = *(const double*)(src + j * strides[i]);
+            }
+        }
+        this->invokeColumns(columns.data(), count, results + offset);
+    }
+    delete[] buffer;
+}
+
+void MathFunction::invokeMatrix(const double* matrix, int rows, int ld, double* results) const
+{
+    int varCount = this->identifier->getVariablesCount();
+    if(ld < varCount)
+    {
+        throw InvalidArgumentException(("The leading dimension " + to_string(ld) + " is less than the " + to_string(varCount) + " variables.").c_str());
+    }
+    vector<const double*> bases(varCount);
+    vector<ptrdiff_t> strides(varCount);
+    for(int i = 0 ; i < varCount ; i++)
+    {
+        bases[i] = matrix + i;
+        strides[i] = ld * sizeof(double);
+    }
+    this->invokeStrided(bases.data(), strides.data(), rows, results);
+}
+
+void MathFunction::invokeGrid(const GridAxis* axes, double* results) const
+{
+    PROFILE_CALL(this);
+    int varCount = this->identifier->getVariablesCount();
+    unsigned long long total = 1;
+    for(int i = 0 ; i < varCount ; i++)
+    {
+        if(axes[i].count < 1)
+        {
+            throw InvalidArgumentException(("Axis " + to_string(i) + " of the grid has no values.").c_str());
+        }
+        total *= axes[i].count;
+    }
+    
+    Program* prog = this->program.load(memory_order_acquire);
+    if(prog != nullptr)
+    {
+        if(this->tier.load(memory_order_relaxed) == TIER_BASELINE)
+        {
+            this->countInvocation(total);
+        }
+        prog->runGrid(axes, results);
+        return;
+    }
+    
+    // Built-ins: the outer variables are broadcast into columns, one inner row at a time.
+    int inner = varCount - 1;
+    int columnSize = axes[inner].count;
+    double* buffer = new double[(size_t)varCount * columnSize];
+    vector<const double*> columns(varCount);
+    vector<int> index(varCount, 0);
+    for(int i = 0 ; i < varCount ; i++)
+    {
+        columns[i] = buffer + (size_t)i * columnSize;
+    }
+    for(int j = 0 ; j < columnSize ; j++)
+    {
+        buffer[(size_t)inner * columnSize + j] = axes[inner].at(j);
+    }
+    for(unsigned long long t = 0 ; t < total / columnSize ; t++)
+    {
+        for(int i = 0 ; i < inner ; i++)
+        {
+            double value = axes[i].at(index[i]);
+            for(int j = 0 ; j < columnSize ; j++)
+            {
+                buffer[(size_t)i * columnSize + j] = value;
+            }
+        }
+        this->invokeColumns(columns.data(), columnSize, results + t * columnSize);
+        for(int i = inner - 1 ; i >= 0 && ++(index[i]) == axes[i].count ; i--)
+        {
+            index[i] = 0;
+        }
+    }
+    delete[] buffer;
+}
+
+int MathFunction::filterBlock(const double* const* columns, const int* rows, int offset, int count, double* buffer, int* kept) const
+{
+    int varCount = this->identifier->getVariablesCount();
+    double* values = buffer + (size_t)varCount * Program::BATCH_SIZE;
+    vector<const double*> block(varCount);
+    for(int i = 0 ; i < varCount ; i++)
+    {
+        if(rows == nullptr)
+        {
+            block[i] = columns[i] + offset;
+            continue;
+        }
+        double* gathered = buffer + (size_t)i * Program::BATCH_SIZE;
+        for(int j = 0 ; j < count ; j++)
+        {
+            gathered[j] = columns[i][rows[j]];
+        }
+        block[i] = gathered;
+    }
+    this->invokeColumns(block.data(), count, values);
+    
+    // Every index is written, and the count only advances past the kept ones, i.e. neither 0 nor NaN.
+    int total = 0;
+    for(int j = 0 ; j < count ; j++)
+    {
+        kept[total] = (rows == nullptr ? offset + j : rows[j]);
+        total += (int)((values[j] < 0.0) | (values[j] > 0.0));
+    }
+    return total;
+}
+
+int MathFunction::filterBatch(const double* const* columns, int rows, const int* selection, int* kept) const
+{
+    PROFILE_CALL(this);
+    if(rows < 0)
+    {
+        throw InvalidArgumentException("The number of rows to filter may not be negative.");
+    }
+    int varCount = this->identifier->getVariablesCount();
+    vector<double> buffer((size_t)(varCount + 1) * Program::BATCH_SIZE);
+    int total = 0;
+    for(int offset = 0 ; offset < rows ; offset += Program::BATCH_SIZE)
+    {
+        int count = (rows - offset < Program::BATCH_SIZE ? rows - offset : Program::BATCH_SIZE);
+        
+        // Indices kept are written at or before the ones read, thus "kept" may alias "selection".
+        total += this->filterBlock(columns, (selection == nullptr ? nullptr : selection + offset), offset, count, buffer.data(), kept + total);
+    }
+    return total;
+}
+
+int MathFunction::filterMask(const double* const* columns, int rows, const uint64_t* selection, uint64_t* mask) const
+{
+    static_assert(Program::BATCH_SIZE % 64 == 0, "Blocks must be made of whole words.");
+    
+    PROFILE_CALL(this);
+    if(rows < 0)
+    {
+        throw InvalidArgumentException("The number of rows to filter may not be negative.");
+    }
+    int varCount = this->identifier->getVariablesCount();
+    vector<double> buffer((size_t)(varCount + 1) * Program::BATCH_SIZE);
+    int indices[Program::BATCH_SIZE];
+    int total = 0;
+    for(int offset = 0 ; offset < rows ; offset += Program::BATCH_SIZE)
+    {
+        int count = (rows - offset < Program::BATCH_SIZE ? rows - offset : Program::BATCH_SIZE);
+        int words = (count + 63) / 64;
+        const uint64_t* in = (selection == nullptr ? nullptr : selection + offset / 64);
+        uint64_t* out = mask + offset / 64;
+        
+        // Blocks fully selected are read in place. The others are gathered, bits beyond the last row dropped.
+        int selected = count;
+        const int* gather = nullptr;
+        if(in != nullptr)
+        {
+            selected = 0;
+            for(int w = 0 ; w < words ; w++)
+            {
+                uint64_t bits = in[w];
+                int base = offset + w * 64;
+                int width = (count - w * 64 < 64 ? count - w * 64 : 64);
+                for(int b = 0 ; b < width ; b++)
+                {
+                    indices[selected] = base + b;
+                    selected += (int)((bits >> b) & 1);
+                }
+            }
+            if(selected < count)
+            {
+                gather = indices;
+            }
+        }
+        
+        for(int w = 0 ; w < words ; w++)
+        {
+            out[w] = 0;
+        }
+        if(selected == 0)
+        {
+            continue;
+        }
+        int found = this->filterBlock(columns, gather, offset, selected, buffer.data(), indices);
+        for(int k = 0 ; k < found ; k++)
+        {
+            int row = indices[k] - offset;
+            out[row / 64] |= (uint64_t)1 << (row % 64);
+        }
+        total += found;
+    }
+    return total;
+}
+
+double MathFunction::invoke(initializer_list<double> var_list) const
+{
+    int _size = var_list.size();
+    if(_size != this->identifier->getVariablesCount())
+    {
+        throw InvalidArgumentException(("The function accepts " + to_string(this->identifier->getVariablesCount()) + " arguments, but received " + to_string(_size) + ".").c_str());
+    }
+    PROFILE_CALL(this);
+    return this->invoke(var_list.begin());
+}
+
+double MathFunction::invoke(const vector<double>& operands) const
+{
+    if((int)(operands.size()) != this->identifier->getVariablesCount())
+    {
+        throw InvalidArgumentException(("The function accepts " + to_string(this->identifier->getVariablesCount()) + " arguments, but received " + to_string(operands.size()) + ".").c_str());
+    }
+    PROFILE_CALL(this);
+    return this->invoke(operands.data());
+}
+
+size_t MathFunction::getStringHeapBytes(const string& str)
+{
+    const char* data = str.data();
+    if(data >= (const char*)(&str) && data < (const char*)(&str + 1))
+    {
+        return 0;
+    }
+    return str.capacity() + 1;
+}
+
+MemoryUsage MathFunction::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.functions = 1;
+    usage.functionBytes = sizeof(MathFunction) + getStringHeapBytes(this->expression);
+    usage.functionBytes += sizeof(MathFunctionIdentifier) + getStringHeapBytes(this->identifier->getName());
+    usage.shadows = (this->isShadow ? 1 : 0);
+    
+    if(this->arena != nullptr)
+    {
+        usage.postfixBytes = this->arena->getReservedBytes();
+    }
+    Node<const OperationElement>* tail = this->postfixOperations;
+    for(Node<const OperationElement>* cache = tail ; cache != nullptr ; )
+    {
+        usage.postfixNodes++;
+        cache = cache->getNext();
+        if(cache == tail)
+        {
+            break;
+        }
+    }
+    
+    Program* prog = this->program;
+    if(prog != nullptr)
+    {
+        usage.programBytes = prog->getMemoryBytes();
+        usage.instructions = prog->getLength();
+        if(prog->getRegisterProgram() != nullptr)
+        {
+            usage.registerInstructions = prog->getRegisterProgram()->getLength();
+        }
+    }
+    if(this->retired != nullptr)
+    {
+        usage.programBytes += this->retired->getMemoryBytes();
+    }
+    
+    usage.dependents = this->getDependentsCount();
+    usage.dependentsBytes = usage.dependents * sizeof(Node<MathFunction>);
+    return usage;
+}
+
+string MathFunction::getVariableName(int index) const
+{
+    if(index < 0 || index >= this->identifier->getVariablesCount() || this->isBuiltIn())
+    {
+        return "";
+    }
+    
+    // The expression is stored without spaces, e.g. "f(x,w[3])=x*sum(w)", where the elements of "w" are named "w[0]" to "w[2]".
+    size_t start = this->expression.find_first_of('(') + 1;
+    int first = 0;
+    while(true)
+    {
+        size_t end = this->expression.find_first_of(",)", start);
+        string param = this->expression.substr(start, end - start);
+        size_t bracket = param.find_first_of('[');
+        int length = (bracket == string::npos ? 1 : parseSubscript(param, bracket));
+        if(index < first + length)
+        {
+            return (bracket == string::npos ? param : param.substr(0, bracket) + '[' + to_string(index - first) + ']');
+        }
+        first += length;
+        start = end + 1;
+    }
+}
+
+void MathFunction::setPrecision(Precision _precision)
+{
+    lock_guard<recursive_mutex> locked(TierCompiler::getLock());
+    if(this->isBuiltIn())
+    {
+        throw InvalidArgumentException("Built-in functions have no precision to set.");
+    }
+    if(this->precision == _precision)
+    {
+        return;
+    }
+    this->precision = _precision;
+    this->compile();
+    this->recompileDependents();
+}
+
+Precision MathFunction::getPrecision() const
+{
+    return this->precision;
+}
+
+bool MathFunction::isTabulated() const
+{
+    return this->tabulation != nullptr;
+}
+
+void MathFunction::untabulate()
+{
+    lock_guard<recursive_mutex> locked(TierCompiler::getLock());
+    if(this->tabulation != nullptr)
+    {
+        this->setTabulation(nullptr);
+    }
+}
+
+const MathFunction& MathFunction::approximate() const
+{
+    return *this;
+}
+
+TierStats MathFunction::getTierStats() const
+{
+    TierStats stats;
+    stats.tier = this->tier;
+    stats.invocations = this->invocations;
+    stats.rows = this->rows;
+    stats.compileNanos = this->compileNanos;
+    return stats;
+}
+
+void MathFunction::setTierPolicy(const TierPolicy& policy)
+{
+    TIER_POLICY = policy;
+}
+
+const TierPolicy& MathFunction::getTierPolicy()
+{
+    return TIER_POLICY;
+}
+
+void MathFunction::setBackend(Backend backend)
+{
+    BACKEND = backend;
+}
+
+Backend MathFunction::getBackend()
+{
+    return BACKEND;
+}
+
+void MathFunction::waitForTiering()
+{
+    TierCompiler::drain();
+}
+
+unsigned long long MathFunction::getPromotionCount()
+{
+    return PROMOTIONS;
+}
+
+const MathFunctionIdentifier& MathFunction::getIdentifier() const
+{
+    return *(this->identifier);
+}
+
+int MathFunction::getDependentsCount() const
+{
+    int count = 0;
+    for(Node<MathFunction>* cache = this->dependents ; cache != nullptr ; cache = cache->getNext())
+    {
+        count++;
+    }
+    return count;
+}
+
+MathFunctionApproximation::MathFunctionApproximation(MathFunctionNamespace& ns, const string& name, double (*_scalar)(double), void (*_batch)(const double*, int, double*))
+    : MathFunction::MathFunction(ns, new MathFunctionIdentifier(name, 1), string())
+{
+    this->scalar = _scalar;
+    this->batch = _batch;
+}
+
+double MathFunctionApproximation::invoke(const double* operands) const
+{
+    return this->scalar(operands[0]);
+}
+
+void MathFunctionApproximation::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    this->batch(columns[0], rows, results);
+}
+
+MathFunctionSine::MathFunctionSine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("sin", 1), false),
+    approximation(ns, "sin", FastMath::sin, FastMath::sinBatch) {}
+
+const MathFunction& MathFunctionSine::approximate() const
+{
+    return this->approximation;
+}
+
+double MathFunctionSine::invoke(const double* operands) const
+{
+    return sin(operands[0]);
+}
+
+void MathFunctionSine::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = sin(columns[0][i]);
+    }
+}
+
+MathFunctionCosine::MathFunctionCosine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("cos", 1), false),
+    approximation(ns, "cos", FastMath::cos, FastMath::cosBatch) {}
+
+const MathFunction& MathFunctionCosine::approximate() const
+{
+    return this->approximation;
+}
+
+double MathFunctionCosine::invoke(const double* operands) const
+{
+    return cos(operands[0]);
+}
+
+void MathFunctionCosine::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = cos(columns[0][i]);
+    }
+}
+
+MathFunctionTangent::MathFunctionTangent(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("tan", 1), false),
+    approximation(ns, "tan", FastMath::tan, FastMath::tanBatch) {}
+
+const MathFunction& MathFunctionTangent::approximate() const
+{
+    return this->approximation;
+}
+
+double MathFunctionTangent::invoke(const double* operands) const
+{
+    return tan(operands[0]);
+}
+
+void MathFunctionTangent::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = tan(columns[0][i]);
+    }
+}
+
+MathFunctionHyperbolicSine::MathFunctionHyperbolicSine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("sinh", 1), false) {}
+
+double MathFunctionHyperbolicSine::invoke(const double* operands) const
+{
+    return sinh(operands[0]);
+}
+
+void MathFunctionHyperbolicSine::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = sinh(columns[0][i]);
+    }
+}
+
+MathFunctionHyperbolicCosine::MathFunctionHyperbolicCosine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("cosh", 1), false) {}
+
+double MathFunctionHyperbolicCosine::invoke(const double* operands) const
+{
+    return cosh(operands[0]);
+}
+
+void MathFunctionHyperbolicCosine::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = cosh(columns[0][i]);
+    }
+}
+
+MathFunctionHyperbolicTangent::MathFunctionHyperbolicTangent(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("tanh", 1), false) {}
+
+double MathFunctionHyperbolicTangent::invoke(const double* operands) const
+{
+    return tanh(operands[0]);
+}
+
+void MathFunctionHyperbolicTangent::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = tanh(columns[0][i]);
+    }
+}
+
+MathFunctionArcSine::MathFunctionArcSine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("asin", 1), false) {}
+
+double MathFunctionArcSine::invoke(const double* operands) const
+{
+    return asin(operands[0]);
+}
+
+void MathFunctionArcSine::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = asin(columns[0][i]);
+    }
+}
+
+MathFunctionArcCosine::MathFunctionArcCosine(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("acos", 1), false) {}
+
+double MathFunctionArcCosine::invoke(const double* operands) const
+{
+    return acos(operands[0]);
+}
+
+void MathFunctionArcCosine::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = acos(columns[0][i]);
+    }
+}
 
 MathFunctionArcTangent::MathFunctionArcTangent(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("atan", 1), false) {}
 
-double MathFunctionArcTangent::invoke(double* operands) const
+double MathFunctionArcTangent::invoke(const double* operands) const
 {
     return atan(operands[0]);
 }
 
+void MathFunctionArcTangent::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = atan(columns[0][i]);
+    }
+}
+
 MathFunctionArcTangent2::MathFunctionArcTangent2(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("atan2", 2), false) {}
 
-double MathFunctionArcTangent2::invoke(double* operands) const
+double MathFunctionArcTangent2::invoke(const double* operands) const
 {
     return atan2(operands[0], operands[1]);
 }
 
-MathFunctionExponential::MathFunctionExponential(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("exp", 1), false) {}
+void MathFunctionArcTangent2::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = atan2(columns[0][i], columns[1][i]);
+    }
+}
+
+MathFunctionExponential::MathFunctionExponential(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("exp", 1), false),
+    approximation(ns, "exp", FastMath::exp, FastMath::expBatch) {}
 
-double MathFunctionExponential::invoke(double* operands) const
+const MathFunction& MathFunctionExponential::approximate() const
+{
+    return this->approximation;
+}
+
+double MathFunctionExponential::invoke(const double* operands) const
 {
     return exp(operands[0]);
 }
 
-MathFunctionNaturalLog::MathFunctionNaturalLog(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("ln", 1), false) {}
+void MathFunctionExponential::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = exp(columns[0][i]);
+    }
+}
+
+MathFunctionNaturalLog::MathFunctionNaturalLog(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("ln", 1), false),
+    approximation(ns, "ln", FastMath::log, FastMath::logBatch) {}
 
-double MathFunctionNaturalLog::invoke(double* operands) const
+const MathFunction& MathFunctionNaturalLog::approximate() const
+{
+    return this->approximation;
+}
+
+double MathFunctionNaturalLog::invoke(const double* operands) const
 {
     return log(operands[0]);
 }
 
-MathFunctionLog10::MathFunctionLog10(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("log", 1), false) {}
+void MathFunctionNaturalLog::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = log(columns[0][i]);
+    }
+}
+
+MathFunctionLog10::MathFunctionLog10(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("log10", 1), false) {}
 
-double MathFunctionLog10::invoke(double* operands) const
+double MathFunctionLog10::invoke(const double* operands) const
 {
     return log10(operands[0]);
 }
 
+void MathFunctionLog10::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = log10(columns[0][i]);
+    }
+}
+
 MathFunctionLog::MathFunctionLog(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("log", 2), false) {}
 
-double MathFunctionLog::invoke(double* operands) const
+double MathFunctionLog::invoke(const double* operands) const
 {
     return log(operands[1]) / log(operands[0]);
 }
 
+void MathFunctionLog::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = log(columns[1][i]) / log(columns[0][i]);
+    }
+}
+
 MathFunctionCeiling::MathFunctionCeiling(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("ceil", 1), false) {}
 
-double MathFunctionCeiling::invoke(double* operands) const
+double MathFunctionCeiling::invoke(const double* operands) const
 {
     return ceil(operands[0]);
 }
 
-MathFunctionFloor::MathFunctionFloor(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("ceil", 1), false) {}
+void MathFunctionCeiling::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = ceil(columns[0][i]);
+    }
+}
+
+MathFunctionFloor::MathFunctionFloor(MathFunctionNamespace& ns) : MathFunction::MathFunction(ns, new MathFunctionIdentifier("floor", 1), false) {}
 
-double MathFunctionFloor::invoke(double* operands) const
+double MathFunctionFloor::invoke(const double* operands) const
 {
     return floor(operands[0]);
 }
 
-const MathFunction& MathFunction::SIN = *(new MathFunctionSine(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::COS = *(new MathFunctionCosine(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::TAN = *(new MathFunctionTangent(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::SINH = *(new MathFunctionHyperbolicSine(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::COSH = *(new MathFunctionHyperbolicCosine(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::TANH = *(new MathFunctionHyperbolicTangent(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::ASIN = *(new MathFunctionArcSine(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::ACOS = *(new MathFunctionArcCosine(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::ATAN = *(new MathFunctionArcTangent(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::ATAN2 = *(new MathFunctionArcTangent2(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::EXP = *(new MathFunctionExponential(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::LN = *(new MathFunctionNaturalLog(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::LOG10 = *(new MathFunctionLog10(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::LOG = *(new MathFunctionLog(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::CEIL = *(new MathFunctionCeiling(MathFunction::DEFAULT_NAMESPACE));
-const MathFunction& MathFunction::FLOOR = *(new MathFunctionFloor(MathFunction::DEFAULT_NAMESPACE));
+void MathFunctionFloor::invokeColumns(const double* const* columns, int rows, double* results) const
+{
+    for(int i = 0 ; i < rows ; i++)
+    {
+        results[i] = floor(columns[0][i]);
+    }
+}
+
+
+/*
+ * Construct a built-in upon its first use, in static storage, and never destroy it.
+ */
+template<typename T>
+static const MathFunction& getBuiltIn()
+{
+    alignas(T) static unsigned char storage[sizeof(T)];
+    static T* func = new(storage) T(const_cast<MathFunctionNamespace&>(MathFunctionNamespace::getBuiltIns()));
+    return *func;
+}
+
+struct BuiltInEntry
+{
+    const char* name;
+    int varCount;
+    const MathFunction& (*function)();
+};
+
+/*
+ * Every built-in by the identifiers it is called by. "log" of a single argument is kept as the name of log10() which
+ *  formulas have been using.
+ */
+static constexpr BuiltInEntry BUILT_INS[] =
+{
+    {"sin", 1, getBuiltIn<MathFunctionSine>},
+    {"cos", 1, getBuiltIn<MathFunctionCosine>},
+    {"tan", 1, getBuiltIn<MathFunctionTangent>},
+    {"sinh", 1, getBuiltIn<MathFunctionHyperbolicSine>},
+    {"cosh", 1, getBuiltIn<MathFunctionHyperbolicCosine>},
+    {"tanh", 1, getBuiltIn<MathFunctionHyperbolicTangent>},
+    {"asin", 1, getBuiltIn<MathFunctionArcSine>},
+    {"acos", 1, getBuiltIn<MathFunctionArcCosine>},
+    {"atan", 1, getBuiltIn<MathFunctionArcTangent>},
+    {"atan2", 2, getBuiltIn<MathFunctionArcTangent2>},
+    {"exp", 1, getBuiltIn<MathFunctionExponential>},
+    {"ln", 1, getBuiltIn<MathFunctionNaturalLog>},
+    {"log10", 1, getBuiltIn<MathFunctionLog10>},
+    {"log", 1, getBuiltIn<MathFunctionLog10>},
+    {"log", 2, getBuiltIn<MathFunctionLog>},
+    {"ceil", 1, getBuiltIn<MathFunctionCeiling>},
+    {"floor", 1, getBuiltIn<MathFunctionFloor>}
+};
+
+static const int BUILT_IN_COUNT = sizeof(BUILT_INS) / sizeof(BUILT_INS[0]);
+
+/*
+ * Slots of the perfect hash of the built-ins, a power of 2 well above their count so that a seed is found quickly.
+ */
+static const int BUILT_IN_SLOTS = 64;
+
+static constexpr size_t getLength(const char* str)
+{
+    size_t length = 0;
+    while(str[length] != '\0')
+    {
+        length++;
+    }
+    return length;
+}
+
+/*
+ * A single-level perfect hash of the built-ins: the seed, and the entry in each slot, -1 if none.
+ */
+struct BuiltInLayout
+{
+    uint32_t seed;
+    int slots[BUILT_IN_SLOTS];
+};
+
+/*
+ * Try the seeds in order until every built-in lands in a slot of its own. Seed 0 means that none was found.
+ */
+static constexpr BuiltInLayout layoutBuiltIns()
+{
+    BuiltInLayout layout = {};
+    for(uint32_t seed = 1 ; seed < 4096 ; seed++)
+    {
+        for(int i = 0 ; i < BUILT_IN_SLOTS ; i++)
+        {
+            layout.slots[i] = -1;
+        }
+        bool placed = true;
+        for(int i = 0 ; i < BUILT_IN_COUNT && placed ; i++)
+        {
+            int slot = PerfectHash::hash(BUILT_INS[i].name, getLength(BUILT_INS[i].name), BUILT_INS[i].varCount, seed) % BUILT_IN_SLOTS;
+            placed = (layout.slots[slot] < 0);
+            layout.slots[slot] = i;
+        }
+        if(placed)
+        {
+            layout.seed = seed;
+            return layout;
+        }
+    }
+    layout.seed = 0;
+    return layout;
+}
+
+static constexpr BuiltInLayout BUILT_IN_LAYOUT = layoutBuiltIns();
+
+static_assert(BUILT_IN_LAYOUT.seed != 0, "No seed gives a perfect hash of the built-ins.");
+
+static MathFunction* findBuiltIn(const MathFunctionIdentifier* ident)
+{
+    const string& name = ident->getName();
+    int entry = BUILT_IN_LAYOUT.slots[PerfectHash::hash(name.data(), name.size(), ident->getVariablesCount(), BUILT_IN_LAYOUT.seed) % BUILT_IN_SLOTS];
+    if(entry < 0 || BUILT_INS[entry].varCount != ident->getVariablesCount() || name != BUILT_INS[entry].name)
+    {
+        return nullptr;
+    }
+    return const_cast<MathFunction*>(&(BUILT_INS[entry].function()));
+}
+
+// Bound through the registry, so that they do not depend on the order of static initialization either.
+const MathFunction& MathFunction::SIN = getBuiltIn<MathFunctionSine>();
+const MathFunction& MathFunction::COS = getBuiltIn<MathFunctionCosine>();
+const MathFunction& MathFunction::TAN = getBuiltIn<MathFunctionTangent>();
+const MathFunction& MathFunction::SINH = getBuiltIn<MathFunctionHyperbolicSine>();
+const MathFunction& MathFunction::COSH = getBuiltIn<MathFunctionHyperbolicCosine>();
+const MathFunction& MathFunction::TANH = getBuiltIn<MathFunctionHyperbolicTangent>();
+const MathFunction& MathFunction::ASIN = getBuiltIn<MathFunctionArcSine>();
+const MathFunction& MathFunction::ACOS = getBuiltIn<MathFunctionArcCosine>();
+const MathFunction& MathFunction::ATAN = getBuiltIn<MathFunctionArcTangent>();
+const MathFunction& MathFunction::ATAN2 = getBuiltIn<MathFunctionArcTangent2>();
+const MathFunction& MathFunction::EXP = getBuiltIn<MathFunctionExponential>();
+const MathFunction& MathFunction::LN = getBuiltIn<MathFunctionNaturalLog>();
+const MathFunction& MathFunction::LOG10 = getBuiltIn<MathFunctionLog10>();
+const MathFunction& MathFunction::LOG = getBuiltIn<MathFunctionLog>();
+const MathFunction& MathFunction::CEIL = getBuiltIn<MathFunctionCeiling>();
+const MathFunction& MathFunction::FLOOR = getBuiltIn<MathFunctionFloor>();
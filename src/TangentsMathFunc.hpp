@@ -9,13 +9,22 @@
  *    MathFunction("f(x, y, ...)", "<operations>");
  */
 
+#include <stdint.h>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "util/Arena.hpp"
 #include "util/LinkedNode.hpp"
+#include "util/LinkedStack.hpp"
 #include "util/HashTable.hpp"
+#include "util/PerfectHash.hpp"
 #include "misc/StringWrap.hpp"
 #include "misc/TFException.hpp"
 #include "Operators.hpp"
+#include "Profiler.hpp"
+#include "Program.hpp"
+#include "TierCompiler.hpp"
 
 #ifndef __TANGENT_MATH_FUNC__
 #define __TANGENT_MATH_FUNC__ 65536
@@ -58,16 +67,191 @@ class MathFunctionIdentifier
         int hash(int capacity) const;
 };
 
+/*
+ * Memory held by a MathFunction or a MathFunctionNamespace, in bytes and object counts.
+ */
+struct MemoryUsage
+{
+    /*
+     * MathFunction objects, including their identifiers and original expressions.
+     */
+    size_t functionBytes = 0;
+    int functions = 0;
+    
+    /*
+     * Arenas holding the postfix expressions.
+     */
+    size_t postfixBytes = 0;
+    int postfixNodes = 0;
+    
+    /*
+     * Compiled programs.
+     */
+    size_t programBytes = 0;
+    int instructions = 0;
+    
+    /*
+     * Instructions of the register forms under BACKEND_REGISTER. Their bytes are included above.
+     */
+    int registerInstructions = 0;
+    
+    /*
+     * Reverse dependency lists.
+     */
+    size_t dependentsBytes = 0;
+    int dependents = 0;
+    
+    /*
+     * Copies left behind by destroyed functions which are still referenced, destroyed along with their last caller. Their bytes are included above.
+     */
+    int shadows = 0;
+    
+    /*
+     * Bucket array and chain nodes of a namespace.
+     */
+    size_t tableBytes = 0;
+    int buckets = 0;
+    int chainNodes = 0;
+    
+    size_t getTotalBytes() const;
+    
+    void add(const MemoryUsage& usage);
+};
+
+/*
+ * Execution tiers of a user-defined function.
+ */
+enum Tier
+{
+    /*
+     * Straight translation of the postfix expression, cheap to compile.
+     */
+    TIER_BASELINE,
+    
+    /*
+     * Still baseline, waiting for the background compiler.
+     */
+    TIER_QUEUED,
+    
+    /*
+     * Callees inlined and constants folded.
+     */
+    TIER_OPTIMIZED
+};
+
+/*
+ * How built-ins called by a function are evaluated.
+ */
+enum Precision
+{
+    /*
+     * By the standard library, correctly rounded or nearly so.
+     */
+    PRECISION_EXACT,
+    
+    /*
+     * sin, cos, tan, exp and ln by the approximations of FastMath, within a few ULP, see misc/FastMath.hpp.
+     *  Other built-ins are exact.
+     */
+    PRECISION_FAST
+};
+
+/*
+ * Interpreters running compiled functions.
+ */
+enum Backend
+{
+    /*
+     * Postfix code over an operand stack.
+     */
+    BACKEND_STACK,
+    
+    /*
+     * Three-address code over registers, see RegisterProgram.
+     */
+    BACKEND_REGISTER
+};
+
+/*
+ * When functions are promoted to the optimized tier. A function is queued once either threshold is crossed.
+ */
+struct TierPolicy
+{
+    /*
+     * If false, every function is compiled optimized right away.
+     */
+    bool enabled = true;
+    
+    /*
+     * Calls of invoke() and invokeBatch(), nested calls included.
+     */
+    unsigned long long invocationThreshold = 1000;
+    
+    /*
+     * Rows evaluated, a scalar call counting as one.
+     */
+    unsigned long long rowThreshold = 65536;
+};
+
+/*
+ * Tier state of a MathFunction.
+ */
+struct TierStats
+{
+    /*
+     * One of the Tier values.
+     */
+    int tier = TIER_BASELINE;
+    
+    /*
+     * Counted while at the baseline tier only.
+     */
+    unsigned long long invocations = 0;
+    unsigned long long rows = 0;
+    
+    /*
+     * Time spent compiling the optimized tier, 0 if not promoted.
+     */
+    unsigned long long compileNanos = 0;
+};
+
 /*
  * Namespace of the MathFunctions
+ *
+ * A namespace may be layered over a parent, e.g. the built-ins or a library shared by many namespaces. Callees are
+ *  looked up in the namespace first, then in its parent and so on, while functions are only ever declared into the
+ *  namespace itself, so the parent is left untouched and a function of the namespace may hide one of the parent.
+ *  The table of a namespace is allocated upon its first declaration, so that a layer costs nothing until it is written to.
+ *
+ * Once populated, a namespace may be frozen into a perfect hash of its functions, which the built-ins always are.
  */
 class MathFunctionNamespace
 {
     private:
         /*
-         * All mathfunctions in this namespace
+         * All mathfunctions in this namespace, parents excluded. nullptr until the first one is declared.
+         */
+        HashTable<const MathFunctionIdentifier, MathFunction>* functions = nullptr;
+        
+        /*
+         * Replaces the table once frozen, see freeze(). The slots hold the functions, nullptr for those destroyed since.
          */
-        HashTable<const MathFunctionIdentifier, MathFunction>* functions;
+        PerfectHash* frozen = nullptr;
+        MathFunction** frozenFunctions = nullptr;
+        
+        /*
+         * Set for the namespace of the built-ins only, which are looked up in their compile-time registry instead.
+         */
+        bool builtIns = false;
+        
+        /*
+         * Buckets of the table once allocated.
+         */
+        int capacity;
+        
+        const MathFunctionNamespace* parent;
+        
+        Precision precision = PRECISION_EXACT;
         
         // Disabled.
         MathFunctionNamespace(const MathFunctionNamespace&);
@@ -92,23 +276,113 @@ class MathFunctionNamespace
          *  it WILL NOT be remove and the operation returns false.
          */
         bool del(const MathFunctionIdentifier* ident);
+        
+        /*
+         * Drop a function from this namespace, whatever references it.
+         */
+        void remove(const MathFunctionIdentifier* ident);
+        
+        /*
+         * The slot of the frozen table holding a function, nullptr if there is none.
+         */
+        MathFunction** getFrozenSlot(const MathFunctionIdentifier* ident) const;
+        
+        /*
+         * A function declared in this namespace itself, nullptr if there is none.
+         */
+        MathFunction* get(const MathFunctionIdentifier* ident) const;
+        
+        /*
+         * A function declared in this namespace or, failing that, in the nearest parent declaring one.
+         */
+        MathFunction* find(const MathFunctionIdentifier* ident) const;
+        
+        static void accumulateMemoryUsage(const MathFunctionIdentifier* ident, MathFunction* func, void* usage);
+        
+        static void collectFunction(const MathFunctionIdentifier* ident, MathFunction* func, void* funcs);
     
     public:
         MathFunctionNamespace();
+        
+        /*
+         * A namespace layered over another one, e.g.
+         *  MathFunctionNamespace tenant(&MathFunctionNamespace::getBuiltIns());
+         *  MathFunction func(tenant, "f(x)", "sin(x) ^ 2");
+         *  The parent MUST outlive the namespace. Callees are resolved when a formula is parsed, so a function declared
+         *  into the parent afterwards is only seen by the formulas parsed afterwards.
+         *
+         * Param(s):
+         *    capacity    -> Buckets of the table, allocated upon the first declaration. Layers usually hold few functions.
+         */
+        explicit MathFunctionNamespace(const MathFunctionNamespace* parent, int capacity = DEFAULT_LAYER_CAPACITY);
+        
         ~MathFunctionNamespace();
         
+        /*
+         * The namespace holding the built-in functions only, which the default namespace is layered over. Read-only.
+         */
+        static const MathFunctionNamespace& getBuiltIns();
+        
+        /*
+         * The namespace this one is layered over, nullptr if none.
+         */
+        const MathFunctionNamespace* getParent() const;
+        
+        /*
+         * Make the set of functions of this namespace immutable, e.g. a library fully declared before bulk parsing, so that
+         *  callees are looked up by a perfect hash instead of walking the chains of the table. Declaring a function into the
+         *  namespace throws InvalidArgumentException afterwards, while its functions may still be redefined or destroyed.
+         *  Parents are not frozen along. Does nothing if already frozen.
+         */
+        void freeze();
+        
+        bool isFrozen() const;
+        
+        /*
+         * Memory held by this namespace and every function in it, shadows included. Parents are not included.
+         */
+        MemoryUsage getMemoryUsage() const;
+        
+        /*
+         * Precision of the functions declared in this namespace afterwards. Those already declared keep theirs.
+         */
+        void setPrecision(Precision _precision);
+        
+        Precision getPrecision() const;
+        
         static const int MAX_FUNCTIONS_CAPACITY = 65537;
         
+        static const int DEFAULT_LAYER_CAPACITY = 1021;
+        
     friend class MathFunction;
 };
 
+/*
+ * A parameter of a MathFunction, as listed in its identifier, e.g. "x" or "w[1000]". Used while parsing only.
+ */
+struct MathFunctionParameter
+{
+    /*
+     * The variable of a scalar, or the first variable of an array.
+     */
+    int index;
+    
+    /*
+     * Variables of an array, 0 for a scalar.
+     */
+    int length;
+};
+
 /*
  * Math function object.
  */
 class MathFunction
 {
     private:
-        static MathFunctionNamespace& DEFAULT_NAMESPACE;
+        /*
+         * Created upon first use, so that functions declared by static initializers of other files find it.
+         */
+        static MathFunctionNamespace& getDefaultNamespace();
         
         /*
          * Identifier of a function, including a string as its name and an integer representing the number of arguments.
@@ -130,14 +404,74 @@ class MathFunction
          */
         Node<const OperationElement>* postfixOperations = nullptr; // circular tail
         
+        /*
+         * Owner of the postfix nodes and operands. Replaced as a whole upon redefinition.
+         */
+        Arena* arena = nullptr;
+        
+        /*
+         * First chunk size of the arena, per character of the formula. Enough for most formulas to fit into one chunk.
+         */
+        static const int ARENA_BYTES_PER_CHARACTER = 40;
+        
+        /*
+         * The flattened postfix expression of the current tier. Rebuilt whenever a callee is redefined.
+         *  Swapped by the background compiler while other threads may be running it.
+         */
+        atomic<Program*> program{nullptr};
+        
+        /*
+         * The baseline program replaced upon promotion. Kept alive until the next recompilation,
+         *  since callers which loaded it before the swap may still be running it.
+         */
+        Program* retired = nullptr;
+        
+        atomic<int> tier{TIER_BASELINE};
+        
+        Precision precision = PRECISION_EXACT;
+        
+        mutable atomic<unsigned long long> invocations{0};
+        
+        mutable atomic<unsigned long long> rows{0};
+        
+        unsigned long long compileNanos = 0;
+        
+        /*
+         * Interpolant installed by a Tabulator, called in place of the formula. Owned by this function.
+         */
+        MathFunction* tabulation = nullptr;
+        
+        static TierPolicy TIER_POLICY;
+        
+        static Backend BACKEND;
+        
+        static atomic<unsigned long long> PROMOTIONS;
+        
         // Disabled
         MathFunction(const MathFunction&);
         void operator=(const MathFunction&);
         
         /*
-         * Whether this object is once referenced by other functions. If YES, then the function will copy itself in its namespace before being destroyed.
+         * Functions referencing this one (reverse dependencies). If not empty, the function will copy itself in its namespace before being destroyed.
          */
-        bool isReferencedByOthers = false;
+        Node<MathFunction>* dependents = nullptr;
+        
+        /*
+         * Whether this is the copy a referenced function left behind in its namespace upon destruction.
+         *  A new function declared with the same identifier takes over its dependents.
+         */
+        bool isShadow = false;
+        
+        /*
+         * Mark of the last graph traversal that visited this function.
+         */
+        unsigned int visitEpoch = 0;
+        
+        /*
+         * Mark of the current graph traversal. Traversals, and thus this counter and the marks, are ONLY safe under
+         *  TierCompiler::getLock(), which every declaration, redefinition, destruction and recompilation holds.
+         */
+        static unsigned int VISIT_EPOCH;
         
         /*
          * If true, all the spaces WILL be removed. c:
@@ -146,18 +480,161 @@ class MathFunction
         
         static bool isAlphabetOrNumber(char c);
         
-        int parseInnerFunctionInput(string& _expressions, int& endIndex, HashTable<String, int>& availableVariables);
+        /*
+         * Bytes a string allocated outside of itself. Short strings are stored inline.
+         */
+        static size_t getStringHeapBytes(const string& str);
+        
+        /*
+         * Split "f(x, y, ...)" into the name and the variable table. Returns the variable count, that is the scalars plus
+         *  the elements of the arrays, e.g. 1001 for "f(x, w[1000])".
+         */
+        static int parseIdentifier(const string& _ident, string& name, HashTable<String, MathFunctionParameter>& varTable);
+        
+        static void addParameter(const string& _param, HashTable<String, MathFunctionParameter>& varTable, int& varCount);
+        
+        /*
+         * The non-negative integer between the bracket at "bracket" and the closing one ending the string, -1 if there is none.
+         */
+        static int parseSubscript(const string& _str, size_t bracket);
+        
+        void parseFormula(string& _formula, HashTable<String, MathFunctionParameter>& varTable);
+        
+        int parseInnerFunctionInput(string& _expressions, int& endIndex, HashTable<String, MathFunctionParameter>& availableVariables);
+        
+        /*
+         * Add a variable or an array element, e.g. "x" or "w[3]", or every element of an array if it is a whole argument of a call.
+         *  Returns the values added.
+         */
+        int addVariable(const string& _operandStr_, HashTable<String, MathFunctionParameter>& varTable, bool wholeArgument);
+        
+        /*
+         * Add the reduction called at "endIndex" if its arguments are whole arrays, e.g. "sum(w)" or "dot(w,x)", and move past it.
+         *
+         * Return:
+         *    False if it is not a reduction, and should be parsed as an ordinary call.
+         */
+        bool parseReduction(const string& _expressions, int& endIndex, const string& name, HashTable<String, MathFunctionParameter>& varTable);
+        
+        /*
+         * The comparison or logical operator starting at "index", moving "index" to its last character, e.g. "<=" or "!".
+         *  Throws InvalidFormulaException for a lone '=', '&' or '|', and for a misplaced '!'.
+         */
+        static const Operator* parseLogicalOperator(const string& _formula, int& index, bool previouslyOperator);
+        
+        /*
+         * Look up a callee in the namespace. Callees that (transitively) depend on this function are rejected.
+         */
+        MathFunction* resolve(const string& name, int varCount);
+        
+        /*
+         * Add the call whose arguments were just parsed: a selection for "if" and "select" of 3 arguments, resolved otherwise.
+         */
+        void addCall(const string& name, int varCount);
         
         void addToNode(const OperationElement* elem);
+        
+        bool isBuiltIn() const;
+        
+        /*
+         * Register this function as a dependent of every user-defined function it calls.
+         */
+        void linkDependencies();
+        
+        /*
+         * Remove this function from the dependents of every user-defined function it calls.
+         *
+         * Param(s):
+         *    unused    -> Receives the shadows left without dependents, once each. They are destroyed by releaseShadows(),
+         *                 once the caller no longer references them.
+         */
+        void unlinkDependencies(vector<MathFunction*>& unused);
+        
+        /*
+         * Destroy the shadows which are still without dependents. A shadow only serves the functions calling it.
+         */
+        static void releaseShadows(const vector<MathFunction*>& unused);
+        
+        void addDependent(MathFunction* func);
+        
+        void removeDependent(MathFunction* func);
+        
+        /*
+         * Whether the given function is reachable from this one through the reverse dependencies.
+         */
+        bool isTransitiveDependent(const MathFunction* func);
+        
+        void collectDependents(unsigned int epoch, LinkedStack<MathFunction>& order);
+        
+        /*
+         * Point every call to "from" in the postfix expression to "to" instead.
+         */
+        void retarget(const MathFunction* from, MathFunction* to);
+        
+        /*
+         * Compile at the current tier.
+         */
+        void compile();
+        
+        /*
+         * Count an evaluation at the baseline tier, and queue the function once hot.
+         */
+        void countInvocation(unsigned long long _rows) const;
+        
+        /*
+         * Called by the TierCompiler with the function lock held. Promotes the callees first.
+         */
+        void promote();
+        
+        /*
+         * Back to the initial tier with fresh counters, used when the formula changes.
+         */
+        void resetTier();
+        
+        /*
+         * Recompile all transitive dependents, each one after the callees it inlines. Other functions are left untouched.
+         */
+        void recompileDependents();
+        
+        /*
+         * Replace the interpolant by another one, or by none if nullptr, and recompile along with the dependents.
+         */
+        void setTabulation(MathFunction* table);
     
     protected:
         MathFunction(MathFunctionNamespace& _name_space, MathFunctionIdentifier* _identifier, bool _replace = false);
         
-        virtual double invoke(double* operands) const;
+        /*
+         * A function outside of its namespace, owned by whoever creates it. See bind() and the approximations of built-ins.
+         */
+        MathFunction(MathFunctionNamespace& _name_space, MathFunctionIdentifier* _identifier, const string& _expression);
+        
+        /*
+         * The built-in called in place of this one by functions at PRECISION_FAST. The function itself if it has no approximation.
+         */
+        virtual const MathFunction& approximate() const;
         
-    public:
-        static const int MAX_VARIABLE_COUNT = 257;
+        virtual double invoke(const double* operands) const;
         
+        /*
+         * Batch form of invoke(const double*), see invokeBatch().
+         */
+        virtual void invokeColumns(const double* const* columns, int rows, double* results) const;
+        
+        /*
+         * Test one block of at most Program::BATCH_SIZE rows, see filterBatch().
+         *
+         * Param(s):
+         *    rows      -> Indices of the rows, gathered into "buffer". If nullptr, the rows from "offset" on, read in place.
+         *    buffer    -> Room for the variables and the values of a block.
+         *    kept      -> Receives the indices of the rows kept. May alias "rows".
+         *
+         * Return:
+         *    Number of rows kept.
+         */
+        int filterBlock(const double* const* columns, const int* rows, int offset, int count, double* buffer, int* kept) const;
+        
+    public:
         static const MathFunction& SIN; // Sine
         static const MathFunction& COS; // Cosine
         static const MathFunction& TAN; // Tangent
@@ -187,7 +664,7 @@ class MathFunction
          */
         MathFunction(MathFunctionNamespace& _name_space, const string& _identifier, const string& formula);
         
-        ~MathFunction();
+        virtual ~MathFunction();
         
         /*
          * Invoke the function. e.g. 
@@ -196,9 +673,186 @@ class MathFunction
          */
         virtual double invoke(initializer_list<double> var_list) const;
         
+        /*
+         * Invoke the function on a row held in a vector, e.g. of a function of arrays:
+         *  MathFunction f("f(w[1000], x[1000])", "dot(w, x)");
+         *  f.invoke(values); // w[0] to w[999], then x[0] to x[999]
+         */
+        double invoke(const vector<double>& operands) const;
+        
+        /*
+         * Invoke the function on many rows at once. e.g.
+         *  const double* columns[] = {xs, ys};
+         *  mf.invokeBatch(columns, rows, results);
+         *
+         * Param(s):
+         *    columns    -> One array of "rows" values per variable, in the order of the identifier.
+         *    results    -> Receives "rows" values. May alias one of the columns.
+         */
+        void invokeBatch(const double* const* columns, int rows, double* results) const;
+        
+        /*
+         * Invoke the function on rows laid out in any strided form, read in place. e.g. over an array of structs:
+         *  const double* bases[] = {&records[0].x, &records[0].y};
+         *  ptrdiff_t strides[] = {sizeof(Record), sizeof(Record)};
+         *  mf.invokeStrided(bases, strides, rows, results);
+         *
+         * Param(s):
+         *    bases      -> Address of the first value of each variable.
+         *    strides    -> Distance in bytes between the values of consecutive rows, per variable.
+         */
+        void invokeStrided(const double* const* bases, const ptrdiff_t* strides, int rows, double* results) const;
+        
+        /*
+         * Invoke the function on each row of a row-major matrix, variable i of row r being matrix[r * ld + i].
+         *
+         * Param(s):
+         *    ld    -> Leading dimension, i.e. doubles from one row to the next. At least the variable count.
+         */
+        void invokeMatrix(const double* matrix, int rows, int ld, double* results) const;
+        
+        /*
+         * Invoke the function over a Cartesian grid, e.g. 100 x 50 values of f(x, y) over [0, 1] x [-1, 1]:
+         *  GridAxis axes[] = {{0, 1, 100}, {-1, 1, 50}};
+         *  mf.invokeGrid(axes, results); // results[i * 50 + j] = f(x_i, y_j)
+         *  Subexpressions not depending on the last variable are computed once per outer index, not once per value.
+         *
+         * Param(s):
+         *    axes       -> One axis per variable.
+         *    results    -> Dense row-major array of the product of the counts, the last axis moving fastest.
+         */
+        void invokeGrid(const GridAxis* axes, double* results) const;
+        
+        /*
+         * Use the function as a predicate over many rows, keeping those it holds for, i.e. is neither 0 nor NaN, without
+         *  writing its values. Filters are chained by passing the rows kept by one as the selection of the next, which
+         *  is then evaluated on those rows only. e.g.
+         *  MathFunction inside("inside(x, y)", "x^2 + y^2 < 1");
+         *  MathFunction above("above(x, y)", "y > x");
+         *  int count = inside.filterBatch(columns, rows, nullptr, kept);
+         *  count = above.filterBatch(columns, count, kept, kept); // rows inside and above
+         *
+         * Param(s):
+         *    columns      -> Same as invokeBatch().
+         *    rows         -> Number of rows to test, i.e. of entries of "selection" if given.
+         *    selection    -> Increasing indices of the rows to test. If nullptr, the rows 0 to "rows" - 1.
+         *    kept         -> Receives the indices of the rows kept, in the same order. Room for "rows" indices. May alias "selection".
+         *
+         * Return:
+         *    Number of rows kept.
+         */
+        int filterBatch(const double* const* columns, int rows, const int* selection, int* kept) const;
+        
+        /*
+         * Same as filterBatch(), with the rows given and kept as bitmasks, row r being bit (r % 64) of word r / 64.
+         *
+         * Param(s):
+         *    selection    -> Words of the rows to test, bits beyond "rows" ignored. If nullptr, every row.
+         *    mask         -> Receives (rows + 63) / 64 words, the bits of the rows kept set. May alias "selection".
+         *
+         * Return:
+         *    Number of rows kept.
+         */
+        int filterMask(const double* const* columns, int rows, const uint64_t* selection, uint64_t* mask) const;
+        
+        /*
+         * Replace the formula of this function, keeping its identifier. e.g.
+         *  MathFunction f("f(x)", "x + 1");
+         *  MathFunction g("g(x)", "f(x) * 2");
+         *  f.redefine("x - 1"); // g(x) is now (x - 1) * 2
+         *  Only the functions (transitively) referencing this one are recompiled. The formula may not reference its dependents.
+         *  MUST NOT overlap any evaluation of this function or of its dependents by other threads, e.g. a batch submitted to an
+         *  AsyncEvaluator, since the programs replaced are destroyed right away. Promotion to the optimized tier is the only
+         *  swap made while other threads may be evaluating.
+         */
+        void redefine(const string& formula);
+        
+        /*
+         * Specialize this function for some of its variables, e.g.
+         *  MathFunction f("f(a, b, x)", "sin(a * b) * x + ln(b)");
+         *  MathFunction* g = f.bind({{"a", 1.0}, {"b", 2.0}}); // g(x) = 0.909... * x + 0.693...
+         *  Every subexpression depending on the bound variables only is folded, calls to built-ins and user-defined functions included.
+         *  The result is compiled at the optimized tier right away. It takes the same name and the remaining variables in their order,
+         *  but it is NOT added into the namespace, so it cannot be referenced by formulas. Redefining a callee recompiles it,
+         *  while redefining this function does not. The caller owns the returned function.
+         *
+         * Param(s):
+         *    values    -> Pairs of a variable name and its value. Each variable may be bound once.
+         */
+        MathFunction* bind(initializer_list<pair<string, double>> values) const;
+        
         const MathFunctionIdentifier& getIdentifier() const;
+        
+        /*
+         * Name of a variable as declared, e.g. "y" for index 1 of "f(x, y)". Built-ins have unnamed variables.
+         */
+        string getVariableName(int index) const;
+        
+        /*
+         * Number of functions directly referencing this one.
+         */
+        int getDependentsCount() const;
+        
+        /*
+         * Memory held by this function alone. Callees are not included.
+         */
+        MemoryUsage getMemoryUsage() const;
+        
+        TierStats getTierStats() const;
+        
+        /*
+         * Switch the built-ins called by this function between exact and fast evaluation, e.g.
+         *  MathFunction f("f(x)", "exp(-x^2 / 2) * sin(x)");
+         *  f.setPrecision(PRECISION_FAST);
+         *  The function and the functions (transitively) referencing it are recompiled. Callers inlining this function
+         *  evaluate its calls at its precision, whatever theirs.
+         */
+        void setPrecision(Precision _precision);
+        
+        Precision getPrecision() const;
+        
+        /*
+         * Whether calls are served by an interpolant, see Tabulator.
+         */
+        bool isTabulated() const;
+        
+        /*
+         * Drop the interpolant, if any, going back to evaluating the formula.
+         *  Recompiles the function and its dependents, thus MUST NOT overlap their evaluation, as redefine().
+         */
+        void untabulate();
+        
+        /*
+         * Applies to functions declared or redefined afterwards. MUST NOT be called while other threads are evaluating.
+         */
+        static void setTierPolicy(const TierPolicy& policy);
+        
+        static const TierPolicy& getTierPolicy();
+        
+        /*
+         * Applies to functions compiled afterwards, i.e. declared, redefined or promoted. BACKEND_STACK by default.
+         *  MUST NOT be called while other threads are evaluating.
+         */
+        static void setBackend(Backend backend);
+        
+        static Backend getBackend();
+        
+        /*
+         * Block until every queued promotion is done.
+         */
+        static void waitForTiering();
+        
+        /*
+         * Number of functions promoted so far.
+         */
+        static unsigned long long getPromotionCount();
     
+    friend class EvaluationPlan;
     friend class MathFunctionNamespace;
+    friend class Program;
+    friend class RegisterProgram;
+    friend class Tabulator;
+    friend class TierCompiler;
 };
 
 #endif
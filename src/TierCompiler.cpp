@@ -0,0 +1,108 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include "TierCompiler.hpp"
+#include "TangentsMathFunc.hpp"
+
+using namespace std;
+
+TierCompiler::TierCompiler() : pending(0), started(false) {}
+
+TierCompiler& TierCompiler::getInstance()
+{
+    // Never destroyed, since the detached thread may still be waiting on it while the process exits.
+    static TierCompiler* instance = new TierCompiler();
+    return *instance;
+}
+
+recursive_mutex& TierCompiler::getLock()
+{
+    static recursive_mutex* lock = new recursive_mutex();
+    return *lock;
+}
+
+void TierCompiler::run()
+{
+    while(true)
+    {
+        {
+            unique_lock<mutex> queued(this->queueLock);
+            while(this->queue.empty())
+            {
+                this->wakeup.wait(queued);
+            }
+        }
+        
+        // The function lock is taken before popping, so a function cannot be destroyed between being popped and compiled.
+        lock_guard<recursive_mutex> locked(getLock());
+        MathFunction* func;
+        {
+            lock_guard<mutex> queued(this->queueLock);
+            if(this->queue.empty())
+            {
+                continue;
+            }
+            func = this->queue.front();
+            this->queue.pop_front();
+        }
+        
+        func->promote();
+        
+        {
+            lock_guard<mutex> queued(this->queueLock);
+            this->pending--;
+            if(this->pending == 0)
+            {
+                this->idle.notify_all();
+            }
+        }
+    }
+}
+
+void TierCompiler::request(MathFunction* func)
+{
+    TierCompiler& tc = getInstance();
+    lock_guard<mutex> queued(tc.queueLock);
+    tc.queue.push_back(func);
+    tc.pending++;
+    if(!(tc.started))
+    {
+        tc.started = true;
+        thread(&TierCompiler::run, &tc).detach();
+    }
+    tc.wakeup.notify_one();
+}
+
+void TierCompiler::cancel(MathFunction* func)
+{
+    TierCompiler& tc = getInstance();
+    lock_guard<mutex> queued(tc.queueLock);
+    deque<MathFunction*>::iterator it = find(tc.queue.begin(), tc.queue.end(), func);
+    if(it != tc.queue.end())
+    {
+        tc.queue.erase(it);
+        tc.pending--;
+        if(tc.pending == 0)
+        {
+            tc.idle.notify_all();
+        }
+    }
+}
+
+void TierCompiler::drain()
+{
+    TierCompiler& tc = getInstance();
+    unique_lock<mutex> queued(tc.queueLock);
+    while(tc.pending > 0)
+    {
+        tc.idle.wait(queued);
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#ifndef __TANGENT_MATH_FUNC__TIER_COMPILER
+#define __TANGENT_MATH_FUNC__TIER_COMPILER 65536
+
+class MathFunction;
+
+/*
+ * Background thread promoting hot functions to the optimized tier, one at a time in request order.
+ *  The thread is started upon the first request and lives until the process exits.
+ */
+class TierCompiler
+{
+    private:
+        /*
+         * Guards the queue only, so that requesting a promotion never waits for a compilation.
+         */
+        std::mutex queueLock;
+        
+        std::condition_variable wakeup;
+        
+        std::condition_variable idle;
+        
+        std::deque<MathFunction*> queue;
+        
+        /*
+         * Queued functions plus the one being compiled.
+         */
+        int pending;
+        
+        bool started;
+        
+        TierCompiler();
+        
+        void run();
+        
+        static TierCompiler& getInstance();
+    
+    public:
+        /*
+         * Held by the compiler thread while it compiles and swaps, and by everything that modifies functions,
+         *  i.e. declaring, redefining and destroying them.
+         */
+        static std::recursive_mutex& getLock();
+        
+        /*
+         * Queue a function for promotion. Does not block on compilations in progress.
+         */
+        static void request(MathFunction* func);
+        
+        /*
+         * Remove a queued function. The caller MUST hold getLock().
+         */
+        static void cancel(MathFunction* func);
+        
+        /*
+         * Block until every queued function has been promoted.
+         */
+        static void drain();
+};
+
+#endif
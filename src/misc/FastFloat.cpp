@@ -0,0 +1,144 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "FastFloat.hpp"
+
+/*
+ * Powers of 10 that are exact as doubles.
+ */
+static const double POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool FastFloat::parseSlow(const char* begin, const char* end, double& value)
+{
+    if(end - begin > MAX_SLOW_PATH_LENGTH)
+    {
+        return false;
+    }
+    char buffer[MAX_SLOW_PATH_LENGTH + 1];
+    memcpy(buffer, begin, end - begin);
+    buffer[end - begin] = '\0';
+    char* stop = nullptr;
+    double result = strtod(buffer, &stop);
+    if(stop != buffer + (end - begin))
+    {
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+bool FastFloat::parse(const char* begin, const char* end, double& value)
+{
+    while(begin < end && *begin == ' ')
+    {
+        begin++;
+    }
+    while(end > begin && end[-1] == ' ')
+    {
+        end--;
+    }
+    if(begin == end)
+    {
+        return false;
+    }
+    
+    const char* cursor = begin;
+    bool negative = false;
+    if(*cursor == '-' || *cursor == '+')
+    {
+        negative = (*cursor == '-');
+        cursor++;
+    }
+    
+    // Significant digits are accumulated as an integer, the decimal point only shifts the exponent.
+    unsigned long long mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    while(cursor < end && *cursor >= '0' && *cursor <= '9')
+    {
+        if(mantissa != 0 || *cursor != '0')
+        {
+            if(digits >= 19)
+            {
+                return parseSlow(begin, end, value);
+            }
+            mantissa = mantissa * 10 + (*cursor - '0');
+            digits++;
+        }
+        any = true;
+        cursor++;
+    }
+    if(cursor < end && *cursor == '.')
+    {
+        cursor++;
+        while(cursor < end && *cursor >= '0' && *cursor <= '9')
+        {
+            if(mantissa != 0 || *cursor != '0')
+            {
+                if(digits >= 19)
+                {
+                    return parseSlow(begin, end, value);
+                }
+                mantissa = mantissa * 10 + (*cursor - '0');
+                digits++;
+            }
+            exponent--;
+            any = true;
+            cursor++;
+        }
+    }
+    if(!any)
+    {
+        return parseSlow(begin, end, value);
+    }
+    if(cursor < end && (*cursor == 'e' || *cursor == 'E'))
+    {
+        cursor++;
+        bool negativeExponent = false;
+        if(cursor < end && (*cursor == '-' || *cursor == '+'))
+        {
+            negativeExponent = (*cursor == '-');
+            cursor++;
+        }
+        if(cursor == end)
+        {
+            return false;
+        }
+        int explicitExponent = 0;
+        while(cursor < end && *cursor >= '0' && *cursor <= '9')
+        {
+            if(explicitExponent < 100000)
+            {
+                explicitExponent = explicitExponent * 10 + (*cursor - '0');
+            }
+            cursor++;
+        }
+        exponent += (negativeExponent ? -explicitExponent : explicitExponent);
+    }
+    if(cursor != end)
+    {
+        return false;
+    }
+    
+    // Clinger's fast path: both the mantissa and the power of 10 are exact, so one rounding gives the correct result.
+    if(mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+    {
+        double result = (double)mantissa;
+        result = (exponent < 0 ? result / POWERS_OF_TEN[-exponent] : result * POWERS_OF_TEN[exponent]);
+        value = (negative ? -result : result);
+        return true;
+    }
+    return parseSlow(begin, end, value);
+}
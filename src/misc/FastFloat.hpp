@@ -0,0 +1,43 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stddef.h>
+
+#ifndef __TANGENT_MATH_FUNC__FAST_FLOAT
+#define __TANGENT_MATH_FUNC__FAST_FLOAT 65536
+
+/*
+ * Decimal text to double without allocating.
+ */
+class FastFloat
+{
+    private:
+        FastFloat();
+        
+        /*
+         * Fields longer than this are not numbers anyone writes, thus rejected by the slow path.
+         */
+        static const int MAX_SLOW_PATH_LENGTH = 127;
+        
+        /*
+         * strtod() on a copy terminated on the stack. Handles whatever the fast path cannot, e.g. "1e-320", "inf" or "nan".
+         */
+        static bool parseSlow(const char* begin, const char* end, double& value);
+    
+    public:
+        /*
+         * Parse [begin, end) as a whole. Leading and trailing spaces are ignored.
+         *  Numbers whose digits fit into 53 bits with a decimal exponent within +-22 take a fast path, as exact as strtod().
+         *
+         * Return:
+         *    False if the text is empty or is not a number. Value is left untouched then.
+         */
+        static bool parse(const char* begin, const char* end, double& value);
+};
+
+#endif
@@ -0,0 +1,342 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "FastMath.hpp"
+
+/*
+ * The kernels are forced inline since a loop calling a function cannot be vectorized.
+ */
+#if defined(__GNUC__)
+#define KERNEL_INLINE inline __attribute__((always_inline))
+#else
+#define KERNEL_INLINE inline
+#endif
+
+const double FastMath::REDUCTION_LIMIT = 1e5;
+
+/*
+ * Rows checked against the fast domain at once by the batch forms.
+ */
+static const int BATCH_BLOCK = 256;
+
+/*
+ * 1.5 * 2^52. Adding it rounds a double of magnitude below 2^51 to an integer, which ends up in the low bits of the sum.
+ */
+static const double SHIFTER = 6755399441055744.0;
+static const int64_t SHIFTER_BITS = 0x4338000000000000;
+
+static const int64_t SIGN_BIT = (int64_t)0x8000000000000000ULL;
+
+/*
+ * pi / 2 split in three parts, the first two having 33 significant bits, so that k times them is exact for |k| < 2^20.
+ */
+static const double TWO_OVER_PI = 6.36619772367581382433e-01;
+static const double PIO2_1 = 1.57079632673412561417e+00;
+static const double PIO2_2 = 6.07710050630396597660e-11;
+static const double PIO2_3 = 2.02226624879595063154e-21;
+
+/*
+ * Minimax polynomials of sin(r) / r - 1 and cos(r) - 1 + r^2 / 2 in r^2 for |r| <= pi / 4, from fdlibm.
+ */
+static const double S1 = -1.66666666666666324348e-01;
+static const double S2 = 8.33333333332248946124e-03;
+static const double S3 = -1.98412698298579493134e-04;
+static const double S4 = 2.75573137070700676789e-06;
+static const double S5 = -2.50507602534068634195e-08;
+static const double S6 = 1.58969099521155010221e-10;
+
+static const double C1 = 4.16666666666666019037e-02;
+static const double C2 = -1.38888888888741095749e-03;
+static const double C3 = 2.48015872894767294178e-05;
+static const double C4 = -2.75573143513906633035e-07;
+static const double C5 = 2.08757232129817482790e-09;
+static const double C6 = -1.13596475577881948265e-11;
+
+/*
+ * ln(2) split in two parts, the first one having 32 significant bits, so that k times it is exact for |k| < 2^21.
+ */
+static const double INV_LN2 = 1.44269504088896338700e+00;
+static const double LN2_HI = 6.93147180369123816490e-01;
+static const double LN2_LO = 1.90821492927058770002e-10;
+
+/*
+ * Bounds of exp() whose results are normal numbers, leaving some margin.
+ */
+static const double EXP_MIN = -708.0;
+static const double EXP_MAX = 709.0;
+
+/*
+ * Minimax polynomial R in s^2 such that log(1 + f) = f - f^2 / 2 + s * (f^2 / 2 + R), s = f / (2 + f), from fdlibm.
+ */
+static const double LG1 = 6.666666666666735130e-01;
+static const double LG2 = 3.999999999940941908e-01;
+static const double LG3 = 2.857142874366239149e-01;
+static const double LG4 = 2.222219843214978396e-01;
+static const double LG5 = 1.818357216161805012e-01;
+static const double LG6 = 1.531383769920937332e-01;
+static const double LG7 = 1.479819860511658591e-01;
+
+/*
+ * Bits of sqrt(1/2). Mantissas are reduced into [sqrt(1/2), sqrt(2)).
+ */
+static const int64_t SQRT_HALF_BITS = 0x3fe6a09e667f3bcd;
+static const int64_t MANTISSA_MASK = 0x000fffffffffffff;
+
+static KERNEL_INLINE int64_t toBits(double x)
+{
+    int64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+static KERNEL_INLINE double fromBits(int64_t bits)
+{
+    double x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/*
+ * a if "bit" is 1, else b, by masking bits. Unlike ?: on doubles, compilers never turn it into a branch.
+ */
+static KERNEL_INLINE double select(int64_t bit, double a, double b)
+{
+    int64_t mask = -bit;
+    return fromBits((toBits(a) & mask) | (toBits(b) & ~mask));
+}
+
+/*
+ * x - k * pi / 2 for the nearest integer k, whose low bits are stored into "quadrant".
+ */
+static KERNEL_INLINE double reduceHalfPi(double x, int64_t& quadrant)
+{
+    double shifted = x * TWO_OVER_PI + SHIFTER;
+    quadrant = toBits(shifted);
+    double k = shifted - SHIFTER;
+    return ((x - k * PIO2_1) - k * PIO2_2) - k * PIO2_3;
+}
+
+static KERNEL_INLINE double sinPolynomial(double r, double z)
+{
+    double value = r + r * z * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+    // Same sign as r, which only matters for -0.
+    return fromBits(toBits(value) | (toBits(r) & SIGN_BIT));
+}
+
+static KERNEL_INLINE double cosPolynomial(double z)
+{
+    double half = 0.5 * z;
+    double w = 1.0 - half;
+    // The rounding error of 1 - z / 2 is added back.
+    return w + (((1.0 - w) - half) + z * z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6))))));
+}
+
+static KERNEL_INLINE double sinKernel(double x)
+{
+    int64_t quadrant;
+    double r = reduceHalfPi(x, quadrant);
+    double z = r * r;
+    double value = select(quadrant & 1, cosPolynomial(z), sinPolynomial(r, z));
+    return fromBits(toBits(value) ^ ((quadrant & 2) << 62));
+}
+
+static KERNEL_INLINE double cosKernel(double x)
+{
+    int64_t quadrant;
+    double r = reduceHalfPi(x, quadrant);
+    double z = r * r;
+    // cos(x) = sin(x + pi / 2)
+    quadrant++;
+    double value = select(quadrant & 1, cosPolynomial(z), sinPolynomial(r, z));
+    return fromBits(toBits(value) ^ ((quadrant & 2) << 62));
+}
+
+static KERNEL_INLINE double tanKernel(double x)
+{
+    int64_t quadrant;
+    double r = reduceHalfPi(x, quadrant);
+    double z = r * r;
+    double s = sinPolynomial(r, z);
+    double c = cosPolynomial(z);
+    return select(quadrant & 1, -c / s, s / c);
+}
+
+static KERNEL_INLINE double expKernel(double x)
+{
+    double shifted = x * INV_LN2 + SHIFTER;
+    int64_t k = toBits(shifted) - SHIFTER_BITS;
+    double kd = shifted - SHIFTER;
+    double r = (x - kd * LN2_HI) - kd * LN2_LO;
+    
+    // Taylor series up to r^13, |r| <= ln(2) / 2, by Estrin's scheme which shortens the chain of dependent operations.
+    double r2 = r * r;
+    double r4 = r2 * r2;
+    double r8 = r4 * r4;
+    double p = ((1.0 / 2 + r * (1.0 / 6)) + r2 * (1.0 / 24 + r * (1.0 / 120)))
+        + r4 * ((1.0 / 720 + r * (1.0 / 5040)) + r2 * (1.0 / 40320 + r * (1.0 / 362880)))
+        + r8 * ((1.0 / 3628800 + r * (1.0 / 39916800)) + r2 * (1.0 / 479001600 + r * (1.0 / 6227020800.0)));
+    return (1.0 + (r + r2 * p)) * fromBits((k + 1023) << 52);
+}
+
+static KERNEL_INLINE double logKernel(double x)
+{
+    int64_t offset = toBits(x) - SQRT_HALF_BITS;
+    int64_t k = offset >> 52;
+    double m = fromBits((offset & MANTISSA_MASK) + SQRT_HALF_BITS);
+    double kd = fromBits(SHIFTER_BITS + k) - SHIFTER;
+    
+    double f = m - 1.0;
+    double s = f / (2.0 + f);
+    double z = s * s;
+    double w = z * z;
+    double r = w * (LG2 + w * (LG4 + w * LG6)) + z * (LG1 + w * (LG3 + w * (LG5 + w * LG7)));
+    double half = 0.5 * f * f;
+    return kd * LN2_HI - ((half - (s * (half + r) + kd * LN2_LO)) - f);
+}
+
+static KERNEL_INLINE bool isReducible(double x)
+{
+    return (fabs(x) <= FastMath::REDUCTION_LIMIT);
+}
+
+static KERNEL_INLINE bool isExpNormal(double x)
+{
+    return (x >= EXP_MIN && x <= EXP_MAX);
+}
+
+static KERNEL_INLINE bool isLogNormal(double x)
+{
+    return (x >= 2.2250738585072014e-308 && x <= 1.7976931348623157e+308);
+}
+
+static double exactSin(double x)
+{
+    return ::sin(x);
+}
+
+static double exactCos(double x)
+{
+    return ::cos(x);
+}
+
+static double exactTan(double x)
+{
+    return ::tan(x);
+}
+
+static double exactExp(double x)
+{
+    return ::exp(x);
+}
+
+static double exactLog(double x)
+{
+    return ::log(x);
+}
+
+double FastMath::sin(double x)
+{
+    return (isReducible(x) ? sinKernel(x) : exactSin(x));
+}
+
+double FastMath::cos(double x)
+{
+    return (isReducible(x) ? cosKernel(x) : exactCos(x));
+}
+
+double FastMath::tan(double x)
+{
+    return (isReducible(x) ? tanKernel(x) : exactTan(x));
+}
+
+double FastMath::exp(double x)
+{
+    return (isExpNormal(x) ? expKernel(x) : exactExp(x));
+}
+
+double FastMath::log(double x)
+{
+    return (isLogNormal(x) ? logKernel(x) : exactLog(x));
+}
+
+/*
+ * The batch forms only pay off once vectorized, which GCC does not do at -O2 alone. Only their loops are built with
+ *  vectorization, the kernels being inlined into them, so that the rest of the file keeps the flags of the build.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC push_options
+#pragma GCC optimize("tree-vectorize", "vect-cost-model=dynamic")
+#endif
+
+/*
+ * Blocks entirely within the fast domain run the kernel alone, in a loop free of calls and branches.
+ *  The others fall back to the standard library row by row.
+ */
+template <double (*KERNEL)(double), bool (*IS_FAST)(double), double (*EXACT)(double)>
+static void evaluateBatch(const double* x, int n, double* y)
+{
+    for(int base = 0 ; base < n ; base += BATCH_BLOCK)
+    {
+        int count = (n - base < BATCH_BLOCK ? n - base : BATCH_BLOCK);
+        const double* in = x + base;
+        double* out = y + base;
+        
+        bool fast = true;
+        for(int i = 0 ; i < count ; i++)
+        {
+            fast &= IS_FAST(in[i]);
+        }
+        if(fast)
+        {
+            for(int i = 0 ; i < count ; i++)
+            {
+                out[i] = KERNEL(in[i]);
+            }
+        }
+        else
+        {
+            for(int i = 0 ; i < count ; i++)
+            {
+                out[i] = (IS_FAST(in[i]) ? KERNEL(in[i]) : EXACT(in[i]));
+            }
+        }
+    }
+}
+
+void FastMath::sinBatch(const double* x, int n, double* y)
+{
+    evaluateBatch<sinKernel, isReducible, exactSin>(x, n, y);
+}
+
+void FastMath::cosBatch(const double* x, int n, double* y)
+{
+    evaluateBatch<cosKernel, isReducible, exactCos>(x, n, y);
+}
+
+void FastMath::tanBatch(const double* x, int n, double* y)
+{
+    evaluateBatch<tanKernel, isReducible, exactTan>(x, n, y);
+}
+
+void FastMath::expBatch(const double* x, int n, double* y)
+{
+    evaluateBatch<expKernel, isExpNormal, exactExp>(x, n, y);
+}
+
+void FastMath::logBatch(const double* x, int n, double* y)
+{
+    evaluateBatch<logKernel, isLogNormal, exactLog>(x, n, y);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC pop_options
+#endif
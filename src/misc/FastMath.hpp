@@ -0,0 +1,58 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#ifndef __TANGENT_MATH_FUNC__FAST_MATH
+#define __TANGENT_MATH_FUNC__FAST_MATH 65536
+
+/*
+ * Approximations of elementary functions, trading the last bits of accuracy for speed.
+ *  Within its fast domain, each function is a branch-free range reduction followed by a polynomial, which the batch forms
+ *  evaluate in loops the compiler vectorizes. Outside of it, e.g. for huge, subnormal or non-finite arguments,
+ *  the standard library is called instead, so the error bounds hold for every argument.
+ *
+ * Bounds are in units in the last place (ULP) of the exact result. They are those measured by bench_approx, rounded up.
+ *
+ *    Function    Fast domain                Max error
+ *    sin, cos    |x| <= 1e5                 SIN_COS_MAX_ULP
+ *    tan         |x| <= 1e5                 TAN_MAX_ULP
+ *    exp         -708 <= x <= 709           EXP_MAX_ULP
+ *    log         normal positive numbers    LOG_MAX_ULP
+ */
+class FastMath
+{
+    private:
+        FastMath();
+    
+    public:
+        static const int SIN_COS_MAX_ULP = 3;
+        static const int TAN_MAX_ULP = 4;
+        static const int EXP_MAX_ULP = 1;
+        static const int LOG_MAX_ULP = 1;
+        
+        /*
+         * Bound of the arguments reduced by sin(), cos() and tan() themselves.
+         */
+        static const double REDUCTION_LIMIT;
+        
+        static double sin(double x);
+        static double cos(double x);
+        static double tan(double x);
+        static double exp(double x);
+        static double log(double x);
+        
+        /*
+         * Batch forms, y[i] = f(x[i]) for i < n. "y" may alias "x".
+         */
+        static void sinBatch(const double* x, int n, double* y);
+        static void cosBatch(const double* x, int n, double* y);
+        static void tanBatch(const double* x, int n, double* y);
+        static void expBatch(const double* x, int n, double* y);
+        static void logBatch(const double* x, int n, double* y);
+};
+
+#endif
@@ -12,6 +12,8 @@
 
 const char* DividedByZeroException::CANNED_MESSAGE = "Divided by 0!";
 
+const char* CancelledException::CANNED_MESSAGE = "Cancelled!";
+
 const char* InvalidArgumentException::CANNED_MESSAGE = "Invalid argument!";
 
 const char* InvalidFormulaException::CANNED_MESSAGE = "Invalid formulation!";
@@ -21,6 +23,11 @@ const char* DividedByZeroException::what() const noexcept
     return CANNED_MESSAGE;
 }
 
+const char* CancelledException::what() const noexcept
+{
+    return CANNED_MESSAGE;
+}
+
 InvalidArgumentException::InvalidArgumentException(const char* _msg)
 {
     static int len1 = strlen(CANNED_MESSAGE);
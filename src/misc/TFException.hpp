@@ -25,6 +25,18 @@ class DividedByZeroException : public exception
         const char* what() const noexcept;
 };
 
+/*
+ * Thrown by the futures of cancelled asynchronous batches, see AsyncEvaluator.
+ */
+class CancelledException : public exception
+{
+    private:
+        static const char* CANNED_MESSAGE;
+    
+    public:
+        const char* what() const noexcept;
+};
+
 /*
  * Thrown when invalid arguments are passed into the function MathFunction<T>::invoke();
  */
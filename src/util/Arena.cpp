@@ -0,0 +1,127 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdlib.h>
+#include <new>
+
+#include "Arena.hpp"
+
+Arena::AllocateHook Arena::ALLOCATE_HOOK = nullptr;
+Arena::ReleaseHook Arena::RELEASE_HOOK = nullptr;
+void* Arena::HOOK_CONTEXT = nullptr;
+
+std::atomic<size_t> Arena::TOTAL_RESERVED(0);
+
+Arena::Arena(size_t _capacity)
+{
+    this->allocateHook = ALLOCATE_HOOK;
+    this->releaseHook = RELEASE_HOOK;
+    this->hookContext = HOOK_CONTEXT;
+    this->head = nullptr;
+    this->used = 0;
+    this->nextCapacity = (_capacity < ALIGNMENT ? ALIGNMENT : _capacity);
+    this->reserved = 0;
+    this->allocated = 0;
+    this->chunkCount = 0;
+}
+
+Arena::~Arena()
+{
+    size_t header = (sizeof(Chunk) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    Chunk* cache = nullptr;
+    while((cache = this->head) != nullptr)
+    {
+        this->head = cache->next;
+        if(this->releaseHook == nullptr)
+        {
+            free(cache);
+        }
+        else
+        {
+            this->releaseHook(cache, header + cache->capacity, this->hookContext);
+        }
+    }
+    TOTAL_RESERVED -= this->reserved;
+}
+
+void Arena::grow(size_t minimum)
+{
+    size_t capacity = this->nextCapacity;
+    while(capacity < minimum)
+    {
+        capacity *= 2;
+    }
+    
+    // The header is padded so the usable memory stays aligned.
+    size_t header = (sizeof(Chunk) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    Chunk* chunk = (Chunk*)(this->allocateHook == nullptr ? malloc(header + capacity) : this->allocateHook(header + capacity, this->hookContext));
+    if(chunk == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    chunk->next = this->head;
+    chunk->capacity = capacity;
+    
+    this->head = chunk;
+    this->used = 0;
+    this->nextCapacity = capacity * 2;
+    this->reserved += header + capacity;
+    this->chunkCount++;
+    TOTAL_RESERVED += header + capacity;
+}
+
+void* Arena::allocate(size_t size)
+{
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if(this->head == nullptr || this->used + size > this->head->capacity)
+    {
+        this->grow(size);
+    }
+    
+    size_t header = (sizeof(Chunk) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    void* ret = ((char*)(this->head)) + header + this->used;
+    this->used += size;
+    this->allocated += size;
+    return ret;
+}
+
+size_t Arena::getReservedBytes() const
+{
+    return this->reserved;
+}
+
+size_t Arena::getAllocatedBytes() const
+{
+    return this->allocated;
+}
+
+int Arena::getChunksCount() const
+{
+    return this->chunkCount;
+}
+
+void Arena::setAllocationHook(AllocateHook allocate, ReleaseHook release, void* context)
+{
+    ALLOCATE_HOOK = (release == nullptr ? nullptr : allocate);
+    RELEASE_HOOK = (allocate == nullptr ? nullptr : release);
+    HOOK_CONTEXT = context;
+}
+
+size_t Arena::getTotalReservedBytes()
+{
+    return TOTAL_RESERVED;
+}
+
+void* operator new(size_t size, Arena& arena)
+{
+    return arena.allocate(size);
+}
+
+void operator delete(void*, Arena&)
+{
+}
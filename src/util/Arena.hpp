@@ -0,0 +1,136 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stddef.h>
+#include <atomic>
+
+#ifndef __TANGENT_MATH_FUNC__ARENA
+#define __TANGENT_MATH_FUNC__ARENA 65536
+
+/*
+ * Bump allocator owning everything a MathFunction builds. Objects placed in an arena are never destroyed one by one,
+ *  thus they MUST NOT own other resources. Deleting the arena releases all of them at once.
+ */
+class Arena
+{
+    public:
+        typedef void* (*AllocateHook)(size_t size, void* context);
+        typedef void (*ReleaseHook)(void* ptr, size_t size, void* context);
+    
+    private:
+        /*
+         * Header of a chunk. The usable memory follows right behind it.
+         */
+        struct Chunk
+        {
+            Chunk* next;
+            size_t capacity;
+        };
+        
+        /*
+         * Most recent chunk, allocations are served from it.
+         */
+        Chunk* head;
+        
+        /*
+         * Bytes used in the head chunk.
+         */
+        size_t used;
+        
+        /*
+         * Capacity of the next chunk. Doubles every time a chunk is added.
+         */
+        size_t nextCapacity;
+        
+        /*
+         * Total bytes reserved from the system, including the chunk headers.
+         */
+        size_t reserved;
+        
+        /*
+         * Total bytes handed out.
+         */
+        size_t allocated;
+        
+        int chunkCount;
+        
+        /*
+         * Hook in effect when this arena was created. Chunks are always released through the same one.
+         */
+        AllocateHook allocateHook;
+        ReleaseHook releaseHook;
+        void* hookContext;
+        
+        static AllocateHook ALLOCATE_HOOK;
+        static ReleaseHook RELEASE_HOOK;
+        static void* HOOK_CONTEXT;
+        
+        /*
+         * Bytes reserved by all arenas alive.
+         */
+        static std::atomic<size_t> TOTAL_RESERVED;
+        
+        // Disabled
+        Arena(const Arena&);
+        void operator=(const Arena&);
+        
+        void grow(size_t minimum);
+    
+    public:
+        static const size_t DEFAULT_CAPACITY = 1024;
+        
+        static const size_t ALIGNMENT = 8;
+        
+        /*
+         * Param(s):
+         *    _capacity    -> Capacity of the first chunk. Chunks are only allocated on demand.
+         */
+        Arena(size_t _capacity = DEFAULT_CAPACITY);
+        ~Arena();
+        
+        /*
+         * Get a block of memory aligned to ALIGNMENT, valid until the arena is deleted.
+         */
+        void* allocate(size_t size);
+        
+        size_t getReservedBytes() const;
+        
+        size_t getAllocatedBytes() const;
+        
+        int getChunksCount() const;
+        
+        /*
+         * Route the chunk allocations of every arena created from now on through the given functions,
+         *  e.g. to account or cap the memory of a tenant. Passing nullptr restores malloc() and free().
+         *  Arenas created before keep releasing their chunks through the hook they were created with.
+         *
+         *  The hook ONLY sees arena chunks, i.e. the postfix expressions of functions with their operands, and the code
+         *  and constants of Program and RegisterProgram. Everything else uses the global operator new and is not seen:
+         *  MathFunction objects, identifiers and their strings, the Arena objects themselves, dependency lists,
+         *  namespace tables and perfect hashes, scratch buffers of compilation and evaluation, and the buffers of
+         *  AsyncEvaluator, CsvEvaluator, Integrator and the like.
+         */
+        static void setAllocationHook(AllocateHook allocate, ReleaseHook release, void* context);
+        
+        /*
+         * Bytes currently reserved by all arenas of the library.
+         */
+        static size_t getTotalReservedBytes();
+};
+
+/*
+ * e.g. new(arena) NumericOperand(1.0);
+ */
+void* operator new(size_t size, Arena& arena);
+
+/*
+ * Only called if a constructor throws. The memory is reclaimed with the arena.
+ */
+void operator delete(void* ptr, Arena& arena);
+
+#endif
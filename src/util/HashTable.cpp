@@ -67,6 +67,7 @@ HashTable<K, T>::~HashTable()
             cache = this->entries[i];
         }
     }
+    delete[] this->entries;
 }
 
 template<typename K, typename T>
@@ -82,7 +83,7 @@ int HashTable<K, T>::getCapacity() const
 }
 
 template<typename K, typename T>
-void HashTable<K, T>::put(K* _key, T* _value, bool& replacing)
+void HashTable<K, T>::put(K* _key, T* _value, bool& replacing, bool owning)
 {
     replacing = false;
     int hash = _key->hash(this->capacity);
@@ -102,7 +103,7 @@ void HashTable<K, T>::put(K* _key, T* _value, bool& replacing)
     {
         if(*(cache->getValue()->getKey()) == *(_key))
         {
-            cache->setValue(new HashEntry<K, T>(_key, _value, false), false);
+            cache->setValue(new HashEntry<K, T>(_key, _value, owning), true);
             replacing = true;
             return;
         }
@@ -110,7 +111,7 @@ void HashTable<K, T>::put(K* _key, T* _value, bool& replacing)
     }
     
     this->size++;
-    this->entries[hash] = new Node<HashEntry<K, T>>(new HashEntry<K, T>(_key, _value, false), this->entries[hash], false);
+    this->entries[hash] = new Node<HashEntry<K, T>>(new HashEntry<K, T>(_key, _value, owning), this->entries[hash], true);
 }
 
 template<typename K, typename T>
@@ -190,4 +191,22 @@ T* HashTable<K, T>::remove(const K* _key)
     return nullptr;
 }
 
+template<typename K, typename T>
+void HashTable<K, T>::forEach(void (*visitor)(K* key, T* value, void* context), void* context) const
+{
+    for(int i = 0 ; i < this->capacity ; i++)
+    {
+        for(Node<HashEntry<K, T>>* cache = this->entries[i] ; cache != nullptr ; cache = cache->getNext())
+        {
+            visitor(cache->getValue()->getKey(), cache->getValue()->getValue(), context);
+        }
+    }
+}
+
+template<typename K, typename T>
+size_t HashTable<K, T>::getMemoryBytes() const
+{
+    return sizeof(HashTable<K, T>) + this->capacity * sizeof(Node<HashEntry<K, T>>*) + this->size * (sizeof(Node<HashEntry<K, T>>) + sizeof(HashEntry<K, T>));
+}
+
 #include "HashTable.inl"
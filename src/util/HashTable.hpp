@@ -6,6 +6,8 @@
  *  https://github.com/tan2pow16/TangentsMathFunc
  */
 
+#include <stddef.h>
+
 #include "LinkedNode.hpp"
 
 #ifndef __TANGENT_MATH_FUNC__HASH_TABLE
@@ -52,10 +54,24 @@ class HashTable
         int getSize() const;
         int getCapacity() const;
         
-        void put(K* _key, T* _value, bool& replacing);
+        /*
+         * Param(s):
+         *    owning    -> Whether the key and the value should be deleted along with the entry.
+         */
+        void put(K* _key, T* _value, bool& replacing, bool owning = false);
         T* get(const K* _key);
         
         T* remove(const K* _key);
+        
+        /*
+         * Call the visitor once for every entry, in no particular order. The table MUST NOT be modified meanwhile.
+         */
+        void forEach(void (*visitor)(K* key, T* value, void* context), void* context) const;
+        
+        /*
+         * Bytes held by the bucket array, the chain nodes and the entries. Keys and values are not included.
+         */
+        size_t getMemoryBytes() const;
 };
 
 #endif
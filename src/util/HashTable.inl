@@ -7,12 +7,16 @@ template HashEntry<MathFunctionIdentifier const, MathFunction>::~HashEntry();
 template HashTable<MathFunctionIdentifier const, MathFunction>::HashTable(int);
 template MathFunction* HashTable<MathFunctionIdentifier const, MathFunction>::remove(MathFunctionIdentifier const*);
 template MathFunction* HashTable<MathFunctionIdentifier const, MathFunction>::get(MathFunctionIdentifier const*);
-template void HashTable<MathFunctionIdentifier const, MathFunction>::put(MathFunctionIdentifier const*, MathFunction*, bool&);
+template void HashTable<MathFunctionIdentifier const, MathFunction>::put(MathFunctionIdentifier const*, MathFunction*, bool&, bool);
 template HashTable<MathFunctionIdentifier const, MathFunction>::~HashTable();
+template int HashTable<MathFunctionIdentifier const, MathFunction>::getSize() const;
+template int HashTable<MathFunctionIdentifier const, MathFunction>::getCapacity() const;
+template void HashTable<MathFunctionIdentifier const, MathFunction>::forEach(void (*)(MathFunctionIdentifier const*, MathFunction*, void*), void*) const;
+template size_t HashTable<MathFunctionIdentifier const, MathFunction>::getMemoryBytes() const;
 
-template HashEntry<String, int>::~HashEntry();
+template HashEntry<String, MathFunctionParameter>::~HashEntry();
 
-template HashTable<String, int>::HashTable(int);
-template int* HashTable<String, int>::get(String const*);
-template void HashTable<String, int>::put(String*, int*, bool&);
-template HashTable<String, int>::~HashTable();
+template HashTable<String, MathFunctionParameter>::HashTable(int);
+template MathFunctionParameter* HashTable<String, MathFunctionParameter>::get(String const*);
+template void HashTable<String, MathFunctionParameter>::put(String*, MathFunctionParameter*, bool&, bool);
+template HashTable<String, MathFunctionParameter>::~HashTable();
@@ -25,8 +25,15 @@ template Node<HashEntry<MathFunctionIdentifier const, MathFunction>>* Node<HashE
 template void Node<HashEntry<MathFunctionIdentifier const, MathFunction>>::setNext(Node<HashEntry<MathFunctionIdentifier const, MathFunction>>*);
 template Node<HashEntry<MathFunctionIdentifier const, MathFunction>>::~Node();
 
-template Node<HashEntry<String, int>>::Node(HashEntry<String, int>*, Node<HashEntry<String, int> >*, bool);
-template Node<HashEntry<String, int>>* Node<HashEntry<String, int>>::getNext() const;
-template HashEntry<String, int>* Node<HashEntry<String, int>>::getValue() const;
-template void Node<HashEntry<String, int>>::setValue(HashEntry<String, int>*, bool);
-template Node<HashEntry<String, int>>::~Node();
+template Node<HashEntry<String, MathFunctionParameter>>::Node(HashEntry<String, MathFunctionParameter>*, Node<HashEntry<String, MathFunctionParameter> >*, bool);
+template Node<HashEntry<String, MathFunctionParameter>>* Node<HashEntry<String, MathFunctionParameter>>::getNext() const;
+template HashEntry<String, MathFunctionParameter>* Node<HashEntry<String, MathFunctionParameter>>::getValue() const;
+template void Node<HashEntry<String, MathFunctionParameter>>::setValue(HashEntry<String, MathFunctionParameter>*, bool);
+template Node<HashEntry<String, MathFunctionParameter>>::~Node();
+
+template Node<MathFunction>::Node(MathFunction*, Node<MathFunction>*, bool);
+template MathFunction* Node<MathFunction>::getValue() const;
+template void Node<MathFunction>::setValue(MathFunction*, bool);
+template Node<MathFunction>* Node<MathFunction>::getNext() const;
+template void Node<MathFunction>::setNext(Node<MathFunction>*);
+template Node<MathFunction>::~Node();
@@ -1,4 +1,5 @@
 #include "../Operators.hpp"
+#include "../TangentsMathFunc.hpp"
 
 template NumericOperand const* LinkedStack<NumericOperand const>::peek() const;
 template NumericOperand const* LinkedStack<NumericOperand const>::pop();
@@ -11,3 +12,8 @@ template Operator const* LinkedStack<Operator const>::pop();
 template Operator const* LinkedStack<Operator const>::peek() const;
 template bool LinkedStack<Operator const>::isEmpty() const;
 template LinkedStack<Operator const>::~LinkedStack();
+
+template void LinkedStack<MathFunction>::push(MathFunction*);
+template MathFunction* LinkedStack<MathFunction>::pop();
+template bool LinkedStack<MathFunction>::isEmpty() const;
+template LinkedStack<MathFunction>::~LinkedStack();
\ No newline at end of file
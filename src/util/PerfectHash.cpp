@@ -0,0 +1,130 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "../misc/TFException.hpp"
+#include "PerfectHash.hpp"
+
+using namespace std;
+
+/*
+ * Seeds tried for a bucket before the slots are doubled. Never reached in practice.
+ */
+static const uint32_t MAX_SEED = 1 << 16;
+
+PerfectHash::PerfectHash(const char* const* keys, const size_t* lengths, const uint32_t* salts, int count)
+{
+    this->bucketCount = count / 2 + 1;
+    this->slotCount = count + count / 4 + 1;
+    
+    vector<vector<int>> buckets(this->bucketCount);
+    for(int i = 0 ; i < count ; i++)
+    {
+        buckets[hash(keys[i], lengths[i], salts[i], 0) % this->bucketCount].push_back(i);
+    }
+    
+    // Equal keys share a bucket, and would collide whatever the seed.
+    for(const vector<int>& bucket : buckets)
+    {
+        for(size_t a = 0 ; a < bucket.size() ; a++)
+        {
+            for(size_t b = a + 1 ; b < bucket.size() ; b++)
+            {
+                int i = bucket[a];
+                int j = bucket[b];
+                if(salts[i] == salts[j] && lengths[i] == lengths[j] && memcmp(keys[i], keys[j], lengths[i]) == 0)
+                {
+                    throw InvalidArgumentException("The keys of a perfect hash must be distinct.");
+                }
+            }
+        }
+    }
+    
+    vector<int> order(this->bucketCount);
+    for(int b = 0 ; b < this->bucketCount ; b++)
+    {
+        order[b] = b;
+    }
+    stable_sort(order.begin(), order.end(), [&buckets](int a, int b) { return buckets[a].size() > buckets[b].size(); });
+    
+    this->seeds = new uint32_t[this->bucketCount];
+    while(true)
+    {
+        vector<bool> taken(this->slotCount, false);
+        bool placed = true;
+        for(int b : order)
+        {
+            const vector<int>& bucket = buckets[b];
+            int size = (int)(bucket.size());
+            uint32_t seed = 1;
+            if(size == 0)
+            {
+                this->seeds[b] = 0;
+                continue;
+            }
+            for( ; seed <= MAX_SEED ; seed++)
+            {
+                int k = 0;
+                for( ; k < size ; k++)
+                {
+                    int slot = hash(keys[bucket[k]], lengths[bucket[k]], salts[bucket[k]], seed) % this->slotCount;
+                    if(taken[slot])
+                    {
+                        break;
+                    }
+                    taken[slot] = true;
+                }
+                if(k == size)
+                {
+                    break;
+                }
+                
+                // Give back the slots taken by this seed.
+                while(k-- > 0)
+                {
+                    taken[hash(keys[bucket[k]], lengths[bucket[k]], salts[bucket[k]], seed) % this->slotCount] = false;
+                }
+            }
+            if(seed > MAX_SEED)
+            {
+                placed = false;
+                break;
+            }
+            this->seeds[b] = seed;
+        }
+        if(placed)
+        {
+            break;
+        }
+        this->slotCount *= 2;
+    }
+}
+
+PerfectHash::~PerfectHash()
+{
+    delete[] this->seeds;
+}
+
+int PerfectHash::getSlotCount() const
+{
+    return this->slotCount;
+}
+
+int PerfectHash::find(const char* key, size_t length, uint32_t salt) const
+{
+    uint32_t seed = this->seeds[hash(key, length, salt, 0) % this->bucketCount];
+    return (int)(hash(key, length, salt, seed) % this->slotCount);
+}
+
+size_t PerfectHash::getMemoryBytes() const
+{
+    return sizeof(PerfectHash) + this->bucketCount * sizeof(uint32_t);
+}
@@ -0,0 +1,85 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef __TANGENT_MATH_FUNC__PERFECT_HASH
+#define __TANGENT_MATH_FUNC__PERFECT_HASH 65536
+
+/*
+ * Collision-free hash of a fixed set of keys, each one a string and a small integer, e.g. a function name and its
+ *  argument count. Built by hash and displace: keys are spread over buckets by a first hash, then every bucket, the
+ *  largest first, gets the first seed of a second hash sending all of its keys to free slots. A lookup hashes twice and
+ *  reads one slot, without any probing.
+ *
+ * Keys outside of the set are sent to an arbitrary slot as well, so the key stored there MUST be compared.
+ */
+class PerfectHash
+{
+    private:
+        /*
+         * Seed of the second hash, per bucket.
+         */
+        uint32_t* seeds;
+        
+        int bucketCount;
+        
+        int slotCount;
+        
+        // Disabled
+        PerfectHash(const PerfectHash&);
+        void operator=(const PerfectHash&);
+    
+    public:
+        /*
+         * FNV-1a over the string then the integer, with a final avalanche. Usable in constant expressions.
+         */
+        static constexpr uint32_t hash(const char* key, size_t length, uint32_t salt, uint32_t seed)
+        {
+            uint32_t h = (2166136261u ^ seed) * 16777619u;
+            for(size_t i = 0 ; i < length ; i++)
+            {
+                h = (h ^ (unsigned char)(key[i])) * 16777619u;
+            }
+            h = (h ^ salt) * 16777619u;
+            h ^= h >> 16;
+            h *= 0x85ebca6bu;
+            h ^= h >> 13;
+            h *= 0xc2b2ae35u;
+            h ^= h >> 16;
+            return h;
+        }
+        
+        /*
+         * Param(s):
+         *    keys       -> Strings of the keys, not necessarily terminated.
+         *    lengths    -> Length of each string.
+         *    salts      -> Integer of each key.
+         *    count      -> Keys, all different.
+         *
+         *  Throws InvalidArgumentException if a key is given twice.
+         */
+        PerfectHash(const char* const* keys, const size_t* lengths, const uint32_t* salts, int count);
+        
+        ~PerfectHash();
+        
+        /*
+         * Slots a key may be sent to, a little more than the keys so that the seeds are found quickly.
+         */
+        int getSlotCount() const;
+        
+        /*
+         * The slot of a key of the set, an arbitrary one for any other key.
+         */
+        int find(const char* key, size_t length, uint32_t salt) const;
+        
+        size_t getMemoryBytes() const;
+};
+
+#endif
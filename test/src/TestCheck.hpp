@@ -0,0 +1,40 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#ifndef __TANGENT_MATH_FUNC__TEST_CHECK
+#define __TANGENT_MATH_FUNC__TEST_CHECK 65536
+
+#include <stdio.h>
+#include <math.h>
+
+/*
+ * Checks shared by the behaviour tests. Each check prints one line, and a test returns the number of failures as its
+ *  exit code, so that any failure fails the run.
+ */
+static int failures = 0;
+
+static inline void check(bool passed, const char* what)
+{
+  failures += (passed ? 0 : 1);
+  fprintf(stdout, "%-4s %s\n", (passed ? "OK" : "FAIL"), what);
+}
+
+/*
+ * Whether "actual" is within "tolerance" of "expected", relative to the value or to 1 for values smaller than 1.
+ */
+static inline bool near(double actual, double expected, double tolerance)
+{
+  return (fabs(actual - expected) <= tolerance * fmax(fabs(expected), 1.0));
+}
+
+/*
+ * Whether evaluating "body" throws an exception of type T.
+ */
+#define THROWS(T, body) ([&]() -> bool { try { body; } catch(const T&) { return true; } catch(...) { return false; } return false; }())
+
+#endif
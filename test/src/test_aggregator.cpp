@@ -0,0 +1,134 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Aggregator.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Aggregation: the same results bit for bit with any number of threads, the first row winning ties across chunks,
+ *  NaN values counted apart, and the error of each summation.
+ */
+
+/*
+ * Several chunks, the last one partial.
+ */
+static const long long ROWS = 5LL * Aggregator::CHUNK_ROWS + 1234;
+
+static const Summation SUMMATIONS[] = {SUMMATION_PLAIN, SUMMATION_COMPENSATED, SUMMATION_PAIRWISE};
+
+static const char* const SUMMATION_NAMES[] = {"plain", "compensated", "pairwise"};
+
+/*
+ * Whether two values are the same bit for bit, NaN being the same as NaN.
+ */
+static bool same(double a, double b)
+{
+  return (a == b && signbit(a) == signbit(b)) || (a != a && b != b);
+}
+
+static bool same(const AggregateResult& a, const AggregateResult& b)
+{
+  return same(a.sum, b.sum) && same(a.mean, b.mean) && same(a.min, b.min) && same(a.max, b.max) && a.argmin == b.argmin && a.argmax == b.argmax
+      && a.count == b.count && a.nanCount == b.nanCount;
+}
+
+int main(int argc, char* argv[])
+{
+  // Pinned to one tier, so that every chunk is evaluated by the same program.
+  TierPolicy policy;
+  policy.enabled = false;
+  MathFunction::setTierPolicy(policy);
+  MathFunction f("f(x)", "3 * x - 1");
+  MathFunction identity("identity(x)", "x");
+  string name;
+  
+  // Values of magnitudes far apart, so that the sums depend on the order of the additions.
+  mt19937_64 rng(65536);
+  uniform_real_distribution<double> uniform(-1, 1);
+  uniform_int_distribution<int> exponent(-8, 8);
+  vector<double> xs(ROWS);
+  for(long long i = 0 ; i < ROWS ; i++)
+  {
+    xs[i] = (i % 1000 == 17 ? NAN : uniform(rng) * pow(10.0, exponent(rng)));
+  }
+  // Extremes held twice in the same chunk and again in later chunks, the first one of each in the second chunk.
+  const long long CHUNK = Aggregator::CHUNK_ROWS;
+  long long lowRows[] = {CHUNK + 5, CHUNK + 5000, 3 * CHUNK + 7, ROWS - 1};
+  long long highRows[] = {CHUNK + 9, 2 * CHUNK + 9, 4 * CHUNK + 1, 5 * CHUNK};
+  for(int k = 0 ; k < 4 ; k++)
+  {
+    xs[lowRows[k]] = -10000000000.0;
+    xs[highRows[k]] = 10000000000.0;
+  }
+  const double* columns[] = {xs.data()};
+  
+  unsigned long long nans = 0;
+  for(long long i = 0 ; i < ROWS ; i++)
+  {
+    nans += (xs[i] != xs[i] ? 1 : 0);
+  }
+  
+  for(int s = 0 ; s < 3 ; s++)
+  {
+    AggregateResult alone = Aggregator(SUMMATIONS[s], 1).aggregate(f, columns, ROWS);
+    bool reproducible = true;
+    for(int threads : {2, 3, 8, 0})
+    {
+      reproducible = reproducible && same(alone, Aggregator(SUMMATIONS[s], threads).aggregate(f, columns, ROWS));
+    }
+    name = string("1 thread and many give the same aggregates bit for bit, ") + SUMMATION_NAMES[s] + " summation";
+    check(reproducible, name.c_str());
+    name = string("the first row of the minimum and of the maximum wins, across chunks, ") + SUMMATION_NAMES[s] + " summation";
+    check(alone.argmin == lowRows[0] && alone.argmax == highRows[0] && alone.min == -30000000001.0 && alone.max == 29999999999.0, name.c_str());
+    name = string("NaN values are counted apart, ") + SUMMATION_NAMES[s] + " summation";
+    check(alone.nanCount == nans && alone.count == ROWS - nans && same(alone.mean, alone.sum / alone.count), name.c_str());
+  }
+  
+  // Every value NaN, and no row at all.
+  vector<double> undefined(3 * CHUNK + 10, NAN);
+  const double* undefinedColumns[] = {undefined.data()};
+  bool allNaN = true;
+  for(int s = 0 ; s < 3 ; s++)
+  {
+    for(int threads : {1, 4})
+    {
+      AggregateResult r = Aggregator(SUMMATIONS[s], threads).aggregate(f, undefinedColumns, (long long)(undefined.size()));
+      allNaN = allNaN && isnan(r.min) && isnan(r.max) && isnan(r.mean) && r.argmin == -1 && r.argmax == -1 && r.sum == 0 && r.count == 0
+          && r.nanCount == undefined.size();
+    }
+  }
+  check(allNaN, "every value NaN: NaN minimum, maximum and mean, no argmin nor argmax, and a zero sum");
+  AggregateResult empty = Aggregator().aggregate(f, columns, 0);
+  check(isnan(empty.mean) && isnan(empty.min) && empty.argmax == -1 && empty.sum == 0 && empty.count == 0 && empty.nanCount == 0, "no row gives no value");
+  
+  // One, then half an ulp of one many times over: each of those vanishes when added to one alone.
+  vector<double> ones(ROWS, ldexp(1.0, -53));
+  ones[0] = 1;
+  const double* oneColumns[] = {ones.data()};
+  double exact = 1 + (ROWS - 1) * ldexp(1.0, -53);
+  double ulp = ldexp(1.0, -52);
+  double plainError = fabs(Aggregator(SUMMATION_PLAIN).aggregate(identity, oneColumns, ROWS).sum - exact);
+  double compensatedError = fabs(Aggregator(SUMMATION_COMPENSATED).aggregate(identity, oneColumns, ROWS).sum - exact);
+  double pairwiseError = fabs(Aggregator(SUMMATION_PAIRWISE).aggregate(identity, oneColumns, ROWS).sum - exact);
+  check(compensatedError <= ulp / 2, "the compensated sum is correctly rounded");
+  check(pairwiseError <= 4 * ulp && pairwiseError >= compensatedError, "the pairwise sum loses a few ulps");
+  check(plainError > 1000 * ulp, "the plain sum loses the small values added to the large one");
+  
+  check(THROWS(InvalidArgumentException, Aggregator().aggregate(f, columns, -1)) && THROWS(InvalidArgumentException, Aggregator(SUMMATION_PLAIN, -1)),
+      "negative counts of rows and of threads throw");
+  
+  MathFunction::setTierPolicy(TierPolicy());
+  return failures;
+}
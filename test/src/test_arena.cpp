@@ -0,0 +1,177 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <util/Arena.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Arenas: alignment of odd sizes, chunks doubling as the arena grows, allocations larger than the next chunk,
+ *  the bytes counted by each arena and by all of them, and chunks released and reused through the allocation hook.
+ */
+
+/*
+ * Chunks handed out and taken back by the hook. Released chunks are kept, and handed out again for the same size.
+ */
+struct Pool
+{
+  int allocations;
+  int releases;
+  size_t allocatedBytes;
+  size_t releasedBytes;
+  vector<void*> freeChunks;
+  vector<size_t> freeSizes;
+};
+
+static void* poolAllocate(size_t size, void* context)
+{
+  Pool* pool = (Pool*)context;
+  pool->allocations++;
+  pool->allocatedBytes += size;
+  for(size_t i = 0 ; i < pool->freeChunks.size() ; i++)
+  {
+    if(pool->freeSizes[i] == size)
+    {
+      void* chunk = pool->freeChunks[i];
+      pool->freeChunks.erase(pool->freeChunks.begin() + i);
+      pool->freeSizes.erase(pool->freeSizes.begin() + i);
+      return chunk;
+    }
+  }
+  return malloc(size);
+}
+
+static void poolRelease(void* ptr, size_t size, void* context)
+{
+  Pool* pool = (Pool*)context;
+  pool->releases++;
+  pool->releasedBytes += size;
+  pool->freeChunks.push_back(ptr);
+  pool->freeSizes.push_back(size);
+}
+
+static bool aligned(const void* ptr)
+{
+  return ((uintptr_t)ptr % Arena::ALIGNMENT) == 0;
+}
+
+struct Pair
+{
+  double value;
+  int index;
+  
+  Pair(double _value, int _index) : value(_value), index(_index)
+  {
+  }
+};
+
+int main(int argc, char* argv[])
+{
+  size_t before = Arena::getTotalReservedBytes();
+  Arena* arena = new Arena(64);
+  check(arena->getChunksCount() == 0 && arena->getReservedBytes() == 0 && arena->getAllocatedBytes() == 0,
+      "a new arena reserves nothing until the first allocation");
+  
+  // Odd sizes are rounded up to the alignment, and laid out back to back in the first chunk.
+  const size_t SIZES[] = {1, 3, 7, 9, 13};
+  char* blocks[5];
+  bool packed = true;
+  size_t expected = 0;
+  for(int i = 0 ; i < 5 ; i++)
+  {
+    blocks[i] = (char*)(arena->allocate(SIZES[i]));
+    memset(blocks[i], i, SIZES[i]);
+    packed = packed && aligned(blocks[i]) && (i == 0 || blocks[i] - blocks[i - 1] == (ptrdiff_t)((SIZES[i - 1] + 7) / 8 * 8));
+    expected += (SIZES[i] + 7) / 8 * 8;
+  }
+  check(packed && arena->getAllocatedBytes() == expected && expected == 56, "odd sizes are aligned and rounded up to the alignment, back to back");
+  size_t header = arena->getReservedBytes() - 64;
+  check(arena->getChunksCount() == 1 && header % Arena::ALIGNMENT == 0 && header >= sizeof(void*) + sizeof(size_t),
+      "the first chunk has the capacity asked for, behind an aligned header");
+  check(Arena::getTotalReservedBytes() == before + arena->getReservedBytes(), "the total counts the bytes of the arena");
+  
+  // Past the capacity of a chunk, the next one doubles, and later allocations are served from it.
+  char* spill = (char*)(arena->allocate(16));
+  check(arena->getChunksCount() == 2 && arena->getReservedBytes() == 2 * header + 64 + 128 && aligned(spill),
+      "an allocation not fitting the chunk adds one twice as large");
+  char* fill = (char*)(arena->allocate(112));
+  memset(fill, 0x5a, 112);
+  check(arena->getChunksCount() == 2 && fill == spill + 16, "the new chunk serves allocations up to its capacity");
+  arena->allocate(8);
+  check(arena->getChunksCount() == 3 && arena->getReservedBytes() == 3 * header + 64 + 128 + 256, "the chunk after it doubles again");
+  bool intact = true;
+  for(int i = 0 ; i < 5 ; i++)
+  {
+    for(size_t j = 0 ; j < SIZES[i] ; j++)
+    {
+      intact = intact && blocks[i][j] == (char)i;
+    }
+  }
+  check(intact, "blocks of earlier chunks stay in place as the arena grows");
+  
+  // Larger than the next chunk: the capacity doubles until it fits, and the rest of that chunk is used afterwards.
+  size_t reserved = arena->getReservedBytes();
+  char* large = (char*)(arena->allocate(5000));
+  memset(large, 0xa5, 5000);
+  check(arena->getChunksCount() == 4 && arena->getReservedBytes() == reserved + header + 8192 && aligned(large),
+      "an oversized allocation gets a chunk of the next capacity doubled until it fits");
+  char* after = (char*)(arena->allocate(3000));
+  memset(after, 0x3c, 3000);
+  check(arena->getChunksCount() == 4 && after == large + 5000, "the rest of the oversized chunk serves later allocations");
+  Pair* pair = new(*arena) Pair(2.5, 7);
+  check(aligned(pair) && pair->value == 2.5 && pair->index == 7 && (char*)pair == after + 3000,
+      "placement new constructs into the arena, right behind the last block");
+  check(Arena::getTotalReservedBytes() == before + arena->getReservedBytes(), "the total follows the arena as it grows");
+  
+  // Deleting the arena gives its bytes back to the total.
+  Arena* other = new Arena(0);
+  other->allocate(1);
+  check(other->getReservedBytes() == header + Arena::ALIGNMENT, "a capacity below the alignment is raised to it");
+  check(Arena::getTotalReservedBytes() == before + arena->getReservedBytes() + other->getReservedBytes(), "the total adds up the arenas alive");
+  delete arena;
+  check(Arena::getTotalReservedBytes() == before + other->getReservedBytes(), "deleting an arena takes its bytes off the total");
+  
+  // Chunks go through the hook in effect when the arena was created, both ways, with matching sizes.
+  Pool pool = {0, 0, 0, 0, vector<void*>(), vector<size_t>()};
+  Arena::setAllocationHook(poolAllocate, poolRelease, &pool);
+  Arena* hooked = new Arena(64);
+  void* first = hooked->allocate(40);
+  hooked->allocate(40);
+  hooked->allocate(300);
+  size_t hookedReserved = hooked->getReservedBytes();
+  check(pool.allocations == 3 && pool.allocatedBytes == hookedReserved, "the hook allocates every chunk, headers included");
+  delete other;
+  check(pool.releases == 0, "an arena created before the hook does not release through it");
+  delete hooked;
+  check(pool.releases == 3 && pool.releasedBytes == pool.allocatedBytes && Arena::getTotalReservedBytes() == before,
+      "deleting an arena releases every chunk through its hook with the size it was allocated with");
+  
+  // A new arena asking for the same chunks gets the released ones back, starting over from their first byte.
+  Arena* reused = new Arena(64);
+  void* again = reused->allocate(40);
+  reused->allocate(40);
+  reused->allocate(300);
+  check(again == first && pool.allocations == 6 && pool.freeChunks.empty() && reused->getReservedBytes() == hookedReserved,
+      "chunks released through the hook are reused by the next arena from their start");
+  Arena::setAllocationHook(nullptr, nullptr, nullptr);
+  delete reused;
+  check(pool.releases == 6 && Arena::getTotalReservedBytes() == before, "removing the hook leaves arenas created with it releasing through it");
+  for(void* chunk : pool.freeChunks)
+  {
+    free(chunk);
+  }
+  
+  return failures;
+}
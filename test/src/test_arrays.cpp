@@ -0,0 +1,151 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <TangentsMathFunc.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Arrays and reductions: elements, reductions against loops from the first element to the last, whole array arguments,
+ *  invalid subscripts and reductions, and batches against single calls on both backends.
+ */
+
+static const int LENGTH = 1000;
+
+static const int ROWS = 300;
+
+/*
+ * Whether two values are the same bit for bit, NaN being the same as NaN.
+ */
+static bool same(double a, double b)
+{
+  return (a == b && signbit(a) == signbit(b)) || (a != a && b != b);
+}
+
+static void run(Backend backend, const char* suffix)
+{
+  MathFunction::setBackend(backend);
+  MathFunctionNamespace ns(&MathFunctionNamespace::getBuiltIns());
+  MathFunction sum(ns, "total(w[1000])", "sum(w)");
+  MathFunction prod(ns, "product(w[1000])", "prod(w)");
+  MathFunction lowest(ns, "lowest(w[1000])", "min(w)");
+  MathFunction highest(ns, "highest(w[1000])", "max(w)");
+  MathFunction lin(ns, "lin(w[1000], x[1000], b)", "dot(w, x) + b");
+  MathFunction head(ns, "head(x[1000])", "x[0] - x[999] * max(x) / sum(x)");
+  MathFunction twice(ns, "twice(v[1000])", "2 * lin(v, v, 0)");
+  string name;
+  
+  mt19937_64 rng(65536);
+  uniform_real_distribution<double> uniform(0.5, 1.5);
+  vector<double> w(LENGTH);
+  vector<double> x(LENGTH);
+  for(int i = 0 ; i < LENGTH ; i++)
+  {
+    w[i] = uniform(rng);
+    x[i] = uniform(rng) - 1;
+  }
+  double total = w[0], product = w[0], low = w[0], high = w[0], dot = w[0] * x[0], squares = w[0] * w[0];
+  for(int i = 1 ; i < LENGTH ; i++)
+  {
+    total += w[i];
+    product *= w[i];
+    low = fmin(low, w[i]);
+    high = fmax(high, w[i]);
+    dot += w[i] * x[i];
+    squares += w[i] * w[i];
+  }
+  vector<double> linOperands(w);
+  linOperands.insert(linOperands.end(), x.begin(), x.end());
+  linOperands.push_back(0.25);
+  
+  name = string("sum, prod, min and max accumulate from the first element to the last, ") + suffix;
+  check(sum.invoke(w) == total && prod.invoke(w) == product && lowest.invoke(w) == low && highest.invoke(w) == high, name.c_str());
+  name = string("dot of two arrays, then a scalar, ") + suffix;
+  check(near(lin.invoke(linOperands), dot + 0.25, 1e-13) && lin.getIdentifier().getVariablesCount() == 2 * LENGTH + 1
+      && lin.getVariableName(LENGTH) == "x[0]" && lin.getVariableName(2 * LENGTH) == "b", name.c_str());
+  name = string("elements by constant index, and a whole array passed as an argument, ") + suffix;
+  check(head.invoke(x) == x[0] - x[LENGTH - 1] * highest.invoke(x) / sum.invoke(x) && near(twice.invoke(w), 2 * squares, 1e-13), name.c_str());
+  
+  vector<double> withNaN(w);
+  withNaN[LENGTH / 2] = NAN;
+  name = string("NaN wins in min and max, and spreads through sum, ") + suffix;
+  check(isnan(lowest.invoke(withNaN)) && isnan(highest.invoke(withNaN)) && isnan(sum.invoke(withNaN)), name.c_str());
+  
+  // Batches of ROWS rows, one column per element, against single calls.
+  vector<vector<double> > data(2 * LENGTH + 1, vector<double>(ROWS));
+  vector<const double*> columns(2 * LENGTH + 1);
+  for(int j = 0 ; j <= 2 * LENGTH ; j++)
+  {
+    for(int i = 0 ; i < ROWS ; i++)
+    {
+      data[j][i] = (i == 7 && j == 5 ? NAN : uniform(rng) - 0.75);
+    }
+    columns[j] = data[j].data();
+  }
+  const MathFunction* funcs[] = {&sum, &prod, &lowest, &highest, &lin, &head, &twice};
+  bool batchSame = true;
+  vector<double> results(ROWS);
+  for(const MathFunction* func : funcs)
+  {
+    int varCount = func->getIdentifier().getVariablesCount();
+    func->invokeBatch(columns.data(), ROWS, results.data());
+    for(int i = 0 ; i < ROWS ; i++)
+    {
+      vector<double> operands(varCount);
+      for(int j = 0 ; j < varCount ; j++)
+      {
+        operands[j] = data[j][i];
+      }
+      batchSame = batchSame && same(results[i], func->invoke(operands));
+    }
+  }
+  name = string("batches give the results of single calls, bit for bit, ") + suffix;
+  check(batchSame, name.c_str());
+  
+  // Grids over small arrays: reductions read the outer variables along with the inner one.
+  MathFunction small(ns, "small(w[3])", "sum(w) * w[2] + dot(w, w) - max(w)");
+  GridAxis axes[] = {{0, 1, 2}, {10, 12, 3}, {20, 23, 4}};
+  double grid[24];
+  small.invokeGrid(axes, grid);
+  bool gridSame = true;
+  for(int i = 0 ; i < 24 ; i++)
+  {
+    gridSame = gridSame && same(grid[i], small.invoke({axes[0].at(i / 12), axes[1].at(i / 4 % 3), axes[2].at(i % 4)}));
+  }
+  name = string("grids over arrays give the results of single calls, bit for bit, ") + suffix;
+  check(gridSame, name.c_str());
+  
+  // Invalid subscripts and reductions.
+  name = string("subscripts out of range or of a scalar throw, ") + suffix;
+  check(THROWS(InvalidFormulaException, MathFunction(ns, "bad(w[3])", "w[3]")) && THROWS(InvalidFormulaException, MathFunction(ns, "bad(w[3])", "w[-1]"))
+      && THROWS(InvalidFormulaException, MathFunction(ns, "bad(w[3], b)", "b[0]")), name.c_str());
+  name = string("dot of arrays of different lengths, and reductions of scalars, throw, ") + suffix;
+  check(THROWS(InvalidFormulaException, MathFunction(ns, "bad(w[3], x[4])", "dot(w, x)")) && THROWS(InvalidFormulaException, MathFunction(ns, "bad(b)", "sum(b)"))
+      && THROWS(InvalidFormulaException, MathFunction(ns, "bad(w[3])", "sum(w) + w")), name.c_str());
+  name = string("an array of the wrong length passed as a whole argument throws, ") + suffix;
+  check(THROWS(InvalidFormulaException, MathFunction(ns, "bad(v[999])", "lin(v, v, 0)")), name.c_str());
+}
+
+int main(int argc, char* argv[])
+{
+  // Pinned to one tier, so that single calls and batches compare bit for bit.
+  TierPolicy policy;
+  policy.enabled = false;
+  MathFunction::setTierPolicy(policy);
+  run(BACKEND_STACK, "stack backend");
+  run(BACKEND_REGISTER, "register backend");
+  MathFunction::setBackend(BACKEND_STACK);
+  MathFunction::setTierPolicy(TierPolicy());
+  return failures;
+}
@@ -0,0 +1,179 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <AsyncEvaluator.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Asynchronous evaluation: coalesced and sliced batches against invokeBatch(), failures and cancellation.
+ *  A worker is held busy by a callback waiting on a gate, so that batches queued behind it stay queued.
+ */
+
+/*
+ * Whether the future of a batch throws an exception of type T.
+ */
+template <typename T>
+static bool futureThrows(const AsyncBatch& batch)
+{
+  return THROWS(T, batch.getFuture().get());
+}
+
+int main(int argc, char* argv[])
+{
+  // Pinned to one tier, so that results compare bit for bit with the direct evaluation.
+  TierPolicy policy;
+  policy.enabled = false;
+  MathFunction::setTierPolicy(policy);
+  
+  MathFunction f("f(x, y)", "sin(x) * y + x / (1 + y^2)");
+  MathFunction inverse("inverse(x)", "1 / x");
+  const int ROWS = 100000;
+  vector<double> xs(ROWS);
+  vector<double> ys(ROWS);
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    xs[i] = 0.001 * i - 7;
+    ys[i] = 0.5 + (i % 97) * 0.01;
+  }
+  vector<double> expected(ROWS);
+  const double* columns[] = {xs.data(), ys.data()};
+  f.invokeBatch(columns, ROWS, expected.data());
+  
+  {
+    // Small batches of varied sizes, coalesced, and large ones, sliced, on several threads.
+    AsyncEvaluator evaluator(4, 64, 1024);
+    vector<double> results(ROWS, -1);
+    vector<AsyncBatch> batches;
+    atomic<int> done(0);
+    int offset = 0;
+    for(int size = 1 ; offset < ROWS ; size = (size * 7) % 5003 + 1)
+    {
+      int rows = min(size, ROWS - offset);
+      const double* part[] = {xs.data() + offset, ys.data() + offset};
+      batches.push_back(evaluator.submit(f, part, rows, results.data() + offset, [&](AsyncStatus status, exception_ptr error) {
+        done += (status == ASYNC_DONE && !error ? 1 : 0);
+      }));
+      offset += rows;
+    }
+    bool settled = true;
+    for(AsyncBatch& batch : batches)
+    {
+      batch.getFuture().get();
+      settled = settled && batch.getStatus() == ASYNC_DONE;
+    }
+    check(settled && done == (int)(batches.size()), "every batch is done, and its callback called once");
+    check(results == expected, "coalesced and sliced batches give the results of invokeBatch()");
+  }
+  
+  {
+    // A failing batch coalesced with others fails alone.
+    AsyncEvaluator evaluator(1, 64, 4096);
+    promise<void> gate;
+    shared_future<void> opened = gate.get_future().share();
+    double one = 1;
+    const double* oneColumn[] = {&one};
+    double held;
+    AsyncBatch holder = evaluator.submit(inverse, oneColumn, 1, &held, [opened](AsyncStatus, exception_ptr) { opened.wait(); });
+    while(holder.getStatus() == ASYNC_QUEUED)
+    {
+      this_thread::yield();
+    }
+    
+    vector<double> inputs = {1, 2, 0, 4, 5, 8};
+    vector<double> outputs(inputs.size(), -1);
+    vector<AsyncBatch> batches;
+    AsyncStatus failedStatus = ASYNC_QUEUED;
+    exception_ptr failedError;
+    for(size_t i = 0 ; i < inputs.size() ; i += 2)
+    {
+      const double* part[] = {inputs.data() + i};
+      batches.push_back(evaluator.submit(inverse, part, 2, outputs.data() + i, (i == 2 ? AsyncCallback([&](AsyncStatus status, exception_ptr error) {
+        failedStatus = status;
+        failedError = error;
+      }) : AsyncCallback())));
+    }
+    check(evaluator.getQueuedCount() == 3, "batches wait behind a busy worker");
+    gate.set_value();
+    holder.getFuture().get();
+    check(futureThrows<DividedByZeroException>(batches[1]) && batches[1].getStatus() == ASYNC_FAILED, "the batch dividing by zero fails");
+    check(failedStatus == ASYNC_FAILED && failedError != nullptr, "its callback receives the error");
+    batches[0].getFuture().get();
+    batches[2].getFuture().get();
+    check(batches[0].getStatus() == ASYNC_DONE && batches[2].getStatus() == ASYNC_DONE && outputs[0] == 1 && outputs[1] == 0.5
+        && outputs[4] == 0.2 && outputs[5] == 0.125, "the batches coalesced with it are done");
+  }
+  
+  {
+    // Cancelling a queued batch, a full queue, and the destructor dropping what is still queued.
+    AsyncEvaluator* evaluator = new AsyncEvaluator(1, 2, 1024);
+    promise<void> gate;
+    shared_future<void> opened = gate.get_future().share();
+    double one = 1;
+    const double* oneColumn[] = {&one};
+    double held;
+    AsyncBatch holder = evaluator->submit(inverse, oneColumn, 1, &held, [opened](AsyncStatus, exception_ptr) { opened.wait(); });
+    while(holder.getStatus() == ASYNC_QUEUED)
+    {
+      this_thread::yield();
+    }
+    
+    vector<double> results(ROWS, -1);
+    AsyncStatus cancelledStatus = ASYNC_QUEUED;
+    AsyncBatch queued = evaluator->submit(f, columns, 10, results.data(), [&](AsyncStatus status, exception_ptr) { cancelledStatus = status; });
+    AsyncBatch other = evaluator->submit(f, columns, 10, results.data() + 10);
+    check(!evaluator->trySubmit(f, columns, 10, results.data() + 20).isValid(), "trySubmit() fails on a full queue");
+    check(queued.cancel() && queued.getStatus() == ASYNC_CANCELLED && cancelledStatus == ASYNC_CANCELLED && evaluator->getQueuedCount() == 1,
+        "a queued batch is cancelled right away, with its callback");
+    check(futureThrows<CancelledException>(queued) && results[0] == -1, "its future throws CancelledException, and no result is written");
+    check(evaluator->trySubmit(f, columns, 10, results.data() + 20).isValid(), "cancelling frees a place in the queue");
+    
+    // Opened once the destructor has dropped the queued batches.
+    thread opener([&]() {
+      this_thread::sleep_for(chrono::milliseconds(50));
+      gate.set_value();
+    });
+    delete evaluator;
+    opener.join();
+    check(other.getStatus() == ASYNC_CANCELLED && futureThrows<CancelledException>(other) && results[10] == -1, "destroying the evaluator cancels the queued batches");
+  }
+  
+  {
+    // Cancelling a running batch stops it between slices.
+    AsyncEvaluator evaluator(1, 16, 256);
+    const int LONG_ROWS = 2000000;
+    vector<double> longXs(LONG_ROWS, 0.5);
+    vector<double> longYs(LONG_ROWS, 2);
+    vector<double> results(LONG_ROWS, -1);
+    const double* longColumns[] = {longXs.data(), longYs.data()};
+    AsyncBatch running = evaluator.submit(f, longColumns, LONG_ROWS, results.data());
+    while(running.getStatus() == ASYNC_QUEUED)
+    {
+      this_thread::yield();
+    }
+    // Long enough for the first slices, far too short for the whole batch.
+    this_thread::sleep_for(chrono::milliseconds(2));
+    bool wasQueued = running.cancel();
+    check(!wasQueued && futureThrows<CancelledException>(running) && running.getStatus() == ASYNC_CANCELLED, "a running batch is cancelled");
+    check(results[0] == f.invoke({0.5, 2.0}) && results[LONG_ROWS - 1] == -1, "the slices run before cancellation are written, not the last one");
+  }
+  
+  check(THROWS(InvalidArgumentException, AsyncEvaluator(1, 0)), "an empty queue throws");
+  check(THROWS(InvalidArgumentException, AsyncBatch().getStatus()), "an invalid handle throws");
+  
+  MathFunction::setTierPolicy(TierPolicy());
+  return failures;
+}
@@ -0,0 +1,159 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <string.h>
+#include <random>
+#include <vector>
+
+#include <TangentsMathFunc.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Batch evaluation in every layout, each one against invoke() row by row.
+ */
+
+static const int ROWS = 1000;
+
+/*
+ * A record of an array of structs, the variables not being adjacent.
+ */
+struct Record
+{
+  long long id;
+  double x;
+  float unused;
+  double y;
+};
+
+/*
+ * Whether both arrays hold the same values bit for bit, NaN included.
+ */
+static bool same(const vector<double>& a, const vector<double>& b)
+{
+  return (a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0);
+}
+
+int main(int argc, char* argv[])
+{
+  // Every function at the optimized tier from the start, so that no promotion happens between two evaluations.
+  TierPolicy policy;
+  policy.enabled = false;
+  MathFunction::setTierPolicy(policy);
+  
+  mt19937_64 rng(65536);
+  uniform_real_distribution<double> uniform(-2.0, 2.0);
+  
+  MathFunction func("f(x, y)", "sin(x) * y ^ 2 - x / (1 + y ^ 2)");
+  vector<double> xs(ROWS);
+  vector<double> ys(ROWS);
+  vector<Record> records(ROWS);
+  vector<double> matrix(ROWS * 3);
+  vector<double> expected(ROWS);
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    xs[i] = records[i].x = matrix[i * 3] = uniform(rng);
+    ys[i] = records[i].y = matrix[i * 3 + 1] = uniform(rng);
+    expected[i] = func.invoke({xs[i], ys[i]});
+  }
+  
+  vector<double> results(ROWS);
+  const double* columns[] = {xs.data(), ys.data()};
+  func.invokeBatch(columns, ROWS, results.data());
+  check(same(results, expected), "contiguous columns match invoke()");
+  
+  fill(results.begin(), results.end(), 0);
+  const double* bases[] = {&(records[0].x), &(records[0].y)};
+  ptrdiff_t strides[] = {sizeof(Record), sizeof(Record)};
+  func.invokeStrided(bases, strides, ROWS, results.data());
+  check(same(results, expected), "an array of structs read in place matches contiguous columns");
+  
+  fill(results.begin(), results.end(), 0);
+  ptrdiff_t dense[] = {sizeof(double), sizeof(double)};
+  func.invokeStrided(columns, dense, ROWS, results.data());
+  check(same(results, expected), "strides of one double are contiguous columns");
+  
+  fill(results.begin(), results.end(), 0);
+  func.invokeMatrix(matrix.data(), ROWS, 3, results.data());
+  check(same(results, expected), "a row-major matrix with padding matches contiguous columns");
+  check(THROWS(InvalidArgumentException, func.invokeMatrix(matrix.data(), ROWS, 1, results.data())), "a leading dimension below the variable count throws");
+  
+  // Reversed: the last row first, through a negative stride.
+  vector<double> reversed(ROWS);
+  const double* last[] = {&(records[ROWS - 1].x), &(records[ROWS - 1].y)};
+  ptrdiff_t backwards[] = {-(ptrdiff_t)(sizeof(Record)), -(ptrdiff_t)(sizeof(Record))};
+  func.invokeStrided(last, backwards, ROWS, reversed.data());
+  bool mirrored = true;
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    mirrored = mirrored && (reversed[i] == expected[ROWS - 1 - i]);
+  }
+  check(mirrored, "negative strides walk the rows backwards");
+  
+  // Built-ins have no program of their own and are gathered block by block.
+  vector<double> sines(ROWS);
+  const double* xBase[] = {&(records[0].x)};
+  MathFunction::SIN.invokeStrided(xBase, strides, ROWS, sines.data());
+  bool exact = true;
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    exact = exact && (sines[i] == sin(xs[i]));
+  }
+  check(exact, "a strided built-in matches sin()");
+  
+  // A broadcast variable: a stride of 0 repeats the same value.
+  double fixed = 0.75;
+  const double* broadcast[] = {xs.data(), &fixed};
+  ptrdiff_t repeat[] = {sizeof(double), 0};
+  func.invokeStrided(broadcast, repeat, ROWS, results.data());
+  exact = true;
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    exact = exact && (results[i] == func.invoke({xs[i], fixed}));
+  }
+  check(exact, "a stride of 0 broadcasts one value");
+  
+  // Grids, against an explicit loop over the axes.
+  MathFunction surface("s(x, y, z)", "sin(x) * cos(y) + x * y * z - z ^ 2 / (1 + x ^ 2)");
+  GridAxis axes[] = {{-1.0, 1.0, 7}, {0.0, 3.0, 11}, {-2.0, 0.5, 300}};
+  vector<double> grid(7 * 11 * 300);
+  surface.invokeGrid(axes, grid.data());
+  double worst = 0;
+  bool endpoints = (axes[2].at(0) == -2.0 && axes[2].at(299) == 0.5 && axes[0].at(3) == 0.0);
+  for(int i = 0 ; i < 7 ; i++)
+  {
+    for(int j = 0 ; j < 11 ; j++)
+    {
+      for(int k = 0 ; k < 300 ; k++)
+      {
+        double value = surface.invoke({axes[0].at(i), axes[1].at(j), axes[2].at(k)});
+        worst = fmax(worst, fabs(grid[(i * 11 + j) * 300 + k] - value) / fmax(fabs(value), 1.0));
+      }
+    }
+  }
+  check(endpoints, "axes start and stop at their bounds");
+  check(worst <= 1e-14, "a grid with hoisted invariants matches the loop over its axes");
+  
+  vector<double> single(1);
+  GridAxis points[] = {{0.5, 9.0, 1}, {2.0, 2.0, 1}, {1.0, 1.0, 1}};
+  surface.invokeGrid(points, single.data());
+  check(single[0] == surface.invoke({0.5, 2.0, 1.0}), "an axis of one value is its start");
+  
+  GridAxis line[] = {{0.0, 1.0, 5}};
+  vector<double> wave(5);
+  MathFunction::SIN.invokeGrid(line, wave.data());
+  check(wave[4] == sin(1.0) && wave[2] == sin(0.5), "a grid of a built-in");
+  
+  GridAxis none[] = {{0.0, 1.0, 5}, {0.0, 1.0, 0}, {0.0, 1.0, 5}};
+  check(THROWS(InvalidArgumentException, surface.invokeGrid(none, grid.data())), "an empty axis throws");
+  
+  MathFunction::setTierPolicy(TierPolicy());
+  return failures;
+}
@@ -0,0 +1,66 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <vector>
+
+#include <TangentsMathFunc.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Partial evaluation: bound functions against the original, on both backends.
+ */
+
+static void run(Backend backend, const char* suffix)
+{
+  MathFunction::setBackend(backend);
+  MathFunctionNamespace ns(&MathFunctionNamespace::getBuiltIns());
+  MathFunction scale(ns, "scale(x)", "x * 3");
+  MathFunction f(ns, "f(a, b, x)", "sin(a * b) * x + ln(b) + scale(a)");
+  string name;
+  
+  MathFunction* g = f.bind({{"a", 1.0}, {"b", 2.0}});
+  name = string("binding some variables keeps the others in order, ") + suffix;
+  check(g->getIdentifier().getVariablesCount() == 1 && g->getVariableName(0) == "x" && g->invoke({0.5}) == f.invoke({1.0, 2.0, 0.5}), name.c_str());
+  
+  MathFunction* h = f.bind({{"x", 4.0}, {"a", -1.5}});
+  name = string("variables may be bound in any order, ") + suffix;
+  check(h->getIdentifier().getVariablesCount() == 1 && h->getVariableName(0) == "b" && h->invoke({2.5}) == f.invoke({-1.5, 2.5, 4.0}), name.c_str());
+  
+  // Every variable bound: the function takes no operand at all.
+  MathFunction* k = f.bind({{"a", 0.25}, {"b", 3.0}, {"x", -2.0}});
+  name = string("binding every variable leaves a constant, invoked without operands, ") + suffix;
+  check(k->getIdentifier().getVariablesCount() == 0 && k->invoke(vector<double>()) == f.invoke({0.25, 3.0, -2.0}) && k->invoke({}) == k->invoke(vector<double>()), name.c_str());
+  double constant = 0;
+  double ignored = 1;
+  const double* none[] = {&ignored};
+  k->invokeBatch(none, 1, &constant);
+  name = string("a constant evaluated in a batch, ") + suffix;
+  check(constant == k->invoke({}), name.c_str());
+  
+  scale.redefine("x * 5");
+  name = string("redefining a callee recompiles the bound functions, ") + suffix;
+  check(k->invoke({}) == f.invoke({0.25, 3.0, -2.0}) && g->invoke({0.5}) == f.invoke({1.0, 2.0, 0.5}), name.c_str());
+  
+  name = string("unknown or twice bound variables throw, ") + suffix;
+  check(THROWS(InvalidArgumentException, delete f.bind({{"z", 1.0}})) && THROWS(InvalidArgumentException, delete f.bind({{"a", 1.0}, {"a", 2.0}})), name.c_str());
+  
+  delete g;
+  delete h;
+  delete k;
+}
+
+int main(int argc, char* argv[])
+{
+  run(BACKEND_STACK, "stack backend");
+  run(BACKEND_REGISTER, "register backend");
+  MathFunction::setBackend(BACKEND_STACK);
+  return failures;
+}
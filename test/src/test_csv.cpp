@@ -0,0 +1,115 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <string>
+
+#include <CsvEvaluator.hpp>
+#include <misc/FastFloat.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * CSV evaluation and the float parser feeding it.
+ */
+
+static bool parses(const char* text, double expected)
+{
+  double value = -12345;
+  return (FastFloat::parse(text, text + strlen(text), value) && (value == expected || (value != value && expected != expected)));
+}
+
+static bool rejects(const char* text)
+{
+  double value = -12345;
+  return (!FastFloat::parse(text, text + strlen(text), value) && value == -12345);
+}
+
+/*
+ * Run the evaluator over "input", returning its whole output.
+ */
+static string evaluate(CsvEvaluator& csv, const string& input)
+{
+  FILE* in = tmpfile();
+  FILE* out = tmpfile();
+  fwrite(input.data(), 1, input.size(), in);
+  rewind(in);
+  csv.run(in, out);
+  fflush(out);
+  rewind(out);
+  string text;
+  char buffer[4096];
+  size_t read;
+  while((read = fread(buffer, 1, sizeof(buffer), out)) > 0)
+  {
+    text.append(buffer, read);
+  }
+  fclose(in);
+  fclose(out);
+  return text;
+}
+
+int main(int argc, char* argv[])
+{
+  check(parses("1.5", 1.5) && parses("-0.25", -0.25) && parses("+3", 3) && parses("1e3", 1000) && parses("2.5E-3", 2.5e-3), "plain numbers");
+  check(parses("  42 ", 42), "leading and trailing spaces are ignored");
+  check(parses(".5", 0.5) && parses("5.", 5.0), "a missing integral or fractional part");
+  double zero = 0;
+  check(FastFloat::parse("-0", "-0" + 2, zero) && zero == 0 && signbit(zero), "negative zero keeps its sign");
+  check(parses("1e-320", strtod("1e-320", nullptr)) && parses("1e308", 1e308), "subnormal and large values take the slow path");
+  check(parses("inf", INFINITY) && parses("-inf", -INFINITY) && parses("nan", NAN), "infinities and NaN");
+  check(parses("0.1", 0.1) && parses("123456789012345678", 123456789012345678.0), "rounding as strtod()");
+  check(rejects("") && rejects("   ") && rejects("abc") && rejects("1.2.3") && rejects("1e") && rejects("12abc") && rejects("-"), "text that is not a number");
+  
+  mt19937_64 rng(65536);
+  uniform_real_distribution<double> uniform(-1e6, 1e6);
+  bool exact = true;
+  for(int i = 0 ; i < 100000 && exact ; i++)
+  {
+    char text[64];
+    double value = uniform(rng) * pow(10.0, (int)(rng() % 40) - 20);
+    snprintf(text, sizeof(text), (i % 2 ? "%.17g" : "%.6f"), value);
+    exact = parses(text, strtod(text, nullptr));
+  }
+  check(exact, "random values parse as by strtod()");
+  
+  MathFunction ratio("ratio(x, y)", "x / y");
+  MathFunction total("total(y, x)", "x + y");
+  
+  CsvEvaluator csv(',', 2, 2, 6);
+  csv.addOutput(ratio, "r");
+  csv.addOutput(total, "t");
+  string output = evaluate(csv, "id,x,name,y\n1,6,\"a,b\",3\n2,1,c,0\n3,abc,d,1\n4,2.5,\"e\",0.5\n5,1,f,4");
+  check(output == "id,x,name,y,r,t\n1,6,\"a,b\",3,2,9\n2,1,c,0,nan,1\n3,abc,d,1,nan,nan\n4,2.5,\"e\",0.5,5,3\n5,1,f,4,0.25,5\n",
+      "columns bound by name, quoted delimiters, failures and non-numbers as NaN, a last line without break");
+  check(csv.getRowCount() == 5, "rows are counted across batches");
+  
+  CsvEvaluator crlf;
+  crlf.addOutput(total, "t");
+  output = evaluate(crlf, "x,y\r\n1,2\r\n\r\n3,4\r\n");
+  check(output.find("1,2,3") != string::npos && output.find("3,4,7") != string::npos, "CRLF line breaks");
+  
+  CsvEvaluator semicolon(';');
+  semicolon.addOutput(total, "t");
+  output = evaluate(semicolon, "y;x\n0.5;0.25\n");
+  check(output == "y;x;t\n0.5;0.25;0.75\n", "another delimiter, columns in any order");
+  
+  CsvEvaluator missing;
+  missing.addOutput(ratio, "r");
+  check(THROWS(InvalidArgumentException, evaluate(missing, "x,z\n1,2\n")), "a variable without a column throws");
+  
+  CsvEvaluator empty;
+  empty.addOutput(ratio, "r");
+  check(evaluate(empty, "") == "" && empty.getRowCount() == 0, "an empty input gives an empty output");
+  
+  return failures;
+}
@@ -0,0 +1,243 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <string>
+#include <vector>
+
+#include <TangentsMathFunc.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Dispatch: every opcode against the same operations written in C++, bit for bit, through single calls, batches and
+ *  grids, on both backends at both tiers. Built both with threaded dispatch and with TANGENT_MATH_FUNC_SWITCH_DISPATCH,
+ *  so that both interpreters are held to the same results.
+ */
+
+#ifdef TANGENT_MATH_FUNC_THREADED_DISPATCH
+static const char* const DISPATCH = "threaded dispatch";
+#else
+static const char* const DISPATCH = "switch dispatch";
+#endif
+
+/*
+ * Values of the variables: dyadic, so that the polynomial rewrite of the optimized tier rounds nothing,
+ *  along with both zeros and NaN.
+ */
+static const double VALUES[] = {-2.5, -1, -0.0, 0, 0.5, 0.75, 1, 3, NAN, 2};
+
+/*
+ * Every combination of the values for the first 3 variables.
+ */
+static const int ROWS = 1000;
+
+static const int DIVISORS[] = {1, 10, 100};
+
+/*
+ * A formula, the opcodes it runs, and the same operations in C++.
+ */
+struct Case
+{
+  const char* declaration;
+  const char* formula;
+  const char* opcodes;
+  int varCount;
+  double (*reference)(const double* v);
+};
+
+static double arithmetic(const double* v)
+{
+  return -v[0] + v[1] * 2 - v[0] / (v[1] * v[1] + 1);
+}
+
+static double remainder(const double* v)
+{
+  return fmod(v[0], v[1] * v[1] + 1) + pow(v[0], v[1]);
+}
+
+static double comparisons(const double* v)
+{
+  double x = v[0];
+  double y = v[1];
+  return (x < y ? 1 : 0) + 2 * (x <= y ? 1 : 0) + 4 * (x > y ? 1 : 0) + 8 * (x >= y ? 1 : 0) + 16 * (x == y ? 1 : 0) + 32 * (x != y ? 1 : 0);
+}
+
+static double logic(const double* v)
+{
+  double x = v[0];
+  double y = v[1];
+  return (x != 0 && y != 0 ? 1 : 0) + 2 * (x != 0 || y != 0 ? 1 : 0) + 4 * (x == 0 ? 1 : 0) + 8 * (x != 0 && y == 0 ? 0 : 1);
+}
+
+static double selection(const double* v)
+{
+  return (v[0] > v[1] ? v[0] : v[1] * 2) + (v[2] != 0 ? 1 : 2);
+}
+
+static double polynomial(const double* v)
+{
+  return 2 * pow(v[0], 3) - v[0] * v[1] + 3 * pow(v[1], 2) + 1;
+}
+
+static double calls(const double* v)
+{
+  double t = v[0] + v[1];
+  return (t * t + t) - floor(v[0] / 2);
+}
+
+/*
+ * The accumulation order of the library, NaN winning in min() and max().
+ */
+static double reductions(const double* v)
+{
+  const double* w = v;
+  const double* u = v + 3;
+  double sum = w[0];
+  double product = u[0];
+  double dot = w[0] * u[0];
+  double lowest = w[0];
+  double highest = u[0];
+  for(int k = 1 ; k < 3 ; k++)
+  {
+    sum += w[k];
+    product *= u[k];
+    dot += w[k] * u[k];
+    lowest = (w[k] < lowest || w[k] != w[k] ? w[k] : lowest);
+    highest = (u[k] > highest || u[k] != u[k] ? u[k] : highest);
+  }
+  return sum + 2 * product + 4 * dot - lowest + highest;
+}
+
+static const Case CASES[] = {
+  {"arithmetic(x, y)", "-x + y * 2 - x / (y * y + 1)", "constant, variable, negative, +, -, * and /", 2, arithmetic},
+  {"remainder(x, y)", "x % (y * y + 1) + x ^ y", "% and ^", 2, remainder},
+  {"comparisons(x, y)", "(x < y) + 2 * (x <= y) + 4 * (x > y) + 8 * (x >= y) + 16 * (x == y) + 32 * (x != y)", "comparisons", 2, comparisons},
+  {"logic(x, y)", "(x && y) + 2 * (x || y) + 4 * !x + 8 * !(x && !y)", "&&, || and !", 2, logic},
+  {"selection(x, y, z)", "if(x > y, x, y * 2) + select(z, 1, 2)", "selections", 3, selection},
+  {"polynomial(x, y)", "2 * x ^ 3 - x * y + 3 * y ^ 2 + 1", "multiply-adds of the polynomial rewrite", 2, polynomial},
+  {"calls(x, y)", "square(x + y) - floor(x / 2)", "calls, and stores of inlined arguments", 2, calls},
+  {"reductions(w[3], u[3])", "sum(w) + 2 * prod(u) + 4 * dot(w, u) - min(w) + max(u)", "sum, prod, dot, min and max", 6, reductions}
+};
+
+/*
+ * Whether two values are the same bit for bit, NaN being the same as NaN.
+ */
+static bool same(double a, double b)
+{
+  return (a == b && signbit(a) == signbit(b)) || (a != a && b != b);
+}
+
+/*
+ * Values of the variables of row "row", every combination of the first 3 being reached.
+ */
+static void fill(int row, int varCount, double* v)
+{
+  for(int k = 0 ; k < varCount ; k++)
+  {
+    v[k] = VALUES[(row / DIVISORS[k % 3] + 3 * k) % 10];
+  }
+}
+
+static void run(Backend backend, bool optimized, const char* suffix)
+{
+  MathFunction::setBackend(backend);
+  TierPolicy policy;
+  policy.enabled = !optimized;
+  policy.invocationThreshold = ~0ULL;
+  policy.rowThreshold = ~0ULL;
+  MathFunction::setTierPolicy(policy);
+  MathFunctionNamespace ns(&MathFunctionNamespace::getBuiltIns());
+  MathFunction square(ns, "square(t)", "t * t + t");
+  string name;
+  
+  for(const Case& c : CASES)
+  {
+    MathFunction func(ns, c.declaration, c.formula);
+    
+    // Single calls and batches over the same rows.
+    vector<vector<double>> columns(c.varCount, vector<double>(ROWS));
+    vector<double> expected(ROWS);
+    bool scalar = true;
+    vector<double> v(c.varCount);
+    for(int row = 0 ; row < ROWS ; row++)
+    {
+      fill(row, c.varCount, v.data());
+      for(int k = 0 ; k < c.varCount ; k++)
+      {
+        columns[k][row] = v[k];
+      }
+      expected[row] = c.reference(v.data());
+      scalar = scalar && same(func.invoke(v), expected[row]);
+    }
+    name = string(c.opcodes) + ": single calls give the results of C++, " + suffix;
+    check(scalar, name.c_str());
+    
+    vector<const double*> pointers(c.varCount);
+    for(int k = 0 ; k < c.varCount ; k++)
+    {
+      pointers[k] = columns[k].data();
+    }
+    vector<double> results(ROWS);
+    func.invokeBatch(pointers.data(), ROWS, results.data());
+    bool batch = true;
+    for(int row = 0 ; row < ROWS ; row++)
+    {
+      batch = batch && same(results[row], expected[row]);
+    }
+    name = string(c.opcodes) + ": batches give the results of C++, " + suffix;
+    check(batch, name.c_str());
+    
+    // Grids run the part not depending on the last variable through single calls of a program of its own.
+    vector<GridAxis> axes(c.varCount);
+    int points = 1;
+    for(int k = 0 ; k < c.varCount ; k++)
+    {
+      axes[k].count = (c.varCount <= 3 ? 10 : 3);
+      axes[k].start = -2.5 + 0.25 * k;
+      axes[k].stop = axes[k].start + 0.5 * (axes[k].count - 1);
+      points *= axes[k].count;
+    }
+    vector<double> grid(points);
+    func.invokeGrid(axes.data(), grid.data());
+    bool gridSame = true;
+    for(int i = 0 ; i < points ; i++)
+    {
+      int rest = i;
+      for(int k = c.varCount - 1 ; k >= 0 ; k--)
+      {
+        v[k] = axes[k].at(rest % axes[k].count);
+        rest /= axes[k].count;
+      }
+      gridSame = gridSame && same(grid[i], c.reference(v.data()));
+    }
+    name = string(c.opcodes) + ": grids give the results of C++, " + suffix;
+    check(gridSame, name.c_str());
+  }
+  
+  // Both zeros divide by zero, through the handlers of / and % alike.
+  MathFunction ratio(ns, "ratio(x, y)", "x / y");
+  MathFunction modulo(ns, "modulo(x, y)", "x % y");
+  name = string("dividing by either zero throws, ") + suffix;
+  check(THROWS(DividedByZeroException, ratio.invoke({1, 0})) && THROWS(DividedByZeroException, ratio.invoke({1, -0.0}))
+      && THROWS(DividedByZeroException, modulo.invoke({1, 0})) && THROWS(DividedByZeroException, modulo.invoke({1, -0.0}))
+      && ratio.invoke({1, 4}) == 0.25 && modulo.invoke({7, 4}) == 3, name.c_str());
+}
+
+int main(int argc, char* argv[])
+{
+  string suffix = string(DISPATCH) + ", ";
+  run(BACKEND_STACK, false, (suffix + "stack backend, baseline tier").c_str());
+  run(BACKEND_STACK, true, (suffix + "stack backend, optimized tier").c_str());
+  run(BACKEND_REGISTER, false, (suffix + "register backend, baseline tier").c_str());
+  run(BACKEND_REGISTER, true, (suffix + "register backend, optimized tier").c_str());
+  MathFunction::setBackend(BACKEND_STACK);
+  MathFunction::setTierPolicy(TierPolicy());
+  return failures;
+}
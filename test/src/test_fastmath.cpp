@@ -0,0 +1,153 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <misc/FastMath.hpp>
+#include <TangentsMathFunc.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Accuracy of the fast built-ins: the scalar and batch forms of FastMath, and the built-ins of a function at PRECISION_FAST,
+ *  within the bounds of FastMath.hpp on random arguments, inside and outside of the fast domains.
+ */
+
+static const int ROWS = 200000;
+
+/*
+ * A built-in checked over a range of arguments. Those of "logarithmic" cases are e^u for u uniform within the bounds.
+ */
+struct AccuracyCase
+{
+  const char* name;
+  double (*scalar)(double);
+  void (*batch)(const double*, int, double*);
+  long double (*reference)(long double);
+  double lower;
+  double upper;
+  bool logarithmic;
+  int maxUlp;
+};
+
+static const AccuracyCase CASES[] = {
+  {"sin", FastMath::sin, FastMath::sinBatch, sinl, -10, 10, false, FastMath::SIN_COS_MAX_ULP},
+  {"sin", FastMath::sin, FastMath::sinBatch, sinl, -1e5, 1e5, false, FastMath::SIN_COS_MAX_ULP},
+  {"cos", FastMath::cos, FastMath::cosBatch, cosl, -10, 10, false, FastMath::SIN_COS_MAX_ULP},
+  {"cos", FastMath::cos, FastMath::cosBatch, cosl, -1e5, 1e5, false, FastMath::SIN_COS_MAX_ULP},
+  {"tan", FastMath::tan, FastMath::tanBatch, tanl, -10, 10, false, FastMath::TAN_MAX_ULP},
+  {"tan", FastMath::tan, FastMath::tanBatch, tanl, -1e5, 1e5, false, FastMath::TAN_MAX_ULP},
+  {"exp", FastMath::exp, FastMath::expBatch, expl, -708, 709, false, FastMath::EXP_MAX_ULP},
+  {"ln", FastMath::log, FastMath::logBatch, logl, -700, 700, true, FastMath::LOG_MAX_ULP}
+};
+
+/*
+ * Distance from the reference in units in the last place of the reference rounded to double.
+ */
+static double ulpError(double value, long double reference)
+{
+  double rounded = (double)reference;
+  if(value == rounded || (isnan(value) && isnan(rounded)))
+  {
+    return 0;
+  }
+  if(!isfinite(value) || !isfinite(rounded))
+  {
+    return INFINITY;
+  }
+  double ulp = nextafter(fabs(rounded), INFINITY) - fabs(rounded);
+  return (double)(fabsl((long double)value - reference) / ulp);
+}
+
+/*
+ * Largest error of the values of a case over the arguments.
+ */
+static double maxError(const AccuracyCase& test, const vector<double>& xs, const vector<double>& values)
+{
+  double worst = 0;
+  for(size_t i = 0 ; i < xs.size() ; i++)
+  {
+    worst = fmax(worst, ulpError(values[i], test.reference(xs[i])));
+  }
+  return worst;
+}
+
+int main(int argc, char* argv[])
+{
+  TierPolicy policy;
+  policy.enabled = false;
+  MathFunction::setTierPolicy(policy);
+  
+  mt19937_64 rng(65536);
+  vector<double> xs(ROWS);
+  vector<double> scalar(ROWS);
+  vector<double> batch(ROWS);
+  vector<double> fast(ROWS);
+  char what[128];
+  for(const AccuracyCase& test : CASES)
+  {
+    uniform_real_distribution<double> uniform(test.lower, test.upper);
+    for(int i = 0 ; i < ROWS ; i++)
+    {
+      double u = uniform(rng);
+      xs[i] = (test.logarithmic ? exp(u) : u);
+    }
+    
+    for(int i = 0 ; i < ROWS ; i++)
+    {
+      scalar[i] = test.scalar(xs[i]);
+    }
+    test.batch(xs.data(), ROWS, batch.data());
+    MathFunction func(string("fast_") + test.name + "(x)", string(test.name) + "(x)");
+    func.setPrecision(PRECISION_FAST);
+    const double* columns[] = {xs.data()};
+    func.invokeBatch(columns, ROWS, fast.data());
+    
+    double scalarError = maxError(test, xs, scalar);
+    double batchError = maxError(test, xs, batch);
+    double fastError = maxError(test, xs, fast);
+    snprintf(what, sizeof(what), "%s over [%g, %g] within %d ULP: scalar %.3f, batch %.3f, PRECISION_FAST %.3f",
+        test.name, test.lower, test.upper, test.maxUlp, scalarError, batchError, fastError);
+    check(scalarError <= test.maxUlp && batchError <= test.maxUlp && fastError <= test.maxUlp, what);
+  }
+  
+  // Outside of the fast domains, in blocks mixing both kinds of arguments, the standard library gives the values.
+  double special[] = {2e5, -1e300, 710, -745, 1e-310, 0, -1, INFINITY, -INFINITY, NAN, 1.5, -2.5};
+  int count = sizeof(special) / sizeof(special[0]);
+  const AccuracyCase* mixed[] = {&CASES[0], &CASES[2], &CASES[4], &CASES[6], &CASES[7]};
+  for(const AccuracyCase* test : mixed)
+  {
+    vector<double> values(count);
+    test->batch(special, count, values.data());
+    bool exact = true;
+    for(int i = 0 ; i < count ; i++)
+    {
+      long double reference = test->reference(special[i]);
+      exact = exact && ulpError(values[i], reference) <= test->maxUlp && ulpError(test->scalar(special[i]), reference) <= test->maxUlp;
+    }
+    snprintf(what, sizeof(what), "%s of huge, subnormal, infinite and NaN arguments within %d ULP", test->name, test->maxUlp);
+    check(exact, what);
+  }
+  
+  // atan has no approximation, and stays exact at PRECISION_FAST.
+  MathFunction arcTangent("fast_atan(x)", "atan(x)");
+  arcTangent.setPrecision(PRECISION_FAST);
+  bool exact = true;
+  for(int i = -40 ; i <= 40 ; i++)
+  {
+    exact = exact && arcTangent.invoke({i * 0.37}) == atan(i * 0.37);
+  }
+  check(exact, "atan is the standard library's at PRECISION_FAST");
+  
+  MathFunction::setTierPolicy(TierPolicy());
+  return failures;
+}
@@ -0,0 +1,162 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <TangentsMathFunc.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Filters: the rows kept by filterBatch() and filterMask() against invoke() row by row, selections, chaining in place,
+ *  NaN taken as false, and the bits of the last word beyond the rows, on both backends.
+ */
+
+/*
+ * Not a multiple of 64, and longer than a block.
+ */
+static const int ROWS = 1000;
+
+static const int WORDS = (ROWS + 63) / 64;
+
+/*
+ * The rows of "candidates" for which "func" is neither 0 nor NaN, computed with invoke().
+ */
+static vector<int> expect(const MathFunction& func, const vector<double>& xs, const vector<double>& ys, const vector<int>& candidates)
+{
+  vector<int> kept;
+  for(int row : candidates)
+  {
+    double value = func.invoke({xs[row], ys[row]});
+    if(value != 0 && value == value)
+    {
+      kept.push_back(row);
+    }
+  }
+  return kept;
+}
+
+/*
+ * The bitmask of the rows.
+ */
+static vector<uint64_t> toMask(const vector<int>& rows)
+{
+  vector<uint64_t> mask(WORDS, 0);
+  for(int row : rows)
+  {
+    mask[row / 64] |= (uint64_t)1 << (row % 64);
+  }
+  return mask;
+}
+
+static void run(Backend backend, const char* suffix)
+{
+  MathFunction::setBackend(backend);
+  MathFunctionNamespace ns(&MathFunctionNamespace::getBuiltIns());
+  MathFunction inside(ns, "inside(x, y)", "x ^ 2 + y ^ 2 < 1");
+  MathFunction above(ns, "above(x, y)", "y - x");
+  MathFunction root(ns, "root(x, y)", "x ^ 0.5");
+  string name;
+  
+  mt19937_64 rng(65536);
+  uniform_real_distribution<double> uniform(-1.5, 1.5);
+  vector<double> xs(ROWS);
+  vector<double> ys(ROWS);
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    xs[i] = (i % 11 == 0 ? 0 : uniform(rng));
+    ys[i] = (i % 13 == 0 ? xs[i] : uniform(rng));
+  }
+  // Rows where "above" is NaN, and rows where it is -0.
+  ys[5] = NAN;
+  xs[6] = NAN;
+  xs[7] = 0;
+  ys[7] = -0.0;
+  const double* columns[] = {xs.data(), ys.data()};
+  vector<int> all(ROWS);
+  vector<int> even;
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    all[i] = i;
+    if(i % 2 == 0)
+    {
+      even.push_back(i);
+    }
+  }
+  
+  // Indices kept, in order.
+  vector<int> kept(ROWS, -1);
+  int count = inside.filterBatch(columns, ROWS, nullptr, kept.data());
+  vector<int> expected = expect(inside, xs, ys, all);
+  name = string("filterBatch() keeps the rows where the function holds, in order, ") + suffix;
+  check(count == (int)(expected.size()) && count > 0 && count < ROWS && vector<int>(kept.begin(), kept.begin() + count) == expected, name.c_str());
+  
+  count = above.filterBatch(columns, ROWS, nullptr, kept.data());
+  expected = expect(above, xs, ys, all);
+  name = string("NaN and -0 are false, ") + suffix;
+  check(count == (int)(expected.size()) && vector<int>(kept.begin(), kept.begin() + count) == expected
+      && find(kept.begin(), kept.begin() + count, 5) == kept.begin() + count && find(kept.begin(), kept.begin() + count, 6) == kept.begin() + count
+      && find(kept.begin(), kept.begin() + count, 7) == kept.begin() + count, name.c_str());
+  count = root.filterBatch(columns, ROWS, nullptr, kept.data());
+  expected = expect(root, xs, ys, all);
+  name = string("a function giving NaN for some rows keeps the others, ") + suffix;
+  check(count == (int)(expected.size()) && vector<int>(kept.begin(), kept.begin() + count) == expected, name.c_str());
+  
+  // A selection, then chaining in place, the second filter reading the rows the first one kept.
+  vector<int> selection(even);
+  count = inside.filterBatch(columns, (int)(selection.size()), selection.data(), kept.data());
+  expected = expect(inside, xs, ys, even);
+  name = string("filterBatch() tests the rows of the selection only, ") + suffix;
+  check(count == (int)(expected.size()) && vector<int>(kept.begin(), kept.begin() + count) == expected, name.c_str());
+  count = inside.filterBatch(columns, (int)(selection.size()), selection.data(), selection.data());
+  int chained = above.filterBatch(columns, count, selection.data(), selection.data());
+  expected = expect(above, xs, ys, expect(inside, xs, ys, even));
+  name = string("filters chain in place, the kept rows aliasing the selection, ") + suffix;
+  check(chained == (int)(expected.size()) && vector<int>(selection.begin(), selection.begin() + chained) == expected, name.c_str());
+  
+  // Bitmasks, the last word being partly beyond the rows.
+  vector<uint64_t> mask(WORDS, ~(uint64_t)0);
+  count = inside.filterMask(columns, ROWS, nullptr, mask.data());
+  expected = expect(inside, xs, ys, all);
+  name = string("filterMask() sets the bits of the rows kept, and clears those beyond the last row, ") + suffix;
+  check(count == (int)(expected.size()) && mask == toMask(expected) && (mask[WORDS - 1] >> (ROWS % 64)) == 0, name.c_str());
+  
+  vector<uint64_t> full(WORDS, ~(uint64_t)0);
+  vector<uint64_t> fromFull(WORDS);
+  int fromFullCount = above.filterMask(columns, ROWS, full.data(), fromFull.data());
+  expected = expect(above, xs, ys, all);
+  name = string("bits of the selection beyond the rows are ignored, ") + suffix;
+  check(fromFullCount == (int)(expected.size()) && fromFull == toMask(expected), name.c_str());
+  
+  vector<uint64_t> evenMask = toMask(even);
+  count = inside.filterMask(columns, ROWS, evenMask.data(), evenMask.data());
+  int chainedMask = above.filterMask(columns, ROWS, evenMask.data(), evenMask.data());
+  expected = expect(above, xs, ys, expect(inside, xs, ys, even));
+  name = string("masks chain in place, and match the indices of filterBatch(), ") + suffix;
+  check(chainedMask == chained && evenMask == toMask(expected) && count == (int)(expect(inside, xs, ys, even).size()), name.c_str());
+  
+  // Empty and invalid inputs.
+  vector<uint64_t> none(WORDS, 0);
+  name = string("no rows, or an empty selection, keep nothing, and a negative count throws, ") + suffix;
+  check(inside.filterBatch(columns, 0, nullptr, kept.data()) == 0 && inside.filterMask(columns, ROWS, none.data(), mask.data()) == 0
+      && mask == none && THROWS(InvalidArgumentException, inside.filterBatch(columns, -1, nullptr, kept.data()))
+      && THROWS(InvalidArgumentException, inside.filterMask(columns, -1, nullptr, mask.data())), name.c_str());
+}
+
+int main(int argc, char* argv[])
+{
+  run(BACKEND_STACK, "stack backend");
+  run(BACKEND_REGISTER, "register backend");
+  MathFunction::setBackend(BACKEND_STACK);
+  return failures;
+}
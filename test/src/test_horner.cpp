@@ -0,0 +1,100 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <random>
+
+#include <TangentsMathFunc.hpp>
+
+using namespace std;
+
+/*
+ * Accuracy of the polynomial rewrite: every formula is compiled twice, once at the baseline tier as written and once
+ *  optimized, i.e. in Horner form, and both are evaluated on the same random points, by invoke() and invokeBatch().
+ */
+
+static const int POINTS = 100000;
+
+/*
+ * Allowed difference, relative to the value or to 1 for values smaller than 1.
+ */
+static const double TOLERANCE = 1e-12;
+
+static const char* const FORMULAS[][2] = {
+  {"p0(x, y)", "9*x^2 + 6*x*y + y^2 - 3*x - y - 1"},
+  {"p1(x)", "x^5 - 3*x^3 + 2*x - 7"},
+  {"p2(x, y, z)", "x^3*y - 2*x^2*y*z + 4*y^2*z^2 - x*z + 0.5*z^3 - 1.25"},
+  {"p3(x, y)", "(x + 1)^3 * (y - 2)^2 + x*y*(x - y)"},
+  {"p4(x, y)", "-x^3 + x*(y - 1)^2 - 2"},
+  {"p5(x)", "1 + x*(1 + x*(0.5 + x*(1/6 + x/24)))"},
+  {"r0(x, y)", "(x^2 + y^2 + 1) / (x^2 + 2)"},
+  {"r1(x, y, z)", "(2*x^3 - x*y + 3) / (y^2 + z^4 + 1) - z^2"},
+  {"m0(x)", "sin(x)^2 + 3*x^4 - x"}
+};
+
+int main(int argc, char* argv[])
+{
+  int failures = 0;
+  mt19937_64 rng(65536);
+  uniform_real_distribution<double> uniform(-3.0, 3.0);
+  
+  for(const auto& formula : FORMULAS)
+  {
+    // The reference stays at the baseline tier, which compiles the formula as it is written.
+    TierPolicy policy;
+    policy.invocationThreshold = ~0ULL;
+    policy.rowThreshold = ~0ULL;
+    MathFunction::setTierPolicy(policy);
+    MathFunction reference(formula[0], formula[1]);
+    
+    policy.enabled = false;
+    MathFunction::setTierPolicy(policy);
+    MathFunction factored(string("h_") + formula[0], formula[1]);
+    
+    int varCount = reference.getIdentifier().getVariablesCount();
+    double* columns[3];
+    for(int i = 0 ; i < varCount ; i++)
+    {
+      columns[i] = new double[POINTS];
+      for(int j = 0 ; j < POINTS ; j++)
+      {
+        columns[i][j] = uniform(rng);
+      }
+    }
+    double* expected = new double[POINTS];
+    double* actual = new double[POINTS];
+    reference.invokeBatch(columns, POINTS, expected);
+    factored.invokeBatch(columns, POINTS, actual);
+    
+    double worst = 0;
+    for(int j = 0 ; j < POINTS ; j++)
+    {
+      double scalar = (varCount == 1 ? factored.invoke({columns[0][j]})
+          : (varCount == 2 ? factored.invoke({columns[0][j], columns[1][j]}) : factored.invoke({columns[0][j], columns[1][j], columns[2][j]})));
+      double scale = fmax(fabs(expected[j]), 1.0);
+      worst = fmax(worst, fabs(actual[j] - expected[j]) / scale);
+      worst = fmax(worst, fabs(scalar - expected[j]) / scale);
+    }
+    
+    bool passed = (worst <= TOLERANCE);
+    failures += (passed ? 0 : 1);
+    fprintf(stdout, "%-4s %-56s %3d -> %3d instructions, max error %.3g\n", (passed ? "OK" : "FAIL"), formula[1],
+        reference.getMemoryUsage().instructions, factored.getMemoryUsage().instructions, worst);
+    
+    for(int i = 0 ; i < varCount ; i++)
+    {
+      delete[] columns[i];
+    }
+    delete[] expected;
+    delete[] actual;
+  }
+  
+  MathFunction::setTierPolicy(TierPolicy());
+  return (failures == 0 ? 0 : 1);
+}
@@ -0,0 +1,72 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <Integrator.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Adaptive integration against closed forms, over one to four variables.
+ */
+
+int main(int argc, char* argv[])
+{
+  const double PI = acos(-1.0);
+  Integrator integrator(1e-10, 1e-10);
+  
+  MathFunction f("f(x, y)", "sin(x) * y");
+  double point[] = {0, 2};
+  IntegrationResult r = integrator.integrate(f, "x", 0, PI, point);
+  check(r.converged && near(r.value, 4.0, 1e-9) && r.error <= 1e-9, "integral of sin(x) * y over [0, pi] at y = 2");
+  
+  r = integrator.integrate(f, "x", PI, 0, point);
+  check(r.converged && near(r.value, -4.0, 1e-9), "reversed bounds negate the integral");
+  
+  MathFunction g("g(x, y)", "x * y ^ 2");
+  double lower[] = {0, -1};
+  double upper[] = {2, 1};
+  r = integrator.integrate(g, {"x", "y"}, lower, upper);
+  check(r.converged && near(r.value, 4.0 / 3.0, 1e-9), "double integral of x * y^2 over [0, 2] x [-1, 1]");
+  
+  MathFunction gauss("gauss(x, y, z, w)", "exp(-(x^2 + y^2 + z^2 + w^2))");
+  double lower4[] = {-1, -1, -1, -1};
+  double upper4[] = {1, 1, 1, 1};
+  Integrator coarse(1e-7, 1e-7, 200000);
+  r = coarse.integrate(gauss, {"x", "y", "z", "w"}, lower4, upper4);
+  double side = sqrt(PI) * erf(1.0);
+  check(r.converged && near(r.value, side * side * side * side, 1e-6), "four-dimensional Gaussian over the unit box");
+  
+  // A peak the first rule misses entirely, found by splitting.
+  MathFunction peak("peak(x)", "1 / (0.0001 + (x - 0.3)^2)");
+  r = integrator.integrate(peak, "x", 0, 1);
+  double expected = 100 * (atan(0.7 / 1e-2) + atan(0.3 / 1e-2));
+  check(r.converged && near(r.value, expected, 1e-8) && r.regions > 1, "a sharp peak is resolved by adaptive splitting");
+  
+  Integrator capped(1e-14, 1e-14, 4);
+  r = capped.integrate(peak, "x", 0, 1);
+  check(!r.converged && r.regions <= 4, "hitting the region limit is reported as not converged");
+  
+  MathFunction root("root(x)", "(x - 0.5) ^ 0.5");
+  r = integrator.integrate(root, "x", 0, 1);
+  check(!r.converged, "an integrand not finite somewhere is reported as not converged");
+  
+  MathFunction pole("pole(x)", "1 / x");
+  check(THROWS(DividedByZeroException, integrator.integrate(pole, "x", -1, 1)), "an error of the integrand is thrown");
+  
+  // Rounds of thousands of nodes are spread over the threads.
+  r = Integrator(1e-7, 1e-7, 200000, 4).integrate(gauss, {"x", "y", "z", "w"}, lower4, upper4);
+  IntegrationResult single = Integrator(1e-7, 1e-7, 200000, 1).integrate(gauss, {"x", "y", "z", "w"}, lower4, upper4);
+  check(r.value == single.value && r.regions == single.regions && r.evaluations == single.evaluations, "threads do not change the result");
+  
+  check(THROWS(InvalidArgumentException, integrator.integrate(f, "z", 0, 1, point)), "an unknown variable throws");
+  check(THROWS(InvalidArgumentException, Integrator(-1.0)), "a negative tolerance throws");
+  
+  return failures;
+}
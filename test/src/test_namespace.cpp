@@ -0,0 +1,92 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <TangentsMathFunc.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Namespaces: lookups through layers and their parents, and what a layer may not see, frozen namespaces,
+ *  and the built-ins found by their compile-time perfect hash.
+ */
+
+int main(int argc, char* argv[])
+{
+  MathFunctionNamespace lib(&MathFunctionNamespace::getBuiltIns());
+  MathFunction sq(lib, "sq(x)", "sin(x) ^ 2");
+  MathFunction offset(lib, "offset(x)", "x + 100");
+  
+  MathFunctionNamespace tenant(&lib);
+  check(tenant.getParent() == &lib && lib.getParent() == &MathFunctionNamespace::getBuiltIns(), "each layer knows its parent");
+  check(tenant.getMemoryUsage().functions == 0 && tenant.getMemoryUsage().tableBytes == sizeof(MathFunctionNamespace), "an empty layer holds no table");
+  
+  MathFunction f(tenant, "f(x)", "sq(x) + cos(x) ^ 2");
+  check(near(f.invoke({0.7}), 1, 1e-15), "a child sees the functions of its parent and of the built-ins");
+  
+  // A function of the child hides the one of the parent, in the child only.
+  MathFunction hiding(tenant, "offset(x)", "x + 1");
+  MathFunction g(tenant, "g(x)", "offset(x)");
+  MathFunction h(lib, "h(x)", "offset(x)");
+  check(g.invoke({1}) == 2 && h.invoke({1}) == 101, "a function of the child hides the one of its parent, in the child only");
+  check(lib.getMemoryUsage().functions == 3 && tenant.getMemoryUsage().functions == 3, "declaring into the child leaves the parent as it was");
+  
+  // Siblings and the parent do not see into a child.
+  MathFunctionNamespace sibling(&lib);
+  check(THROWS(InvalidFormulaException, MathFunction(sibling, "k(x)", "f(x)")), "a sibling does not see the functions of another child");
+  check(THROWS(InvalidFormulaException, MathFunction(lib, "k(x)", "g(x)")), "a parent does not see the functions of its child");
+  MathFunctionNamespace alone;
+  MathFunctionNamespace other;
+  MathFunction a(alone, "a(x)", "x * 2");
+  check(THROWS(InvalidFormulaException, MathFunction(other, "b(x)", "a(x)")), "independent namespaces do not see each other");
+  
+  // Callees are resolved when parsing, so a function declared into the parent later is seen by later formulas only.
+  MathFunction early(tenant, "early(x)", "x");
+  MathFunction late(lib, "late(x)", "x * 3");
+  MathFunction user(tenant, "user(x)", "late(x) + early(x)");
+  check(user.invoke({2}) == 8, "a function declared into the parent afterwards is seen by formulas parsed afterwards");
+  
+  // A grandchild sees every ancestor, the nearest definition winning.
+  MathFunctionNamespace grandchild(&tenant);
+  MathFunction deep(grandchild, "deep(x)", "offset(x) + late(x) + sq(0)");
+  check(deep.invoke({1}) == 2 + 3, "a grandchild sees its parent first, then its grandparent");
+  
+  // Built-ins, each one resolving to its own function.
+  MathFunction floors(tenant, "floors(x)", "floor(x)");
+  MathFunction ceils(tenant, "ceils(x)", "ceil(x)");
+  check(floors.invoke({2.7}) == 2 && floors.invoke({-2.5}) == -3 && ceils.invoke({2.2}) == 3 && ceils.invoke({-2.5}) == -2, "floor is not ceil");
+  MathFunction logs(tenant, "logs(x)", "log(x) - log10(x)");
+  MathFunction bases(tenant, "bases(b, x)", "log(b, x)");
+  check(logs.invoke({1000}) == 0 && near(bases.invoke({2, 8}), 3, 1e-15), "log of one argument is log10, log of two takes the base first");
+  MathFunction every(tenant, "every(x)", "sin(x) + cos(x) + tan(x) + sinh(x) + cosh(x) + tanh(x) + asin(x) + acos(x) + atan(x) + atan2(x, 2) + exp(x) + ln(x)");
+  double x = 0.3;
+  check(every.invoke({x}) == sin(x) + cos(x) + tan(x) + sinh(x) + cosh(x) + tanh(x) + asin(x) + acos(x) + atan(x) + atan2(x, 2.0) + exp(x) + log(x),
+      "every other built-in resolves to its own function");
+  check(MathFunctionNamespace::getBuiltIns().isFrozen(), "the built-ins are frozen");
+  
+  // Frozen namespaces: lookups go on, declarations throw.
+  MathFunction twin(lib, "twin(x)", "x + 1");
+  MathFunction twin2(lib, "twin(x, y)", "x + y");
+  MathFunction* doomed = new MathFunction(lib, "doomed(x)", "x");
+  lib.freeze();
+  lib.freeze();
+  check(lib.isFrozen() && !tenant.isFrozen(), "freezing applies to the namespace only, and twice does nothing more");
+  check(THROWS(InvalidArgumentException, MathFunction(lib, "k(x)", "x")), "declaring into a frozen namespace throws");
+  MathFunction after(tenant, "after(x)", "sq(x) + twin(x) + twin(x, 10) + late(x)");
+  check(after.invoke({1}) == sq.invoke({1}) + 2 + 11 + 3, "a child finds the functions of a frozen parent, by name and number of arguments");
+  twin.redefine("x + 2");
+  check(after.invoke({1}) == sq.invoke({1}) + 3 + 11 + 3, "a function of a frozen namespace may be redefined, recompiling its callers");
+  delete doomed;
+  check(THROWS(InvalidFormulaException, MathFunction(tenant, "k(x)", "doomed(x)")), "a function destroyed in a frozen namespace is no longer found");
+  MathFunctionNamespace layer(&lib);
+  MathFunction fresh(layer, "fresh(x)", "twin(x) * 2");
+  check(fresh.invoke({1}) == 6, "a layer over a frozen namespace takes declarations");
+  
+  return failures;
+}
@@ -0,0 +1,176 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <string>
+#include <vector>
+
+#include <EvaluationPlan.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Comparison and logical operators and selections: precedence, short formulas, folded selections,
+ *  and divisions by zero guarded by a selection, on both backends at both tiers.
+ */
+
+static const int ROWS = 1000;
+
+/*
+ * Whether two values are the same bit for bit, NaN being the same as NaN.
+ */
+static bool same(double a, double b)
+{
+  return (a == b && signbit(a) == signbit(b)) || (a != a && b != b);
+}
+
+/*
+ * Whether a batch over "xs" gives the results of invoke() row by row.
+ */
+static bool batchMatches(const MathFunction& func, const vector<double>& xs)
+{
+  vector<double> results(xs.size());
+  const double* columns[] = {xs.data()};
+  func.invokeBatch(columns, (int)(xs.size()), results.data());
+  for(size_t i = 0 ; i < xs.size() ; i++)
+  {
+    if(!same(results[i], func.invoke({xs[i]})))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void run(Backend backend, bool optimized, const char* suffix)
+{
+  MathFunction::setBackend(backend);
+  TierPolicy policy;
+  policy.enabled = !optimized;
+  policy.invocationThreshold = ~0ULL;
+  policy.rowThreshold = ~0ULL;
+  MathFunction::setTierPolicy(policy);
+  MathFunctionNamespace ns(&MathFunctionNamespace::getBuiltIns());
+  string name;
+  
+  // Precedence as in C: arithmetic, then comparisons, then equality, then && and ||, the unary ! binding tightest.
+  MathFunction less(ns, "less(a, b)", "a < b + 1");
+  MathFunction notEqual(ns, "notEqual(x)", "!x == 0");
+  MathFunction notPlus(ns, "notPlus(x)", "!x + 1");
+  MathFunction andOr(ns, "andOr(a, b, c)", "a || b && c");
+  MathFunction orAnd(ns, "orAnd(a, b, c)", "a && b || c");
+  MathFunction chain(ns, "chain(a, b)", "a + 1 < b * 2 == 1");
+  name = string("a < b + 1 compares with the sum, ") + suffix;
+  check(less.invoke({2, 1}) == 0 && less.invoke({1.5, 1}) == 1, name.c_str());
+  name = string("!x == 0 is (!x) == 0, and !x + 1 is (!x) + 1, ") + suffix;
+  check(notEqual.invoke({5}) == 1 && notEqual.invoke({0}) == 0 && notPlus.invoke({0}) == 2 && notPlus.invoke({-3}) == 1, name.c_str());
+  name = string("&& binds tighter than ||, ") + suffix;
+  check(andOr.invoke({1, 0, 0}) == 1 && andOr.invoke({0, 1, 0}) == 0 && orAnd.invoke({0, 0, 1}) == 1 && orAnd.invoke({1, 0, 0}) == 0, name.c_str());
+  name = string("comparisons bind tighter than equality, looser than arithmetic, ") + suffix;
+  check(chain.invoke({1, 1.5}) == 1 && chain.invoke({2, 1.5}) == 0, name.c_str());
+  
+  // Formulas of an operand or two, without spaces, and truncated operators.
+  MathFunction one(ns, "one(x)", "!x");
+  MathFunction two(ns, "two(x, y)", "x<y");
+  MathFunction three(ns, "three(x, y)", "x!=y");
+  MathFunction four(ns, "four(x, y)", "x>=y");
+  name = string("short formulas parse, ") + suffix;
+  check(one.invoke({0}) == 1 && two.invoke({1, 2}) == 1 && three.invoke({1, 1}) == 0 && four.invoke({1, 1}) == 1, name.c_str());
+  name = string("a lone '=', '&' or '|', and a misplaced '!', throw, ") + suffix;
+  check(THROWS(InvalidFormulaException, MathFunction(ns, "bad(x)", "x=1")) && THROWS(InvalidFormulaException, MathFunction(ns, "bad(x)", "x&1"))
+      && THROWS(InvalidFormulaException, MathFunction(ns, "bad(x)", "x|1")) && THROWS(InvalidFormulaException, MathFunction(ns, "bad(x)", "x!")), name.c_str());
+  MathFunction dangling(ns, "dangling(x)", "x<");
+  MathFunction lone(ns, "lone(x)", "!");
+  MathFunction plus(ns, "plus(x)", "x+");
+  name = string("an operator missing its operand gives NaN, as arithmetic does, ") + suffix;
+  check(isnan(dangling.invoke({1})) && isnan(lone.invoke({1})) && isnan(plus.invoke({1})), name.c_str());
+  
+  // Selections of constants are folded into their value by the optimized tier, with the same result either way.
+  MathFunction folded(ns, "folded(x)", "if(3 > 2, 4, 5) + select(0, 6, 7)");
+  MathFunction undefined(ns, "undefined(x)", "if((0 - 1) ^ 0.5, 8, 9)");
+  MathFunction kept(ns, "kept(x)", "if(x, 2, 3)");
+  name = string("selections of constants pick their operand, NaN being true, ") + suffix;
+  check(folded.invoke({0}) == 11 && undefined.invoke({0}) == 8 && kept.invoke({0}) == 3 && kept.invoke({NAN}) == 2, name.c_str());
+  if(optimized)
+  {
+    name = string("selections of constants are folded, ") + suffix;
+    check(folded.getMemoryUsage().instructions == 1 && undefined.getMemoryUsage().instructions == 1 && kept.getMemoryUsage().instructions == 4, name.c_str());
+  }
+  
+  // Divisions by zero in a branch not taken, directly and through calls, against those whose value is used.
+  MathFunction inverse(ns, "inverse(x)", "if(x == 0, 0, 1 / x)");
+  MathFunction reverse(ns, "reverse(x)", "select(x != 0, 1 / x, -1) + if(x == 0, 2, 3 % x)");
+  MathFunction callee(ns, "callee(x)", "1 / x");
+  MathFunction caller(ns, "caller(x)", "if(x == 0, 0, callee(x)) + if(x, callee(x), 0)");
+  MathFunction nested(ns, "nested(x)", "if(x == 1, 0, if(x == -1, 0, 1 / (x * x - 1)))");
+  MathFunction taken(ns, "taken(x)", "if(x == 0, 1 / x, 0)");
+  MathFunction condition(ns, "condition(x)", "if(1 / x > 0, 1, 2)");
+  MathFunction wasted(ns, "wasted(x)", "if(x == 0, 0, 1) * (1 / x)");
+  name = string("a division by zero in a branch not taken is dropped, ") + suffix;
+  check(inverse.invoke({0}) == 0 && inverse.invoke({4}) == 0.25 && reverse.invoke({0}) == 1 && reverse.invoke({2}) == 1.5
+      && caller.invoke({0}) == 0 && caller.invoke({2}) == 1 && nested.invoke({1}) == 0 && nested.invoke({-1}) == 0, name.c_str());
+  name = string("a division by zero in the branch taken, in a condition, or outside a selection throws, ") + suffix;
+  check(THROWS(DividedByZeroException, taken.invoke({0})) && THROWS(DividedByZeroException, condition.invoke({0}))
+      && THROWS(DividedByZeroException, wasted.invoke({0})) && taken.invoke({1}) == 0 && condition.invoke({-1}) == 2, name.c_str());
+  
+  // Batches run blocks holding a zero again row by row, and give the results of single calls.
+  vector<double> xs(ROWS);
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    xs[i] = (i % 7 == 3 ? 0 : (i % 5 == 0 ? 1 : 0.01 * i - 5));
+  }
+  name = string("batches of guarded divisions give the results of single calls, ") + suffix;
+  check(batchMatches(inverse, xs) && batchMatches(reverse, xs) && batchMatches(caller, xs) && batchMatches(nested, xs), name.c_str());
+  vector<double> results(ROWS);
+  const double* columns[] = {xs.data()};
+  name = string("batches dividing by zero in the branch taken throw, ") + suffix;
+  check(THROWS(DividedByZeroException, taken.invokeBatch(columns, ROWS, results.data()))
+      && THROWS(DividedByZeroException, wasted.invokeBatch(columns, ROWS, results.data())), name.c_str());
+  
+  // Grids and plans run their rows again the same way.
+  GridAxis axis = {-2, 2, 5};
+  double grid[5];
+  inverse.invokeGrid(&axis, grid);
+  EvaluationPlan plan({&inverse, &reverse});
+  double row[] = {0};
+  double values[2];
+  plan.run(row, values);
+  vector<double> outputs0(ROWS);
+  vector<double> outputs1(ROWS);
+  double* outputs[] = {outputs0.data(), outputs1.data()};
+  plan.runBatch(columns, ROWS, outputs);
+  bool planSame = true;
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    planSame = planSame && same(outputs0[i], inverse.invoke({xs[i]})) && same(outputs1[i], reverse.invoke({xs[i]}));
+  }
+  name = string("grids and plans drop a division by zero in a branch not taken, ") + suffix;
+  check(grid[0] == -0.5 && grid[2] == 0 && grid[4] == 0.5 && values[0] == 0 && values[1] == 1 && planSame, name.c_str());
+  EvaluationPlan failing({&inverse, &taken});
+  name = string("a plan dividing by zero in the branch taken throws, ") + suffix;
+  check(THROWS(DividedByZeroException, failing.run(row, values)), name.c_str());
+}
+
+int main(int argc, char* argv[])
+{
+  run(BACKEND_STACK, false, "stack backend, baseline tier");
+  run(BACKEND_STACK, true, "stack backend, optimized tier");
+  run(BACKEND_REGISTER, false, "register backend, baseline tier");
+  run(BACKEND_REGISTER, true, "register backend, optimized tier");
+  MathFunction::setBackend(BACKEND_STACK);
+  MathFunction::setTierPolicy(TierPolicy());
+  
+  // Selections are parsed from calls of 3 arguments, so no function of that name and argument count may be declared.
+  check(THROWS(InvalidArgumentException, MathFunction("if(a, b, c)", "a + b + c")) && THROWS(InvalidArgumentException, MathFunction("select(a, b, c)", "a")),
+      "declaring if or select of 3 arguments throws");
+  MathFunction twoArguments("if(a, b)", "a * b");
+  MathFunction user("user(x)", "if(x, 3) + if(x > 0, 1, 2)");
+  check(user.invoke({2}) == 7, "if of another argument count is a function as any other");
+  return failures;
+}
@@ -0,0 +1,136 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <EvaluationPlan.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Evaluation plans: the fused program against each function evaluated alone, bit for bit, and the values it shares.
+ */
+
+static const int ROWS = 1001;
+
+/*
+ * Whether two values are the same bit for bit, NaN being the same as NaN.
+ */
+static bool same(double a, double b)
+{
+  return (a == b && signbit(a) == signbit(b)) || (a != a && b != b);
+}
+
+int main(int argc, char* argv[])
+{
+  // Compiled optimized right away, as the plan is.
+  TierPolicy policy;
+  policy.enabled = false;
+  MathFunction::setTierPolicy(policy);
+  
+  string terms = "cos(x * 0)";
+  for(int i = 1 ; i < 80 ; i++)
+  {
+    terms += " + cos(x * " + to_string(i) + " + y)";
+  }
+  MathFunction r("r(x, y)", "(x^2 + y^2)^0.5");
+  MathFunction wave("wave(x, y)", terms);
+  MathFunction f("f(x, y)", "r(x, y) * 2 + wave(x, y)");
+  MathFunction g("g(y, x, z)", "r(x, y) + z - wave(x, y) / 3");
+  MathFunction h("h(z, x)", "if(z > 0, r(x, z), -x) + sin(x) * sin(x)");
+  vector<const MathFunction*> funcs = {&f, &g, &h};
+  EvaluationPlan plan(funcs);
+  
+  check(plan.getVariableCount() == 3 && plan.getVariableName(0) == "x" && plan.getVariableName(1) == "y" && plan.getVariableName(2) == "z"
+      && plan.getOutputCount() == 3, "the variables are those of the functions, in order of first appearance");
+  
+  mt19937_64 rng(65536);
+  uniform_real_distribution<double> uniform(-3, 3);
+  vector<double> xs(ROWS);
+  vector<double> ys(ROWS);
+  vector<double> zs(ROWS);
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    xs[i] = uniform(rng);
+    ys[i] = uniform(rng);
+    zs[i] = (i % 5 == 0 ? 0 : uniform(rng));
+  }
+  const double* columns[] = {xs.data(), ys.data(), zs.data()};
+  vector<vector<double> > outputs(3, vector<double>(ROWS));
+  double* results[] = {outputs[0].data(), outputs[1].data(), outputs[2].data()};
+  plan.runBatch(columns, ROWS, results);
+  
+  // Each function alone, its columns picked by name.
+  vector<vector<double> > alone(3, vector<double>(ROWS));
+  const double* fColumns[] = {xs.data(), ys.data()};
+  const double* gColumns[] = {ys.data(), xs.data(), zs.data()};
+  const double* hColumns[] = {zs.data(), xs.data()};
+  f.invokeBatch(fColumns, ROWS, alone[0].data());
+  g.invokeBatch(gColumns, ROWS, alone[1].data());
+  h.invokeBatch(hColumns, ROWS, alone[2].data());
+  bool batchSame = true;
+  bool scalarSame = true;
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    double row[] = {xs[i], ys[i], zs[i]};
+    double values[3];
+    plan.run(row, values);
+    for(int j = 0 ; j < 3 ; j++)
+    {
+      batchSame = batchSame && same(outputs[j][i], alone[j][i]);
+      scalarSame = scalarSame && same(values[j], alone[j][i]);
+    }
+  }
+  check(batchSame, "runBatch() gives the results of each function alone, bit for bit");
+  check(scalarSame, "run() gives the results of each function alone, bit for bit");
+  
+  // What the functions share is computed once.
+  EvaluationPlan planF({&f});
+  EvaluationPlan planG({&g});
+  EvaluationPlan planH({&h});
+  check(plan.getLength() < planF.getLength() + planG.getLength() + planH.getLength() && plan.getMemoryBytes() > 0,
+      "the fused program is shorter than the three alone");
+  EvaluationPlan twice({&f, &f});
+  check(twice.getLength() == planF.getLength(), "a function listed twice is computed once");
+  
+  // The plan keeps the formulas it was created from, whether a callee is inlined, as r is, or called, as wave is.
+  //  Profiled builds inline no callee at all.
+  double row[] = {3, 4, 1};
+  double values[3];
+  double waved = wave.invoke({3.0, 4.0});
+  r.redefine("x + y");
+  plan.run(row, values);
+  check(values[0] == 10 + waved, "the plan does not follow the redefinition of an inlined callee");
+  wave.redefine("x - y");
+  plan.run(row, values);
+  check(values[0] == 10 + waved && values[1] == 6 - waved / 3, "the plan does not follow the redefinition of a called callee");
+  
+  // Nor does it need the functions any more.
+  MathFunction* temporary = new MathFunction("temporary(x)", "wave(x, 1) + x");
+  EvaluationPlan* outliving = new EvaluationPlan({temporary});
+  delete temporary;
+  wave.redefine("x * y");
+  double single[] = {3};
+  outliving->run(single, values);
+  check(values[0] == 5, "the plan outlives the functions it was created from");
+  delete outliving;
+  
+  MathFunction inverse("inverse(x, y)", "y / x");
+  EvaluationPlan failing({&f, &inverse});
+  double zero[] = {0, 1};
+  double failed[2];
+  check(THROWS(DividedByZeroException, failing.run(zero, failed)), "an error of one function throws out of the plan");
+  check(THROWS(InvalidArgumentException, EvaluationPlan(vector<const MathFunction*>())), "an empty list throws");
+  
+  MathFunction::setTierPolicy(TierPolicy());
+  return failures;
+}
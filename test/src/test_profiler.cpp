@@ -0,0 +1,85 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <vector>
+
+#include <TangentsMathFunc.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Profiler: per-opcode totals, and samples spread over every instruction of a formula whose length divides the
+ *  sampling interval. Built both with and without TANGENT_MATH_FUNC_PROFILE, nothing being recorded without.
+ */
+
+static const int CALLS = 64 * 2000;
+
+static const int OPCODES[] = {OPCODE_VARIABLE, OPCODE_NEGATIVE, OPCODE_CONSTANT, OPCODE_MULTIPLICATION};
+
+int main(int argc, char* argv[])
+{
+  // Pinned to the baseline tier, so that the program is the plain translation of the formula.
+  TierPolicy policy;
+  policy.enabled = true;
+  policy.invocationThreshold = ~0ULL;
+  policy.rowThreshold = ~0ULL;
+  MathFunction::setTierPolicy(policy);
+  MathFunction f("f(x)", "-x * 2");
+  
+  Profiler::setEnabled(true);
+  for(int i = 0 ; i < CALLS ; i++)
+  {
+    f.invoke({(double)i});
+  }
+  Profiler::setEnabled(false);
+  
+  if(!Profiler::isAvailable())
+  {
+    bool nothing = true;
+    for(int opcode = 0 ; opcode < OPCODE_COUNT ; opcode++)
+    {
+      nothing = nothing && Profiler::getExecutedCount(opcode) == 0 && Profiler::getSampledCount(opcode) == 0;
+    }
+    check(nothing, "without TANGENT_MATH_FUNC_PROFILE, nothing is recorded");
+    MathFunction::setTierPolicy(TierPolicy());
+    return failures;
+  }
+  
+  // 4 instructions per call: a fixed interval of 64 would time the same one of them on every sample.
+  check(f.getMemoryUsage().instructions == 4, "the program of -x * 2 is 4 instructions long, which divides the interval");
+  bool executed = true;
+  bool spread = true;
+  unsigned long long sampled = 0;
+  for(int opcode : OPCODES)
+  {
+    executed = executed && Profiler::getExecutedCount(opcode) == CALLS;
+    // CALLS / 64 samples expected for each, give or take a few standard deviations.
+    spread = spread && Profiler::getSampledCount(opcode) > CALLS / 64 * 3 / 4 && Profiler::getSampledCount(opcode) < CALLS / 64 * 5 / 4;
+    sampled += Profiler::getSampledCount(opcode);
+  }
+  check(executed, "every instruction is counted once per call");
+  check(spread, "every instruction of the formula is timed about as often as the others");
+  check(sampled > 4ULL * CALLS / 64 * 9 / 10 && sampled < 4ULL * CALLS / 64 * 11 / 10, "one instruction out of SAMPLE_INTERVAL is timed on average");
+  
+  // Batches count every row, and reset() drops everything.
+  Profiler::reset();
+  vector<double> xs(1000, 1);
+  vector<double> results(1000);
+  const double* columns[] = {xs.data()};
+  Profiler::setEnabled(true);
+  f.invokeBatch(columns, 1000, results.data());
+  Profiler::setEnabled(false);
+  check(Profiler::getExecutedCount(OPCODE_MULTIPLICATION) == 1000 && Profiler::getExecutedCount(OPCODE_DIVISION) == 0, "each row of a batch counts as an instruction");
+  Profiler::reset();
+  check(Profiler::getExecutedCount(OPCODE_MULTIPLICATION) == 0 && Profiler::getSampledCount(OPCODE_VARIABLE) == 0, "reset() drops the counts");
+  
+  MathFunction::setTierPolicy(TierPolicy());
+  return failures;
+}
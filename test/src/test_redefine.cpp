@@ -0,0 +1,98 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <TangentsMathFunc.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Dependency graph: redefinition reaching transitive dependents, circular references, and destroyed callees,
+ *  whose shadows go along with their last caller. Leak-checked when built with -fsanitize=address.
+ */
+
+int main(int argc, char* argv[])
+{
+  MathFunctionNamespace ns(&MathFunctionNamespace::getBuiltIns());
+  
+  MathFunction h(ns, "h(x)", "x + 1");
+  MathFunction k(ns, "k(x)", "h(x) * 2");
+  MathFunction m(ns, "m(x, y)", "k(x) + h(y)");
+  check(m.invoke({3, 4}) == 13, "m(3, 4) = (3 + 1) * 2 + (4 + 1)");
+  check(h.getDependentsCount() == 2 && k.getDependentsCount() == 1, "h is referenced by k and m, k by m");
+  
+  h.redefine("x - 1");
+  check(k.invoke({3}) == 4, "redefining h recompiles its direct dependent k");
+  check(m.invoke({3, 4}) == 7, "redefining h recompiles its transitive dependent m");
+  
+  k.redefine("h(x) * 3");
+  check(m.invoke({3, 4}) == 9 && h.invoke({3}) == 2, "redefining k recompiles m, leaving h as it was");
+  
+  check(THROWS(InvalidFormulaException, h.redefine("m(x, x)")), "h may not reference m, which depends on h");
+  check(THROWS(InvalidFormulaException, h.redefine("k(x)")), "h may not reference k, which depends on h");
+  check(THROWS(InvalidFormulaException, h.redefine("h(x) + 1")), "h may not reference itself");
+  check(h.invoke({3}) == 2 && m.invoke({3, 4}) == 9, "a rejected redefinition keeps the previous formula");
+  
+  // A destroyed callee stays alive for its callers, until a new function of the same identifier takes over.
+  MathFunction* p = new MathFunction(ns, "p(x)", "x * 10");
+  MathFunction q(ns, "q(x)", "p(x) + 1");
+  delete p;
+  check(q.invoke({2}) == 21, "q keeps calling the last definition of a destroyed p");
+  
+  MathFunction p2(ns, "p(x)", "x * 100");
+  check(q.invoke({2}) == 201, "a new p takes over the callers of the destroyed one");
+  check(p2.getDependentsCount() == 1, "the new p has q as its dependent");
+  
+  p2.redefine("x");
+  check(q.invoke({2}) == 3, "redefining the new p recompiles q");
+  
+  // A layer hides a function of its parent within its own namespace only.
+  MathFunctionNamespace layer(&ns);
+  MathFunction* hidden = new MathFunction(layer, "h(x)", "x * x");
+  MathFunction r(layer, "r(x)", "h(x)");
+  check(r.invoke({5}) == 25, "r sees the h of its own layer");
+  check(m.invoke({3, 4}) == 9, "functions of the parent keep calling the h of the parent");
+  delete hidden;
+  check(r.invoke({5}) == 25, "r keeps the destroyed h of its layer");
+  
+  // Unreferenced, the function hiding the one of the parent leaves nothing behind.
+  MathFunctionNamespace other(&ns);
+  MathFunction* unused = new MathFunction(other, "h(x)", "x * x");
+  delete unused;
+  MathFunction s(other, "s(x)", "h(x)");
+  check(s.invoke({5}) == 4, "destroying an unreferenced h of a layer restores the h of the parent");
+  
+  // A shadow goes along with its last caller, and a shadow calling another one releases it in turn.
+  MathFunctionNamespace pool(&ns);
+  bool served = true;
+  for(int i = 0 ; i < 100 ; i++)
+  {
+    MathFunction* a = new MathFunction(pool, "a(x)", "x + 1");
+    MathFunction* b = new MathFunction(pool, "b(x)", "a(x) * 2");
+    MathFunction* c = new MathFunction(pool, "c(x)", "b(x) + a(x)");
+    delete a;
+    delete b;
+    served = served && pool.getMemoryUsage().shadows == 2 && c->invoke({1}) == 6;
+    delete c;
+  }
+  MemoryUsage left = pool.getMemoryUsage();
+  check(served && left.shadows == 0 && left.functions == 0 && left.postfixBytes == 0 && left.programBytes == 0 && left.dependents == 0,
+      "shadows are destroyed along with their last caller, leaving nothing behind");
+  
+  MathFunction* d = new MathFunction(pool, "d(x)", "x * 3");
+  MathFunction e(pool, "e(x)", "d(x) + 1");
+  delete d;
+  e.redefine("d(x) + 2");
+  check(pool.getMemoryUsage().shadows == 1 && e.invoke({1}) == 5, "a redefinition still calling a shadow keeps it");
+  e.redefine("x + 2");
+  check(pool.getMemoryUsage().shadows == 0 && pool.getMemoryUsage().functions == 1 && e.invoke({1}) == 3,
+      "a redefinition no longer calling a shadow destroys it");
+  
+  return failures;
+}
@@ -0,0 +1,168 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <TangentsMathFunc.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Register backend: the same functions compiled for both backends, at both tiers, give the same results bit for bit.
+ */
+
+static const int ROWS = 1000;
+
+/*
+ * Functions of three variables, calling the helpers of evaluate().
+ */
+static const char* const FORMULAS[][2] = {
+  {"f0(x, y, z)", "9*x^2 + 6*x*y + y^2 - 3*x - y - 1"},
+  {"f1(x, y, z)", "x"},
+  {"f2(x, y, z)", "-y"},
+  {"f3(x, y, z)", "2.5"},
+  {"f4(x, y, z)", "(x + y) * (x + y) - (x + y) / (z * z + 1)"},
+  {"f5(x, y, z)", "sin(x * y) + sin(x * y) * cos(x * y) + cos(x * y)"},
+  {"f6(x, y, z)", "((x + 1) * (y + 2) + (z + 3) * (x + 4)) * ((y + 5) * (z + 6) + (x + 7) * (y + 8)) - ((z + 9) * (x + 10) + (y + 11) * (z + 12))"},
+  {"f7(x, y, z)", "twice(x) + twice(twice(y)) - twice(x)"},
+  {"f8(x, y, z)", "swap(x, y) - swap(y, x) + swap(z, z)"},
+  {"f9(x, y, z)", "long(x) + long(y) * long(x)"},
+  {"f10(x, y, z)", "x % 3 + y ^ 3 - z ^ 0.5"},
+  {"f11(x, y, z)", "if(x > y, x - y, y - x) + (x < z && !(y >= z)) * 10"},
+  {"f12(x, y, z)", "floor(x) * ceil(y) + log(z * z + 2, 2) - ln(x * x + 1) + log(y * y + 1)"},
+  {"f13(x, y, z)", "exp(-(x^2 + y^2)) / (1 + z^2) + atan2(y, x)"},
+  {"f14(v[3])", "sum(v) * max(v) - dot(v, v) + v[1] * min(v) - prod(v)"}
+};
+
+/*
+ * Whether two values are the same bit for bit, NaN being the same as NaN.
+ */
+static bool same(double a, double b)
+{
+  return (a == b && signbit(a) == signbit(b)) || (a != a && b != b);
+}
+
+/*
+ * Declare the helpers and functions into a namespace of their own under a backend, and evaluate them with invoke() and
+ *  invokeBatch().
+ *
+ * Param(s):
+ *    scalar    -> Receives the values of invoke(), formula after formula.
+ *    batch     -> Receives the values of invokeBatch().
+ */
+static void evaluate(Backend backend, const double* const* columns, vector<double>& scalar, vector<double>& batch, int& instructions, int& registerInstructions)
+{
+  MathFunction::setBackend(backend);
+  MathFunctionNamespace ns(&MathFunctionNamespace::getBuiltIns());
+  string terms = "sin(x + 0)";
+  for(int i = 1 ; i < 80 ; i++)
+  {
+    terms += " + sin(x + " + to_string(i) + ")";
+  }
+  vector<MathFunction*> funcs;
+  funcs.push_back(new MathFunction(ns, "twice(x)", "x * 2"));
+  funcs.push_back(new MathFunction(ns, "swap(a, b)", "a - b * 2"));
+  funcs.push_back(new MathFunction(ns, "long(x)", terms));
+  size_t helpers = funcs.size();
+  for(size_t i = 0 ; i < sizeof(FORMULAS) / sizeof(FORMULAS[0]) ; i++)
+  {
+    funcs.push_back(new MathFunction(ns, FORMULAS[i][0], FORMULAS[i][1]));
+  }
+  
+  scalar.clear();
+  batch.clear();
+  instructions = 0;
+  registerInstructions = 0;
+  vector<double> values(ROWS);
+  for(size_t f = helpers ; f < funcs.size() ; f++)
+  {
+    for(int i = 0 ; i < ROWS ; i++)
+    {
+      scalar.push_back(funcs[f]->invoke({columns[0][i], columns[1][i], columns[2][i]}));
+    }
+    funcs[f]->invokeBatch(columns, ROWS, values.data());
+    batch.insert(batch.end(), values.begin(), values.end());
+    instructions += funcs[f]->getMemoryUsage().instructions;
+    registerInstructions += funcs[f]->getMemoryUsage().registerInstructions;
+  }
+  
+  for(size_t f = funcs.size() ; f > 0 ; f--)
+  {
+    delete funcs[f - 1];
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  mt19937_64 rng(65536);
+  uniform_real_distribution<double> uniform(-4, 4);
+  vector<double> xs(ROWS);
+  vector<double> ys(ROWS);
+  vector<double> zs(ROWS);
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    xs[i] = uniform(rng);
+    ys[i] = uniform(rng);
+    zs[i] = uniform(rng);
+  }
+  // Equal operands and zeros, for the comparisons and the roots.
+  xs[0] = ys[0] = zs[0] = 0;
+  xs[1] = ys[1] = 2;
+  const double* columns[] = {xs.data(), ys.data(), zs.data()};
+  
+  // Baseline tier first, with thresholds never reached, then the optimized tier right away.
+  for(int tier = 1 ; tier <= 2 ; tier++)
+  {
+    TierPolicy policy;
+    policy.enabled = (tier == 1);
+    policy.invocationThreshold = ~0ULL;
+    policy.rowThreshold = ~0ULL;
+    MathFunction::setTierPolicy(policy);
+    
+    vector<double> stackScalar, stackBatch, registerScalar, registerBatch;
+    int stackInstructions, unused, instructions, registerInstructions;
+    evaluate(BACKEND_STACK, columns, stackScalar, stackBatch, stackInstructions, unused);
+    evaluate(BACKEND_REGISTER, columns, registerScalar, registerBatch, instructions, registerInstructions);
+    
+    bool scalarSame = true;
+    bool batchSame = true;
+    for(size_t i = 0 ; i < stackScalar.size() ; i++)
+    {
+      scalarSame = scalarSame && same(stackScalar[i], registerScalar[i]);
+      batchSame = batchSame && same(stackBatch[i], registerBatch[i]);
+    }
+    string suffix = (tier == 1 ? ", baseline tier" : ", optimized tier");
+    check(scalarSame, ("invoke() gives the same results on both backends" + suffix).c_str());
+    check(batchSame, ("invokeBatch() gives the same results on both backends" + suffix).c_str());
+    check(registerInstructions > 0 && registerInstructions < instructions && instructions == stackInstructions,
+        ("the register forms take fewer instructions than the stack programs" + suffix).c_str());
+  }
+  MathFunction::setTierPolicy(TierPolicy());
+  
+  // The corpus polynomial of the README, and errors raised by a register program.
+  TierPolicy policy;
+  policy.enabled = false;
+  MathFunction::setTierPolicy(policy);
+  MathFunction::setBackend(BACKEND_REGISTER);
+  MathFunction poly("poly(x, y)", "9*x^2 + 6*x*y + y^2 - 3*x - y - 1");
+  check(poly.getMemoryUsage().registerInstructions == 5 && poly.getMemoryUsage().instructions == 15, "the README polynomial takes 5 register instructions and 15 stack ones");
+  MathFunction inverse("inverse(x)", "1 / x");
+  double zero = 0;
+  const double* zeros[] = {&zero};
+  double result;
+  check(THROWS(DividedByZeroException, inverse.invoke({0.0})) && THROWS(DividedByZeroException, inverse.invokeBatch(zeros, 1, &result)),
+      "division by zero throws from a register program");
+  MathFunction::setBackend(BACKEND_STACK);
+  MathFunction::setTierPolicy(TierPolicy());
+  
+  return failures;
+}
@@ -0,0 +1,88 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <vector>
+
+#include <RootFinder.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Batched root finding: converged rows against closed forms, and the status of each kind of failing row.
+ */
+
+static const int ROWS = 10000;
+
+int main(int argc, char* argv[])
+{
+  RootFinder finder(1e-12, 100);
+  MathFunction f("f(x, c)", "x^2 - c");
+  MathFunction df("df(x, c)", "2 * x");
+  
+  // More rows than a block, so that several blocks are solved.
+  vector<double> cs(ROWS);
+  vector<double> lower(ROWS, 0.0);
+  vector<double> upper(ROWS);
+  for(int i = 0 ; i < ROWS ; i++)
+  {
+    cs[i] = 0.5 + i * 0.01;
+    upper[i] = cs[i] + 1;
+  }
+  const double* columns[] = {nullptr, cs.data()};
+  
+  for(int method = 0 ; method < 2 ; method++)
+  {
+    vector<double> roots(ROWS);
+    vector<int> iterations(ROWS);
+    vector<int> status(ROWS);
+    int converged = (method == 0 ? finder.solve(f, "x", columns, lower.data(), upper.data(), ROWS, roots.data(), iterations.data(), status.data())
+        : finder.solve(f, df, "x", columns, lower.data(), upper.data(), ROWS, roots.data(), iterations.data(), status.data()));
+    bool exact = (converged == ROWS);
+    for(int i = 0 ; i < ROWS ; i++)
+    {
+      exact = exact && status[i] == ROOT_CONVERGED && fabs(roots[i] - sqrt(cs[i])) <= 1e-11 && iterations[i] > 0 && iterations[i] <= 100;
+    }
+    check(exact, (method == 0 ? "Brent's method finds every square root" : "safeguarded Newton's method finds every square root"));
+  }
+  
+  // One row of each kind of failure, among converging ones.
+  double c[] = {4, 4, -1, 4, 9};
+  double lo[] = {1.5, 3, -0.5, -1, 0};
+  double hi[] = {3, 5, 0.5, 1, 1e308};
+  MathFunction g("g(x, c)", "(x^2 - c) / (x - 1)");
+  const double* gColumns[] = {nullptr, c};
+  double roots[5];
+  int iterations[5];
+  int status[5];
+  int converged = finder.solve(g, "x", gColumns, lo, hi, 5, roots, iterations, status);
+  check(status[0] == ROOT_CONVERGED && fabs(roots[0] - 2) <= 1e-11, "a bracketed row converges");
+  check(status[1] == ROOT_NOT_BRACKETED && roots[1] != roots[1], "a row whose ends have the same sign is not bracketed, its root NaN");
+  check(status[2] == ROOT_NOT_BRACKETED && roots[2] != roots[2], "a row without any root is not bracketed");
+  check(status[3] == ROOT_NOT_FINITE && roots[3] != roots[3], "a row dividing by zero on the way is not finite");
+  check(status[4] == ROOT_NOT_FINITE, "a row overflowing to infinity is not finite");
+  check(converged == 1, "only converged rows are counted");
+  
+  RootFinder hurried(1e-15, 3);
+  converged = hurried.solve(f, "x", columns, lower.data(), upper.data(), 1, roots, iterations, status);
+  check(converged == 0 && status[0] == ROOT_MAX_ITERATIONS && iterations[0] == 3 && fabs(roots[0] - sqrt(cs[0])) < 1, "the iteration limit reports the best estimate");
+  
+  double exactRoot[] = {0.0};
+  double exactLo[] = {-1.0};
+  double exactHi[] = {1.0};
+  double zero[] = {0.0};
+  const double* zColumns[] = {nullptr, zero};
+  MathFunction line("line(x, c)", "x - c");
+  finder.solve(line, "x", zColumns, exactLo, exactHi, 1, exactRoot, iterations, status);
+  check(status[0] == ROOT_CONVERGED && exactRoot[0] == 0, "an exact zero stops the row");
+  
+  check(THROWS(InvalidArgumentException, finder.solve(f, "y", columns, lower.data(), upper.data(), 1, roots)), "an unknown variable throws");
+  
+  return failures;
+}
@@ -0,0 +1,125 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <vector>
+
+#include <Tabulator.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Tabulation: the interpolant against the formula, directly and through a caller, and what drops or refuses it.
+ */
+
+static const double TOLERANCE = 1e-10;
+
+/*
+ * Largest difference between two functions of one variable over [lower, upper], the first one being called directly
+ *  and through invokeBatch(). Counts into "differing" the points where the values are not the same bit for bit.
+ */
+static double maxDifference(const MathFunction& func, const MathFunction& reference, double lower, double upper, int& differing)
+{
+  const int POINTS = 10007;
+  vector<double> xs(POINTS);
+  for(int i = 0 ; i < POINTS ; i++)
+  {
+    xs[i] = lower + (upper - lower) * i / (POINTS - 1);
+  }
+  vector<double> values(POINTS);
+  const double* columns[] = {xs.data()};
+  func.invokeBatch(columns, POINTS, values.data());
+  double worst = 0;
+  differing = 0;
+  for(int i = 0 ; i < POINTS ; i++)
+  {
+    double expected = reference.invoke({xs[i]});
+    differing += (values[i] != expected ? 1 : 0);
+    worst = fmax(worst, fmax(fabs(values[i] - expected), fabs(func.invoke({xs[i]}) - expected)));
+  }
+  return worst;
+}
+
+int main(int argc, char* argv[])
+{
+  MathFunctionNamespace ns(&MathFunctionNamespace::getBuiltIns());
+  Tabulator tabulator(TOLERANCE, TOLERANCE);
+  
+  MathFunction f(ns, "f(x)", "exp(-x^2) * sin(3 * x) / (1 + x^2) + atan(x)^3");
+  MathFunction reference(ns, "reference(x)", "exp(-x^2) * sin(3 * x) / (1 + x^2) + atan(x)^3");
+  MathFunction g(ns, "g(x, y)", "f(x) * 2 + y");
+  MathFunction gReference(ns, "gReference(x)", "reference(x) * 2 + 1");
+  MathFunction gCall(ns, "gCall(x)", "g(x, 1)");
+  
+  TabulationResult r = tabulator.tabulate(f, -4, 4);
+  check(r.converged && f.isTabulated(), "f converges over [-4, 4]");
+  check(r.maxError <= TOLERANCE && r.pieces[0] > 1 && r.pieces[1] == 1 && r.evaluations > 0, "the reported error is within the tolerance");
+  int differing;
+  check(maxDifference(f, reference, -4, 4, differing) <= 10 * TOLERANCE && differing > 0, "f is within the tolerance between the test points");
+  check(maxDifference(gCall, gReference, -4, 4, differing) <= 20 * TOLERANCE && differing > 0, "a caller declared beforehand calls the interpolant");
+  
+  bool exact = true;
+  for(double x = -9 ; x <= 9 ; x += 0.25)
+  {
+    exact = exact && (fabs(x) <= 4 || f.invoke({x}) == reference.invoke({x}));
+  }
+  check(exact, "outside of the box, f evaluates its formula");
+  
+  f.untabulate();
+  check(!f.isTabulated() && f.invoke({0.3}) == reference.invoke({0.3}), "untabulate() goes back to the formula");
+  
+  // Redefining a callee drops the interpolant of its caller.
+  MathFunction k(ns, "k(x)", "cos(x)");
+  MathFunction p(ns, "p(x)", "k(x) * x");
+  r = tabulator.tabulate(p, 0, 2);
+  check(r.converged && p.isTabulated(), "p converges over [0, 2]");
+  k.redefine("sin(x)");
+  check(!p.isTabulated() && p.invoke({1.5}) == sin(1.5) * 1.5, "redefining the callee of p drops its interpolant");
+  p.redefine("k(x) * x * 2");
+  r = tabulator.tabulate(p, 0, 2);
+  bool tabulated = r.converged && p.isTabulated();
+  p.redefine("k(x)");
+  check(tabulated && !p.isTabulated() && p.invoke({1.5}) == sin(1.5), "redefining p drops its interpolant");
+  
+  // Two variables: only the rougher variable needs more pieces.
+  MathFunction h(ns, "h(x, y)", "sin(20 * x) * (1 + y^2)");
+  MathFunction hReference(ns, "hReference(x, y)", "sin(20 * x) * (1 + y^2)");
+  double lower[] = {0, -1};
+  double upper[] = {1, 1};
+  r = tabulator.tabulate(h, lower, upper);
+  check(r.converged && h.isTabulated() && r.pieces[0] > r.pieces[1], "h converges, x taking more pieces than y");
+  double worst = 0;
+  for(int i = 0 ; i <= 200 ; i++)
+  {
+    for(int j = 0 ; j <= 50 ; j++)
+    {
+      double x = i / 200.0, y = -1 + j / 25.0;
+      worst = fmax(worst, fabs(h.invoke({x, y}) - hReference.invoke({x, y})));
+    }
+  }
+  check(worst <= 10 * TOLERANCE, "h is within the tolerance over its box");
+  
+  // Failures leave the formula in place.
+  Tabulator small(1e-14, 0, 4, 8);
+  MathFunction rough(ns, "rough(x)", "sin(50 * x)");
+  r = small.tabulate(rough, 0, 10);
+  check(!r.converged && !rough.isTabulated() && r.pieces[0] <= 8, "hitting the piece limit does not converge");
+  MathFunction root(ns, "root(x)", "x ^ 0.5");
+  r = tabulator.tabulate(root, -1, 1);
+  check(!r.converged && !root.isTabulated() && root.invoke({0.25}) == 0.5, "a function not finite over the box does not converge");
+  
+  check(THROWS(InvalidArgumentException, Tabulator(-1, 0)), "a negative tolerance throws");
+  check(THROWS(InvalidArgumentException, Tabulator(1e-10, 1e-10, Tabulator::MAX_DEGREE + 1)), "a degree above MAX_DEGREE throws");
+  check(THROWS(InvalidArgumentException, tabulator.tabulate(f, 1, 1)), "empty bounds throw");
+  check(THROWS(InvalidArgumentException, tabulator.tabulate(f, 0, INFINITY)), "infinite bounds throw");
+  check(THROWS(InvalidArgumentException, tabulator.tabulate(h, 0, 1)), "one range for two variables throws");
+  check(THROWS(InvalidArgumentException, tabulator.tabulate(f, lower, upper)), "two ranges for one variable throw");
+  
+  return failures;
+}
@@ -0,0 +1,89 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <TangentsMathFunc.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace std;
+
+/*
+ * Tiered execution: promotion of hot functions and their callees, and redefinitions once promoted or while queued.
+ */
+
+static void call(const MathFunction& func, int times)
+{
+  for(int i = 0 ; i < times ; i++)
+  {
+    func.invoke({(double)(i)});
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  TierPolicy policy;
+  policy.invocationThreshold = 100;
+  policy.rowThreshold = ~0ULL;
+  MathFunction::setTierPolicy(policy);
+  
+  MathFunction f("f(x)", "x * x + 1");
+  MathFunction g("g(x)", "f(x) * 2 + f(x + 1)");
+  check(g.getTierStats().tier == TIER_BASELINE, "functions start at the baseline tier");
+  double baseline = g.invoke({3});
+  
+  call(g, 98);
+  check(g.getTierStats().tier == TIER_BASELINE && g.getTierStats().invocations == 99, "calls below the threshold are counted");
+  call(g, 1);
+  MathFunction::waitForTiering();
+  check(g.getTierStats().tier == TIER_OPTIMIZED, "the threshold queues the function, which gets promoted");
+  check(f.getTierStats().tier == TIER_OPTIMIZED, "its callee is promoted along with it");
+  check(g.invoke({3}) == baseline, "the optimized tier gives the same result");
+  
+  // Redefining the callee of a promoted function.
+  f.redefine("x - 1");
+  check(f.getTierStats().tier == TIER_BASELINE, "a redefinition sends the function back to the baseline tier");
+  check(g.invoke({3}) == 2 * 2 + 3, "the promoted caller is recompiled with the new callee");
+  call(f, 100);
+  MathFunction::waitForTiering();
+  check(f.getTierStats().tier == TIER_OPTIMIZED && f.invoke({3}) == 2, "a redefined function is promoted again");
+  check(g.invoke({3}) == 7, "its caller stays consistent once it is promoted again");
+  
+  // Redefining a function waiting for the background compiler.
+  MathFunction h("h(x)", "x + 10");
+  call(h, 100);
+  h.redefine("x + 20");
+  MathFunction::waitForTiering();
+  check(h.invoke({1}) == 21, "a queued promotion never brings back the previous formula");
+  call(h, 100);
+  MathFunction::waitForTiering();
+  check(h.getTierStats().tier == TIER_OPTIMIZED && h.invoke({1}) == 21, "the redefined function is promoted with its new formula");
+  
+  // Rows of batches count toward the row threshold.
+  policy.invocationThreshold = ~0ULL;
+  policy.rowThreshold = 1000;
+  MathFunction::setTierPolicy(policy);
+  MathFunction b("b(x)", "x / 2");
+  double xs[1000];
+  double ys[1000];
+  for(int i = 0 ; i < 1000 ; i++)
+  {
+    xs[i] = i;
+  }
+  const double* columns[] = {xs};
+  b.invokeBatch(columns, 1000, ys);
+  MathFunction::waitForTiering();
+  check(b.getTierStats().tier == TIER_OPTIMIZED && ys[999] == 499.5, "a batch crossing the row threshold promotes the function");
+  
+  policy.enabled = false;
+  MathFunction::setTierPolicy(policy);
+  MathFunction o("o(x)", "x + 1");
+  check(o.getTierStats().tier == TIER_OPTIMIZED, "with tiering disabled, functions are compiled optimized right away");
+  
+  MathFunction::setTierPolicy(TierPolicy());
+  return failures;
+}
@@ -0,0 +1,118 @@
+/*
+ * Tangent's Math Function V1.02
+ *  Copyright (c) 2018-2022, tangent65536. All rights reserved.
+ *
+ * The code may be found on my GitHub repository:
+ *  https://github.com/tan2pow16/TangentsMathFunc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include <TangentsMathFunc.hpp>
+#include <CsvEvaluator.hpp>
+
+using namespace std;
+
+static void usage()
+{
+  fprintf(stderr,
+    "Usage: csv_eval [options] <identifier> <formula> [<identifier> <formula> ...]\n"
+    "  Reads a CSV file with a header line and appends one column per function, named after it.\n"
+    "  Variables are bound to the columns of the same name. Every function may call the ones declared before it.\n"
+    "\n"
+    "  -i <file>     Input, standard input by default.\n"
+    "  -o <file>     Output, standard output by default.\n"
+    "  -d <char>     Delimiter, ',' by default.\n"
+    "  -b <rows>     Rows per batch, %d by default.\n"
+    "  -p <digits>   Significant digits of the results, 17 by default.\n"
+    "\n"
+    "  e.g. csv_eval -i in.csv \"f(x, y)\" \"9*x^2 + 6*x*y + y^2\" > out.csv\n",
+    CsvEvaluator::DEFAULT_BATCH_ROWS);
+}
+
+int main(int argc, char* argv[])
+{
+  const char* input = nullptr;
+  const char* output = nullptr;
+  char delimiter = ',';
+  int batchRows = CsvEvaluator::DEFAULT_BATCH_ROWS;
+  int precision = 17;
+  
+  int index = 1;
+  for( ; index + 1 < argc && argv[index][0] == '-' && strlen(argv[index]) == 2 ; index += 2)
+  {
+    switch(argv[index][1])
+    {
+      case 'i':
+        input = argv[index + 1];
+        break;
+      case 'o':
+        output = argv[index + 1];
+        break;
+      case 'd':
+        delimiter = argv[index + 1][0];
+        break;
+      case 'b':
+        batchRows = atoi(argv[index + 1]);
+        break;
+      case 'p':
+        precision = atoi(argv[index + 1]);
+        break;
+      default:
+        usage();
+        return 1;
+    }
+  }
+  if(index >= argc || (argc - index) % 2 != 0)
+  {
+    usage();
+    return 1;
+  }
+  
+  FILE* in = (input != nullptr ? fopen(input, "rb") : stdin);
+  FILE* out = (output != nullptr ? fopen(output, "wb") : stdout);
+  if(in == nullptr || out == nullptr)
+  {
+    fprintf(stderr, "Cannot open %s\n", in == nullptr ? input : output);
+    return 1;
+  }
+  
+  vector<MathFunction*> funcs;
+  int ret = 0;
+  try
+  {
+    CsvEvaluator evaluator(delimiter, batchRows, CsvEvaluator::DEFAULT_BATCH_COUNT, precision);
+    for( ; index < argc ; index += 2)
+    {
+      MathFunction* func = new MathFunction(argv[index], argv[index + 1]);
+      funcs.push_back(func);
+      evaluator.addOutput(*func, func->getIdentifier().getName());
+    }
+    evaluator.run(in, out);
+    fprintf(stderr, "%llu rows\n", evaluator.getRowCount());
+  }
+  catch(const exception& ex)
+  {
+    fprintf(stderr, "%s\n", ex.what());
+    ret = 1;
+  }
+  
+  for(size_t i = funcs.size() ; i > 0 ; i--)
+  {
+    delete funcs[i - 1];
+  }
+  if(in != stdin)
+  {
+    fclose(in);
+  }
+  if(out != stdout)
+  {
+    fclose(out);
+  }
+  return ret;
+}